@@ -5,13 +5,25 @@
 #include "fps.h"
 #include "gl_common.h"
 #include "icosphere.h"
+#include "icosphere_cache.h"
 #ifdef USE_SSBO_RENDERING
 #include "ssbo_rendering.h"
 #endif
 #include "billboard_rendering.h"
 #include "camera.h"
+#include "deferred.h"
+#include "depth_sort.h"
+#include "dynamic_resolution.h"
+#include "gpu_readback.h"
+#include "hybrid_rendering.h"
+#include "instance_generator.h"
+#include "instance_sim.h"
+#include "instance_stream.h"
 #include "instanced_rendering.h"
+#include "job_system.h"
+#include "light_clusters.h"
 #include "material.h"
+#include "pbr.h"
 #include "perf_timer.h"
 #include "postprocess.h"
 #include "shader.h"
@@ -21,13 +33,137 @@
 
 typedef enum {
 	IBL_STATE_IDLE = 0,
-	IBL_STATE_LUMINANCE,
+	IBL_STATE_LUMINANCE, /* Enchaîne sur la 1re tranche spéculaire */
 	IBL_STATE_SPECULAR_INIT,
 	IBL_STATE_SPECULAR_MIPS,
 	IBL_STATE_IRRADIANCE,
 	IBL_STATE_DONE
 } IBLState;
 
+/* Chemin de rendu des sphères (touche L) */
+typedef enum {
+	RENDER_MODE_MESH = 0,  /* Icosphère tessellée pour toutes les instances */
+	RENDER_MODE_BILLBOARD, /* Imposteurs ray-tracés pour toutes les instances */
+	RENDER_MODE_HYBRID,    /* Tri GPU par taille à l'écran (mesh/imposteur) */
+	RENDER_MODE_COUNT
+} SphereRenderMode;
+
+/* Benchmark des modes de rendu en fonction du nombre d'instances (Shift+L) */
+enum { RENDER_BENCH_STEPS = 4 };
+
+typedef struct {
+	int active;
+	int step;  /* Index dans la liste des nombres d'instances */
+	int mode;  /* SphereRenderMode en cours de mesure */
+	int frame; /* Frame courante pour ce couple (step, mode) */
+	int saved_mode;
+	int saved_instance_count;
+	double gpu_ms_sum;
+	double gpu_ms[RENDER_BENCH_STEPS][RENDER_MODE_COUNT];
+	int hybrid_mesh_count[RENDER_BENCH_STEPS];
+	int hybrid_impostor_count[RENDER_BENCH_STEPS];
+	BillboardFragmentStats fragments[RENDER_BENCH_STEPS];
+	BillboardFragmentStats legacy_fragments[RENDER_BENCH_STEPS];
+} RenderBenchmark;
+
+/* Pré-passe de profondeur x tri front-to-back, passe mesh (Ctrl+O).
+ * Configuration : bit 0 = pré-passe, bit 1 = tri GPU. */
+enum { DEPTH_BENCH_CONFIGS = 4 };
+
+typedef struct {
+	int active;
+	int config;
+	int frame;
+	int saved_mode;
+	int saved_prepass;
+	int saved_sort;
+	double gpu_ms_sum;
+	double frame_ms_sum;
+	double fragments_sum;
+	double gpu_ms[DEPTH_BENCH_CONFIGS];
+	double frame_ms[DEPTH_BENCH_CONFIGS];
+	double fragments[DEPTH_BENCH_CONFIGS];
+} DepthBenchmark;
+
+/* Forward / différé à overdraw croissant (Ctrl+I) : même nombre
+ * d'instances, rayon croissant à espacement fixe */
+enum { DEFERRED_BENCH_STEPS = 4 };
+
+typedef struct {
+	int active;
+	int step;
+	int deferred; /* Chemin en cours de mesure */
+	int frame;
+	int saved_mode;
+	int saved_deferred;
+	GLuint coverage_query; /* Pixels éclairés par la résolution */
+	double gpu_ms_sum;
+	double fragments_sum;
+	double coverage_sum;
+	double gpu_ms[DEFERRED_BENCH_STEPS][2];
+	double fragments[DEFERRED_BENCH_STEPS][2]; /* Passe shade / G-buffer */
+	double covered[DEFERRED_BENCH_STEPS];
+} DeferredBenchmark;
+
+/* Lumières analytiques clusterisées, 0 .. 10 000 lumières (Ctrl+T) */
+enum { LIGHT_STEPS = 5 };
+
+typedef struct {
+	int active;
+	int step;
+	int frame;
+	int saved_step;
+	double cull_ms_sum;
+	double gpu_ms_sum;
+	double cull_ms[LIGHT_STEPS];
+	double gpu_ms[LIGHT_STEPS];
+	double lights_per_cluster[LIGHT_STEPS]; /* Indices / clusters */
+} LightBenchmark;
+
+/* Composite compute plein écran vs classes de tuiles, caméra fixe puis en
+ * panoramique, DoF et motion blur actifs (Ctrl+Shift+K) */
+enum { TILE_BENCH_STEPS = 2 };
+
+typedef struct {
+	int active;
+	int step;  /* 0 : caméra fixe, 1 : panoramique */
+	int tiled; /* Chemin en cours de mesure */
+	int frame;
+	int saved_compute;
+	int saved_tiled;
+	unsigned int saved_effects;
+	float saved_yaw;
+	double gpu_ms_sum;
+	double gpu_ms[TILE_BENCH_STEPS][2];
+	/* Répartition des tuiles en fin de mesure du chemin par classes */
+	unsigned int tiles[TILE_BENCH_STEPS][TILE_CLASS_COUNT];
+} TileBenchmark;
+
+/* Budgets GPU de la résolution dynamique (Shift+Y) : 60, 120, 240 Hz */
+enum { DRS_TARGET_STEPS = 3 };
+
+/* Instances animées chaque frame via un InstanceStream (touche U) */
+enum { DYNAMIC_INSTANCE_STEPS = 4 };
+
+typedef struct {
+	int active;
+	int step; /* Index dans la liste des nombres d'instances */
+	int frames;
+	double update_ms_sum; /* Écriture CPU dans la région mappée */
+	double wait_ms_sum;   /* Attente des fences (GPU en retard) */
+} DynamicInstances;
+
+/* Scène de test générée sur GPU : 10^3 .. 10^6 instances (touche N) */
+enum { SCALE_TEST_STEPS = 4 };
+
+typedef struct {
+	int step; /* 0 : scène matériaux par défaut, sinon index + 1 */
+	InstanceGenParams params;
+	int frames;
+	double frame_ms_sum;
+	double gen_gpu_ms;
+} ScaleTest;
+
 typedef struct {
 	IBLState state;
 	int current_mip;
@@ -35,6 +171,8 @@ typedef struct {
 	int width;
 	int height;
 	float threshold;
+	PbrLuminanceThreshold luminance; /* Copie CPU (relecture) */
+	unsigned long long luminance_ticket;
 	GLuint pending_hdr_tex;
 	GLuint pending_spec_tex;
 	GLuint pending_irr_tex;
@@ -54,6 +192,10 @@ typedef struct {
 	uint64_t frame_count;
 	Shader* pbr_instanced_shader;
 	Shader* pbr_billboard_shader;
+	Shader* pbr_compact_shader;           /* SphereInstanceCompact (mesh) */
+	Shader* pbr_billboard_compact_shader; /* SphereInstanceCompact */
+	Shader* depth_prepass_shader;         /* Position seule (touche O) */
+	Shader* depth_prepass_compact_shader;
 	Shader* debug_shader;
 	MaterialLib* material_lib;
 	char** hdr_files;
@@ -65,6 +207,25 @@ typedef struct {
 	UIContext ui;
 	InstancedGroup instanced_group;
 	BillboardGroup billboard_group;
+	HybridGroup hybrid_group;
+	DepthSortGroup depth_sort_group; /* Ordre front-to-back (Shift+O) */
+	RenderBenchmark render_bench;
+	DepthBenchmark depth_bench;
+	DeferredRenderer deferred; /* G-buffer (créé au premier usage) */
+	DeferredBenchmark deferred_bench;
+	LightClusters lights; /* Forward+ clusterisé (créé au premier usage) */
+	LightBenchmark light_bench;
+	TileBenchmark tile_bench;
+	DynamicResolution drs; /* Échelle de rendu pilotée par le GPU (Y) */
+	BillboardStatsPass billboard_stats;
+	InstanceGenerator instance_gen;
+	MaterialTable material_table;
+	int edited_material; /* Index édité via Alt + pavé numérique */
+	JobSystem* jobs; /* Partagé (simulation, géométrie, chargements) */
+	InstanceStream instance_stream;
+	InstanceSim instance_sim; /* Simulation CPU des instances dynamiques */
+	DynamicInstances dynamic;
+	ScaleTest scale_test;
 	Skybox skybox;
 	Camera camera;
 	IBLContext ibl_ctx;
@@ -86,16 +247,24 @@ typedef struct {
 	int show_envmap;
 	int first_mouse;
 	int camera_enabled;
-	int billboard_mode;
+	int render_mode;
+	int depth_prepass; /* Pré-passe Z puis passe principale en GL_LEQUAL */
+	int depth_sort;    /* Instances mesh triées par profondeur (GPU) */
+	int deferred_shading; /* Passe mesh en G-buffer + résolution (I) */
+	int light_step;       /* Nombre de lumières analytiques (T) */
+	int dynamic_resolution; /* Résolution dynamique active (Y) */
+	int drs_target_step;    /* Budget GPU courant (Shift+Y) */
+	int instance_count;
+	int instance_capacity; /* Taille allouée des buffers d'instances */
 	int show_debug_tex;
 	int hdr_count;
 	int current_hdr_index;
 	int env_map_loading;
 
 	GLuint sphere_vao;
-	GLuint sphere_vbo;
-	GLuint sphere_nbo;
-	GLuint sphere_ebo;
+	IcosphereMesh sphere_mesh; /* Niveau courant (buffers possédés par le
+	                              cache) */
+	IcosphereCache sphere_cache;
 	GLuint quad_vbo;
 	GLuint skybox_shader;
 	GLuint hdr_texture;
@@ -107,10 +276,10 @@ typedef struct {
 	GLuint shader_irmap;
 	GLuint shader_lum_pass1;
 	GLuint shader_lum_pass2;
-	GLuint exposure_pbo;
 	GLuint dummy_black_tex;
 	GLuint dummy_white_tex;
 	GLuint lum_ssbo[2];
+	GLuint fragment_query; /* GL_SAMPLES_PASSED des benchmarks sphères */
 
 	float env_lod;
 	float debug_lod;
@@ -119,11 +288,12 @@ typedef struct {
 	float u_ao;
 	float u_exposure;
 	float auto_threshold;
-	float current_exposure;
+	GpuReadback readback; /* Relectures GPU -> CPU sans stall */
 
 #ifdef USE_SSBO_RENDERING
 	SSBOGroup ssbo_group;
 	Shader* pbr_ssbo_shader;
+	Shader* pbr_ssbo_compact_shader; /* Grille statique (MaterialTable) */
 #endif
 
 } App;
@@ -139,12 +309,28 @@ void app_run(App* app);
 void app_render(App* app);
 void app_update(App* app);
 void app_update_gpu_buffers(App* app);
+void app_use_sphere_mesh(App* app);
 #ifdef USE_SSBO_RENDERING
 void app_init_ssbo(App* app);
 #endif
 void app_render_ui(App* app);
 void app_init_instancing(App* app);
+void app_set_instance_count(App* app, int count);
+void app_generate_instances(App* app, const InstanceGenParams* params);
+/* count > 0 : instances animées (InstanceStream), 0 : retour au statique */
+void app_set_dynamic_instances(App* app, int count);
 void app_render_instanced(App* app, mat4 view, mat4 proj, vec3 camera_pos);
+#ifndef USE_SSBO_RENDERING
+void app_render_hybrid(App* app, mat4 view, mat4 proj, vec3 camera_pos);
+void app_render_deferred(App* app, mat4 view, mat4 proj, vec3 camera_pos);
+#endif
+void app_render_benchmark_start(App* app);
+void app_depth_benchmark_start(App* app);
+void app_deferred_benchmark_start(App* app);
+void app_set_light_count(App* app, int count);
+void app_light_benchmark_start(App* app);
+void app_tile_benchmark_start(App* app);
+void app_set_dynamic_resolution(App* app, int enabled);
 /* Input handling */
 void app_handle_input(App* app);
 
@@ -7,7 +7,7 @@
 
 enum {
 	MIN_SUBDIV = 0,
-	MAX_SUBDIV = 6,
+	MAX_SUBDIV = 8,
 	CUBEMAP_SIZE = 1024,
 	INITIAL_SUBDIVISIONS = 3
 };
@@ -55,6 +55,8 @@ static const int MAX_FPS_TEXT_LENGTH = 64;
 // Postprocess
 static const float DEFAULT_EXPOSURE_STEP = 0.1F;
 static const float DEFAULT_MIN_EXPOSURE = 0.1F;
+// Material edit (Alt + pavé numérique)
+static const float MATERIAL_ROUGHNESS_STEP = 0.05F;
 
 static const float DEFAULT_AUTO_THRESHOLD = 5.0F;
 
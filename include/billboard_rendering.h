@@ -3,17 +3,30 @@
 
 #include "gl_common.h"
 #include "instanced_rendering.h" /* For SphereInstance */
+#include "shader.h"
+#include <cglm/types.h>
 
 typedef struct {
 	GLuint vao;           // VAO dédié (Quad Geometry + Instances)
 	GLuint instance_vbo;  // Stockage des instances sur GPU
 	int instance_count;   // Nombre de sphères
+	InstanceFormat format;
+	InstanceStream* stream; // Emprunté : instances dynamiques (sinon NULL)
 } BillboardGroup;
 
 /* Alloue le buffer d'instances sur le GPU */
 void billboard_group_init(BillboardGroup* group, const SphereInstance* data,
                           int count);
 
+/* Variante compacte (shader pbr_ibl_billboard_compact.vert) */
+void billboard_group_init_compact(BillboardGroup* group,
+                                  const SphereInstanceCompact* data,
+                                  int count);
+
+/* Instances dynamiques (voir instanced_group_init_stream) */
+void billboard_group_init_stream(BillboardGroup* group, InstanceStream* stream,
+                                 InstanceFormat format, int count);
+
 /* Prépare le VAO en liant la geometrie Quad (passée en argument)
    avec le VBO d'instances interne */
 void billboard_group_prepare(BillboardGroup* group, GLuint quad_vbo);
@@ -23,4 +36,26 @@ void billboard_group_draw(BillboardGroup* group);
 
 void billboard_group_cleanup(BillboardGroup* group);
 
+/* Statistiques de fragments des imposteurs (benchmark uniquement) */
+typedef struct {
+	GLuint rasterized; /* Fragments générés par les quads */
+	GLuint covered;    /* Fragments touchant réellement la sphère */
+} BillboardFragmentStats;
+
+typedef struct {
+	Shader* shader; /* pbr_ibl_billboard.vert + billboard_stats.frag */
+	GLuint counter_ssbo;
+} BillboardStatsPass;
+
+int billboard_stats_init(BillboardStatsPass* pass);
+
+/* Redessine le groupe sans depth test ni écriture couleur et compte les
+ * fragments. legacy_bounds = 1 mesure l'ancien quad (3R, centré) comme
+ * référence. Bloquant (relecture du compteur). */
+void billboard_stats_measure(BillboardStatsPass* pass, BillboardGroup* group,
+                             mat4 view, mat4 proj, vec3 camera_pos,
+                             int legacy_bounds, BillboardFragmentStats* out);
+
+void billboard_stats_cleanup(BillboardStatsPass* pass);
+
 #endif
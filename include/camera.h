@@ -79,4 +79,8 @@ void camera_get_view_matrix(Camera* cam, mat4 view);
 void camera_process_scroll(Camera* cam, float yoffset);
 void camera_fixed_update(Camera* cam);
 
+/* Plans near/far d'une projection construite par glm_perspective */
+float camera_projection_near(mat4 proj);
+float camera_projection_far(mat4 proj);
+
 #endif
@@ -0,0 +1,68 @@
+#ifndef DEFERRED_H
+#define DEFERRED_H
+
+#include "gl_common.h"
+#include "postprocess.h"
+#include "shader.h"
+#include <cglm/types.h>
+#include <stddef.h>
+
+/* Unités de texture du G-buffer (0..2 : textures IBL) */
+enum {
+	DEFERRED_TEX_UNIT_ALBEDO_AO = 3,
+	DEFERRED_TEX_UNIT_NORMAL = 4,
+	DEFERRED_TEX_UNIT_MATERIAL = 5,
+	DEFERRED_TEX_UNIT_DEPTH = 6
+};
+
+/**
+ * Rendu différé des sphères mesh.
+ *
+ * La passe géométrie (shaders/gbuffer.frag) écrit un G-buffer compact de
+ * 10 octets par pixel :
+ *  - RGBA8 : albedo + AO
+ *  - RG16  : normale octaédrique
+ *  - RG8   : metallic + roughness (déjà clampée)
+ * La vélocité et la profondeur sont écrites directement dans les textures du
+ * PostProcess (velocity_tex, scene_depth_tex). Une passe plein écran
+ * (shaders/deferred_resolve.frag) évalue ensuite l'IBL une fois par pixel
+ * dans scene_color_tex, quel que soit l'overdraw.
+ */
+typedef struct {
+	GLuint gbuffer_fbo;
+	GLuint resolve_fbo; /* scene_color_tex seule (pas de boucle sur Z) */
+	GLuint albedo_ao_tex;
+	GLuint normal_tex;
+	GLuint material_tex;
+	GLuint depth_tex; /* Emprunté : scene_depth_tex */
+	GLuint scene_fbo; /* Emprunté : rebindé après la résolution */
+	GLuint empty_vao;
+	Shader* geometry_shader;         /* SphereInstance */
+	Shader* geometry_compact_shader; /* SphereInstanceCompact */
+	Shader* resolve_shader;
+	int width;
+	int height;
+} DeferredRenderer;
+
+/* Charge les shaders et crée le G-buffer aux dimensions du PostProcess.
+ * Retourne 0 si échec. */
+int deferred_init(DeferredRenderer* deferred, const PostProcess* post);
+
+/* Recrée les cibles après postprocess_resize (textures empruntées
+ * réallouées). Retourne 0 si le G-buffer est incomplet. */
+int deferred_resize(DeferredRenderer* deferred, const PostProcess* post);
+
+/* Lie le G-buffer : les sphères sont ensuite dessinées avec
+ * geometry_shader ou geometry_compact_shader */
+void deferred_begin_geometry(DeferredRenderer* deferred);
+
+/* Passe plein écran dans scene_color_tex (resolve_shader déjà lié avec les
+ * textures IBL et camPos), puis rebinde le framebuffer de la scène */
+void deferred_resolve(DeferredRenderer* deferred, mat4 view, mat4 proj);
+
+/* Octets par pixel du G-buffer propre (hors vélocité et profondeur) */
+size_t deferred_gbuffer_bytes_per_pixel(void);
+
+void deferred_cleanup(DeferredRenderer* deferred);
+
+#endif /* DEFERRED_H */
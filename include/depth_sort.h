@@ -0,0 +1,55 @@
+#ifndef DEPTH_SORT_H
+#define DEPTH_SORT_H
+
+#include "gl_common.h"
+#include "icosphere_cache.h"
+#include "instanced_rendering.h"
+#include "shader.h"
+#include <cglm/types.h>
+
+/* Bins de profondeur (répartition logarithmique entre near et far) */
+enum { DEPTH_SORT_BINS = 4096 };
+
+/**
+ * Tri GPU des instances par profondeur vue (front-to-back).
+ *
+ * Tri par comptage en 3 dispatchs de shaders/depth_sort.comp : chaque
+ * instance visible (frustum) reçoit un bin, les bins sont comptés, un
+ * préfixe donne les offsets, puis les instances sont recopiées dans l'ordre.
+ * Le nombre d'instances visibles va directement dans la commande indirecte,
+ * le CPU ne relit rien. L'ordre à l'intérieur d'un bin est arbitraire
+ * (atomiques), ce qui suffit pour l'early-Z.
+ */
+typedef struct {
+	InstancedGroup sorted;  /* VAO mesh + instances triées */
+	Shader* sort_shader;
+	GLuint source_buffer;   /* Emprunté : liste complète des instances */
+	GLintptr source_offset; /* Région lue (instances dynamiques) */
+	GLuint keys_buffer;     /* Bin de chaque instance (~0 : hors frustum) */
+	GLuint bins_buffer;     /* Compteurs puis offsets par bin */
+	GLuint command_buffer;  /* DrawElementsIndirectCommand */
+	int instance_count;
+} DepthSortGroup;
+
+/* Alloue le buffer trié (capacité = count) et charge le compute.
+ * source_buffer doit contenir count SphereInstance. Retourne 0 si échec. */
+int depth_sort_group_init(DepthSortGroup* group, GLuint source_buffer,
+                          int count);
+
+/* (Re)lie la géométrie icosphère au VAO trié */
+void depth_sort_group_bind_mesh(DepthSortGroup* group,
+                                const IcosphereMesh* mesh);
+
+/* Trie les instances visibles pour cette frame (3 dispatchs) */
+void depth_sort_group_sort(DepthSortGroup* group, mat4 view, mat4 proj,
+                           size_t index_count);
+
+/* Dessine les instances triées en indirect (shader déjà lié) */
+void depth_sort_group_draw(DepthSortGroup* group);
+
+/* Relit le nombre d'instances visibles (bloquant : tests / debug) */
+int depth_sort_group_read_count(DepthSortGroup* group);
+
+void depth_sort_group_cleanup(DepthSortGroup* group);
+
+#endif /* DEPTH_SORT_H */
@@ -0,0 +1,77 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include "gl_common.h"
+#include "perf_timer.h"
+
+/* Plus petit changement d'échelle appliqué (hystérésis) */
+#define DRS_SCALE_STEP 0.025F
+
+/* Timestamps posés à chaque frame */
+typedef enum {
+	DRS_STAMP_SCENE = 0, /* Début du rendu de la scène */
+	DRS_STAMP_POST,      /* Début du post-processing */
+	DRS_STAMP_END,       /* Fin du composite */
+	DRS_STAMP_COUNT
+} DrsStamp;
+
+/**
+ * Résolution dynamique pilotée par le temps GPU.
+ *
+ * Des GL_TIMESTAMP encadrent la scène et le post-processing ; ils sont relus
+ * GPU_TIMESTAMP_RING_FRAMES frames plus tard au plus, seulement si le
+ * résultat est déjà disponible. Un régulateur PI travaille sur la fraction
+ * de pixels (le coût de la scène est à peu près proportionnel à l'aire)
+ * avec une zone morte autour de la cible, et l'échelle appliquée ne change
+ * que par pas de DRS_SCALE_STEP au moins (hystérésis) pour ne pas faire
+ * pomper l'image.
+ */
+typedef struct {
+	GPUTimestampRing timestamps; /* DRS_STAMP_COUNT par frame */
+
+	float target_ms; /* Budget GPU scène + post */
+	float min_scale;
+	float max_scale;
+	float scale;    /* Échelle appliquée (par axe) */
+	float integral; /* Terme intégral, en fraction de pixels */
+
+	double scene_ms; /* Dernière mesure relue */
+	double post_ms;
+	int has_sample;
+} DynamicResolution;
+
+/* Pas de ressource GL ici : les requêtes sont créées au premier mark */
+void dynamic_resolution_init(DynamicResolution* drs, float target_ms,
+                             float min_scale, float max_scale);
+
+/* Change le budget ; l'état du régulateur est conservé */
+void dynamic_resolution_set_target(DynamicResolution* drs, float target_ms);
+
+/* Remet l'échelle au maximum et oublie l'historique */
+void dynamic_resolution_reset(DynamicResolution* drs);
+
+/* Pose un timestamp ; DRS_STAMP_SCENE ouvre une nouvelle frame */
+void dynamic_resolution_mark(DynamicResolution* drs, DrsStamp stamp);
+
+/**
+ * Relit sans bloquer les frames terminées puis fait un pas du régulateur
+ * avec la plus récente. Retourne l'échelle à utiliser pour cette frame.
+ */
+float dynamic_resolution_update(DynamicResolution* drs);
+
+/* Un pas du régulateur pour un temps GPU mesuré (sans GL, testable) */
+float dynamic_resolution_step(DynamicResolution* drs, double gpu_ms);
+
+/* Préfixe du marqueur de trace, relu par scripts/trace_analyze.py */
+#define DRS_TRACE_MARKER_PREFIX "render_scale="
+
+/**
+ * Insère dans le flux GL un marqueur "render_scale=0.750 960x540"
+ * (glDebugMessageInsert) : une capture apitrace garde l'échelle de chaque
+ * frame, DRS actif ou non. Appelé une fois par frame.
+ */
+void dynamic_resolution_trace_marker(float scale, int width, int height);
+
+void dynamic_resolution_cleanup(DynamicResolution* drs);
+
+#endif /* DYNAMIC_RESOLUTION_H */
@@ -0,0 +1,163 @@
+#ifndef FRAME_GRAPH_H
+#define FRAME_GRAPH_H
+
+#include "gl_common.h"
+#include "perf_timer.h"
+
+enum {
+	FRAME_GRAPH_MAX_PASSES = 16,
+	FRAME_GRAPH_MAX_RESOURCES = 24,
+	FRAME_GRAPH_MAX_USES = 12, /* Accès déclarés par passe */
+	FRAME_GRAPH_NO_TARGET = -1 /* Passe compute : aucun framebuffer */
+};
+
+typedef enum {
+	FRAME_GRAPH_TEXTURE = 0,
+	FRAME_GRAPH_BUFFER
+} FrameGraphResourceType;
+
+/* Manière dont une passe touche une ressource : fixe le bit de barrière
+ * attendu par le lecteur */
+typedef enum {
+	FRAME_GRAPH_SAMPLED = 0, /* sampler (texelFetch, texture) */
+	FRAME_GRAPH_IMAGE,       /* imageLoad / imageStore */
+	FRAME_GRAPH_STORAGE,     /* SSBO */
+	FRAME_GRAPH_UNIFORM,     /* UBO */
+	FRAME_GRAPH_INDIRECT,    /* glDispatchComputeIndirect / draw indirect */
+	FRAME_GRAPH_ATTACHMENT,  /* Attachement du framebuffer de la passe */
+	FRAME_GRAPH_TRANSFER     /* glBufferSubData, glTexSubImage, blit */
+} FrameGraphAccess;
+
+typedef struct {
+	const char* name; /* Chaîne statique */
+	FrameGraphResourceType type;
+	/* Lue hors du graphe (écran, frame suivante, relecture CPU) : ses
+	 * producteurs ne sont jamais éliminés */
+	int exported;
+} FrameGraphResource;
+
+typedef struct {
+	int resource;
+	FrameGraphAccess access;
+	int write;
+} FrameGraphUse;
+
+typedef void (*FrameGraphCallback)(void* user);
+
+typedef struct {
+	const char* name; /* Chaîne statique, aussi nom du groupe de debug */
+	FrameGraphCallback execute;
+	/* Optionnel : appelé à la compilation si la passe est éliminée (rend
+	 * ses cibles au pool) */
+	FrameGraphCallback culled;
+	void* user;
+	int enabled;
+	/* Framebuffer lié avec le viewport width x height avant la passe,
+	 * FRAME_GRAPH_NO_TARGET sinon */
+	GLint framebuffer;
+	int width;
+	int height;
+	FrameGraphUse uses[FRAME_GRAPH_MAX_USES];
+	int use_count;
+	int live; /* Résultat de la compilation */
+} FrameGraphPass;
+
+/* Passe retenue, dans l'ordre d'exécution */
+typedef struct {
+	int pass;
+	GLbitfield barriers; /* glMemoryBarrier avant la passe, 0 : aucune */
+	int bind_target;     /* Lie le framebuffer de la passe */
+
+	/* Timeline GPU relue (GL_TIMESTAMP) */
+	double start_ms; /* Depuis le début de la première passe */
+	double gpu_ms;
+	double gpu_ms_sum; /* Depuis le dernier rapport */
+	int gpu_samples;
+} FrameGraphStep;
+
+/**
+ * Graphe de passes déclaratif.
+ *
+ * Chaque passe déclare les ressources qu'elle lit et écrit, et comment
+ * (sampler, image, SSBO, UBO, indirect, attachement, transfert). La
+ * compilation, une fois par configuration :
+ * - élimine les passes désactivées et celles dont aucune écriture n'est
+ *   lue par une passe vivante ou une ressource exportée ;
+ * - ordonne les passes vivantes (tri topologique sur les dépendances
+ *   lecture/écriture dans l'ordre de déclaration) en préférant celles
+ *   qui ne changent pas de framebuffer, puis l'ordre de déclaration ;
+ * - place devant chaque passe les seuls bits de glMemoryBarrier qu'exige
+ *   une écriture incohérente (image, SSBO) encore non visible pour le
+ *   type d'accès du lecteur. Deux frames sont simulées : la seconde donne
+ *   le régime permanent, avec les dépendances d'une frame à l'autre.
+ *
+ * Les ressources écrites hors du graphe (scène rastérisée) sont importées
+ * sans écriture en attente. Les barrières internes à une passe (entre deux
+ * dispatchs d'un même effet) restent dans la passe.
+ *
+ * L'exécution pose un GL_TIMESTAMP avant chaque passe et un à la fin,
+ * relus GPU_TIMESTAMP_RING_FRAMES frames plus tard s'ils sont disponibles,
+ * et entoure chaque passe d'un groupe de debug à son nom.
+ */
+typedef struct {
+	FrameGraphResource resources[FRAME_GRAPH_MAX_RESOURCES];
+	int resource_count;
+	FrameGraphPass passes[FRAME_GRAPH_MAX_PASSES];
+	int pass_count;
+
+	/* Résultat de frame_graph_compile() */
+	FrameGraphStep steps[FRAME_GRAPH_MAX_PASSES];
+	int step_count;
+	int compiled;
+	int generation;      /* Compilations depuis l'init */
+	int barrier_count;   /* glMemoryBarrier par frame */
+	int target_switches; /* Changements de framebuffer par frame */
+
+	/* Un timestamp par étape + fin, tag : génération de la frame */
+	GPUTimestampRing timestamps;
+} FrameGraph;
+
+/* Pas de ressource GL ici : les requêtes sont créées à la première
+ * exécution */
+void frame_graph_init(FrameGraph* graph);
+
+/* Oublie passes et ressources (nouvelle configuration) ; les requêtes et
+ * la génération sont conservées */
+void frame_graph_reset(FrameGraph* graph);
+
+/* Déclare une ressource, retourne son indice (-1 : graphe plein) */
+int frame_graph_add_resource(FrameGraph* graph, const char* name,
+                             FrameGraphResourceType type, int exported);
+
+/* Déclare une passe active sans cible (`culled` optionnel), retourne son
+ * indice (-1 : graphe plein) */
+int frame_graph_add_pass(FrameGraph* graph, const char* name,
+                         FrameGraphCallback execute,
+                         FrameGraphCallback culled, void* user);
+
+/* Framebuffer et viewport liés avant la passe */
+void frame_graph_set_target(FrameGraph* graph, int pass, GLint framebuffer,
+                            int width, int height);
+
+/* Accès de la passe à une ressource (0 : liste pleine) */
+int frame_graph_read(FrameGraph* graph, int pass, int resource,
+                     FrameGraphAccess access);
+int frame_graph_write(FrameGraph* graph, int pass, int resource,
+                      FrameGraphAccess access);
+
+/* Élimination, ordre, barrières ; retourne le nombre de passes retenues */
+int frame_graph_compile(FrameGraph* graph);
+
+/* Exécute les passes retenues (compile si nécessaire) */
+void frame_graph_execute(FrameGraph* graph);
+
+/* Bits de barrière qu'attend un accès après une écriture incohérente */
+GLbitfield frame_graph_barrier_bits(FrameGraphAccess access,
+                                    FrameGraphResourceType type);
+
+/* Temps GPU moyen de chaque passe depuis le dernier rapport (log) */
+void frame_graph_report(FrameGraph* graph);
+
+void frame_graph_cleanup(FrameGraph* graph);
+
+#endif /* FRAME_GRAPH_H */
@@ -0,0 +1,88 @@
+#ifndef GPU_READBACK_H
+#define GPU_READBACK_H
+
+#include "gl_common.h"
+#include <stddef.h>
+
+enum {
+	GPU_READBACK_MAX_REQUESTS = 32, /* Requêtes en vol */
+	GPU_READBACK_DEFAULT_CAPACITY = 64 * 1024,
+	/* Offsets des copies : compatibles avec tout type de pixel */
+	GPU_READBACK_ALIGNMENT = 16
+};
+
+/* Appelé par gpu_readback_poll, `data` n'est valide que pendant l'appel */
+typedef void (*GpuReadbackCallback)(void* user, const void* data,
+                                    size_t size);
+
+typedef struct {
+	GpuReadbackCallback callback; /* NULL : copie dans `user` */
+	void* user;
+	size_t offset; /* Dans l'anneau */
+	size_t size;
+	size_t span; /* size aligné + octets sautés au bouclage */
+	GLsync fence;
+	unsigned long long frame; /* Frame de la demande */
+} GpuReadbackRequest;
+
+/**
+ * Relectures GPU -> CPU sans point de synchronisation.
+ *
+ * Une demande copie une région de buffer ou une texture dans un anneau
+ * glBufferStorage persistant (lecture, cohérent), suivie d'un fence. Le
+ * résultat est livré par gpu_readback_poll(), une fois par frame, dès que
+ * le fence est passé (au plus tôt à la frame suivante) : jamais d'attente
+ * CPU. Les livraisons suivent l'ordre des demandes. Anneau ou file pleins :
+ * la demande est refusée (ticket 0), l'appelant garde sa dernière valeur.
+ *
+ * Deux façons de récupérer le résultat : un callback, ou (callback NULL)
+ * une copie dans `user` suivie d'un test du ticket par gpu_readback_done().
+ */
+typedef struct {
+	GLuint buffer;
+	unsigned char* mapped;
+	size_t capacity;
+	size_t head; /* Prochain octet libre */
+	size_t used; /* Octets en vol (spans) */
+
+	GpuReadbackRequest requests[GPU_READBACK_MAX_REQUESTS];
+	int first; /* Plus ancienne requête en vol */
+	int count;
+
+	unsigned long long frame;
+	unsigned long long next_ticket;      /* Prochain ticket attribué */
+	unsigned long long delivered_ticket; /* Dernier ticket livré */
+	int dropped;      /* Demandes refusées (anneau plein) */
+	int last_latency; /* Frames entre demande et livraison */
+} GpuReadback;
+
+int gpu_readback_init(GpuReadback* readback, size_t capacity);
+
+/* Copie [offset, offset + size) de `buffer`. Retourne un ticket (> 0) ou
+ * 0 si la demande est refusée. */
+unsigned long long gpu_readback_buffer(GpuReadback* readback, GLuint buffer,
+                                       GLintptr offset, size_t size,
+                                       GpuReadbackCallback callback,
+                                       void* user);
+
+/* Copie le niveau `level` d'une texture 2D (glGetTexImage, `size` octets
+ * attendus pour format/type). */
+unsigned long long gpu_readback_texture(GpuReadback* readback, GLuint texture,
+                                        GLint level, GLenum format,
+                                        GLenum type, size_t size,
+                                        GpuReadbackCallback callback,
+                                        void* user);
+
+/* Début de frame : livre les requêtes terminées, sans bloquer */
+void gpu_readback_poll(GpuReadback* readback);
+
+/* 1 si la demande `ticket` a été livrée */
+int gpu_readback_done(const GpuReadback* readback, unsigned long long ticket);
+
+/* Attend et livre tout ce qui est en vol (tests, fin de programme) */
+void gpu_readback_flush(GpuReadback* readback);
+
+/* Abandonne les requêtes en vol sans les livrer */
+void gpu_readback_cleanup(GpuReadback* readback);
+
+#endif /* GPU_READBACK_H */
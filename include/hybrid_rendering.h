@@ -0,0 +1,83 @@
+#ifndef HYBRID_RENDERING_H
+#define HYBRID_RENDERING_H
+
+#include "billboard_rendering.h"
+#include "gl_common.h"
+#include "icosphere_cache.h"
+#include "instanced_rendering.h"
+#include "shader.h"
+#include <cglm/types.h>
+
+/* Projected radius (pixels) above which a sphere is drawn with the mesh */
+#define HYBRID_DEFAULT_MESH_THRESHOLD_PX 48.0F
+
+/* Layout imposé par glDrawElementsIndirect */
+typedef struct {
+	GLuint count;
+	GLuint instance_count;
+	GLuint first_index;
+	GLint base_vertex;
+	GLuint base_instance;
+} DrawElementsIndirectCommand;
+
+/* Layout imposé par glDrawArraysIndirect */
+typedef struct {
+	GLuint count;
+	GLuint instance_count;
+	GLuint first;
+	GLuint base_instance;
+} DrawArraysIndirectCommand;
+
+/* Contenu du buffer indirect (miroir du bloc DrawCommands du compute) */
+typedef struct {
+	DrawElementsIndirectCommand mesh;
+	DrawArraysIndirectCommand impostor;
+} HybridDrawCommands;
+
+/**
+ * Rendu hybride mesh / imposteur.
+ *
+ * Une passe compute (shaders/hybrid_classify.comp) lit toutes les instances,
+ * élimine celles hors frustum puis range chacune dans le bucket "mesh"
+ * (sphères proches/grandes à l'écran) ou "impostor" (sphères lointaines,
+ * ray-tracées sur un quad). Les deux buckets sont dessinés en indirect, le CPU
+ * ne connaît jamais la répartition.
+ */
+typedef struct {
+	InstancedGroup mesh;     /* VAO mesh + instances compactées (mesh) */
+	BillboardGroup impostor; /* VAO quad + instances compactées (impostor) */
+	Shader* classify_shader;
+	GLuint source_buffer; /* Emprunté : liste complète des instances */
+	GLintptr source_offset; /* Région lue (instances dynamiques) */
+	GLuint command_buffer;
+	int instance_count;
+	float mesh_threshold_px;
+} HybridGroup;
+
+/* Alloue les buckets (capacité = count) et charge le compute de tri.
+ * source_buffer doit contenir count SphereInstance. Retourne 0 si échec. */
+int hybrid_group_init(HybridGroup* group, GLuint source_buffer, int count);
+
+/* (Re)lie la géométrie icosphère au bucket mesh */
+void hybrid_group_bind_mesh(HybridGroup* group, const IcosphereMesh* mesh);
+
+/* (Re)lie le quad au bucket impostor */
+void hybrid_group_prepare_impostor(HybridGroup* group, GLuint quad_vbo);
+
+/* Remplit les deux buckets et les commandes indirectes pour cette frame */
+void hybrid_group_classify(HybridGroup* group, mat4 view, mat4 proj,
+                           int viewport_height, size_t index_count);
+
+/* Dessine le bucket mesh (shader mesh déjà lié) */
+void hybrid_group_draw_mesh(HybridGroup* group);
+
+/* Dessine le bucket impostor (shader billboard déjà lié) */
+void hybrid_group_draw_impostors(HybridGroup* group);
+
+/* Relit la répartition (bloquant : debug / benchmark uniquement) */
+void hybrid_group_read_counts(HybridGroup* group, int* mesh_count,
+                              int* impostor_count);
+
+void hybrid_group_cleanup(HybridGroup* group);
+
+#endif /* HYBRID_RENDERING_H */
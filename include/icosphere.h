@@ -1,8 +1,11 @@
 #ifndef ICOSPHERE_H
 #define ICOSPHERE_H
 
+#include "job_system.h"
+#include "mesh_optimize.h"
 #include <cglm/cglm.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /* Dynamic array for vec3 */
 typedef struct {
@@ -34,9 +37,61 @@ void uintarray_init(UintArray* array);
 void uintarray_push(UintArray* array, unsigned int value);
 void uintarray_free(UintArray* array);
 
+/* Bornes des niveaux de subdivision supportés */
+#define ICOSPHERE_MAX_SUBDIVISIONS 8
+
+/* Tailles exactes au niveau n : 10 * 4^n + 2 sommets, 20 * 4^n faces */
+size_t icosphere_vertex_count(int subdivisions);
+size_t icosphere_index_count(int subdivisions);
+
 /* Icosphere operations */
 void icosphere_init(IcosphereGeometry* geom);
+
+/* Dimensionne les tableaux pour le niveau demandé (plus aucun realloc
+ * pendant icosphere_generate). Retourne 0 si l'allocation échoue. */
+int icosphere_reserve(IcosphereGeometry* geom, int subdivisions);
+
 void icosphere_generate(IcosphereGeometry* geom, int subdivisions);
+
+/* Même résultat (bit à bit) que icosphere_generate, les faces de chaque
+ * niveau étant réparties sur le job system (jobs == NULL : séquentiel) */
+void icosphere_generate_parallel(IcosphereGeometry* geom, int subdivisions,
+                                 JobSystem* jobs);
 void icosphere_free(IcosphereGeometry* geom);
 
+/**
+ * Réordonne les triangles pour le cache post-transform (Forsyth) puis
+ * renumérote sommets et normales dans l'ordre de première utilisation.
+ * Forme et triangles inchangés ; before/after (optionnels) reçoivent les
+ * ACMR/ATVR mesurés. Retourne 0 si l'allocation échoue (géométrie
+ * intacte).
+ */
+int icosphere_optimize(IcosphereGeometry* geom, MeshCacheStats* before,
+                       MeshCacheStats* after);
+
+/*
+ * Flux sommets GPU : positions seules. Sur la sphère unité la normale est
+ * la position, les shaders la recalculent (plus de flux de normales).
+ */
+typedef enum {
+	ICOSPHERE_POSITION_FLOAT = 0, /* vec3 float, 12 octets */
+	ICOSPHERE_POSITION_SNORM16,   /* 3 x snorm16 + padding, 8 octets */
+	ICOSPHERE_POSITION_FORMAT_COUNT
+} IcospherePositionFormat;
+
+/* Taille d'un sommet dans le flux */
+size_t icosphere_position_stride(IcospherePositionFormat format);
+
+/* Écrit les vertices.size positions au format demandé (out : stride *
+ * vertices.size octets) */
+void icosphere_pack_positions(const IcosphereGeometry* geom,
+                              IcospherePositionFormat format, void* out);
+
+/* Indices 16 bits possibles jusqu'au niveau 6 (40962 sommets) */
+int icosphere_fits_short_indices(size_t vertex_count);
+
+/* Copie les indices en 16 bits (icosphere_fits_short_indices requis) */
+void icosphere_pack_short_indices(const IcosphereGeometry* geom,
+                                  uint16_t* out);
+
 #endif /* ICOSPHERE_H */
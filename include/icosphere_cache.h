@@ -0,0 +1,88 @@
+#ifndef ICOSPHERE_CACHE_H
+#define ICOSPHERE_CACHE_H
+
+#include "gl_common.h"
+#include "icosphere.h"
+#include "job_system.h"
+#include "mesh_optimize.h"
+#include <stddef.h>
+
+enum { ICOSPHERE_CACHE_LEVELS = ICOSPHERE_MAX_SUBDIVISIONS + 1 };
+
+/* Buffers GPU d'un niveau (immutables une fois téléversés) */
+typedef struct {
+	GLuint vbo; /* Positions seules (normale = position) */
+	GLuint ebo;
+	size_t vertex_count;
+	size_t index_count;
+	IcospherePositionFormat position_format;
+	GLenum index_type; /* GL_UNSIGNED_SHORT si <= 65536 sommets */
+} IcosphereMesh;
+
+/* Octets lus par le vertex fetch pour dessiner une instance du maillage */
+size_t icosphere_mesh_vertex_bytes(const IcosphereMesh* mesh);
+size_t icosphere_mesh_index_bytes(const IcosphereMesh* mesh);
+
+/* Attribut 0 (position) et buffer d'indices du VAO actuellement lié ;
+ * l'attribut 1 (ancien flux de normales) est désactivé */
+void icosphere_mesh_setup_vao(const IcosphereMesh* mesh);
+
+/**
+ * Icosphères par niveau de subdivision, générées hors du thread de rendu.
+ * Chaque niveau est optimisé pour le cache post-transform avant
+ * téléversement (icosphere_optimize).
+ *
+ * Un niveau demandé est généré par un job (JobSystem) dans `pending`, puis
+ * téléversé dans des buffers neufs au poll suivant sa fin. Le niveau
+ * affiché reste utilisable jusqu'à l'échange : aucune frame ne dessine un
+ * maillage incomplet. Les niveaux déjà générés restent en VRAM, revenir à
+ * un niveau connu est immédiat.
+ */
+typedef struct {
+	/* Emprunté ; NULL ou aucun worker : génération synchrone */
+	JobSystem* jobs;
+	IcosphereMesh levels[ICOSPHERE_CACHE_LEVELS];
+	IcospherePositionFormat format; /* Format des téléversements */
+	int current; /* Niveau affiché (-1 : aucun) */
+	int wanted;  /* Dernier niveau demandé */
+
+	/* Génération en cours (un job à la fois) */
+	IcosphereGeometry pending;
+	int pending_level; /* -1 : aucune */
+	JobCounter counter;
+	double pending_ms; /* Durée mesurée sur le worker */
+	MeshCacheStats pending_before; /* Cache post-transform avant/après */
+	MeshCacheStats pending_after;  /* optimisation */
+} IcosphereCache;
+
+void icosphere_cache_init(IcosphereCache* cache, JobSystem* jobs);
+
+/* Demande un niveau ; renvoie 1 si le maillage courant a changé. À appeler
+ * à chaque frame (le poll téléverse les générations terminées). */
+int icosphere_cache_request(IcosphereCache* cache, int level);
+
+/* Génère et téléverse immédiatement (démarrage) ; renvoie 1 si le niveau
+ * est devenu courant */
+int icosphere_cache_load(IcosphereCache* cache, int level);
+
+/* Téléverse une géométrie déjà générée comme niveau `level` et la rend
+ * courante (remplace un niveau existant) */
+int icosphere_cache_store(IcosphereCache* cache, int level,
+                          const IcosphereGeometry* geom);
+
+/* Change le format des positions : les niveaux en VRAM sont libérés et le
+ * niveau affiché est régénéré tout de suite. Renvoie 1 si le maillage
+ * courant a changé. */
+int icosphere_cache_set_format(IcosphereCache* cache,
+                               IcospherePositionFormat format);
+
+/* Maillage affiché, NULL tant qu'aucun niveau n'est prêt */
+const IcosphereMesh* icosphere_cache_current(const IcosphereCache* cache);
+
+/* 1 si un job de génération est en cours */
+int icosphere_cache_busy(const IcosphereCache* cache);
+
+/* Attend le job éventuel puis libère tous les buffers */
+void icosphere_cache_cleanup(IcosphereCache* cache);
+
+#endif /* ICOSPHERE_CACHE_H */
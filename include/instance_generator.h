@@ -0,0 +1,53 @@
+#ifndef INSTANCE_GENERATOR_H
+#define INSTANCE_GENERATOR_H
+
+#include "gl_common.h"
+#include "instanced_rendering.h"
+#include "material.h"
+#include "shader.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/* Disposition des instances générées */
+typedef enum {
+	INSTANCE_LAYOUT_GRID = 0, /* Grille régulière centrée (plan XY) */
+	INSTANCE_LAYOUT_POISSON,  /* Grille jittérée : distance min garantie */
+	INSTANCE_LAYOUT_COUNT
+} InstanceLayout;
+
+/* Description compacte d'une scène : le GPU en déduit chaque instance */
+typedef struct {
+	InstanceLayout layout;
+	int count;
+	float spacing;      /* Distance entre centres de cellules */
+	float radius;       /* Rayon des sphères (échelle du modèle) */
+	int material_index; /* -1 : cycle sur toute la bibliothèque */
+	uint32_t seed;      /* Graine du jitter (INSTANCE_LAYOUT_POISSON) */
+	InstanceFormat format; /* SphereInstance ou SphereInstanceCompact */
+} InstanceGenParams;
+
+/**
+ * Génération procédurale d'instances sur GPU (shaders/instance_generate.comp).
+ * Écrit directement les instances (format complet ou compact) dans un buffer
+ * existant, sans tableau CPU intermédiaire. Les matériaux sont lus dans la
+ * MaterialTable.
+ */
+typedef struct {
+	Shader* shader;
+} InstanceGenerator;
+
+int instance_generator_init(InstanceGenerator* gen);
+
+/* Remplit dest_buffer[0 .. params->count[ ; le buffer doit être assez grand
+ * (instance_format_stride(params->format) octets par instance) */
+void instance_generator_run(InstanceGenerator* gen,
+                            const InstanceGenParams* params,
+                            const MaterialTable* materials,
+                            GLuint dest_buffer);
+
+/* Nombre de colonnes utilisé pour une grille de `count` instances */
+int instance_generator_columns(int count);
+
+void instance_generator_cleanup(InstanceGenerator* gen);
+
+#endif /* INSTANCE_GENERATOR_H */
@@ -0,0 +1,71 @@
+#ifndef INSTANCE_SIM_H
+#define INSTANCE_SIM_H
+
+#include "job_system.h"
+#include "material.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/* Instances par itération des kernels (AVX : 8, SSE2 : 4, scalaire : 1) */
+#if defined(__AVX__)
+#define INSTANCE_SIM_LANES 8
+#elif defined(__SSE2__)
+#define INSTANCE_SIM_LANES 4
+#else
+#define INSTANCE_SIM_LANES 1
+#endif
+
+/* Tranche de travail d'un thread (multiple de INSTANCE_SIM_LANES) */
+enum { INSTANCE_SIM_CHUNK = 4096 };
+
+/* Une ligne de matériau = les 2 derniers vec4 utiles d'une instance :
+ * (albedo, metallic), (roughness, ao, 0, 0) */
+enum { INSTANCE_SIM_MATERIAL_FLOATS = 8 };
+
+/**
+ * Simulation d'instances en structure de tableaux (SoA).
+ * Chaque tableau est aligné sur SIMD_ALIGNMENT et rembourré à un multiple
+ * de INSTANCE_SIM_LANES. Les sphères rebondissent dans une boîte ; chaque
+ * rebond passe au matériau suivant.
+ */
+typedef struct {
+	float* pos_x;
+	float* pos_y;
+	float* pos_z;
+	float* vel_x;
+	float* vel_y;
+	float* vel_z;
+	float* scale;
+	uint32_t* material;
+	float* material_rows; /* material_count * INSTANCE_SIM_MATERIAL_FLOATS */
+	int material_count;
+	int count;
+	float bounds_min[3];
+	float bounds_max[3];
+} InstanceSim;
+
+/* Grille centrée (même disposition que la scène par défaut), vitesses
+ * pseudo-aléatoires reproductibles (seed) */
+int instance_sim_init(InstanceSim* sim, const MaterialLib* lib, int count,
+                      float spacing, float radius, uint32_t seed);
+
+/* Intègre [begin, end[ (kernel SIMD) */
+void instance_sim_step(InstanceSim* sim, int begin, int end, float dt);
+
+/* Écrit [begin, end[ au format SphereInstance / SphereInstanceSSBO
+ * (mat4 + 2 vec4 matériau, `stride` octets par instance). Stores
+ * non-temporels : destination idéale = buffer mappé write-combined. */
+void instance_sim_write(const InstanceSim* sim, void* out, size_t stride,
+                        int begin, int end);
+
+/* step + write fusionnés, une tranche INSTANCE_SIM_CHUNK par job
+ * (jobs NULL : mono-thread) */
+void instance_sim_update(InstanceSim* sim, JobSystem* jobs, float dt,
+                         void* out, size_t stride);
+
+/* "AVX", "SSE2" ou "scalar" */
+const char* instance_sim_simd_name(void);
+
+void instance_sim_cleanup(InstanceSim* sim);
+
+#endif /* INSTANCE_SIM_H */
@@ -0,0 +1,46 @@
+#ifndef INSTANCE_STREAM_H
+#define INSTANCE_STREAM_H
+
+#include "gl_common.h"
+#include <stddef.h>
+
+/* CPU écrit la frame N+2 pendant que le GPU lit la frame N */
+enum { INSTANCE_STREAM_FRAMES = 3 };
+
+/**
+ * Buffer d'instances dynamique : glBufferStorage persistant + cohérent,
+ * découpé en INSTANCE_STREAM_FRAMES régions protégées chacune par un fence.
+ *
+ * Chaque frame : instance_stream_next() renvoie la région à remplir, puis
+ * les draws lisent cette même région (base instance pour les VBO,
+ * glBindBufferRange pour les SSBO). Le fence de la région est posé au
+ * next() suivant, donc après tous les draws de la frame.
+ */
+typedef struct {
+	GLuint buffer;
+	unsigned char* mapped; /* Pointeur persistant (toutes les régions) */
+	size_t stride;         /* Taille d'une instance */
+	int capacity;          /* Instances par région (>= demandé, aligné) */
+	size_t region_size;    /* capacity * stride */
+	GLsync fences[INSTANCE_STREAM_FRAMES];
+	int region;            /* Région courante, -1 avant le 1er next() */
+	double last_wait_ms;   /* Attente CPU du dernier next() (stall GPU) */
+} InstanceStream;
+
+/* Alloue 3 régions d'au moins `count` instances de `stride` octets.
+ * Les régions respectent GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT. */
+int instance_stream_init(InstanceStream* stream, size_t stride, int count);
+
+/* Pose le fence de la région précédente, attend que la suivante soit libre
+ * et renvoie son pointeur d'écriture (capacity instances). */
+void* instance_stream_next(InstanceStream* stream);
+
+/* Première instance de la région courante (draw *BaseInstance) */
+GLuint instance_stream_base_instance(const InstanceStream* stream);
+
+/* Offset en octets de la région courante (glBindBufferRange) */
+GLintptr instance_stream_offset(const InstanceStream* stream);
+
+void instance_stream_cleanup(InstanceStream* stream);
+
+#endif /* INSTANCE_STREAM_H */
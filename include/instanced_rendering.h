@@ -2,7 +2,11 @@
 #define INSTANCED_RENDERING_H
 
 #include "gl_common.h"
+#include "icosphere_cache.h"
+#include "instance_stream.h"
 #include <cglm/cglm.h>
+#include <stddef.h>
+#include <stdint.h>
 
 typedef struct {
 	mat4 model;
@@ -13,20 +17,60 @@ typedef struct {
 	float padding;
 } __attribute__((aligned(SIMD_ALIGNMENT))) SphereInstance;
 
+/**
+ * Instance compacte (16 bytes, 8x moins que SphereInstance) :
+ * position + rayon uniforme, le matériau est lu dans la MaterialTable.
+ * scale_material = half(scale) << 16 | material_index (16 bits).
+ */
+typedef struct {
+	vec3 position;
+	uint32_t scale_material;
+} SphereInstanceCompact;
+
+#define SPHERE_INSTANCE_MAX_MATERIALS 65536
+
+typedef enum {
+	INSTANCE_FORMAT_FULL = 0, /* SphereInstance (matrice + matériau) */
+	INSTANCE_FORMAT_COMPACT   /* SphereInstanceCompact + MaterialTable */
+} InstanceFormat;
+
 typedef struct {
 	GLuint vao;           // VAO dédié (Mesh + Instances)
 	GLuint instance_vbo;  // Stockage des instances sur GPU
 	int instance_count;   // Nombre de sphères
+	InstanceFormat format;
+	InstanceStream* stream; // Emprunté : instances dynamiques (sinon NULL)
+	GLenum index_type;      // Type des indices du maillage lié
 } InstancedGroup;
 
+void sphere_instance_compact_pack(SphereInstanceCompact* out,
+                                  const vec3 position, float scale,
+                                  uint32_t material_index);
+
+/* Taille d'une instance sur GPU pour un format donné */
+size_t instance_format_stride(InstanceFormat format);
+
 /* Alloue le buffer d'instances sur le GPU */
 void instanced_group_init(InstancedGroup* group, const SphereInstance* data,
                           int count);
 
+/* Variante compacte : data peut être NULL (rempli ensuite par le GPU) */
+void instanced_group_init_compact(InstancedGroup* group,
+                                  const SphereInstanceCompact* data,
+                                  int count);
+
+/* Instances dynamiques : le VBO est le buffer persistant du stream, chaque
+ * draw lit la région courante via la base instance */
+void instanced_group_init_stream(InstancedGroup* group, InstanceStream* stream,
+                                 InstanceFormat format, int count);
+
+/* Attributs d'instance (locations 2..7) du VBO actuellement lié */
+void instanced_setup_attributes(InstanceFormat format);
+
 /* Lie le groupe aux buffers de quand l'icosphere
  * change) */
-void instanced_group_bind_mesh(InstancedGroup* group, GLuint vbo, GLuint nbo,
-                               GLuint ebo);
+void instanced_group_bind_mesh(InstancedGroup* group,
+                               const IcosphereMesh* mesh);
 
 void instanced_group_bind_billboard(InstancedGroup* group, GLuint vbo);
 
@@ -0,0 +1,142 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <pthread.h>
+
+enum {
+	JOB_SYSTEM_MAX_WORKERS = 64,
+	JOB_DEQUE_CAPACITY = 1024 /* Puissance de 2, par thread et priorité */
+};
+
+/* Ordre de service : toutes les files HIGH (locales, injectées, volées)
+ * passent avant la moindre file NORMAL, etc. */
+typedef enum {
+	JOB_PRIORITY_HIGH = 0,
+	JOB_PRIORITY_NORMAL,
+	JOB_PRIORITY_LOW,
+	JOB_PRIORITY_COUNT
+} JobPriority;
+
+typedef void (*JobFn)(void* user_data);
+
+/* Traite les indices [begin, end[ */
+typedef void (*JobRangeFn)(void* user_data, int begin, int end);
+
+/**
+ * Compteur fork/join : incrémenté à la soumission, décrémenté à la fin de
+ * chaque job. job_system_wait() rend la main quand il retombe à zéro.
+ * Initialiser à {0} ; un compteur peut être partagé par plusieurs jobs.
+ */
+typedef struct {
+	int pending;
+} JobCounter;
+
+typedef struct {
+	JobFn fn;
+	JobRangeFn range_fn; /* Job de parallel-for (découpé à la volée) */
+	void* user_data;
+	int begin;
+	int end;
+	int grain;
+	JobPriority priority;
+	JobCounter* counter;
+} Job;
+
+/**
+ * Deque Chase-Lev à capacité fixe : le propriétaire empile et dépile en bas
+ * (LIFO, cache chaud), les voleurs prennent en haut (FIFO, gros morceaux).
+ */
+typedef struct {
+	long top;
+	char _pad0[64 - sizeof(long)]; /* top et bottom sur 2 lignes de cache */
+	long bottom;
+	char _pad1[64 - sizeof(long)];
+	Job jobs[JOB_DEQUE_CAPACITY];
+} JobDeque;
+
+/* File protégée par JobSystem.inject_mutex (tableau extensible, LIFO) */
+typedef struct {
+	Job* jobs;
+	int count;
+	int capacity;
+} JobQueue;
+
+struct JobSystem;
+
+typedef struct {
+	struct JobSystem* system;
+	int index; /* 0 = thread créateur, 1..worker_count = workers */
+	unsigned rng; /* Choix de la victime du vol */
+	JobDeque deques[JOB_PRIORITY_COUNT];
+	/* Statistiques (relâchées, indicatives) */
+	long executed;
+	long stolen;
+} JobWorker;
+
+typedef struct JobSystem {
+	JobWorker* workers; /* slot_count (slot 0 : thread créateur) */
+	int slot_count;     /* Fixé avant le démarrage des workers */
+	pthread_t threads[JOB_SYSTEM_MAX_WORKERS];
+	int worker_count; /* Threads effectivement créés */
+
+	/* Soumissions depuis un thread extérieur (loader, etc.) */
+	pthread_mutex_t inject_mutex;
+	JobQueue injected[JOB_PRIORITY_COUNT];
+	int has_injected; /* Lecture atomique sans verrou */
+	/* Jobs longs servis par les workers seuls (jamais par un wait) */
+	JobQueue background[JOB_PRIORITY_COUNT];
+	int has_background;
+
+	/* Endormissement des workers inactifs */
+	pthread_mutex_t sleep_mutex;
+	pthread_cond_t sleep_cond;
+	unsigned work_epoch; /* Incrémenté à chaque soumission */
+	int sleepers;
+	int shutdown;
+} JobSystem;
+
+/* Nombre de coeurs logiques disponibles (>= 1) */
+int job_system_cpu_count(void);
+
+/* worker_count < 0 : un worker par coeur, moins le thread appelant.
+ * Le thread appelant devient le propriétaire du slot 0 s'il ne possède pas
+ * encore de slot (il exécute des jobs pendant job_system_wait).
+ * Retourne NULL en cas d'échec. */
+JobSystem* job_system_create(int worker_count);
+
+/* Attend la fin de tous les workers ; les jobs en file sont abandonnés */
+void job_system_destroy(JobSystem* system);
+
+/* Soumission depuis n'importe quel thread ; counter peut être NULL */
+void job_system_submit(JobSystem* system, JobFn fn, void* user_data,
+                       JobPriority priority, JobCounter* counter);
+
+/* Comme job_system_submit, mais seul un worker exécutera le job : un
+ * job_system_wait() (thread de rendu compris) ne le prend jamais, même
+ * soumis depuis ce thread. Sans worker, exécuté sur place. */
+void job_system_submit_background(JobSystem* system, JobFn fn,
+                                  void* user_data, JobPriority priority,
+                                  JobCounter* counter);
+
+/* Bloque jusqu'à counter == 0, en exécutant des jobs en attendant */
+void job_system_wait(JobSystem* system, JobCounter* counter);
+
+/* Exécute fn sur [0, count[ par tranches d'au plus `grain` indices.
+ * Découpage binaire paresseux : les moitiés droites sont volées par les
+ * workers libres. Bloquant. */
+void job_system_parallel_for(JobSystem* system, int count, int grain,
+                             JobRangeFn fn, void* user_data,
+                             JobPriority priority);
+
+/* Threads exécutant des jobs (workers + thread créateur) */
+int job_system_thread_count(const JobSystem* system);
+
+/* Cumul depuis la création, tous threads du système (indicatif) */
+typedef struct {
+	long executed; /* Jobs terminés */
+	long stolen;   /* Jobs pris dans la deque d'un autre thread */
+} JobSystemStats;
+
+void job_system_stats(const JobSystem* system, JobSystemStats* stats);
+
+#endif /* JOB_SYSTEM_H */
@@ -0,0 +1,88 @@
+#ifndef LIGHT_CLUSTERS_H
+#define LIGHT_CLUSTERS_H
+
+#include "gl_common.h"
+#include "shader.h"
+#include <cglm/types.h>
+#include <stdint.h>
+
+/* Grille de clusters (doit correspondre à shaders/light_cull.comp et
+ * pbr_functions.glsl) : tuiles écran x tranches de profondeur logarithmiques */
+enum {
+	LIGHT_CLUSTER_X = 16,
+	LIGHT_CLUSTER_Y = 9,
+	LIGHT_CLUSTER_Z = 24,
+	LIGHT_CLUSTER_COUNT =
+	    LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y * LIGHT_CLUSTER_Z,
+	LIGHT_MAX_PER_CLUSTER = 256,
+	/* Indices partagés par tous les clusters (128 en moyenne) */
+	LIGHT_INDEX_CAPACITY = LIGHT_CLUSTER_COUNT * 128
+};
+
+/* SSBO réservés aux lumières (0-4 : computes, 5 : matériaux) */
+enum { LIGHT_BINDING_LIGHTS = 6, LIGHT_BINDING_CLUSTERS = 7 };
+
+/* Valeur de direction_cos_outer[3] marquant une lumière ponctuelle */
+#define LIGHT_POINT_COS_OUTER (-2.0F)
+
+/* Miroir std430 de AnalyticLight (48 octets) */
+typedef struct {
+	vec4 position_range;      /* xyz : position monde, w : portée */
+	vec4 color_cos_inner;     /* rgb : couleur x intensité, w : cos int. */
+	vec4 direction_cos_outer; /* xyz : axe du spot, w : cos ext. */
+} AnalyticLight;
+
+/**
+ * Forward+ clusterisé pour des milliers de lumières analytiques.
+ *
+ * Un compute (shaders/light_cull.comp, un workgroup par cluster) teste la
+ * sphère d'influence de chaque lumière contre l'AABB vue du cluster et écrit
+ * une liste d'indices compacte. Les fragment shaders PBR ne parcourent que
+ * la liste du cluster qui les contient, le coût par pixel ne dépend plus du
+ * nombre total de lumières.
+ */
+typedef struct {
+	Shader* cull_shader;
+	GLuint light_buffer;   /* AnalyticLight[light_capacity] */
+	GLuint cluster_buffer; /* Compteur, plages par cluster, indices */
+	int light_count;
+	int light_capacity;
+	int viewport_width; /* Grille calculée pour ce viewport */
+	int viewport_height;
+	float near_plane;
+	float far_plane;
+} LightClusters;
+
+int light_clusters_init(LightClusters* clusters);
+
+/* Remplace les lumières (le buffer grandit si besoin). count = 0 désactive
+ * l'éclairage analytique. */
+void light_clusters_upload(LightClusters* clusters,
+                           const AnalyticLight* lights, int count);
+
+/**
+ * Lumières pseudo-aléatoires reproductibles dans [bounds_min, bounds_max] :
+ * une sur quatre est un spot orienté vers -Z. La portée diminue avec la
+ * densité pour que chaque point reste éclairé par quelques dizaines de
+ * lumières au plus.
+ */
+void light_clusters_generate(AnalyticLight* lights, int count,
+                             const vec3 bounds_min, const vec3 bounds_max,
+                             uint32_t seed);
+
+/* Tranche logarithmique contenant une profondeur vue (miroir du GLSL) */
+int light_clusters_slice(float view_depth, float near_plane, float far_plane);
+
+/* Reconstruit les listes de lumières pour cette frame */
+void light_clusters_cull(LightClusters* clusters, mat4 view, mat4 proj,
+                         int width, int height);
+
+/* Lie les SSBO et les uniforms de lookup (shader PBR déjà utilisé) */
+void light_clusters_bind(const LightClusters* clusters, Shader* shader);
+
+/* Nombre d'indices écrits par le dernier cull (bloquant : tests / debug) */
+int light_clusters_read_index_count(LightClusters* clusters);
+
+void light_clusters_cleanup(LightClusters* clusters);
+
+#endif /* LIGHT_CLUSTERS_H */
@@ -22,4 +22,38 @@ typedef struct {
 MaterialLib* material_load_presets(const char* path);
 void material_free_lib(MaterialLib* lib);
 
+/* Point de binding SSBO de la table (voir shaders/material_table.glsl) */
+#define MATERIAL_TABLE_BINDING 5
+
+/**
+ * Copie GPU de la bibliothèque : 2 vec4 par matériau,
+ * (albedo, metallic) puis (roughness, ao, 0, 0).
+ * Les instances compactes n'y font référence que par index.
+ */
+typedef struct {
+	float albedo_metallic[4];
+	float roughness_ao[4]; /* roughness, ao, 0, 0 */
+} MaterialGPU;
+
+typedef struct {
+	GLuint ssbo;
+	int count;
+} MaterialTable;
+
+void material_gpu_pack(const PBRMaterial* material, MaterialGPU* out);
+
+int material_table_init(MaterialTable* table, const MaterialLib* lib);
+
+/**
+ * Re-téléverse la seule entrée `index` après modification de
+ * lib->materials[index] : toutes les instances compactes qui la
+ * référencent voient le changement à la frame suivante.
+ */
+int material_table_update(MaterialTable* table, const MaterialLib* lib,
+                          int index);
+
+void material_table_bind(const MaterialTable* table);
+
+void material_table_cleanup(MaterialTable* table);
+
 #endif
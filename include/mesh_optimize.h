@@ -0,0 +1,50 @@
+#ifndef MESH_OPTIMIZE_H
+#define MESH_OPTIMIZE_H
+
+#include <cglm/types.h>
+#include <stddef.h>
+
+/* Taille du cache post-transform visée par le réordonnancement et simulée
+ * par les statistiques (FIFO, ordre de grandeur des GPU actuels) */
+enum { MESH_OPTIMIZE_CACHE_SIZE = 32 };
+
+/**
+ * Efficacité du cache post-transform pour un ordre d'indices :
+ *  - ACMR : sommets transformés par triangle (0.5 idéal, 3.0 pire cas)
+ *  - ATVR : sommets transformés par sommet unique (1.0 idéal)
+ */
+typedef struct {
+	size_t transformed;
+	double acmr;
+	double atvr;
+} MeshCacheStats;
+
+/* Simule un cache FIFO de `cache_size` sommets sur la liste de triangles */
+MeshCacheStats mesh_analyze_vertex_cache(const unsigned int* indices,
+                                         size_t index_count,
+                                         size_t vertex_count,
+                                         int cache_size);
+
+/**
+ * Réordonne les triangles (algorithme de Forsyth, "Linear-Speed Vertex
+ * Cache Optimisation") pour maximiser les hits du cache post-transform.
+ * Les triangles et leur orientation sont conservés. Retourne 0 si
+ * l'allocation échoue (indices inchangés).
+ */
+int mesh_optimize_vertex_cache(unsigned int* indices, size_t index_count,
+                               size_t vertex_count);
+
+/**
+ * Renumérote les sommets dans l'ordre de première utilisation (localité du
+ * vertex fetch). remap[ancien] = nouveau ; les indices sont réécrits. Les
+ * sommets inutilisés sont placés à la fin.
+ */
+void mesh_optimize_vertex_fetch_remap(unsigned int* indices,
+                                      size_t index_count, size_t vertex_count,
+                                      unsigned int* remap);
+
+/* Applique un remap à un attribut par sommet. Retourne 0 si échec. */
+int mesh_remap_vec3(vec3* data, size_t vertex_count,
+                    const unsigned int* remap);
+
+#endif /* MESH_OPTIMIZE_H */
@@ -3,28 +3,48 @@
 
 #include "gl_common.h"
 
+/* SSBO du seuil de luminance lu par spmap/irmap
+ * (shaders/IBL/luminance_threshold.glsl) */
+enum { PBR_THRESHOLD_BINDING = 2 };
+
+typedef struct {
+	float mean_luminance;
+	float clamp_threshold;
+} PbrLuminanceThreshold;
+
 /* Prefiltered Specular Map Generation */
 GLuint build_prefiltered_specular_map(GLuint shader, GLuint env_hdr_tex,
-                                      int width, int height, float threshold);
+                                      int width, int height,
+                                      GLuint threshold_ssbo);
 
 /* Granular Prefiltering (for async/progressive loading) */
 GLuint pbr_prefilter_init(int width, int height);
 void pbr_prefilter_mip(GLuint shader, GLuint env_hdr_tex, GLuint dest_tex,
                        int width, int height, int level, int total_levels,
-                       int slice_index, int total_slices, float threshold);
+                       int slice_index, int total_slices,
+                       GLuint threshold_ssbo);
 
 GLuint build_irradiance_map(GLuint shader, GLuint env_hdr_tex, int size,
-                            float threshold);
+                            GLuint threshold_ssbo);
 
 GLuint pbr_irradiance_init(int size);
 void pbr_irradiance_slice_compute(GLuint shader, GLuint env_hdr_tex,
                                   GLuint dest_tex, int size, int slice_index,
-                                  int total_slices, float threshold);
+                                  int total_slices, GLuint threshold_ssbo);
 
 GLuint build_brdf_lut_map(int size);
 
-float compute_mean_luminance_gpu(GLuint shader_pass1, GLuint shader_pass2,
-                                 GLuint hdr_tex, int width, int height,
-                                 float clamp_multiplier, GLuint ssbos[2]);
+/* Seuil fixe (PbrLuminanceThreshold) pour les bakes sans réduction */
+GLuint pbr_threshold_buffer_create(float threshold);
+
+/* Réduction de la luminance moyenne de hdr_tex. Le seuil validé
+ * (mean * clamp_multiplier, default_threshold si < 1 ou non fini) reste
+ * dans ssbos[1] (PbrLuminanceThreshold), lu tel quel par le bake ; le CPU
+ * le relit via GpuReadback. Sans shaders : ssbos[1] reçoit
+ * default_threshold et retourne 0. */
+int dispatch_mean_luminance_gpu(GLuint shader_pass1, GLuint shader_pass2,
+                                GLuint hdr_tex, int width, int height,
+                                float clamp_multiplier,
+                                float default_threshold, GLuint ssbos[2]);
 
 #endif /* PBR_H */
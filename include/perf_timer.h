@@ -18,6 +18,14 @@ typedef struct {
 	struct timespec end;
 } PerfTimer;
 
+enum TimeConversionFactors {
+	NS_PER_MS = 1000000,    // Nanoseconds per millisecond
+	NS_PER_US = 1000,       // Nanoseconds per microsecond
+	NS_PER_S = 1000000000,  // Nanoseconds per second
+	US_PER_S = 1000000,     // Microseconds per second
+	MS_PER_S = 1000         // Milliseconds per second
+};
+
 /**
  * @brief GPU performance timer using OpenGL Query Objects
  *
@@ -30,6 +38,26 @@ typedef struct {
 	int active;
 } GPUTimer;
 
+/* Frames en vol avant relecture : le CPU n'attend jamais le GPU */
+enum { GPU_TIMESTAMP_RING_FRAMES = 4 };
+
+/**
+ * @brief Anneau de GL_TIMESTAMP relus sans bloquer
+ *
+ * Chaque frame pose jusqu'à stamp_count timestamps dans son slot ; ils sont
+ * relus GPU_TIMESTAMP_RING_FRAMES frames plus tard au plus, seulement si le
+ * dernier posé est disponible. Un slot jamais relu (GPU trop en retard) est
+ * abandonné quand une frame le reprend.
+ */
+typedef struct {
+	GLuint* queries; /* GPU_TIMESTAMP_RING_FRAMES x stamp_count */
+	int stamp_count;
+	int slot; /* Slot de la frame courante */
+	int last[GPU_TIMESTAMP_RING_FRAMES]; /* Dernier timestamp posé */
+	/* Tag de la frame complète non relue, 0 : aucune */
+	int pending[GPU_TIMESTAMP_RING_FRAMES];
+} GPUTimestampRing;
+
 /**
  * @brief Hybrid performance timer combining CPU and GPU measurements
  */
@@ -94,6 +122,51 @@ double gpu_timer_elapsed_ms(GPUTimer* timer, int wait_for_result);
  */
 void gpu_timer_cleanup(GPUTimer* timer);
 
+// ============================================================================
+// GPU Timestamp Ring API
+// ============================================================================
+
+/**
+ * @brief Crée les requêtes de l'anneau (sans effet s'il est déjà prêt)
+ * @param stamp_count Timestamps au plus par frame
+ * @return 1 si l'anneau est utilisable
+ */
+int gpu_timestamp_ring_init(GPUTimestampRing* ring, int stamp_count);
+
+/**
+ * @brief Ouvre une frame dans le slot suivant
+ */
+void gpu_timestamp_ring_begin(GPUTimestampRing* ring);
+
+/**
+ * @brief Pose le timestamp `stamp` (0..stamp_count-1, croissants) de la
+ * frame courante
+ */
+void gpu_timestamp_ring_stamp(GPUTimestampRing* ring, int stamp);
+
+/**
+ * @brief Ferme la frame courante : elle devient lisible
+ * @param tag Valeur non nulle rendue par try_read (génération, etc.)
+ */
+void gpu_timestamp_ring_end(GPUTimestampRing* ring, int tag);
+
+/**
+ * @brief Relit la plus ancienne frame terminée, sans attendre le GPU
+ * @param stamps Reçoit les timestamps posés (ns), au moins stamp_count
+ * @param tag Reçoit le tag passé à end (peut être NULL)
+ * @return Slot de la frame relue, -1 si aucune n'est disponible.
+ * Appeler en boucle pour aller de la plus ancienne à la plus récente.
+ */
+int gpu_timestamp_ring_try_read(GPUTimestampRing* ring, GLuint64* stamps,
+                                int* tag);
+
+/**
+ * @brief Oublie les frames en vol (les requêtes sont conservées)
+ */
+void gpu_timestamp_ring_discard(GPUTimestampRing* ring);
+
+void gpu_timestamp_ring_cleanup(GPUTimestampRing* ring);
+
 // ============================================================================
 // Hybrid Timer API
 // ============================================================================
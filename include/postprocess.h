@@ -3,9 +3,15 @@
 
 #include "effects/fx_auto_exposure.h"
 #include "effects/fx_bloom.h"
+#include "effects/fx_color_lut.h"
 #include "effects/fx_dof.h"
 #include "effects/fx_motion_blur.h"
+#include "effects/fx_tile_classify.h"
+#include "frame_graph.h"
 #include "gl_common.h"
+#include "gpu_readback.h"
+#include "postprocess_variants.h"
+#include "render_target_pool.h"
 #include "shader.h"
 #include <cglm/cglm.h>
 #include <cglm/types.h>
@@ -56,6 +62,9 @@ typedef enum {
 	POSTFX_EXPOSURE_DEBUG = (1U << 9U),     /* 0x200 */
 	POSTFX_MOTION_BLUR = (1U << 10U),       /* 0x400 */
 	POSTFX_MOTION_BLUR_DEBUG = (1U << 11U), /* 0x800 */
+	/* Chaîne couleur par LUT 3D : posé par le composite quand la LUT est
+	 * active (postprocess_set_color_lut), pas par les presets */
+	POSTFX_COLOR_LUT = (1U << 12U), /* 0x1000 */
 } PostProcessEffect;
 
 /* Structure pour le Color Grading (Style Unreal Engine) */
@@ -124,7 +133,7 @@ typedef struct {
 typedef struct {
 	uint32_t active_effects;
 	float time;
-	float _pad0[2];
+	float render_scale[2]; /* Région rendue / taille des cibles */
 
 	/* Vignette */
 	float vignette_intensity;
@@ -198,6 +207,14 @@ typedef struct PostProcess {
 	GLuint velocity_tex;    /* Velocity Buffer (GL_RG16F) */
 	GLuint scene_depth_tex; /* Depth (GL_DEPTH_COMPONENT32F) */
 
+	/* Cibles des effets, prises au premier rendu actif */
+	RenderTargetPool target_pool;
+
+	/* Passes de postprocess_end(), reconstruites quand frame_graph_key
+	 * (masque du composite + chemin compute) change */
+	FrameGraph frame_graph;
+	unsigned int frame_graph_key;
+
 	/* Bloom Resources */
 	BloomFX bloom_fx;
 
@@ -219,6 +236,18 @@ typedef struct PostProcess {
 
 	/* Shaders */
 	Shader* postprocess_shader;  /* Shader combinant tous les effets */
+	PostProcessVariants variants; /* Permutations par masque d'effets */
+	/* Composite compute (tuiles 16x16 + apron en mémoire partagée) */
+	Shader* composite_compute_shader;
+	GLuint composite_tex; /* RGBA8, blitté vers le framebuffer par défaut */
+	GLuint composite_fbo;
+	int compute_composite; /* 1 : composite compute, 0 : fragment */
+	/* Classes de tuiles du composite compute (DoF / motion blur) */
+	TileClassifyFX tile_classify_fx;
+	/* White balance, grading, tonemapping et gamma cuits en LUT 3D */
+	ColorLutFX color_lut_fx;
+	/* Relectures asynchrones (exposition, histogramme), NULL : aucune */
+	GpuReadback* readback;
 	Shader* tile_max_shader;     /* Compute Shader: Tile Max Velocity */
 	Shader* neighbor_max_shader; /* Compute Shader: Neighbor Max
 	                                Velocity */
@@ -227,6 +256,13 @@ typedef struct PostProcess {
 	int width;
 	int height;
 
+	/* Résolution dynamique : la scène n'occupe que le coin bas-gauche
+	 * render_width x render_height des cibles (allouées à width x height,
+	 * jamais réallouées), le composite remet à l'échelle */
+	float render_scale;
+	int render_width;
+	int render_height;
+
 	/* Pipeline Settings (Effets actifs) */
 	unsigned int active_effects;
 
@@ -260,6 +296,9 @@ void postprocess_set_dummy_textures(PostProcess* post_processing,
 /* Redimensionnement */
 void postprocess_resize(PostProcess* post_processing, int width, int height);
 
+/* Échelle de rendu de la scène dans ]0, 1] (1 : résolution native) */
+void postprocess_set_render_scale(PostProcess* post_processing, float scale);
+
 /* Activation/désactivation d'effets */
 void postprocess_enable(PostProcess* post_processing, PostProcessEffect effect);
 void postprocess_disable(PostProcess* post_processing,
@@ -288,7 +327,17 @@ void postprocess_set_bloom(PostProcess* post_processing, float intensity,
                            float threshold, float soft_threshold);
 void postprocess_set_dof(PostProcess* post_processing, float focal_distance,
                          float focal_range, float bokeh_scale);
+/* Niveaux de la chaîne de bloom (1..BLOOM_MAX_MIP_LEVELS), retourne le
+ * nombre retenu */
+int postprocess_set_bloom_levels(PostProcess* post_processing, int levels);
+/* Exposition relue de façon asynchrone (quelques frames de retard) */
 float postprocess_get_exposure(PostProcess* post_processing);
+/* VRAM des cibles de rendu : scène, composite et pool (prêtées + libres) */
+size_t postprocess_vram_bytes(const PostProcess* post_processing);
+/* Détail par effet dans le log */
+void postprocess_log_vram(const PostProcess* post_processing);
+void postprocess_set_readback(PostProcess* post_processing,
+                              GpuReadback* readback);
 void postprocess_set_auto_exposure(PostProcess* post_processing,
                                    float min_luminance, float max_luminance,
                                    float speed_up, float speed_down,
@@ -314,6 +363,20 @@ typedef struct {
 void postprocess_apply_preset(PostProcess* post_processing,
                               const PostProcessPreset* preset);
 
+/* Composite en compute (1) ou en fragment (0) ; retourne le chemin retenu
+ * (0 si postprocess.comp n'a pas pu être chargé) */
+int postprocess_set_compute_composite(PostProcess* post_processing,
+                                      int enabled);
+
+/* Taille de la LUT couleur (COLOR_LUT_SIZE_SMALL / _LARGE), 0 : chaîne
+ * analytique ; retourne la taille retenue */
+int postprocess_set_color_lut(PostProcess* post_processing, int size);
+
+/* Composite compute par classes de tuiles (1) ou plein écran (0) ; retourne
+ * le mode retenu (0 si les shaders de classification manquent) */
+int postprocess_set_tile_classification(PostProcess* post_processing,
+                                        int enabled);
+
 /* Rendu */
 void postprocess_begin(
     PostProcess* post_processing); /* Commence le rendu dans le FBO */
@@ -0,0 +1,95 @@
+#ifndef POSTPROCESS_VARIANTS_H
+#define POSTPROCESS_VARIANTS_H
+
+#include "gl_common.h"
+#include "perf_timer.h"
+#include "shader.h"
+#include <stddef.h>
+
+enum {
+	POSTPROCESS_MAX_VARIANTS = 32,
+	/* Bits de active_effects lus par postprocess.frag */
+	POSTPROCESS_VARIANT_KEY_BITS = 13,
+	POSTPROCESS_VARIANT_KEY_MASK =
+	    (1U << POSTPROCESS_VARIANT_KEY_BITS) - 1U,
+	POSTPROCESS_VARIANT_DEFINES_SIZE = 64,
+	POSTPROCESS_VARIANT_NAME_SIZE = 160
+};
+
+typedef enum {
+	POSTPROCESS_VARIANT_COMPILING = 0,
+	POSTPROCESS_VARIANT_READY,
+	POSTPROCESS_VARIANT_FAILED /* Reste sur l'uber-shader */
+} PostProcessVariantState;
+
+typedef struct {
+	unsigned int key; /* Masque d'effets figé à la compilation */
+	PostProcessVariantState state;
+	GLuint pending_program; /* Programme en cours de compilation */
+	int frames_waited;
+	Shader* shader;
+	/* Temps GPU du composite depuis le dernier rapport */
+	double gpu_ms_sum;
+	int gpu_samples;
+} PostProcessVariant;
+
+/**
+ * Permutations spécialisées de shaders/postprocess.frag.
+ *
+ * L'uber-shader teste chaque effet à l'exécution (masque lu dans l'UBO). Pour
+ * chaque masque rencontré, une variante est compilée avec
+ * POSTFX_VARIANT_MASK injecté après #version : les branches des effets
+ * désactivés disparaissent à la compilation (code, registres, fetchs). La
+ * compilation ne bloque pas le rendu : l'uber-shader sert tant que la
+ * variante n'est pas prête. Le composite est chronométré par variante.
+ */
+typedef struct {
+	PostProcessVariant entries[POSTPROCESS_MAX_VARIANTS];
+	int count;
+	PostProcessVariant uber;    /* Statistiques de l'uber-shader */
+	PostProcessVariant compute; /* Statistiques du composite compute */
+	PostProcessVariant tiled;   /* Compute par classes de tuiles */
+	int enabled;             /* 0 : toujours l'uber-shader (comparaison) */
+
+	PostProcessVariant* selected; /* Dernier choix de select */
+	/* Début et fin du composite, relus sans bloquer */
+	GPUTimestampRing timestamps;
+	PostProcessVariant* query_owner[GPU_TIMESTAMP_RING_FRAMES];
+	int timing; /* Frame ouverte par begin_timing */
+} PostProcessVariants;
+
+/* Bits de active_effects qui changent le code du composite */
+unsigned int postprocess_variant_key(unsigned int active_effects);
+
+/* Bloc #define injecté dans la variante */
+void postprocess_variant_defines(unsigned int key, char* out, size_t size);
+
+/* Nom lisible ("bloom+dof+vignette", "none") pour les logs */
+void postprocess_variant_name(unsigned int key, char* out, size_t size);
+
+void postprocess_variants_init(PostProcessVariants* variants);
+
+/**
+ * Shader à utiliser pour ce masque : la variante si elle est prête, sinon
+ * `uber` (la compilation est lancée au premier usage). Fait aussi avancer
+ * les compilations en cours.
+ */
+Shader* postprocess_variants_select(PostProcessVariants* variants,
+                                    unsigned int active_effects,
+                                    Shader* uber);
+
+/* Le composite de cette frame passe par postprocess.comp (plein écran, ou
+ * par classes de tuiles si `tiled`) */
+void postprocess_variants_select_compute(PostProcessVariants* variants,
+                                         int tiled);
+
+/* Encadrent le draw du composite, attribué au dernier shader choisi */
+void postprocess_variants_begin_timing(PostProcessVariants* variants);
+void postprocess_variants_end_timing(PostProcessVariants* variants);
+
+/* Log du temps GPU moyen par variante, puis remise à zéro */
+void postprocess_variants_report(PostProcessVariants* variants);
+
+void postprocess_variants_cleanup(PostProcessVariants* variants);
+
+#endif /* POSTPROCESS_VARIANTS_H */
@@ -0,0 +1,88 @@
+#ifndef RENDER_TARGET_POOL_H
+#define RENDER_TARGET_POOL_H
+
+#include "gl_common.h"
+#include <stddef.h>
+
+enum {
+	RENDER_TARGET_POOL_MAX = 32,
+	/* Cible libre détruite après autant de frames sans preneur */
+	RENDER_TARGET_POOL_IDLE_FRAMES = 120,
+	/* Propriétaires distincts dans un rapport */
+	RENDER_TARGET_POOL_MAX_OWNERS = 8
+};
+
+typedef struct {
+	GLuint texture; /* glTexStorage2D, un niveau */
+	int width;
+	int height;
+	GLenum format;
+	size_t bytes;
+	const char* owner; /* Chaîne statique, NULL : libre */
+	unsigned long long last_used; /* Frame de la dernière libération */
+} RenderTarget;
+
+/* Mémoire d'un propriétaire (rapport VRAM) */
+typedef struct {
+	const char* owner; /* NULL : cibles libres gardées par le pool */
+	size_t bytes;
+	int targets;
+} RenderTargetUsage;
+
+/**
+ * Pool de cibles de rendu 2D, clé taille + format.
+ *
+ * Les textures sont immuables (glTexStorage2D) : une cible n'est jamais
+ * réallouée, seulement prêtée. render_target_pool_acquire() rend une
+ * cible libre de même clé si le pool en garde une, sinon en crée une.
+ * render_target_pool_release() la rend au pool sans la détruire : une
+ * cible transitoire rendue dès la fin de sa passe est reprise par la
+ * prochaine acquisition de même clé, dans la même frame (aliasing de
+ * cibles dont les durées de vie ne se chevauchent pas). Les cibles libres
+ * non reprises pendant RENDER_TARGET_POOL_IDLE_FRAMES sont détruites.
+ *
+ * Le pool n'insère aucune barrière : les passes qui se passent une cible
+ * sont déjà séparées par les glMemoryBarrier de leurs effets.
+ */
+typedef struct {
+	RenderTarget targets[RENDER_TARGET_POOL_MAX];
+	int count;
+	unsigned long long frame;
+	int created; /* Textures créées depuis l'init */
+	int reused;  /* Acquisitions servies par une cible libre */
+	int changed; /* Allocation modifiée depuis le dernier rapport */
+} RenderTargetPool;
+
+void render_target_pool_init(RenderTargetPool* pool);
+
+/* Prête une cible width x height (filtre `filter`, clamp), 0 si le pool
+ * est plein */
+GLuint render_target_pool_acquire(RenderTargetPool* pool, int width,
+                                  int height, GLenum format, GLenum filter,
+                                  const char* owner);
+
+/* Rend une cible au pool (0 ignoré) */
+void render_target_pool_release(RenderTargetPool* pool, GLuint texture);
+
+/* Début de frame : détruit les cibles libres inutilisées */
+void render_target_pool_begin_frame(RenderTargetPool* pool);
+
+/* Détruit toutes les cibles libres (redimensionnement) */
+void render_target_pool_trim(RenderTargetPool* pool);
+
+/* Octets prêtés à `owner`, ou gardés libres si `owner` est NULL */
+size_t render_target_pool_bytes(const RenderTargetPool* pool,
+                                const char* owner);
+
+/* Mémoire par propriétaire (libres en dernier), retourne le nombre
+ * d'entrées écrites */
+int render_target_pool_usage(const RenderTargetPool* pool,
+                             RenderTargetUsage* usage, int max_usage);
+
+/* Octets par texel d'un format interne (0 : inconnu) */
+size_t render_target_format_bytes(GLenum format);
+
+/* Détruit toutes les cibles, prêtées ou non */
+void render_target_pool_cleanup(RenderTargetPool* pool);
+
+#endif /* RENDER_TARGET_POOL_H */
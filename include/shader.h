@@ -9,6 +9,10 @@ GLuint shader_compile(const char* path, GLenum type);
 /* Read shader source from file (exposed for testing) */
 char* shader_read_file(const char* path);
 
+/* Same as shader_read_file, with `defines` (e.g. "#define FOO 1\n")
+ * inserted right after the #version line of the expanded source */
+char* shader_read_file_with_defines(const char* path, const char* defines);
+
 /* Create a shader program from vertex and fragment shader files */
 GLuint shader_load_program(const char* vertex_path, const char* fragment_path);
 
@@ -39,6 +43,22 @@ Shader* shader_load(const char* vertex_path, const char* fragment_path);
 /* Load and link a compute shader, automatically caching all active uniforms. */
 Shader* shader_load_compute_program(const char* compute_path);
 
+/* Same with `defines` injected after #version (permutations), labelled
+ * `name` */
+Shader* shader_load_compute_program_with_defines(const char* compute_path,
+                                                 const char* defines,
+                                                 const char* name);
+
+/* Non-blocking program creation (vertex + fragment with injected defines).
+ * begin issues compile + link without querying any status, is_ready polls
+ * KHR_parallel_shader_compile when the driver exposes it (always 1
+ * otherwise), finish checks the link and wraps the program (NULL and program
+ * deleted on failure). */
+GLuint shader_program_begin(const char* vertex_path,
+                            const char* fragment_path, const char* defines);
+int shader_program_is_ready(GLuint program);
+Shader* shader_program_finish(GLuint program, const char* name);
+
 /* Destroy the shader wrapper, freeing cached memory. Does NOT delete the GL
  * program if it was created externally, but DOES delete it if created via
  * shader_load. */
@@ -58,4 +78,9 @@ void shader_set_vec3(Shader* shader, const char* name, const float* val);
 void shader_set_vec4(Shader* shader, const char* name, const float* val);
 void shader_set_mat4(Shader* shader, const char* name, const float* val);
 
+/* Upload `count` vec4 to the uniform array `name`. Only the first element
+ * of an array ("name[0]") is cached by name; the others follow it. */
+void shader_set_vec4_array(Shader* shader, const char* name,
+                           const float* val, int count);
+
 #endif /* SHADER_H */
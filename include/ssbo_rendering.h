@@ -2,6 +2,9 @@
 #define SSBO_RENDERING_H
 
 #include "gl_common.h"
+#include "icosphere_cache.h"
+#include "instance_stream.h"
+#include "instanced_rendering.h"
 #include <cglm/types.h>
 
 /**
@@ -21,6 +24,11 @@ typedef struct {
 	GLuint ssbo;
 	GLuint vao;
 	int instance_count;
+	/* COMPACT : SphereInstanceCompact, matériaux lus dans la MaterialTable
+	 * (shaders/pbr_ibl_ssbo_compact.vert) */
+	InstanceFormat format;
+	InstanceStream* stream; /* Emprunté : instances dynamiques (sinon NULL) */
+	GLenum index_type;      /* Type des indices du maillage lié */
 } SSBOGroup;
 
 /**
@@ -29,10 +37,24 @@ typedef struct {
 void ssbo_group_init(SSBOGroup* group, const SphereInstanceSSBO* data,
                      int count);
 
+/**
+ * Variante compacte (16 bytes par instance, même layout std430 que
+ * SphereInstanceCompact)
+ */
+void ssbo_group_init_compact(SSBOGroup* group,
+                             const SphereInstanceCompact* data, int count);
+
+/**
+ * Instances dynamiques : le SSBO est la région courante du stream
+ * (glBindBufferRange à chaque draw)
+ */
+void ssbo_group_init_stream(SSBOGroup* group, InstanceStream* stream,
+                            int count);
+
 /**
  * Lie la géométrie mesh au VAO du groupe SSBO
  */
-void ssbo_group_bind_mesh(SSBOGroup* group, GLuint vbo, GLuint nbo, GLuint ebo);
+void ssbo_group_bind_mesh(SSBOGroup* group, const IcosphereMesh* mesh);
 
 /**
  * Effectue le rendu instancié via SSBO
@@ -18,6 +18,9 @@ RE_LABEL = re.compile(
 )
 RE_PUSH = re.compile(r'^\s*(\d+)\s+glPushDebugGroup\(.*message\s*=\s*"(.*)"\)')
 RE_POP = re.compile(r"^\s*(\d+)\s+glPopDebugGroup\(\)")
+RE_RENDER_SCALE = re.compile(
+    r'^\s*(\d+)\s+glDebugMessageInsert\(.*buf\s*=\s*"render_scale=([0-9.]+)\s+(\d+)x(\d+)"\)'
+)
 RE_RESULT = re.compile(
     r"^\s*(\d+)\s+glGetQueryObjectui64v\(id\s*=\s*(\d+)\s*,\s*pname\s*=\s*GL_QUERY_RESULT\s*,\s*params\s*=\s*&(\d+)\)"
 )
@@ -52,14 +55,17 @@ def parse_trace_dump(dump_lines):
         dump_lines: Iterator of lines from apitrace dump output
 
     Returns:
-        tuple: (prog_labels, call_markers_raw, timestamp_fetches)
+        tuple: (prog_labels, call_markers_raw, timestamp_fetches, render_scales)
             - prog_labels: dict mapping program ID to shader label
             - call_markers_raw: list of (start, end, label) tuples
             - timestamp_fetches: list of (call_no, timestamp_value) tuples
+            - render_scales: list of (call_no, scale, width, height) tuples,
+              one per frame (dynamic resolution marker)
     """
     prog_labels = {}
     call_markers_raw = []
     timestamp_fetches = []
+    render_scales = []
     marker_stack = []
 
     for line in dump_lines:
@@ -83,13 +89,19 @@ def parse_trace_dump(dump_lines):
                 call_markers_raw.append((start_call, call_no, label))
             continue
 
+        match = RE_RENDER_SCALE.match(line)
+        if match:
+            call_no, scale, width, height = match.groups()
+            render_scales.append((int(call_no), float(scale), int(width), int(height)))
+            continue
+
         match = RE_RESULT.match(line)
         if match:
             call_no, _qid, val = match.groups()
             timestamp_fetches.append((int(call_no), int(val)))
             continue
 
-    return prog_labels, call_markers_raw, timestamp_fetches
+    return prog_labels, call_markers_raw, timestamp_fetches, render_scales
 
 
 def extract_timer_duration(start_call, end_call, timestamp_fetches):
@@ -205,6 +217,71 @@ def calculate_nested_timer_sums(marker_instances):
             parent["is_sum"] = False
 
 
+def assign_render_scales(marker_instances, render_scales):
+    """
+    Tag each debug group with the render scale of the frame it belongs to.
+
+    Args:
+        marker_instances: List of marker instance dictionaries
+        render_scales: List of (call_no, scale, width, height) tuples (sorted)
+
+    Returns:
+        None (modifies marker_instances in place; "render_scale" is None for
+        groups recorded before the first marker)
+    """
+    for marker in marker_instances:
+        marker["render_scale"] = None
+        for call_no, scale, _width, _height in render_scales:
+            if call_no > marker["start"]:
+                break
+            marker["render_scale"] = scale
+
+
+def summarize_render_scales(render_scales):
+    """
+    Summarize the per-frame render scale markers.
+
+    Args:
+        render_scales: List of (call_no, scale, width, height) tuples (sorted)
+
+    Returns:
+        dict or None: frames, min, max, mean, changes and per-scale frame
+        counts; None when the trace has no marker
+    """
+    if not render_scales:
+        return None
+
+    scales = [scale for _call, scale, _w, _h in render_scales]
+    histogram = {}
+    for scale in scales:
+        histogram[scale] = histogram.get(scale, 0) + 1
+
+    return {
+        "frames": len(scales),
+        "min": min(scales),
+        "max": max(scales),
+        "mean": sum(scales) / len(scales),
+        "changes": sum(1 for a, b in zip(scales, scales[1:]) if a != b),
+        "histogram": histogram,
+    }
+
+
+def print_render_scale_summary(summary):
+    """Print the dynamic resolution summary (render scale per frame)."""
+    print("\n=== Render Scale (Per Frame) ===")
+    if summary is None:
+        print("No render_scale marker in trace.")
+        return
+
+    print(
+        f"Frames: {summary['frames']}  "
+        f"min {summary['min']:.3f}  mean {summary['mean']:.3f}  "
+        f"max {summary['max']:.3f}  changes {summary['changes']}"
+    )
+    for scale, count in sorted(summary["histogram"].items(), reverse=True):
+        print(f"  {scale:.3f}: {count} frames")
+
+
 def get_shader_name(prog_id, prog_labels):
     """
     Get shader name from program ID.
@@ -367,7 +444,7 @@ def print_instance_table(instances):
 
     print("\n=== Debug Groups (Per Instance) ===")
 
-    fmt = "| {0:<40} | {1:>12} | {2:>7} | {3:>10} | {4:>11} |"
+    fmt = "| {0:<40} | {1:>12} | {2:>7} | {3:>10} | {4:>11} | {5:>6} |"
     sep = (
         "+"
         + "-" * 42
@@ -380,10 +457,16 @@ def print_instance_table(instances):
         + "+"
         + "-" * 13
         + "+"
+        + "-" * 8
+        + "+"
     )
 
     print(sep)
-    print(fmt.format("Debug Group", "Call Range", "Calls", "GPU[ms]", "Timer[ms]"))
+    print(
+        fmt.format(
+            "Debug Group", "Call Range", "Calls", "GPU[ms]", "Timer[ms]", "Scale"
+        )
+    )
     print(sep)
 
     for marker in sorted_inst:
@@ -399,12 +482,14 @@ def print_instance_table(instances):
         else:
             timer_str = "N/A"
 
+        scale = marker.get("render_scale")
         row = [
             marker["label"][:40],
             call_range,
             marker["calls"],
             f"{gpu_ms:.2f}",
             timer_str,
+            f"{scale:.3f}" if scale is not None else "N/A",
         ]
         print(fmt.format(*row))
     print(sep)
@@ -443,24 +528,27 @@ def main():
         text=True,
     )
 
-    prog_labels, call_markers_raw, timestamp_fetches = parse_trace_dump(
-        dump_proc.stdout
+    prog_labels, call_markers_raw, timestamp_fetches, render_scales = (
+        parse_trace_dump(dump_proc.stdout)
     )
     dump_proc.wait()
 
-    # Sort timestamp fetches by call number
+    # Sort timestamp fetches and scale markers by call number
     timestamp_fetches.sort(key=lambda x: x[0])
+    render_scales.sort(key=lambda x: x[0])
 
     # Create marker instances
     marker_instances = create_marker_instances(call_markers_raw, timestamp_fetches)
 
     # Calculate nested timer sums
     calculate_nested_timer_sums(marker_instances)
+    assign_render_scales(marker_instances, render_scales)
 
     print(
         f"[*] Found {len(prog_labels)} shader labels, "
         f"{len(marker_instances)} debug group instances, "
-        f"and {len(timestamp_fetches)} timestamp fetches."
+        f"{len(timestamp_fetches)} timestamp fetches "
+        f"and {len(render_scales)} render scale markers."
     )
 
     # Replay and process
@@ -496,6 +584,7 @@ def main():
 
     print_shader_table(shader_stats, frame_count)
     print_instance_table(marker_instances)
+    print_render_scale_summary(summarize_render_scales(render_scales))
 
     print(f"\n[!] Total Frames: {frame_count}")
     print("[!] Timer [ms] = Manual GL_TIMESTAMP from glGetQueryObjectui64v pairs.")
@@ -503,6 +592,7 @@ def main():
         "[!] GPU [ms]   = Driver auto-profiling (accurate for Fragment/Vertex shaders)."
     )
     print("[!] * = Sum of nested timers (group has no own timer).")
+    print("[!] Scale = render_scale marker of the frame (dynamic resolution).")
 
 
 if __name__ == "__main__":
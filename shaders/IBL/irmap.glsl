@@ -5,7 +5,8 @@ layout(local_size_x = 32, local_size_y = 32, local_size_z = 1) in;
 layout(binding = 0) uniform sampler2D envMap;
 layout(binding = 1, rgba16f) restrict writeonly uniform image2D irradianceMap;
 
-uniform float clamp_threshold;
+@header "luminance_threshold.glsl";
+
 uniform int u_offset_y;
 uniform int u_max_y;
 
@@ -40,8 +41,8 @@ void OrthonormalBasis(vec3 n, out vec3 t, out vec3 b)
 vec3 soft_clamp_smoothstep(vec3 color)
 {
 	float lum = dot(color, vec3(0.2126, 0.7152, 0.0722));
-	float transition_start = clamp_threshold;
-	float transition_end = clamp_threshold * 1.5;
+	float transition_start = clampThreshold;
+	float transition_end = clampThreshold * 1.5;
 
 	if (lum <= transition_start)
 		return color;
@@ -12,14 +12,13 @@ layout(std430, binding = 0) buffer GroupSums
 	float groupSums[];
 };
 
-// Output: single float = mean luminance
-layout(std430, binding = 1) buffer Result
-{
-	float meanLuminance;
-};
+// Output: mean luminance + clamp threshold, read by the IBL bake
+@header "luminance_threshold.glsl";
 
 uniform uint numGroups;
 uniform uint numPixels;
+uniform float clampMultiplier;
+uniform float defaultThreshold;
 
 shared float sharedSum[256];
 
@@ -46,6 +45,12 @@ void main()
 
 	// Final write
 	if (id == 0) {
-		meanLuminance = sharedSum[0] / float(numPixels);
+		float mean = sharedSum[0] / float(numPixels);
+		float threshold = mean * clampMultiplier;
+		if (isnan(threshold) || isinf(threshold) || threshold < 1.0) {
+			threshold = defaultThreshold;
+		}
+		meanLuminance = mean;
+		clampThreshold = threshold;
 	}
 }
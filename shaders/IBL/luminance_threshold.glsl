@@ -0,0 +1,12 @@
+/*
+ * Luminance threshold of the environment being baked, written by
+ * luminance_reduce_pass2.glsl and read directly by spmap.glsl and
+ * irmap.glsl: the bake never waits for the CPU. The CPU gets a copy later
+ * through GpuReadback (UI, exposure). Binding matches PBR_THRESHOLD_BINDING
+ * in pbr.h.
+ */
+layout(std430, binding = 2) buffer LuminanceThreshold
+{
+	float meanLuminance;
+	float clampThreshold; /* Déjà validé (>= 1, fini) */
+};
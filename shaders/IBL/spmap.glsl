@@ -12,13 +12,14 @@ layout(binding = 1,
 
 layout(location = 0) uniform float roughnessValue;
 layout(location = 1) uniform int currentMipLevel;
-layout(location = 2) uniform float clampThreshold;
 
 layout(location = 3) uniform int u_offset_y;
 layout(location = 4) uniform int u_max_y;
 
 layout(local_size_x = 32, local_size_y = 32, local_size_z = 1) in;
 
+@header "luminance_threshold.glsl";
+
 // Convertit un vecteur directionnel en coordonnées UV équirectangulaires
 vec2 dirToUV(vec3 v)
 {
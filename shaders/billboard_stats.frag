@@ -0,0 +1,30 @@
+#version 450 core
+
+// Fragment statistics for the sphere impostors (render benchmark only).
+// Drawn with depth test and color writes disabled: every rasterized quad
+// fragment is counted, plus the ones the ray actually hits.
+
+in vec3 WorldPos;
+in vec3 SphereCenter;
+in float SphereRadius;
+
+uniform vec3 camPos;
+
+layout(std430, binding = 0) buffer FragmentStats {
+	uint rasterizedFragments;
+	uint coveredFragments;
+};
+
+@header "sphere_impostor.glsl";
+
+void main()
+{
+	atomicAdd(rasterizedFragments, 1u);
+
+	float t;
+	vec3 N;
+	if (intersectSphere(camPos, normalize(WorldPos - camPos), SphereCenter,
+	                    SphereRadius, t, N)) {
+		atomicAdd(coveredFragments, 1u);
+	}
+}
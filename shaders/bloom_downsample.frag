@@ -1,4 +1,4 @@
-#version 330 core
+#version 440 core
 
 /*
  * Downsampling 13-tap de Jorge Jimenez (Next Gen Post Processing in Call of
@@ -9,7 +9,7 @@
 in vec2 TexCoords;
 out vec3 FragColor;
 
-uniform sampler2D srcTexture;
+layout(binding = 0) uniform sampler2D srcTexture;
 uniform vec2
     srcResolution; /* Résolution de la texture source (pas la destination !) */
 
@@ -0,0 +1,33 @@
+/*
+ * Bloom mip chain seen as images: one texture per level, level i on image
+ * unit i (BLOOM_MAX_MIP_LEVELS in fx_bloom.h, 8 = minimum
+ * GL_MAX_COMPUTE_IMAGE_UNIFORMS). Only the first levelCount units are bound.
+ * coherent: a level written by other invocations of the same dispatch is
+ * read back after memoryBarrierImage().
+ */
+#define BLOOM_MAX_LEVELS 8
+
+layout(binding = 0, r11f_g11f_b10f) uniform coherent image2D
+    bloomMips[BLOOM_MAX_LEVELS];
+
+uniform int levelCount;
+
+/* Texel fetch with the same clamp as GL_CLAMP_TO_EDGE */
+vec3 loadMip(int level, ivec2 texel)
+{
+	ivec2 size = imageSize(bloomMips[level]);
+	return imageLoad(bloomMips[level], clamp(texel, ivec2(0), size - 1))
+	    .rgb;
+}
+
+/* Out-of-range stores are discarded by the image unit */
+void storeMip(int level, ivec2 texel, vec3 color)
+{
+	imageStore(bloomMips[level], texel, vec4(color, 1.0));
+}
+
+/* 2x2 box, weighted per operand (R11G11B10 / FP16 overflow) */
+vec3 box4(vec3 a, vec3 b, vec3 c, vec3 d)
+{
+	return a * 0.25 + b * 0.25 + c * 0.25 + d * 0.25;
+}
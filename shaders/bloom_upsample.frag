@@ -1,4 +1,4 @@
-#version 330 core
+#version 440 core
 
 /*
  * Upsampling avec Tent Filter (3x3)
@@ -8,7 +8,7 @@
 in vec2 TexCoords;
 out vec3 FragColor;
 
-uniform sampler2D srcTexture;
+layout(binding = 0) uniform sampler2D srcTexture;
 uniform float filterRadius; /* Rayon du filtre, défaut 1.0 */
 
 void main()
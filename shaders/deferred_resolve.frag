@@ -0,0 +1,59 @@
+#version 450 core
+
+// Résolution du rendu différé : IBL évalué une seule fois par pixel
+layout(location = 0) out vec4 FragColor;
+
+uniform sampler2D gAlbedoAO;
+uniform sampler2D gNormal;
+uniform sampler2D gMaterial;
+uniform sampler2D gDepth;
+uniform mat4 invViewProj;
+uniform vec2 viewportSize;  // Région rendue (résolution dynamique)
+
+uniform vec3 camPos;
+uniform sampler2D irradianceMap;
+uniform sampler2D prefilterMap;
+uniform sampler2D brdfLUT;
+uniform int debugMode;
+
+@header "pbr_functions.glsl";
+@header "gbuffer.glsl";
+
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	float depth = texelFetch(gDepth, pixel, 0).r;
+	if (depth >= 1.0) {
+		discard;  // Fond : rempli ensuite par la skybox
+	}
+
+	vec4 albedoAO = texelFetch(gAlbedoAO, pixel, 0);
+	vec3 N = decodeOctahedral(texelFetch(gNormal, pixel, 0).rg);
+	vec2 material = texelFetch(gMaterial, pixel, 0).rg;
+	vec3 albedo = albedoAO.rgb;
+	float ao = albedoAO.a;
+	float metallic = material.x;
+	float roughness = material.y;  // Déjà clampée par gbuffer.frag
+
+	// Position monde reconstruite depuis la profondeur
+	vec2 uv = gl_FragCoord.xy / viewportSize;
+	vec4 world = invViewProj * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+	vec3 P = world.xyz / world.w;
+	vec3 V = normalize(camPos - P);
+
+	vec3 color;
+	if (debugMode != 0) {
+		color = compute_debug(N, V, albedo, metallic, roughness, ao,
+		                      debugMode);
+	} else {
+		vec3 R = reflect(-V, N);
+		float NdotV = max(dot(N, V), 0.0);
+		vec3 F0 = mix(vec3(0.04), albedo, metallic);
+		color = compute_IBL_PBR_Advanced(N, V, R, F0, NdotV, albedo,
+		                                 metallic, roughness, ao);
+		color += compute_clustered_lights(P, depth, N, V, albedo,
+		                                  metallic, roughness);
+	}
+
+	FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,9 @@
+#version 450 core
+
+// Triangle plein écran (3 sommets, pas de VBO)
+void main()
+{
+	float x = -1.0 + float((gl_VertexID & 1) << 2);
+	float y = -1.0 + float((gl_VertexID & 2) << 1);
+	gl_Position = vec4(x, y, 0.0, 1.0);
+}
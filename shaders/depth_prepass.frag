@@ -0,0 +1,6 @@
+#version 450 core
+
+// Profondeur seule : les écritures couleur sont masquées par l'application
+void main()
+{
+}
@@ -0,0 +1,18 @@
+#version 450 core
+
+// Pré-passe de profondeur : position seule, aucun varying.
+// Le calcul doit rester identique à pbr_ibl_instanced.vert (invariant) pour
+// que la passe principale passe le test GL_LEQUAL sur la même profondeur.
+layout(location = 0) in vec3 in_position;
+layout(location = 2) in mat4 i_model;  // Emplacement 2, 3, 4, 5
+
+uniform mat4 projection;
+uniform mat4 view;
+
+invariant gl_Position;
+
+void main()
+{
+	vec3 WorldPos = vec3(i_model * vec4(in_position, 1.0));
+	gl_Position = projection * view * vec4(WorldPos, 1.0);
+}
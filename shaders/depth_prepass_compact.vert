@@ -0,0 +1,19 @@
+#version 450 core
+
+// Pré-passe de profondeur, instances compactes (cf. depth_prepass.vert)
+layout(location = 0) in vec3 in_position;
+layout(location = 2) in vec3 i_position;
+layout(location = 3) in uint i_scaleMaterial;
+
+uniform mat4 projection;
+uniform mat4 view;
+
+invariant gl_Position;
+
+@header "material_table.glsl";
+
+void main()
+{
+	vec3 WorldPos = i_position + in_position * compactScale(i_scaleMaterial);
+	gl_Position = projection * view * vec4(WorldPos, 1.0);
+}
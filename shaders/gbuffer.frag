@@ -0,0 +1,42 @@
+#version 450 core
+
+// Passe géométrie du rendu différé : mêmes entrées que pbr_ibl_instanced.frag,
+// aucune texture d'environnement lue
+layout(location = 0) out vec4 GAlbedoAO;  // RGBA8 : albedo, ao
+layout(location = 1) out vec2 VelocityOut;
+layout(location = 2) out vec2 GNormal;    // RG16 : normale octaédrique
+layout(location = 3) out vec2 GMaterial;  // RG8 : metallic, roughness
+
+in vec3 WorldPos;
+in vec3 Normal;
+in vec3 Albedo;
+in float Metallic;
+in float Roughness;
+in float AO;
+in vec4 CurrentClipPos;
+in vec4 PreviousClipPos;
+
+// Déclarés pour pbr_functions.glsl, inutilisés ici
+uniform sampler2D irradianceMap;
+uniform sampler2D prefilterMap;
+uniform sampler2D brdfLUT;
+
+@header "pbr_functions.glsl";
+@header "gbuffer.glsl";
+
+void main()
+{
+	vec3 N = normalize(Normal);
+
+	// Le clamping utilise les dérivées écran de N : il doit être fait
+	// ici, pas dans la résolution (voisins d'une autre sphère)
+	float roughness = max(compute_roughness_clamping(N, Roughness), 0.04);
+
+	GAlbedoAO = vec4(Albedo, AO);
+	GNormal = encodeOctahedral(N);
+	GMaterial = vec2(Metallic, roughness);
+
+	vec2 currentPosNDC = CurrentClipPos.xy / CurrentClipPos.w;
+	vec2 previousPosNDC = PreviousClipPos.xy / PreviousClipPos.w;
+	VelocityOut = (currentPosNDC - previousPosNDC) * 0.5;
+}
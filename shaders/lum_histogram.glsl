@@ -0,0 +1,24 @@
+/*
+ * Log-luminance histogram shared by lum_histogram.comp (build) and
+ * lum_adapt.comp (reduce). Bin 0 holds the pixels darker than minLogLum
+ * (black background, dark corners): they are counted but kept out of the
+ * average. Bins 1..255 split [minLogLum, minLogLum + logLumRange] evenly.
+ * LUM_HISTOGRAM_BINS matches fx_auto_exposure.h.
+ */
+#define LUM_HISTOGRAM_BINS 256
+
+layout(std430, binding = 0) buffer LumHistogram
+{
+	uint bins[LUM_HISTOGRAM_BINS];      /* Frame en cours, remis à 0 */
+	uint debugBins[LUM_HISTOGRAM_BINS]; /* Copie pour l'overlay */
+};
+
+uniform float minLogLum;
+uniform float logLumRange;
+
+/* Center of bin 1..255 in log2 luminance */
+float binLogLum(int bin)
+{
+	return minLogLum +
+	       (float(bin) - 0.5) / float(LUM_HISTOGRAM_BINS - 1) * logLumRange;
+}
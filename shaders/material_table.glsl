@@ -0,0 +1,45 @@
+// ----------------------------------------------------------------------------
+// Material table (MaterialTable in material.h, MATERIAL_TABLE_BINDING) and
+// SphereInstanceCompact decoding
+// ----------------------------------------------------------------------------
+
+// Two vec4 per material: (albedo, metallic), (roughness, ao, -, -)
+layout(std430, binding = 5) readonly buffer MaterialTableBuffer {
+	vec4 materialTable[];
+};
+
+struct MaterialData {
+	vec3 albedo;
+	float metallic;
+	float roughness;
+	float ao;
+};
+
+MaterialData fetchMaterial(uint index)
+{
+	vec4 albedoMetallic = materialTable[index * 2u];
+	vec4 pbr = materialTable[index * 2u + 1u];
+
+	MaterialData material;
+	material.albedo = albedoMetallic.rgb;
+	material.metallic = albedoMetallic.a;
+	material.roughness = pbr.x;
+	material.ao = pbr.y;
+	return material;
+}
+
+// scale_material = half(scale) << 16 | material index
+float compactScale(uint scaleMaterial)
+{
+	return unpackHalf2x16(scaleMaterial >> 16u).x;
+}
+
+uint compactMaterial(uint scaleMaterial)
+{
+	return scaleMaterial & 0xFFFFu;
+}
+
+uint packCompactScaleMaterial(float scale, uint material)
+{
+	return (packHalf2x16(vec2(scale, 0.0)) << 16u) | (material & 0xFFFFu);
+}
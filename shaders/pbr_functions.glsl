@@ -87,11 +87,114 @@ float compute_roughness_clamping(vec3 N, float roughness)
 	return roughness;
 }
 
+// ----------------------------------------------------------------------------
+// Clustered Analytic Lights (lists built by light_cull.comp)
+// ----------------------------------------------------------------------------
+const uvec3 CLUSTER_GRID = uvec3(16u, 9u, 24u);
+const uint CLUSTER_COUNT = CLUSTER_GRID.x * CLUSTER_GRID.y * CLUSTER_GRID.z;
+
+struct AnalyticLight {
+	vec4 positionRange;     // xyz: world position, w: range
+	vec4 colorCosInner;     // rgb: color * intensity, w: spot inner cos
+	vec4 directionCosOuter; // xyz: spot axis, w: outer cos (< -1: point)
+};
+
+layout(std430, binding = 6) readonly buffer AnalyticLights {
+	AnalyticLight lights[];
+};
+
+layout(std430, binding = 7) readonly buffer LightClusters {
+	uint lightIndexCount;
+	uint lightIndexCapacity;
+	uvec2 clusterRanges[CLUSTER_COUNT]; // x: first index, y: count
+	uint lightIndices[];
+};
+
+uniform int lightCount;       // 0: analytic lighting disabled
+uniform vec2 clusterTileScale; // CLUSTER_GRID.xy / viewport size
+uniform vec3 clusterDepth;    // near, far, CLUSTER_GRID.z / log(far / near)
+
+uint cluster_index(float windowDepth)
+{
+	float near = clusterDepth.x;
+	float far = clusterDepth.y;
+	float ndc = windowDepth * 2.0 - 1.0;
+	float viewDepth = 2.0 * near * far / (far + near - ndc * (far - near));
+
+	float slice = log(max(viewDepth, near) / near) * clusterDepth.z;
+	uint z = min(uint(slice), CLUSTER_GRID.z - 1u);
+	uvec2 tile = min(uvec2(gl_FragCoord.xy * clusterTileScale),
+	                 CLUSTER_GRID.xy - 1u);
+	return (z * CLUSTER_GRID.y + tile.y) * CLUSTER_GRID.x + tile.x;
+}
+
+vec3 evaluate_light(AnalyticLight light, vec3 P, vec3 N, vec3 V, vec3 F0,
+                    vec3 albedo, float metallic, float roughness)
+{
+	vec3 toLight = light.positionRange.xyz - P;
+	float dist2 = dot(toLight, toLight);
+	float range = light.positionRange.w;
+	vec3 L = toLight * inversesqrt(max(dist2, EPSILON));
+	float NdotL = dot(N, L);
+	if (dist2 >= range * range || NdotL <= 0.0) {
+		return vec3(0.0);
+	}
+
+	// Inverse square, windowed to reach zero at the range (UE4)
+	float ratio2 = dist2 / (range * range);
+	float window = clamp(1.0 - ratio2 * ratio2, 0.0, 1.0);
+	float attenuation = window * window / (dist2 + 1.0);
+
+	float cosOuter = light.directionCosOuter.w;
+	if (cosOuter >= -1.0) {
+		float cosAngle = dot(-L, light.directionCosOuter.xyz);
+		attenuation *=
+		    smoothstep(cosOuter, light.colorCosInner.w, cosAngle);
+	}
+
+	// Cook-Torrance: GGX, Smith-Schlick, Fresnel-Schlick
+	vec3 H = normalize(V + L);
+	float NdotV = max(dot(N, V), EPSILON);
+	float NdotH = max(dot(N, H), 0.0);
+	float a = roughness * roughness;
+	float a2 = a * a;
+	float d = NdotH * NdotH * (a2 - 1.0) + 1.0;
+	float D = a2 / (PI * d * d);
+	float k = (roughness + 1.0) * (roughness + 1.0) / 8.0;
+	float G = NdotV / (NdotV * (1.0 - k) + k) *
+	          (NdotL / (NdotL * (1.0 - k) + k));
+	vec3 F = F0 + (1.0 - F0) * pow(1.0 - max(dot(H, V), 0.0), 5.0);
+
+	vec3 specular = D * G * F / max(4.0 * NdotV * NdotL, EPSILON);
+	vec3 kD = (1.0 - F) * (1.0 - metallic);
+	return (kD * albedo * INV_PI + specular) * light.colorCosInner.rgb *
+	       (attenuation * NdotL);
+}
+
+// Only the lights of the fragment's cluster are visited
+vec3 compute_clustered_lights(vec3 P, float windowDepth, vec3 N, vec3 V,
+                              vec3 albedo, float metallic, float roughness)
+{
+	if (lightCount == 0) {
+		return vec3(0.0);
+	}
+
+	uvec2 range = clusterRanges[cluster_index(windowDepth)];
+	vec3 F0 = mix(vec3(0.04), albedo, metallic);
+	vec3 color = vec3(0.0);
+	for (uint i = 0u; i < range.y; i++) {
+		AnalyticLight light = lights[lightIndices[range.x + i]];
+		color += evaluate_light(light, P, N, V, F0, albedo, metallic,
+		                        roughness);
+	}
+	return color;
+}
+
 // ----------------------------------------------------------------------------
 // Master Function: Compute Shading
 // ----------------------------------------------------------------------------
-vec3 compute_pbr(vec3 N, vec3 V, vec3 albedo, float metallic, float roughness,
-                 float ao)
+vec3 compute_pbr(vec3 P, float windowDepth, vec3 N, vec3 V, vec3 albedo,
+                 float metallic, float roughness, float ao)
 {
 	vec3 R = reflect(-V, N);
 	float NdotV = max(dot(N, V), 0.0);
@@ -104,6 +207,10 @@ vec3 compute_pbr(vec3 N, vec3 V, vec3 albedo, float metallic, float roughness,
 	// 2. Compute PBR
 	vec3 color = compute_IBL_PBR_Advanced(N, V, R, F0, NdotV, albedo,
 	                                      metallic, clamped_roughness, ao);
+
+	// 3. Analytic lights
+	color += compute_clustered_lights(P, windowDepth, N, V, albedo,
+	                                  metallic, clamped_roughness);
 	return color;
 }
 
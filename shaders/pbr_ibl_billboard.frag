@@ -3,6 +3,11 @@
 layout(location = 0) out vec4 FragColor;
 layout(location = 1) out vec2 VelocityOut;
 
+// The quad lies on the sphere's front tangent plane (see the vertex shader),
+// so the ray-traced depth is never closer than the rasterized one: early-Z
+// stays enabled.
+layout(depth_greater) out float gl_FragDepth;
+
 in vec3 WorldPos;  // Position on the billboard plane
 in vec3 Normal;    // Synchronized (unused)
 in vec3 SphereCenter;
@@ -28,32 +33,8 @@ uniform mat4 previousViewProj;
 // Include common PBR functions
 @header "pbr_functions.glsl";
 
-// ----------------------------------------------------------------------------
-// Ray-Sphere Intersection
-// ----------------------------------------------------------------------------
-bool intersectSphere(vec3 ro, vec3 rd, vec3 center, float radius, out float t,
-                     out vec3 normal)
-{
-	vec3 oc = ro - center;
-	float b = dot(oc, rd);
-	float c = dot(oc, oc) - radius * radius;
-	float h = b * b - c;
-
-	if (h < 0.0)
-		return false;  // No intersection
-
-	h = sqrt(h);
-	// Intersection t
-	t = -b - h;
-
-	if (t < 0.0) {
-		return false;
-	}
-
-	vec3 hitPos = ro + t * rd;
-	normal = normalize(hitPos - center);
-	return true;
-}
+// Ray-sphere intersection
+@header "sphere_impostor.glsl";
 
 void main()
 {
@@ -89,7 +70,8 @@ void main()
 		color = compute_debug(N, V, Albedo, Metallic, Roughness, AO,
 		                      debugMode);
 	} else {
-		color = compute_pbr(N, V, Albedo, Metallic, Roughness, AO);
+		color = compute_pbr(sphereHitPos, gl_FragDepth, N, V, Albedo,
+		                    Metallic, Roughness, AO);
 	}
 
 	FragColor = vec4(color, 1.0);
@@ -1,7 +1,6 @@
 #version 450 core
 
 layout(location = 0) in vec3 in_position;  // Quad vertex in local space (+-0.5)
-layout(location = 1) in vec3 in_normal;    // Synchronized slot (unused here)
 
 // Per-instance attributes (same slots as mesh rendering for compatibility)
 layout(location = 2) in mat4 i_model;   // Instance Model Matrix
@@ -22,58 +21,26 @@ out vec4 PreviousClipPos;
 
 uniform mat4 projection;
 uniform mat4 view;
-uniform mat4 previousViewProj;  // Kept for interface compatibility, maybe
-                                // unused for billboards initially
+uniform mat4 previousViewProj;
 
-// We need to calculate the billboard size to bound the sphere
-// The sphere is at i_model[3].xyz
-// The scale is extracts from i_model columns lengths. Assuming uniform scale
-// for spheres.
+// Measurement only (billboard_stats): 1 = legacy camera-facing quad of side
+// 3R centered on the sphere, used as the "before" reference.
+uniform int legacyBounds;
+
+@header "sphere_billboard.glsl";
 
 void main()
 {
-	// Extract scale from model matrix (assuming uniform scale)
+	// Icosphere vertices lie on the unit sphere, so radius == model scale
 	float scaleX = length(vec3(i_model[0]));
 	float scaleY = length(vec3(i_model[1]));
 	float scaleZ = length(vec3(i_model[2]));
-	float maxScale = max(scaleX, max(scaleY, scaleZ));
-
-	SphereRadius = maxScale * 0.5;  // Model is usually diameter 1 or radius
-	                                // 1? Icosphere is radius 1?
-	// Let's check icosphere generation. It uses radius 1. So if model scale
-	// is 1, radius is 1. Since we want diameter 1 to be scale 1 usually,
-	// wait. Icosphere vertices are on unit circle (~1.0). So radius is 1.0.
-	// If I scale by 1.0, the object is radius 1.0.
-	// Wait, typical "unit sphere" is radius 1 or radius 0.5 (diameter 1)?
-	// The existing code uses radius 1.0 (X=0.52... Z=0.85...). distance is
-	// sqrt(0.52^2 + 0.85^2) ~= 1. So existing spheres have Radius = Scale.
-
-	SphereRadius = maxScale;
+	SphereRadius = max(scaleX, max(scaleY, scaleZ));
 	SphereCenter = vec3(i_model[3]);
 
-	// Billboard calculation
-	// We want the quad to always face the camera, but centered at
-	// SphereCenter. Standard billboard technique: Camera Right =
-	// vec3(view[0][0], view[1][0], view[2][0]) Camera Up    =
-	// vec3(view[0][1], view[1][1], view[2][1])
-
-	vec3 camRight = vec3(view[0][0], view[1][0], view[2][0]);
-	vec3 camUp = vec3(view[0][1], view[1][1], view[2][1]);
-
-	// Calculate world position of this vertex (in_position is like (-0.5,
-	// -0.5) to (0.5, 0.5)) We need to scale the quad to cover the sphere.
-	// Radius * 2.0 covers the diameter. Better specific slightly larger to
-	// avoid precision clipping at edges? Let's stick to exact bounds for
-	// now. A sphere of radius R needs a quad of side 2R. If in_position is
-	// in range [-0.5, 0.5], sides are length 1.0. So we multiply by
-	// SphereRadius * 2.0.
-
-	// Add a small padding (1.5x) to ensure the quad covers the sphere even
-	// in perspective projection and to avoid harsh clipping at the edges.
-	float quadSize = SphereRadius * 2.0 * 1.5;
-
-	WorldPos = SphereCenter + camRight * in_position.x * quadSize +
-	           camUp * in_position.y * quadSize;
+	bool visible = placeSphereBillboard(SphereCenter, SphereRadius,
+	                                    in_position.xy, view, projection,
+	                                    legacyBounds != 0, WorldPos);
 
 	Albedo = i_albedo;
 	Metallic = i_pbr.x;
@@ -86,5 +53,6 @@ void main()
 	CurrentClipPos = projection * view * vec4(WorldPos, 1.0);
 	PreviousClipPos = previousViewProj * vec4(WorldPos, 1.0);
 
-	gl_Position = CurrentClipPos;
+	// Degenerate quad outside the clip volume
+	gl_Position = visible ? CurrentClipPos : vec4(2.0, 2.0, 2.0, 1.0);
 }
@@ -0,0 +1,49 @@
+#version 450 core
+
+layout(location = 0) in vec3 in_position;  // Quad vertex in local space (+-0.5)
+
+// SphereInstanceCompact (16 bytes), material fetched from the table
+layout(location = 2) in vec3 i_position;
+layout(location = 3) in uint i_scaleMaterial;
+
+out vec3 WorldPos;
+out vec3 Normal;
+out vec3 SphereCenter;
+out float SphereRadius;
+out vec3 Albedo;
+out float Metallic;
+out float Roughness;
+out float AO;
+
+out vec4 CurrentClipPos;
+out vec4 PreviousClipPos;
+
+uniform mat4 projection;
+uniform mat4 view;
+uniform mat4 previousViewProj;
+
+@header "sphere_billboard.glsl";
+@header "material_table.glsl";
+
+void main()
+{
+	SphereCenter = i_position;
+	SphereRadius = compactScale(i_scaleMaterial);
+
+	bool visible = placeSphereBillboard(SphereCenter, SphereRadius,
+	                                    in_position.xy, view, projection,
+	                                    false, WorldPos);
+
+	MaterialData material = fetchMaterial(compactMaterial(i_scaleMaterial));
+	Albedo = material.albedo;
+	Metallic = material.metallic;
+	Roughness = material.roughness;
+	AO = material.ao;
+
+	Normal = -vec3(view[0][2], view[1][2], view[2][2]);
+
+	CurrentClipPos = projection * view * vec4(WorldPos, 1.0);
+	PreviousClipPos = previousViewProj * vec4(WorldPos, 1.0);
+
+	gl_Position = visible ? CurrentClipPos : vec4(2.0, 2.0, 2.0, 1.0);
+}
@@ -29,7 +29,8 @@ void main()
 	vec3 color = (debugMode != 0)
 	                 ? compute_debug(N, V, Albedo, Metallic, Roughness, AO,
 	                                 debugMode)
-	                 : compute_pbr(N, V, Albedo, Metallic, Roughness, AO);
+	                 : compute_pbr(WorldPos, gl_FragCoord.z, N, V, Albedo,
+	                               Metallic, Roughness, AO);
 
 	FragColor = vec4(color, 1.0);
 
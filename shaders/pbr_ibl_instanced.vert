@@ -1,7 +1,6 @@
 #version 450 core
 
-layout(location = 0) in vec3 in_position;
-layout(location = 1) in vec3 in_normal;
+layout(location = 0) in vec3 in_position;  // Sphère unité : normale = position
 
 // Attributs d'instance (Vertex Attrib Divisor = 1)
 layout(location = 2) in mat4 i_model;   // Emplacement 2, 3, 4, 5
@@ -23,6 +22,9 @@ uniform mat4 previousViewProj;
 out vec4 CurrentClipPos;
 out vec4 PreviousClipPos;
 
+// Même profondeur au bit près que depth_prepass*.vert (GL_LEQUAL)
+invariant gl_Position;
+
 void main()
 {
 	WorldPos = vec3(i_model * vec4(in_position, 1.0));
@@ -31,7 +33,7 @@ void main()
 	// Si vous n'avez pas de scale non-uniforme, mat3(i_model) suffit pour
 	// les performances
 	mat3 normalMatrix = mat3(transpose(inverse(i_model)));
-	Normal = normalize(normalMatrix * in_normal);
+	Normal = normalize(normalMatrix * in_position);
 
 	Albedo = i_albedo;
 	Metallic = i_pbr.x;
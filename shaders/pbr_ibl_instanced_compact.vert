@@ -0,0 +1,44 @@
+#version 450 core
+
+layout(location = 0) in vec3 in_position;  // Sphère unité : normale = position
+
+// SphereInstanceCompact (16 bytes) : position + rayon/matériau empaquetés
+layout(location = 2) in vec3 i_position;
+layout(location = 3) in uint i_scaleMaterial;
+
+out vec3 WorldPos;
+out vec3 Normal;
+out vec3 Albedo;
+out float Metallic;
+out float Roughness;
+out float AO;
+
+uniform mat4 projection;
+uniform mat4 view;
+uniform mat4 previousViewProj;
+
+out vec4 CurrentClipPos;
+out vec4 PreviousClipPos;
+
+// Même profondeur au bit près que depth_prepass*.vert (GL_LEQUAL)
+invariant gl_Position;
+
+@header "material_table.glsl";
+
+void main()
+{
+	// Échelle uniforme, pas de rotation : la normale est inchangée
+	WorldPos = i_position + in_position * compactScale(i_scaleMaterial);
+	Normal = normalize(in_position);
+
+	MaterialData material = fetchMaterial(compactMaterial(i_scaleMaterial));
+	Albedo = material.albedo;
+	Metallic = material.metallic;
+	Roughness = material.roughness;
+	AO = material.ao;
+
+	CurrentClipPos = projection * view * vec4(WorldPos, 1.0);
+	PreviousClipPos = previousViewProj * vec4(WorldPos, 1.0);
+
+	gl_Position = CurrentClipPos;
+}
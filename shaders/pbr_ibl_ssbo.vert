@@ -1,7 +1,6 @@
 #version 440 core
 
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec3 aNormal;
+layout(location = 0) in vec3 aPos; /* Sphère unité : normale = position */
 
 /* SSBO avec les données d'instances */
 struct InstanceData {
@@ -41,7 +40,7 @@ void main()
 	 * normalisée */
 	/* On applique juste la rotation de la matrice model (pas de scale dans
 	 * notre cas) */
-	Normal = normalize(mat3(inst.model) * aNormal);
+	Normal = normalize(mat3(inst.model) * aPos);
 
 	/* Passage des propriétés matériau */
 	Albedo = inst.albedo;
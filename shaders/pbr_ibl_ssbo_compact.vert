@@ -0,0 +1,46 @@
+#version 440 core
+
+layout(location = 0) in vec3 aPos; /* Sphère unité : normale = position */
+
+/* SphereInstanceCompact (16 bytes) : position + rayon/matériau empaquetés */
+struct InstanceData {
+	vec3 position;
+	uint scaleMaterial;
+};
+
+layout(std430, binding = 0) readonly buffer InstanceBuffer
+{
+	InstanceData instances[];
+};
+
+/* Uniforms globaux */
+uniform mat4 projection;
+uniform mat4 view;
+
+/* Outputs vers le fragment shader */
+out vec3 WorldPos;
+out vec3 Normal;
+out vec3 Albedo;
+out float Metallic;
+out float Roughness;
+out float AO;
+
+@header "material_table.glsl";
+
+void main()
+{
+	InstanceData inst = instances[gl_InstanceID];
+
+	/* Échelle uniforme, pas de rotation : la normale est inchangée */
+	WorldPos = inst.position + aPos * compactScale(inst.scaleMaterial);
+	Normal = normalize(aPos);
+
+	/* Propriétés matériau lues dans la table */
+	MaterialData material = fetchMaterial(compactMaterial(inst.scaleMaterial));
+	Albedo = material.albedo;
+	Metallic = material.metallic;
+	Roughness = material.roughness;
+	AO = material.ao;
+
+	gl_Position = projection * view * vec4(WorldPos, 1.0);
+}
@@ -1,12 +1,34 @@
-uniform sampler2D bloomTexture;
+/* Level 0: thresholded scene, level 1: chain already upsampled into it */
+layout(binding = 1) uniform sampler2D bloomTexture;
+layout(binding = 7) uniform sampler2D bloomUpTexture;
 
 /* ============================================================================
    EFFECT: BLOOM
    ============================================================================
  */
 
-vec3 applyBloom(vec3 color)
+/* Last upsample step (level 1 -> 0, 9-tap tent) done here instead of a
+   half-resolution read-modify-write pass */
+vec3 bloomTent(vec2 uv)
 {
-	vec3 bloomColor = texture(bloomTexture, TexCoords).rgb;
+	vec2 d = b_radius / vec2(textureSize(bloomUpTexture, 0));
+	vec3 sum = texture(bloomUpTexture, uv).rgb * 4.0;
+	sum += (texture(bloomUpTexture, uv + vec2(0.0, d.y)).rgb +
+	        texture(bloomUpTexture, uv - vec2(0.0, d.y)).rgb +
+	        texture(bloomUpTexture, uv + vec2(d.x, 0.0)).rgb +
+	        texture(bloomUpTexture, uv - vec2(d.x, 0.0)).rgb) *
+	       2.0;
+	sum += texture(bloomUpTexture, uv + d).rgb +
+	       texture(bloomUpTexture, uv - d).rgb +
+	       texture(bloomUpTexture, uv + vec2(d.x, -d.y)).rgb +
+	       texture(bloomUpTexture, uv + vec2(-d.x, d.y)).rgb;
+	return sum / 16.0;
+}
+
+vec3 applyBloom(vec3 color, vec2 uv)
+{
+	vec2 bloomUV = sceneUV(uv);
+	vec3 bloomColor =
+	    texture(bloomTexture, bloomUV).rgb + bloomTent(bloomUV);
 	return color + bloomColor * b_intensity;
 }
@@ -14,8 +14,8 @@ vec3 applyChromAbbr(vec2 uv)
 	/* Direct texture samples for R/B channels (skip motion blur for
 	 * performance) Trade-off: Only green channel gets motion blur, but CA
 	 * is subtle at edges */
-	float r = texture(screenTexture, uv + direction * ca_strength).r;
-	float b = texture(screenTexture, uv - direction * ca_strength).b;
+	float r = fetchSceneColor(sceneUV(uv + direction * ca_strength)).r;
+	float b = fetchSceneColor(sceneUV(uv - direction * ca_strength)).b;
 
 	return vec3(r, centerBlurred.g, b);
 }
@@ -0,0 +1,42 @@
+/* ============================================================================
+   DEPTH OF FIELD: CIRCLE OF CONFUSION
+   ============================================================================
+ */
+
+/*
+ * Blur factor of a raw depth, 0 in the focal range, 1 fully blurred. Shared
+ * by applyDoF and the tile classifier (postprocess_classify.comp): a tile
+ * whose max factor stays under DOF_MIN_BLUR is composited without DoF.
+ * `dist` is the linear view distance (debug colors).
+ */
+#define DOF_MIN_BLUR 0.01
+
+float dofBlurFactor(float depth, out float dist)
+{
+	/* Calculate Circle of Confusion (CoC) */
+	float zNear = 0.1;
+	float zFar = 1000.0;
+	float z_ndc = 2.0 * depth - 1.0;
+	dist = (2.0 * zNear * zFar) / (zFar + zNear - z_ndc * (zFar - zNear));
+
+	float coc = abs(dist - d_focalDistance) / (dist + 0.0001);
+
+	/* Apply focal range (in-focus zone) */
+	float blurFactor = 0.0;
+	if (dist > d_focalDistance - d_focalRange &&
+	    dist < d_focalDistance + d_focalRange) {
+		blurFactor = 0.0;
+	} else {
+		/* Smooth transition at edges of focal range */
+		float edge = d_focalRange;
+		float distDiff = abs(dist - d_focalDistance);
+		if (distDiff < edge + 5.0) {
+			blurFactor = (distDiff - edge) / 5.0;
+		} else {
+			blurFactor = 1.0;
+		}
+	}
+
+	blurFactor *= clamp(coc * d_bokehScale, 0.0, 1.0);
+	return clamp(blurFactor, 0.0, 1.0);
+}
@@ -0,0 +1,55 @@
+/* ============================================================================
+   COLOR PIPELINE: 3D LUT
+   ============================================================================
+ */
+
+/*
+ * White balance, color grading, tonemapping and gamma depend only on the
+ * exposed color and on rarely edited parameters: postprocess_lut.comp bakes
+ * them (displayTransform) into a size^3 LUT, the composite does one
+ * trilinear fetch.
+ *
+ * The LUT input is log-encoded: log2(c + COLOR_LUT_EPSILON) spans
+ * [log2(epsilon), log2(COLOR_LUT_MAX + epsilon)]. The offset puts black
+ * exactly on the first node (no lifted blacks), the log spreads the nodes
+ * evenly in stops above it. Inputs beyond COLOR_LUT_MAX clamp, where the
+ * tonemapper has already saturated.
+ */
+#define COLOR_LUT_EPSILON (1.0 / 1024.0)
+#define COLOR_LUT_MAX 64.0
+
+layout(binding = 8) uniform sampler3D colorLut;
+
+vec3 colorLutEncode(vec3 color)
+{
+	const float lo = log2(COLOR_LUT_EPSILON);
+	const float hi = log2(COLOR_LUT_MAX + COLOR_LUT_EPSILON);
+	vec3 l = log2(max(color, vec3(0.0)) + COLOR_LUT_EPSILON);
+	return clamp((l - lo) / (hi - lo), 0.0, 1.0);
+}
+
+vec3 colorLutDecode(vec3 t)
+{
+	const float lo = log2(COLOR_LUT_EPSILON);
+	const float hi = log2(COLOR_LUT_MAX + COLOR_LUT_EPSILON);
+	return exp2(mix(vec3(lo), vec3(hi), t)) - COLOR_LUT_EPSILON;
+}
+
+/* Exposed linear HDR -> gamma-encoded display color, what the LUT bakes
+   (needs color_grading.glsl and tonemap.glsl) */
+vec3 displayTransform(vec3 color)
+{
+	if (enableColorGrading) {
+		color = apply_color_grading(color);
+	}
+	color = unrealTonemap(color);
+	return pow(color, vec3(1.0 / 2.2));
+}
+
+vec3 sampleColorLut(vec3 color)
+{
+	/* Node centers: t = 0 and t = 1 land on the first and last texels */
+	float size = float(textureSize(colorLut, 0).x);
+	vec3 uvw = colorLutEncode(color) * ((size - 1.0) / size) + 0.5 / size;
+	return texture(colorLut, uvw).rgb;
+}
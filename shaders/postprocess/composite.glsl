@@ -0,0 +1,92 @@
+/* ============================================================================
+   MAIN PIPELINE
+   ============================================================================
+ */
+
+/*
+ * Final color of one output pixel (screen UV), shared by the fragment
+ * composite (postprocess.frag) and the compute one (postprocess.comp).
+ * Gamma-encoded, ready for the 8-bit target.
+ */
+vec3 compositePixel(vec2 uv)
+{
+	/* 1. Priority Debug Check for Motion Blur */
+	if (enableMotionBlurDebug) {
+		return applyMotionBlur(uv);
+	}
+
+	vec3 color;
+
+	/* Skybox Hack: Depth ~ 1.0 (only CA needs it, skip the fetch
+	   otherwise) */
+	bool isSkybox = false;
+	if (enableChromAbbr) {
+		float depth = fetchSceneDepth(sceneUV(uv));
+		isSkybox = depth >= 0.99999;
+	}
+
+	/* 2. Pipeline: Motion Blur -> Chromatic Aberration */
+	if (enableChromAbbr && !isSkybox) {
+		/* CA samples "SceneSource" (which calls MB) */
+		color = applyChromAbbr(uv);
+	} else {
+		/* Direct fetch (or MB only) */
+		color = getSceneSource(uv);
+	}
+
+	/* 3. Depth of Field */
+	if (enableDoF) {
+		/* applyDoF handles skybox check internally */
+		vec3 dofColor = applyDoF(color, uv);
+
+		/* Check if it returned a debug visualization (assumed if
+		   drastically different, but applyDoF returns valid color or
+		   debug color. We just assign it.) */
+		color = dofColor;
+	}
+
+	/* 4. Bloom */
+	if (enableBloom) {
+		color = applyBloom(color, uv);
+	}
+
+	/* 5. Exposure */
+	float finalExposure = getCombinedExposure();
+	color *= finalExposure;
+
+	if (enableColorLut) {
+		/* 6, 7, 9. Grading, tonemapping and gamma baked in the LUT */
+		color = sampleColorLut(color);
+
+		/* 8. Vignette, moved past the gamma: pow(c * v, g) =
+		   pow(c, g) * pow(v, g) */
+		if (enableVignette) {
+			color *= pow(vignetteFactor(uv), 1.0 / 2.2);
+		}
+	} else {
+		/* 6. Color Grading & White Balance */
+		if (enableColorGrading) {
+			/* apply_color_grading handles WB internally in our
+			 * new module */
+			color = apply_color_grading(color);
+		}
+
+		/* 7. Tonemapping */
+		color = unrealTonemap(color);
+
+		/* 8. Vignette */
+		if (enableVignette) {
+			color = applyVignette(color, uv);
+		}
+
+		/* 9. Gamma Correction */
+		color = pow(color, vec3(1.0 / 2.2));
+	}
+
+	/* 10. Grain */
+	if (enableGrain) {
+		color = applyGrain(color, uv);
+	}
+
+	return color;
+}
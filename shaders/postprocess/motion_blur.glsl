@@ -1,16 +1,17 @@
-uniform sampler2D velocityTexture;
-uniform sampler2D neighborMaxTexture;
-
 /* ============================================================================
    EFFECT: MOTION BLUR
    ============================================================================
  */
 
-/* Advanced Reconstruction using NeighborMax and Depth Weighting */
+/* Advanced Reconstruction using NeighborMax and Depth Weighting.
+   uv and velocities are in screen UV, fetches go through sceneUV() and the
+   fetch*() helpers (scene_fetch.glsl or scene_tile.glsl) */
 vec3 applyMotionBlur(vec2 uv)
 {
+	vec2 centerUV = sceneUV(uv);
+
 	/* 1. Get Velocity at center pixel */
-	vec2 velocity = texture(velocityTexture, uv).rg;
+	vec2 velocity = texture(velocityTexture, centerUV).rg;
 
 	/* Debug Visualization (Early Exit) */
 	if (enableMotionBlurDebug) {
@@ -29,11 +30,11 @@ vec3 applyMotionBlur(vec2 uv)
 
 	/* 2. Get Neighbor Max Velocity */
 	vec2 maxNeighborVelocity =
-	    texture(neighborMaxTexture, uv).rg * mb_intensity;
+	    fetchNeighborMaxVelocity(centerUV) * mb_intensity;
 	float maxNeighborSpeed = length(maxNeighborVelocity);
 
 	/* Fetch Center Color (Raw) */
-	vec3 centerColor = texture(screenTexture, uv).rgb;
+	vec3 centerColor = sampleScene(uv);
 
 	/* Early exit if negligible motion */
 	if (speed < 0.0001 && maxNeighborSpeed < 0.0001) {
@@ -41,10 +42,10 @@ vec3 applyMotionBlur(vec2 uv)
 	}
 
 	/* Jitter */
-	float noise = InterleavedGradientNoise(gl_FragCoord.xy);
+	float noise = InterleavedGradientNoise(pixelPosition());
 
 	/* Center Depth */
-	float centerDepth = linearizeDepth(texture(depthTexture, uv).r);
+	float centerDepth = linearizeDepth(fetchSceneDepth(centerUV));
 
 	vec3 acc = centerColor;
 	float totalWeight = 1.0;
@@ -56,15 +57,14 @@ vec3 applyMotionBlur(vec2 uv)
 			continue;  // Skip center
 
 		float t = mix(-0.5, 0.5, (float(i) + noise) / float(samples));
-		vec2 sampleUV = uv + velocity * t;
+		vec2 sampleUV = sceneUV(uv + velocity * t);
 
 		/* Always sample RAW screen texture here.
 		   (CA is applied *after* this function returns) */
-		vec3 sampleColor = texture(screenTexture, sampleUV).rgb;
+		vec3 sampleColor = fetchSceneColor(sampleUV);
 
 		/* Depth Weighting */
-		float sampleDepth =
-		    linearizeDepth(texture(depthTexture, sampleUV).r);
+		float sampleDepth = linearizeDepth(fetchSceneDepth(sampleUV));
 		float depthDiff = sampleDepth - centerDepth;
 		float weight = 1.0;
 
@@ -89,5 +89,5 @@ vec3 getSceneSource(vec2 uv)
 	if (enableMotionBlur) {
 		return applyMotionBlur(uv);
 	}
-	return texture(screenTexture, uv).rgb;
+	return sampleScene(uv);
 }
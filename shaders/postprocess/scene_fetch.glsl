@@ -0,0 +1,36 @@
+/* ============================================================================
+   SCENE FETCH: FRAGMENT PATH
+   ============================================================================
+ */
+
+/*
+ * Scene fetches used by the composite effects. The fragment path reads the
+ * textures directly; the compute path (scene_tile.glsl) provides the same
+ * functions backed by a shared-memory tile.
+ */
+layout(binding = 4) uniform sampler2D velocityTexture;
+layout(binding = 5) uniform sampler2D neighborMaxTexture;
+
+/* Bilinear scene color at a scene UV */
+vec3 fetchSceneColor(vec2 sceneUv)
+{
+	return texture(screenTexture, sceneUv).rgb;
+}
+
+/* Raw (non-linear) depth at a scene UV */
+float fetchSceneDepth(vec2 sceneUv)
+{
+	return texture(depthTexture, sceneUv).r;
+}
+
+/* Largest velocity around this pixel (tile max of the 3x3 neighbors) */
+vec2 fetchNeighborMaxVelocity(vec2 sceneUv)
+{
+	return texture(neighborMaxTexture, sceneUv).rg;
+}
+
+/* Output pixel position (noise seeds) */
+vec2 pixelPosition()
+{
+	return gl_FragCoord.xy;
+}
@@ -0,0 +1,119 @@
+/* ============================================================================
+   SCENE FETCH: COMPUTE PATH (SHARED-MEMORY TILE)
+   ============================================================================
+ */
+
+/*
+ * Each work group loads the scene texels under its output tile, plus an
+ * apron, into shared memory once. The motion blur taps, the chromatic
+ * aberration taps and the depth reads of every effect then come from the
+ * tile; taps that land outside it fall back to the textures.
+ *
+ * The tile lives in scene texel space: with dynamic resolution the scene
+ * footprint of the 16x16 output tile is smaller than 16 texels, so it
+ * still fits.
+ *
+ * The velocity neighborhood (the tile-max / neighbor-max passes of the
+ * fragment path) is reduced here too (tile_velocity.glsl), or read back
+ * from the classifier in the tile class permutations (POSTFX_TILE_CLASS).
+ *
+ * main() sets compositeTile, the output tile of the group, before
+ * loadSceneTile(): the class permutations take it from their tile list.
+ */
+#define SCENE_TILE_GROUP 16
+#define SCENE_TILE_APRON 8
+#define SCENE_TILE_SIZE (SCENE_TILE_GROUP + 2 * SCENE_TILE_APRON)
+#define SCENE_TILE_TEXELS (SCENE_TILE_SIZE * SCENE_TILE_SIZE)
+#define SCENE_TILE_THREADS (SCENE_TILE_GROUP * SCENE_TILE_GROUP)
+
+layout(binding = 4) uniform sampler2D velocityTexture;
+
+@header "tile_velocity.glsl";
+
+shared vec4 tileScene[SCENE_TILE_TEXELS]; /* rgb: color, a: raw depth */
+
+ivec2 compositeTile;    /* Output tile of the group */
+ivec2 tileOrigin;       /* Scene texel of tileScene[0] */
+vec2 tileMaxVelocity;   /* Neighborhood max, read by motion blur */
+
+/* Must be called by every invocation of the group (barriers) */
+void loadSceneTile()
+{
+	ivec2 sceneSize = textureSize(screenTexture, 0);
+	vec2 groupPixel = vec2(compositeTile) * float(SCENE_TILE_GROUP);
+	ivec2 groupTexel = ivec2(floor(groupPixel * renderScale));
+	tileOrigin = groupTexel - SCENE_TILE_APRON;
+
+	int local = int(gl_LocalInvocationIndex);
+	for (int i = local; i < SCENE_TILE_TEXELS; i += SCENE_TILE_THREADS) {
+		ivec2 offset = ivec2(i % SCENE_TILE_SIZE, i / SCENE_TILE_SIZE);
+		/* Same clamp as GL_CLAMP_TO_EDGE */
+		ivec2 texel = clamp(tileOrigin + offset, ivec2(0),
+		                    sceneSize - 1);
+		tileScene[i] = vec4(texelFetch(screenTexture, texel, 0).rgb,
+		                    texelFetch(depthTexture, texel, 0).r);
+	}
+
+	tileMaxVelocity = vec2(0.0);
+	if (enableMotionBlur) {
+#ifdef POSTFX_TILE_CLASS
+		/* Already reduced by the classifier */
+		tileMaxVelocity = tileMaxVelocities[tileIndex(compositeTile)];
+#else
+		tileMaxVelocity = reduceNeighborhoodVelocity(groupTexel);
+#endif
+	}
+
+	barrier();
+}
+
+bool inSceneTile(ivec2 index, int margin)
+{
+	return all(greaterThanEqual(index, ivec2(0))) &&
+	       all(lessThan(index, ivec2(SCENE_TILE_SIZE - margin)));
+}
+
+vec4 tileTexel(ivec2 index)
+{
+	return tileScene[index.y * SCENE_TILE_SIZE + index.x];
+}
+
+/* Bilinear scene color at a scene UV (same weights as the sampler) */
+vec3 fetchSceneColor(vec2 sceneUv)
+{
+	vec2 p = sceneUv * vec2(textureSize(screenTexture, 0)) - 0.5;
+	ivec2 index = ivec2(floor(p)) - tileOrigin;
+	if (!inSceneTile(index, 1)) {
+		return texture(screenTexture, sceneUv).rgb;
+	}
+
+	vec2 f = fract(p);
+	vec3 c00 = tileTexel(index).rgb;
+	vec3 c10 = tileTexel(index + ivec2(1, 0)).rgb;
+	vec3 c01 = tileTexel(index + ivec2(0, 1)).rgb;
+	vec3 c11 = tileTexel(index + ivec2(1, 1)).rgb;
+	return mix(mix(c00, c10, f.x), mix(c01, c11, f.x), f.y);
+}
+
+/* Raw depth at a scene UV (nearest, like the depth sampler) */
+float fetchSceneDepth(vec2 sceneUv)
+{
+	vec2 p = sceneUv * vec2(textureSize(depthTexture, 0));
+	ivec2 index = ivec2(floor(p)) - tileOrigin;
+	if (!inSceneTile(index, 0)) {
+		return texture(depthTexture, sceneUv).r;
+	}
+	return tileTexel(index).a;
+}
+
+vec2 fetchNeighborMaxVelocity(vec2 sceneUv)
+{
+	return tileMaxVelocity;
+}
+
+vec2 pixelPosition()
+{
+	return vec2(compositeTile * SCENE_TILE_GROUP +
+	            ivec2(gl_LocalInvocationID.xy)) +
+	       0.5;
+}
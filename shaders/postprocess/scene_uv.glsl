@@ -0,0 +1,12 @@
+/*
+ * The scene targets keep their full-window size; with dynamic resolution the
+ * scene only covers the bottom-left renderScale fraction of them. Every
+ * scene-space fetch goes through sceneUV(), the output stays in screen UV.
+ */
+vec2 sceneUV(vec2 uv)
+{
+	/* Stay half a texel inside the region: bilinear taps must not reach
+	   the cleared texels beyond it */
+	vec2 texel = 1.0 / vec2(textureSize(screenTexture, 0));
+	return min(uv * renderScale, renderScale - 0.5 * texel);
+}
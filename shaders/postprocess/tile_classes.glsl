@@ -0,0 +1,43 @@
+/* ============================================================================
+   COMPOSITE TILE CLASSES
+   ============================================================================
+ */
+
+/*
+ * Written by postprocess_classify.comp, read by the per-class permutations
+ * of postprocess.comp (POSTFX_TILE_CLASS). Layout mirrors
+ * TileClassifyHeader (fx_tile_classify.h).
+ */
+#define TILE_CLASS_SKIP 0  /* Neither DoF nor motion blur */
+#define TILE_CLASS_CHEAP 1 /* DoF blend only */
+#define TILE_CLASS_FULL 2  /* Motion blur (+ DoF) */
+#define TILE_CLASS_COUNT 3
+
+layout(std430, binding = 3) buffer TileLists
+{
+	/* x: tiles in the class (atomic), y = z = 1: indirect dispatch */
+	uvec4 tileDispatch[TILE_CLASS_COUNT];
+	uvec4 tileGrid; /* Tiles in x, in y, capacity of one list */
+	uint tileList[]; /* Class c at [c * tileGrid.z], x | y << 16 */
+};
+
+/* Neighborhood max velocity of each tile, row-major */
+layout(std430, binding = 4) buffer TileVelocity
+{
+	vec2 tileMaxVelocities[];
+};
+
+uint packTile(ivec2 tile)
+{
+	return uint(tile.x) | (uint(tile.y) << 16u);
+}
+
+ivec2 unpackTile(uint value)
+{
+	return ivec2(value & 0xFFFFu, value >> 16u);
+}
+
+uint tileIndex(ivec2 tile)
+{
+	return uint(tile.y) * tileGrid.x + uint(tile.x);
+}
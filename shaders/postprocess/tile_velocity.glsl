@@ -0,0 +1,48 @@
+/* ============================================================================
+   VELOCITY NEIGHBORHOOD OF A COMPOSITE TILE
+   ============================================================================
+ */
+
+/*
+ * Largest velocity around a 16x16 output tile: max over its scene texels
+ * plus one tile of margin on each side (what the tile-max / neighbor-max
+ * passes give the fragment path). Needs velocityTexture; every invocation
+ * of the group must call it (barriers).
+ */
+#define VELOCITY_GROUP 16
+#define VELOCITY_THREADS (VELOCITY_GROUP * VELOCITY_GROUP)
+#define VELOCITY_NEIGHBORHOOD (3 * VELOCITY_GROUP)
+
+shared vec2 groupVelocity[VELOCITY_THREADS];
+
+vec2 reduceNeighborhoodVelocity(ivec2 groupTexel)
+{
+	ivec2 sceneSize = textureSize(velocityTexture, 0);
+	int local = int(gl_LocalInvocationIndex);
+	vec2 maxVelocity = vec2(0.0);
+	ivec2 base = groupTexel - VELOCITY_GROUP;
+	const int count = VELOCITY_NEIGHBORHOOD * VELOCITY_NEIGHBORHOOD;
+	for (int i = local; i < count; i += VELOCITY_THREADS) {
+		ivec2 offset = ivec2(i % VELOCITY_NEIGHBORHOOD,
+		                     i / VELOCITY_NEIGHBORHOOD);
+		ivec2 texel = clamp(base + offset, ivec2(0), sceneSize - 1);
+		vec2 v = texelFetch(velocityTexture, texel, 0).rg;
+		if (dot(v, v) > dot(maxVelocity, maxVelocity)) {
+			maxVelocity = v;
+		}
+	}
+	groupVelocity[local] = maxVelocity;
+	barrier();
+
+	for (int s = VELOCITY_THREADS / 2; s > 0; s >>= 1) {
+		if (local < s) {
+			vec2 v1 = groupVelocity[local];
+			vec2 v2 = groupVelocity[local + s];
+			if (dot(v2, v2) > dot(v1, v1)) {
+				groupVelocity[local] = v2;
+			}
+		}
+		barrier();
+	}
+	return groupVelocity[0];
+}
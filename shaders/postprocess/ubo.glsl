@@ -3,8 +3,7 @@ layout(std140, binding = 0) uniform PostProcessBlock
 {
 	uint activeEffects;
 	float time;
-	float _pad0_0;
-	float _pad0_1;
+	vec2 renderScale; /* Scene region / target size (dynamic res.) */
 
 	/* Vignette (16 bytes) */
 	float v_intensity;
@@ -79,16 +78,30 @@ layout(std140, binding = 0) uniform PostProcessBlock
 	float _pad9;
 };
 
+/* Effect mask: specialized permutations get it as a compile-time constant
+   (POSTFX_VARIANT_MASK, injected by postprocess_variants.c) so disabled
+   effects are stripped; the uber-shader reads it from the UBO. The tile
+   class permutations of postprocess.comp (POSTFX_TILE_EFFECT_MASK) strip
+   the effects their tiles do not need from the runtime mask. */
+#ifdef POSTFX_VARIANT_MASK
+#define effectMask POSTFX_VARIANT_MASK
+#elif defined(POSTFX_TILE_EFFECT_MASK)
+#define effectMask (activeEffects & POSTFX_TILE_EFFECT_MASK)
+#else
+#define effectMask activeEffects
+#endif
+
 /* Compatibility Helper Macros */
-#define enableVignette ((activeEffects & (1u << 0u)) != 0u)
-#define enableGrain ((activeEffects & (1u << 1u)) != 0u)
-#define enableExposure ((activeEffects & (1u << 2u)) != 0u)
-#define enableChromAbbr ((activeEffects & (1u << 3u)) != 0u)
-#define enableBloom ((activeEffects & (1u << 4u)) != 0u)
-#define enableColorGrading ((activeEffects & (1u << 5u)) != 0u)
-#define enableDoF ((activeEffects & (1u << 6u)) != 0u)
-#define enableDoFDebug ((activeEffects & (1u << 7u)) != 0u)
-#define enableAutoExposure ((activeEffects & (1u << 8u)) != 0u)
-#define enableExposureDebug ((activeEffects & (1u << 9u)) != 0u)
-#define enableMotionBlur ((activeEffects & (1u << 10u)) != 0u)
-#define enableMotionBlurDebug ((activeEffects & (1u << 11u)) != 0u)
+#define enableVignette ((effectMask & (1u << 0u)) != 0u)
+#define enableGrain ((effectMask & (1u << 1u)) != 0u)
+#define enableExposure ((effectMask & (1u << 2u)) != 0u)
+#define enableChromAbbr ((effectMask & (1u << 3u)) != 0u)
+#define enableBloom ((effectMask & (1u << 4u)) != 0u)
+#define enableColorGrading ((effectMask & (1u << 5u)) != 0u)
+#define enableDoF ((effectMask & (1u << 6u)) != 0u)
+#define enableDoFDebug ((effectMask & (1u << 7u)) != 0u)
+#define enableAutoExposure ((effectMask & (1u << 8u)) != 0u)
+#define enableExposureDebug ((effectMask & (1u << 9u)) != 0u)
+#define enableMotionBlur ((effectMask & (1u << 10u)) != 0u)
+#define enableMotionBlurDebug ((effectMask & (1u << 11u)) != 0u)
+#define enableColorLut ((effectMask & (1u << 12u)) != 0u)
@@ -0,0 +1,56 @@
+/* ============================================================================
+   DYNAMIC RESOLUTION: SCENE REGION + UPSCALE
+   ============================================================================
+ */
+
+@header "scene_uv.glsl";
+
+/*
+ * Catmull-Rom bicubic in 9 bilinear taps (the middle pair of weights is
+ * folded into one tap per axis). Sharper than bilinear when the region is
+ * stretched back to the window; the negative lobes can ring below zero on
+ * HDR edges, hence the final max().
+ */
+vec3 sampleSceneBicubic(vec2 uv)
+{
+	vec2 texSize = vec2(textureSize(screenTexture, 0));
+	vec2 samplePos = uv * texSize;
+	vec2 texPos1 = floor(samplePos - 0.5) + 0.5;
+	vec2 f = samplePos - texPos1;
+
+	vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+	vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+	vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+	vec2 w3 = f * f * (-0.5 + 0.5 * f);
+	vec2 w12 = w1 + w2;
+
+	/* Tap centers clamped to the rendered region */
+	vec2 lo = 0.5 / texSize;
+	vec2 hi = renderScale - lo;
+	vec2 uv0 = clamp((texPos1 - 1.0) / texSize, lo, hi);
+	vec2 uv12 = clamp((texPos1 + w2 / w12) / texSize, lo, hi);
+	vec2 uv3 = clamp((texPos1 + 2.0) / texSize, lo, hi);
+
+	vec2 tapUV[3] = vec2[3](uv0, uv12, uv3);
+	vec2 tapWeight[3] = vec2[3](w0, w12, w3);
+
+	vec3 result = vec3(0.0);
+	for (int y = 0; y < 3; y++) {
+		for (int x = 0; x < 3; x++) {
+			vec2 tap = vec2(tapUV[x].x, tapUV[y].y);
+			result += texture(screenTexture, tap).rgb *
+			          tapWeight[x].x * tapWeight[y].y;
+		}
+	}
+
+	return max(result, vec3(0.0));
+}
+
+/* Scene color at a screen UV: plain fetch at native resolution */
+vec3 sampleScene(vec2 uv)
+{
+	if (renderScale.x >= 1.0 && renderScale.y >= 1.0) {
+		return fetchSceneColor(uv);
+	}
+	return sampleSceneBicubic(sceneUV(uv));
+}
@@ -22,11 +22,9 @@ float sdRoundedBox(vec2 p, vec2 b, float r)
 	return length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - r;
 }
 
-vec3 applyVignette(vec3 color, vec2 uv)
+/* Darkening factor of the vignette at uv (1.0: untouched) */
+float vignetteFactor(vec2 uv)
 {
-	if (!enableVignette)
-		return color;
-
 	/* Center UVs: (-1 to 1) */
 	vec2 uv_centered = uv * 2.0 - 1.0;
 
@@ -118,7 +116,13 @@ vec3 applyVignette(vec3 color, vec2 uv)
 	/* Apply Intensity: Mix between 1.0 (no vignette) and Factor */
 	/* Actually intensity usually means "how dark is the darkness" */
 
-	float final_mask = mix(1.0, factor, v_intensity);
+	return mix(1.0, factor, v_intensity);
+}
+
+vec3 applyVignette(vec3 color, vec2 uv)
+{
+	if (!enableVignette)
+		return color;
 
-	return color * final_mask;
+	return color * vignetteFactor(uv);
 }
@@ -0,0 +1,80 @@
+// ----------------------------------------------------------------------------
+// Billboard placement for sphere impostors (shared by the billboard vertex
+// shaders, whatever the instance format)
+// ----------------------------------------------------------------------------
+
+// Exact NDC bounding rectangle of a perspective-projected sphere.
+// "2D Polyhedral Bounds of a Clipped, Perspective-Projected 3D Sphere",
+// Mara & McGuire 2013. c is in view space with +z pointing forward, the
+// projection is assumed symmetric (glm_perspective).
+vec4 projectSphereBounds(vec3 c, float r, float p00, float p11)
+{
+	vec3 cr = c * r;
+	float czr2 = c.z * c.z - r * r;
+
+	float vx = sqrt(c.x * c.x + czr2);
+	float minx = (vx * c.x - cr.z) / (vx * c.z + cr.x);
+	float maxx = (vx * c.x + cr.z) / (vx * c.z - cr.x);
+
+	float vy = sqrt(c.y * c.y + czr2);
+	float miny = (vy * c.y - cr.z) / (vy * c.z + cr.y);
+	float maxy = (vy * c.y + cr.z) / (vy * c.z - cr.y);
+
+	return vec4(minx * p00, miny * p11, maxx * p00, maxy * p11);
+}
+
+// World position of a quad corner (quadPos in +-0.5) tightly bounding the
+// sphere on screen. Returns false when the sphere is entirely behind the near
+// plane (nothing to rasterize). legacyBounds: old 3R camera-facing quad,
+// measurement only.
+bool placeSphereBillboard(vec3 center, float r, vec2 quadPos, mat4 view,
+                          mat4 projection, bool legacyBounds,
+                          out vec3 worldPos)
+{
+	// Camera basis (rows of the view rotation) and world position
+	mat3 viewRot = mat3(view);
+	vec3 camRight = vec3(view[0][0], view[1][0], view[2][0]);
+	vec3 camUp = vec3(view[0][1], view[1][1], view[2][1]);
+	vec3 camBack = vec3(view[0][2], view[1][2], view[2][2]);
+	vec3 camWorld = -(transpose(viewRot) * vec3(view[3]));
+
+	if (legacyBounds) {
+		float quadSize = r * 2.0 * 1.5;
+		worldPos = center + camRight * quadPos.x * quadSize +
+		           camUp * quadPos.y * quadSize;
+		return true;
+	}
+
+	// glm_perspective: [3][2] = 2fn/(n-f), [2][2] = (f+n)/(n-f)
+	float nearPlane = projection[3][2] / (projection[2][2] - 1.0);
+
+	// View space center with +z forward
+	vec3 c = vec3(view * vec4(center, 1.0));
+	c.z = -c.z;
+
+	if (c.z + r < nearPlane) {
+		worldPos = center;
+		return false;
+	}
+
+	vec4 ndcBounds = vec4(-1.0, -1.0, 1.0, 1.0);
+	float planeDepth = nearPlane;
+
+	if (c.z - r > nearPlane) {
+		ndcBounds = projectSphereBounds(c, r, projection[0][0],
+		                                projection[1][1]);
+		// Front tangent plane, pulled slightly towards the camera so
+		// every ray hit lies behind it (depth_greater contract).
+		planeDepth = max(nearPlane, (c.z - r) * 0.9999);
+	}
+	// else: the sphere crosses the near plane, a full-screen quad at the
+	// near plane is the only conservative choice.
+
+	vec2 ndc = mix(ndcBounds.xy, ndcBounds.zw, quadPos + 0.5);
+	vec3 viewPos = vec3(ndc.x * planeDepth / projection[0][0],
+	                    ndc.y * planeDepth / projection[1][1], -planeDepth);
+
+	worldPos = camWorld + camRight * viewPos.x + camUp * viewPos.y +
+	           camBack * viewPos.z;
+	return true;
+}
@@ -0,0 +1,26 @@
+// ----------------------------------------------------------------------------
+// Ray-Sphere Intersection (shared by the impostor shaders)
+// ----------------------------------------------------------------------------
+bool intersectSphere(vec3 ro, vec3 rd, vec3 center, float radius, out float t,
+                     out vec3 normal)
+{
+	vec3 oc = ro - center;
+	float b = dot(oc, rd);
+	float c = dot(oc, oc) - radius * radius;
+	float h = b * b - c;
+
+	if (h < 0.0)
+		return false;  // No intersection
+
+	h = sqrt(h);
+	// Intersection t
+	t = -b - h;
+
+	if (t < 0.0) {
+		return false;
+	}
+
+	vec3 hitPos = ro + t * rd;
+	normal = normalize(hitPos - center);
+	return true;
+}
@@ -3,11 +3,20 @@
 #include "adaptive_sampler.h"
 #include "app_settings.h"
 #include "billboard_rendering.h"
+#include "depth_sort.h"
 #include "fps.h"
 #include "gl_common.h"
 #include "glad/glad.h"
+#include "gpu_readback.h"
+#include "hybrid_rendering.h"
 #include "icosphere.h"
+#include "icosphere_cache.h"
+#include "instance_generator.h"
+#include "instance_sim.h"
+#include "job_system.h"
+#include "instance_stream.h"
 #include "instanced_rendering.h"
+#include "light_clusters.h"
 #include "render_utils.h"
 #include <stb_image.h>
 #ifdef USE_SSBO_RENDERING
@@ -43,6 +52,8 @@
 
 enum { PBR_DEBUG_MODE_COUNT = 9 };
 enum { MAX_PATH_LENGTH = 256 };
+/* Shift+B : cycle des niveaux de bloom, en dessous le halo est trop court */
+enum { BLOOM_MIN_CYCLE_LEVELS = 3 };
 enum {
 	DEBUG_TEXT_BUFFER_SIZE = 128,
 	RANGE_TEXT_BUFFER_SIZE = 64,
@@ -76,6 +87,73 @@ static const vec3 UI_SPINNER_COLOR = {90.0F / 255.0F, 111.0F / 255.0F,
                                       185.0F / 255.0F};
 static const size_t UI_LOADING_TEXT_SIZE = 64;
 
+/* Render mode benchmark (Shift+L) */
+static const char* const RENDER_MODE_NAMES[RENDER_MODE_COUNT] = {
+    "Mesh", "Billboard", "Hybrid"};
+static const int RENDER_BENCH_INSTANCE_COUNTS[RENDER_BENCH_STEPS] = {
+    100, 1000, 10000, 100000};
+static const int RENDER_BENCH_WARMUP_FRAMES = 10;
+static const int RENDER_BENCH_MEASURED_FRAMES = 60;
+
+/* Depth pre-pass / front-to-back benchmark (Ctrl+O) */
+static const char* const DEPTH_BENCH_CONFIG_NAMES[DEPTH_BENCH_CONFIGS] = {
+    "Baseline", "Pre-pass", "Sorted", "Pre-pass + sorted"};
+static const int DEPTH_BENCH_WARMUP_FRAMES = 10;
+static const int DEPTH_BENCH_MEASURED_FRAMES = 60;
+
+/* Forward vs deferred benchmark (Ctrl+I) : rayon = facteur x espacement */
+static const char* const SHADING_PATH_NAMES[2] = {"Forward", "Deferred"};
+static const float DEFERRED_BENCH_RADIUS_SCALES[DEFERRED_BENCH_STEPS] = {
+    0.2F, 0.4F, 0.8F, 1.6F};
+static const int DEFERRED_BENCH_INSTANCES = 10000;
+static const int DEFERRED_BENCH_WARMUP_FRAMES = 10;
+static const int DEFERRED_BENCH_MEASURED_FRAMES = 60;
+
+/* Clustered analytic lights (T, Ctrl+T) */
+static const int LIGHT_STEP_COUNTS[LIGHT_STEPS] = {0, 10, 100, 1000,
+                                                   10000};
+static const uint32_t LIGHT_SEED = 4242U;
+static const int LIGHT_BENCH_WARMUP_FRAMES = 10;
+static const int LIGHT_BENCH_MEASURED_FRAMES = 60;
+
+/* Composite par classes de tuiles (Shift+K, Ctrl+Shift+K) */
+static const char* const TILE_BENCH_STEP_NAMES[TILE_BENCH_STEPS] = {
+    "Static", "Panning"};
+static const char* const TILE_BENCH_PATH_NAMES[2] = {"Full-screen",
+                                                     "Tile classes"};
+static const float TILE_BENCH_PAN_DEGREES = 1.5F; /* Par frame */
+static const int TILE_BENCH_WARMUP_FRAMES = 10;
+static const int TILE_BENCH_MEASURED_FRAMES = 60;
+
+/* Dynamic resolution (Y, Shift+Y) : budget GPU scène + post-processing */
+static const float DRS_TARGET_MS[DRS_TARGET_STEPS] = {16.7F, 8.3F, 4.2F};
+static const float DRS_MIN_SCALE = 0.5F;
+static const float DRS_MAX_SCALE = 1.0F;
+
+/* GPU generated scale test scene (N) */
+static const int SCALE_TEST_COUNTS[SCALE_TEST_STEPS] = {1000, 10000, 100000,
+                                                        1000000};
+static const int SCALE_TEST_REPORT_FRAMES = 120;
+static const float SCALE_TEST_RADIUS = 1.0F;
+
+/* Dynamic instance streaming (U) */
+static const int DYNAMIC_INSTANCE_COUNTS[DYNAMIC_INSTANCE_STEPS] = {
+    1000, 10000, 100000, 1000000};
+static const int DYNAMIC_REPORT_FRAMES = 120;
+static const float DYNAMIC_SPHERE_RADIUS = 0.5F;
+static const uint32_t DYNAMIC_SIM_SEED = 1337U;
+/* Pas max : évite l'effet tunnel après un gel (chargement, debug) */
+static const float DYNAMIC_MAX_DT = 0.1F;
+static const int DYNAMIC_BENCH_WARMUP = 2;
+static const int DYNAMIC_BENCH_ITERATIONS = 10;
+
+/* Sphere vertex stream (Ctrl+L : format, Ctrl+Shift+L : vertex fetch) */
+static const char* const
+    POSITION_FORMAT_NAMES[ICOSPHERE_POSITION_FORMAT_COUNT] = {"float32",
+                                                              "snorm16"};
+static const int VERTEX_BENCH_WARMUP = 2;
+static const int VERTEX_BENCH_ITERATIONS = 20;
+
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 
 static void key_callback(GLFWwindow* window, int key, int scancode, int action,
@@ -97,7 +175,12 @@ static int compute_luminance_histogram(App* app, int* buckets, int size,
 static void draw_luminance_histogram_graph(App* app, const int* buckets,
                                            int size, float min_lum,
                                            float max_lum);
-static void app_update_instancing_mode(App* app);
+static void app_render_benchmark_record(App* app, double gpu_ms, mat4 view,
+                                        mat4 proj, vec3 camera_pos);
+static void app_depth_benchmark_record(App* app, double gpu_ms);
+static void app_deferred_benchmark_record(App* app, double gpu_ms);
+static void app_light_benchmark_record(App* app, double cull_ms,
+                                       double gpu_ms);
 static void app_process_ibl_state_machine(App* app);
 
 static int compare_strings(const void* string_a, const void* string_b)
@@ -195,6 +278,10 @@ int app_init(App* app, int width, int height, const char* title)
 		return 0;
 	}
 
+	/* Job system partagé ; le thread principal possède le slot 0.
+	 * En cas d'échec tout s'exécute sur le thread principal (jobs NULL). */
+	app->jobs = job_system_create(-1);
+
 	/* Disable VSync for performance comparison */
 	glfwSwapInterval(0);
 
@@ -225,14 +312,12 @@ int app_init(App* app, int width, int height, const char* title)
 	LOG_INFO("suckless_ogl.context.base.window", "version: %s",
 	         glGetString(GL_VERSION));
 	LOG_INFO("suckless_ogl.context.base.window", "platform: linux");
-	/* Async PBO Init */
-	glGenBuffers(1, &app->exposure_pbo);
-	glBindBuffer(GL_PIXEL_PACK_BUFFER, app->exposure_pbo);
-	glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(float), NULL, GL_STREAM_READ);
-	glObjectLabel(GL_BUFFER, app->exposure_pbo, -1,
-	              "Exposure Readback PBO");
-	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-	app->current_exposure = 1.0F;
+	/* Relectures asynchrones (exposition, histogramme, luminance IBL) */
+	if (!gpu_readback_init(&app->readback,
+	                       GPU_READBACK_DEFAULT_CAPACITY)) {
+		LOG_ERROR("suckless-ogl.app", "Failed to create readback ring");
+		return 0;
+	}
 	app->lum_ssbo[0] = 0;
 	app->lum_ssbo[1] = 0;
 
@@ -305,7 +390,7 @@ int app_init(App* app, int width, int height, const char* title)
 		return 0;
 	}
 
-	app->billboard_mode = 1;
+	app->render_mode = RENDER_MODE_BILLBOARD;
 	app->pbr_billboard_shader = shader_load(
 	    "shaders/pbr_ibl_billboard.vert", "shaders/pbr_ibl_billboard.frag");
 	if (app->pbr_billboard_shader) {
@@ -333,9 +418,12 @@ int app_init(App* app, int width, int height, const char* title)
 	glBindVertexArray(app->sphere_vao);
 	glObjectLabel(GL_VERTEX_ARRAY, app->sphere_vao, -1, "Main Sphere VAO");
 	glBindVertexArray(0);
-	glGenBuffers(1, &app->sphere_vbo);
-	glGenBuffers(1, &app->sphere_nbo);
-	glGenBuffers(1, &app->sphere_ebo);
+
+	/* Niveau initial synchrone (les groupes d'instances s'y lient), les
+	 * suivants sont générés par le job system */
+	icosphere_cache_init(&app->sphere_cache, app->jobs);
+	icosphere_cache_load(&app->sphere_cache, app->subdivisions);
+	app_use_sphere_mesh(app);
 
 	/* Enable depth testing */
 	glEnable(GL_DEPTH_TEST);
@@ -358,6 +446,8 @@ int app_init(App* app, int width, int height, const char* title)
 	// 5.0s window, 200 samples
 	adaptive_sampler_init(&app->fps_sampler, SAMPLER_WINDOW, SAMPLER_TARGET,
 	                      SAMPLER_INITIAL_GUESS);
+	dynamic_resolution_init(&app->drs, DRS_TARGET_MS[0], DRS_MIN_SCALE,
+	                        DRS_MAX_SCALE);
 	app->last_frame_time = glfwGetTime();
 
 	ui_init(&app->ui, "assets/fonts/FiraCode-Regular.ttf",
@@ -386,9 +476,28 @@ int app_init(App* app, int width, int height, const char* title)
 		LOG_ERROR("suckless-ogl.app", "Failed to load pbr_ssbo shader");
 		return 0;
 	}
+
+	/* Grille statique compacte ; le stream dynamique reste complet */
+	material_table_init(&app->material_table, app->material_lib);
+	app->pbr_ssbo_compact_shader =
+	    shader_load("shaders/pbr_ibl_ssbo_compact.vert",
+	                "shaders/pbr_ibl_instanced.frag");
+	if (!app->pbr_ssbo_compact_shader) {
+		LOG_ERROR("suckless-ogl.app",
+		          "Failed to load pbr_ssbo_compact shader");
+		return 0;
+	}
 	LOG_INFO("suckless-ogl.app", "SSBO rendering mode active");
 #else
 	app_init_instancing(app);
+	app->scale_test.params = (InstanceGenParams){
+	    .layout = INSTANCE_LAYOUT_GRID,
+	    .spacing = DEFAULT_SPACING,
+	    .radius = SCALE_TEST_RADIUS,
+	    .material_index = -1,
+	    .seed = 1,
+	    .format = INSTANCE_FORMAT_COMPACT,
+	};
 	app->pbr_instanced_shader = shader_load(
 	    "shaders/pbr_ibl_instanced.vert", "shaders/pbr_ibl_instanced.frag");
 	if (app->pbr_instanced_shader) {
@@ -401,8 +510,30 @@ int app_init(App* app, int width, int height, const char* title)
 		return 0;
 	}
 
-	/* Setup initial VAO based on default mode (Mesh) */
-	app_update_instancing_mode(app);
+	/* Instances compactes : matériaux lus dans la table (scale test) */
+	material_table_init(&app->material_table, app->material_lib);
+	app->pbr_compact_shader =
+	    shader_load("shaders/pbr_ibl_instanced_compact.vert",
+	                "shaders/pbr_ibl_instanced.frag");
+	app->pbr_billboard_compact_shader =
+	    shader_load("shaders/pbr_ibl_billboard_compact.vert",
+	                "shaders/pbr_ibl_billboard.frag");
+	if (!app->pbr_compact_shader || !app->pbr_billboard_compact_shader) {
+		LOG_WARN("suckless-ogl.app",
+		         "Compact instance shaders unavailable");
+	}
+
+	/* Pré-passe de profondeur (touche O) */
+	app->depth_prepass_shader = shader_load("shaders/depth_prepass.vert",
+	                                        "shaders/depth_prepass.frag");
+	app->depth_prepass_compact_shader =
+	    shader_load("shaders/depth_prepass_compact.vert",
+	                "shaders/depth_prepass.frag");
+	if (!app->depth_prepass_shader ||
+	    !app->depth_prepass_compact_shader) {
+		LOG_WARN("suckless-ogl.app",
+		         "Depth pre-pass shaders unavailable");
+	}
 #endif
 
 	/* Initialize post-processing */
@@ -412,6 +543,7 @@ int app_init(App* app, int width, int height, const char* title)
 		return 0;
 	}
 	postprocess_set_dummy_textures(&app->postprocess, app->dummy_black_tex);
+	postprocess_set_readback(&app->postprocess, &app->readback);
 
 	postprocess_disable(&app->postprocess, POSTFX_VIGNETTE);
 	postprocess_disable(&app->postprocess, POSTFX_GRAIN);
@@ -437,8 +569,9 @@ void app_init_ssbo(App* app)
 	const float grid_w = (float)(cols - 1) * spacing;
 	const float grid_h = (float)(rows - 1) * spacing;
 
-	SphereInstanceSSBO* data =
-	    malloc(sizeof(SphereInstanceSSBO) * total_count);
+	/* Instances compactes : les matériaux sont lus dans la table */
+	SphereInstanceCompact* data =
+	    malloc(sizeof(SphereInstanceCompact) * total_count);
 	if (!data) {
 		LOG_ERROR("suckless-ogl.app",
 		          "Failed to allocate memory for SSBO");
@@ -449,66 +582,53 @@ void app_init_ssbo(App* app)
 		const int grid_x = i % cols;
 		const int grid_y = i / cols;
 
-		glm_mat4_identity(data[i].model);
-
 		const float pos_x = ((float)grid_x * spacing) -
 		                    (grid_w * HALF_OFFSET_MULTIPLIER);
 		const float pos_y = -(((float)grid_y * spacing) -
 		                      (grid_h * HALF_OFFSET_MULTIPLIER));
 
 		vec3 position = {pos_x, pos_y, 0.0F};
-		glm_translate(data[i].model, position);
-
-		PBRMaterial* mat = &app->material_lib->materials[i];
-
-		glm_vec3_copy(mat->albedo, data[i].albedo);
-		data[i].metallic = mat->metallic;
-		data[i].roughness = mat->roughness;
-		data[i].ao = 1.0F;
-		data[i]._padding[0] = 0.0F;
-		data[i]._padding[1] = 0.0F;
+		sphere_instance_compact_pack(&data[i], position, 1.0F,
+		                             (uint32_t)i);
 	}
 
 	/* Debug : vérifier la première instance */
 	LOG_DEBUG("suckless-ogl.ssbo",
-	          "First instance - pos: (%.2f, %.2f, %.2f), "
-	          "albedo: (%.2f, "
-	          "%.2f, %.2f)",
-	          data[0].model[3][0], data[0].model[3][1], data[0].model[3][2],
-	          data[0].albedo[0], data[0].albedo[1], data[0].albedo[2]);
+	          "First instance - pos: (%.2f, %.2f, %.2f)",
+	          data[0].position[0], data[0].position[1],
+	          data[0].position[2]);
 
-	ssbo_group_init(&app->ssbo_group, data, total_count);
-	ssbo_group_bind_mesh(&app->ssbo_group, app->sphere_vbo, app->sphere_nbo,
-	                     app->sphere_ebo);
+	ssbo_group_init_compact(&app->ssbo_group, data, total_count);
+	ssbo_group_bind_mesh(&app->ssbo_group, &app->sphere_mesh);
 
 	free(data);
 }
 #endif
 
-void app_init_instancing(App* app)
+/* Grille centrée de `count` sphères. Les matériaux sont répétés au-delà de
+ * la taille de la bibliothèque ; pour le nombre par défaut on retrouve
+ * exactement la grille historique DEFAULT_COLS x DEFAULT_COLS. */
+static SphereInstance* app_create_instance_grid(const MaterialLib* lib,
+                                                int count)
 {
-	// 1. Calcul des dimensions (identique au legacy)
-	const int total_count =
-	    MIN(app->material_lib->count, DEFAULT_COLS * DEFAULT_COLS);
-	const int cols = DEFAULT_COLS;
-	const int rows = (total_count + cols - 1) / cols;
+	const int cols = instance_generator_columns(count);
+	const int rows = (count + cols - 1) / cols;
 	const float spacing = DEFAULT_SPACING;
 
 	const float grid_w = (float)(cols - 1) * spacing;
 	const float grid_h = (float)(rows - 1) * spacing;
 
-	// 2. Allocation temporaire pour le transfert (alignée
-	// pour SIMD/AVX)
+	// Allocation temporaire pour le transfert (alignée pour SIMD/AVX)
 	SphereInstance* data = NULL;
 	if (posix_memalign((void**)&data, SIMD_ALIGNMENT,
-	                   sizeof(SphereInstance) * (size_t)total_count) != 0) {
+	                   sizeof(SphereInstance) * (size_t)count) != 0) {
 		LOG_ERROR("suckless-ogl.app",
 		          "Failed to allocate aligned memory "
 		          "for instancing");
-		return;
+		return NULL;
 	}
 
-	for (int i = 0; i < total_count; i++) {
+	for (int i = 0; i < count; i++) {
 		const int grid_x = i % cols;
 		const int grid_y = i / cols;
 
@@ -527,42 +647,574 @@ void app_init_instancing(App* app)
 
 		// Récupération des propriétés du matériau
 		// depuis la bibliothèque
-		PBRMaterial* mat = &app->material_lib->materials[i];
+		const PBRMaterial* mat = &lib->materials[i % lib->count];
 
-		glm_vec3_copy(mat->albedo, data[i].albedo);
+		glm_vec3_copy((float*)mat->albedo, data[i].albedo);
 		data[i].metallic = mat->metallic;
 		data[i].roughness = mat->roughness;
 		data[i].ao = 1.0F;  // Valeur par défaut
+		data[i].padding = 0.0F;
+	}
+
+	return data;
+}
+
+/* Libère les groupes d'instances (statiques ou branchés sur le stream) */
+static void app_release_instance_groups(App* app)
+{
+#ifdef USE_SSBO_RENDERING
+	ssbo_group_cleanup(&app->ssbo_group);
+#else
+	depth_sort_group_cleanup(&app->depth_sort_group);
+	hybrid_group_cleanup(&app->hybrid_group);
+	billboard_group_cleanup(&app->billboard_group);
+	instanced_group_cleanup(&app->instanced_group);
+	app->instanced_group.vao = 0;
+	app->instanced_group.instance_vbo = 0;
+#endif
+}
+
+/* Rend le buffer persistant (les groupes qui l'empruntent sont libérés) */
+static void app_dynamic_instances_release(App* app)
+{
+	if (!app->dynamic.active) {
+		return;
+	}
+	app_release_instance_groups(app);
+	instance_stream_cleanup(&app->instance_stream);
+	instance_sim_cleanup(&app->instance_sim);
+	app->dynamic.active = 0;
+}
+
+/* (Re)crée les groupes mesh/billboard/hybride pour `count` instances.
+ * data (format complet) peut être NULL : buffers remplis ensuite par le GPU.
+ * Le format compact n'a ni groupe hybride ni tri en profondeur (tous deux
+ * recopient des SphereInstance). */
+static void app_allocate_instance_groups(App* app, const SphereInstance* data,
+                                         int count, InstanceFormat format)
+{
+	/* Les groupes statiques remplacent les instances dynamiques */
+	app_dynamic_instances_release(app);
+
+	/* Libère les groupes précédents (changement de taille) */
+	if (app->instanced_group.instance_vbo) {
+		depth_sort_group_cleanup(&app->depth_sort_group);
+		hybrid_group_cleanup(&app->hybrid_group);
+		billboard_group_cleanup(&app->billboard_group);
+		instanced_group_cleanup(&app->instanced_group);
+		app->instanced_group.vao = 0;
 	}
 
-	// 3. Initialisation du groupe (Transfert VBO Instance +
-	// Création VAO)
-	instanced_group_init(&app->instanced_group, data, total_count);
+	// Initialisation du groupe (Transfert VBO Instance)
+	if (format == INSTANCE_FORMAT_COMPACT) {
+		instanced_group_init_compact(&app->instanced_group, NULL,
+		                             count);
+	} else {
+		instanced_group_init(&app->instanced_group, data, count);
+	}
 
-	// 4. Premier lien avec la géométrie actuelle
-	// Note: on utilise les noms de buffers de ton app.h
-	// (sphere_vbo, etc.)
-	instanced_group_bind_mesh(&app->instanced_group, app->sphere_vbo,
-	                          app->sphere_nbo, app->sphere_ebo);
+	// Lien avec la géométrie actuelle
+	instanced_group_bind_mesh(&app->instanced_group, &app->sphere_mesh);
 
 	/* Initialize Billboard Group as well (shares the same
 	 * data) */
-	billboard_group_init(&app->billboard_group, data, total_count);
+	if (format == INSTANCE_FORMAT_COMPACT) {
+		billboard_group_init_compact(&app->billboard_group, NULL,
+		                             count);
+	} else {
+		billboard_group_init(&app->billboard_group, data, count);
+	}
 	billboard_group_prepare(&app->billboard_group, app->quad_vbo);
 
+	/* Hybrid mode classifies the mesh group buffer every frame */
+	if (format == INSTANCE_FORMAT_FULL &&
+	    hybrid_group_init(&app->hybrid_group,
+	                      app->instanced_group.instance_vbo, count)) {
+		hybrid_group_bind_mesh(&app->hybrid_group, &app->sphere_mesh);
+		hybrid_group_prepare_impostor(&app->hybrid_group,
+		                              app->quad_vbo);
+	}
+
+	/* Front-to-back ordering reads the same buffer */
+	if (format == INSTANCE_FORMAT_FULL &&
+	    depth_sort_group_init(&app->depth_sort_group,
+	                          app->instanced_group.instance_vbo, count)) {
+		depth_sort_group_bind_mesh(&app->depth_sort_group,
+		                           &app->sphere_mesh);
+	}
+
+	app->instance_count = count;
+	app->instance_capacity = count;
+}
+
+void app_set_instance_count(App* app, int count)
+{
+	if (count <= 0 || !app->material_lib || app->material_lib->count <= 0) {
+		return;
+	}
+
+	SphereInstance* data =
+	    app_create_instance_grid(app->material_lib, count);
+	if (!data) {
+		return;
+	}
+
+	app_allocate_instance_groups(app, data, count, INSTANCE_FORMAT_FULL);
 	free(data);
 }
 
-static void app_update_instancing_mode(App* app)
+#ifndef USE_SSBO_RENDERING
+/* Bytes of instance data resident on the GPU (all sphere render paths) */
+static size_t app_instance_vram_bytes(const App* app)
 {
-	/* No longer needed as we have separate groups
-	 * initialized */
+	/* Mesh VBO + billboard VBO (+ 2 hybrid buckets + depth sorted copy,
+	 * full format only) */
+	const InstanceFormat format = app->instanced_group.format;
+	const size_t copies = format == INSTANCE_FORMAT_COMPACT ? 2 : 5;
+	return (size_t)app->instance_capacity *
+	       instance_format_stride(format) * copies;
+}
+#endif
+
+void app_generate_instances(App* app, const InstanceGenParams* params)
+{
+#ifdef USE_SSBO_RENDERING
 	(void)app;
+	(void)params;
+	LOG_WARN("suckless-ogl.app",
+	         "GPU instance generation requires the instanced VBO path");
+#else
+	if (params->count <= 0) {
+		return;
+	}
+	if (!app->instance_gen.shader &&
+	    !instance_generator_init(&app->instance_gen)) {
+		return;
+	}
+
+	/* Buffers only grow: shrinking reuses the current storage */
+	if (params->count > app->instance_capacity ||
+	    params->format != app->instanced_group.format ||
+	    app->dynamic.active) {
+		app_allocate_instance_groups(app, NULL, params->count,
+		                             params->format);
+	}
+
+	const GLsizeiptr size = (GLsizeiptr)(
+	    (size_t)params->count * instance_format_stride(params->format));
+
+	GPU_MEASURE_MS(gen_ms)
+	{
+		instance_generator_run(&app->instance_gen, params,
+		                       &app->material_table,
+		                       app->instanced_group.instance_vbo);
+
+		/* The billboard group keeps its own copy */
+		glBindBuffer(GL_COPY_READ_BUFFER,
+		             app->instanced_group.instance_vbo);
+		glBindBuffer(GL_COPY_WRITE_BUFFER,
+		             app->billboard_group.instance_vbo);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+		                    0, 0, size);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	app->instance_count = params->count;
+	app->instanced_group.instance_count = params->count;
+	app->billboard_group.instance_count = params->count;
+	app->hybrid_group.instance_count = params->count;
+	app->depth_sort_group.instance_count = params->count;
+
+	app->scale_test.gen_gpu_ms = gen_ms;
+	app->scale_test.frames = 0;
+	app->scale_test.frame_ms_sum = 0.0;
+
+	LOG_INFO("suckless-ogl.scale",
+	         "%d instances (%s, %s %zu B): generated in %.3f ms GPU, "
+	         "instance VRAM %.1f MiB (capacity %d)",
+	         params->count,
+	         params->layout == INSTANCE_LAYOUT_POISSON ? "poisson" : "grid",
+	         params->format == INSTANCE_FORMAT_COMPACT ? "compact" : "full",
+	         instance_format_stride(params->format), gen_ms,
+	         (double)app_instance_vram_bytes(app) / (1024.0 * 1024.0),
+	         app->instance_capacity);
+#endif
 }
 
-void app_render_billboards(App* app, mat4 view, mat4 proj, vec3 camera_pos)
+#ifndef USE_SSBO_RENDERING
+/* Touche N : scène par défaut -> 10^3 -> ... -> 10^6 -> scène par défaut.
+ * Shift : grille / jitter, Ctrl : instances complètes / compactes. */
+static void app_scale_test_next(App* app, int mods)
+{
+	ScaleTest* test = &app->scale_test;
+
+	if (check_flag(mods, GLFW_MOD_SHIFT) ||
+	    check_flag(mods, GLFW_MOD_CONTROL)) {
+		if (check_flag(mods, GLFW_MOD_SHIFT)) {
+			test->params.layout = (test->params.layout + 1) %
+			                      INSTANCE_LAYOUT_COUNT;
+		} else {
+			test->params.format =
+			    test->params.format == INSTANCE_FORMAT_COMPACT
+			        ? INSTANCE_FORMAT_FULL
+			        : INSTANCE_FORMAT_COMPACT;
+		}
+		if (test->step == 0) {
+			LOG_INFO(
+			    "suckless-ogl.scale", "Scale test: %s, %s instances",
+			    test->params.layout == INSTANCE_LAYOUT_POISSON
+			        ? "poisson"
+			        : "grid",
+			    test->params.format == INSTANCE_FORMAT_COMPACT
+			        ? "compact"
+			        : "full");
+			return;
+		}
+	} else {
+		test->step = (test->step + 1) % (SCALE_TEST_STEPS + 1);
+	}
+
+	if (test->step == 0) {
+		app_init_instancing(app);
+		LOG_INFO("suckless-ogl.scale",
+		         "Scale test off: %d material spheres",
+		         app->instance_count);
+		return;
+	}
+
+	test->params.count = SCALE_TEST_COUNTS[test->step - 1];
+	app_generate_instances(app, &test->params);
+}
+
+/* Temps de frame moyen de la scène de test (log périodique) */
+static void app_scale_test_update(App* app)
+{
+	ScaleTest* test = &app->scale_test;
+	if (test->step == 0) {
+		return;
+	}
+
+	test->frame_ms_sum += app->delta_time * 1000.0;
+	test->frames++;
+	if (test->frames < SCALE_TEST_REPORT_FRAMES) {
+		return;
+	}
+
+	LOG_INFO("suckless-ogl.scale",
+	         "%d instances | %-9s | frame %.3f ms (avg over %d frames) | "
+	         "gen %.3f ms | VRAM %.1f MiB",
+	         app->instance_count, RENDER_MODE_NAMES[app->render_mode],
+	         test->frame_ms_sum / (double)test->frames, test->frames,
+	         test->gen_gpu_ms,
+	         (double)app_instance_vram_bytes(app) / (1024.0 * 1024.0));
+	test->frames = 0;
+	test->frame_ms_sum = 0.0;
+}
+#endif
+
+void app_set_dynamic_instances(App* app, int count)
+{
+	app_dynamic_instances_release(app);
+
+	if (count <= 0) {
+#ifdef USE_SSBO_RENDERING
+		app_init_ssbo(app);
+#else
+		app_init_instancing(app);
+#endif
+		return;
+	}
+
+	app_release_instance_groups(app);
+
+#ifdef USE_SSBO_RENDERING
+	const size_t stride = sizeof(SphereInstanceSSBO);
+#else
+	const size_t stride = sizeof(SphereInstance);
+#endif
+	if (!instance_sim_init(&app->instance_sim, app->material_lib, count,
+	                       DEFAULT_SPACING, DYNAMIC_SPHERE_RADIUS,
+	                       DYNAMIC_SIM_SEED)) {
+		app_set_dynamic_instances(app, 0);
+		return;
+	}
+	if (!instance_stream_init(&app->instance_stream, stride, count)) {
+		instance_sim_cleanup(&app->instance_sim);
+		app_set_dynamic_instances(app, 0);
+		return;
+	}
+
+	InstanceStream* stream = &app->instance_stream;
+#ifdef USE_SSBO_RENDERING
+	ssbo_group_init_stream(&app->ssbo_group, stream, count);
+	ssbo_group_bind_mesh(&app->ssbo_group, &app->sphere_mesh);
+#else
+	instanced_group_init_stream(&app->instanced_group, stream,
+	                            INSTANCE_FORMAT_FULL, count);
+	instanced_group_bind_mesh(&app->instanced_group, &app->sphere_mesh);
+
+	billboard_group_init_stream(&app->billboard_group, stream,
+	                            INSTANCE_FORMAT_FULL, count);
+	billboard_group_prepare(&app->billboard_group, app->quad_vbo);
+
+	/* The classification reads the current region (source_offset) */
+	if (hybrid_group_init(&app->hybrid_group, stream->buffer, count)) {
+		hybrid_group_bind_mesh(&app->hybrid_group, &app->sphere_mesh);
+		hybrid_group_prepare_impostor(&app->hybrid_group,
+		                              app->quad_vbo);
+	}
+	if (depth_sort_group_init(&app->depth_sort_group, stream->buffer,
+	                          count)) {
+		depth_sort_group_bind_mesh(&app->depth_sort_group,
+		                           &app->sphere_mesh);
+	}
+	app->instance_capacity = count;
+#endif
+
+	app->instance_count = count;
+	app->dynamic.active = 1;
+	app->dynamic.frames = 0;
+	app->dynamic.update_ms_sum = 0.0;
+	app->dynamic.wait_ms_sum = 0.0;
+}
+
+/* Format écrit par la simulation dans la région mappée */
+#ifdef USE_SSBO_RENDERING
+typedef SphereInstanceSSBO DynamicInstance;
+#else
+typedef SphereInstance DynamicInstance;
+#endif
+
+/* Avance la simulation dans la région de la frame et journalise le débit */
+static void app_dynamic_instances_update(App* app)
+{
+	DynamicInstances* dyn = &app->dynamic;
+	if (!dyn->active) {
+		return;
+	}
+
+	DynamicInstance* region = instance_stream_next(&app->instance_stream);
+	if (!region) {
+		return;
+	}
+
+	/* Simulation SoA + écriture multi-thread, directement dans la région
+	 * mappée (stores non-temporels, jamais de relecture) */
+	const float dt = (float)MIN(app->delta_time, DYNAMIC_MAX_DT);
+	PERF_MEASURE_MS(update_ms)
+	{
+		instance_sim_update(&app->instance_sim, app->jobs, dt,
+		                    region, sizeof(DynamicInstance));
+	}
+
+#ifndef USE_SSBO_RENDERING
+	app->hybrid_group.source_offset =
+	    instance_stream_offset(&app->instance_stream);
+	app->depth_sort_group.source_offset =
+	    app->hybrid_group.source_offset;
+#endif
+
+	dyn->update_ms_sum += update_ms;
+	dyn->wait_ms_sum += app->instance_stream.last_wait_ms;
+	dyn->frames++;
+	if (dyn->frames < DYNAMIC_REPORT_FRAMES) {
+		return;
+	}
+
+	const double avg_update = dyn->update_ms_sum / (double)dyn->frames;
+	LOG_INFO("suckless-ogl.stream",
+	         "%d dynamic instances | update %.3f ms (%.0f instances/ms, "
+	         "%.1f MiB/s, %d threads, %s) | fence wait %.3f ms",
+	         app->instance_count, avg_update,
+	         avg_update > 0.0 ? (double)app->instance_count / avg_update
+	                          : 0.0,
+	         avg_update > 0.0 ? (double)app->instance_count *
+	                                (double)sizeof(DynamicInstance) /
+	                                (avg_update * 1024.0 * 1024.0 / 1000.0)
+	                          : 0.0,
+	         job_system_thread_count(app->jobs), instance_sim_simd_name(),
+	         dyn->wait_ms_sum / (double)dyn->frames);
+	dyn->frames = 0;
+	dyn->update_ms_sum = 0.0;
+	dyn->wait_ms_sum = 0.0;
+}
+
+/* Ctrl+U : scalabilité de la simulation sur des job systems temporaires de
+ * 1..N threads, hors GPU (buffer système) pour isoler le coût CPU. Bloquant. */
+static void app_dynamic_instances_benchmark(App* app)
+{
+	const int count = DYNAMIC_INSTANCE_COUNTS[app->dynamic.step];
+	const int max_threads = job_system_cpu_count();
+	InstanceSim sim;
+	void* scratch = NULL;
+
+	if (!instance_sim_init(&sim, app->material_lib, count, DEFAULT_SPACING,
+	                       DYNAMIC_SPHERE_RADIUS, DYNAMIC_SIM_SEED)) {
+		return;
+	}
+	if (posix_memalign(&scratch, SIMD_ALIGNMENT,
+	                   (size_t)count * sizeof(DynamicInstance)) != 0) {
+		instance_sim_cleanup(&sim);
+		return;
+	}
+
+	double single_ms = 0.0;
+	LOG_INFO("suckless-ogl.sim", "Simulation scaling: %d instances (%s)",
+	         count, instance_sim_simd_name());
+
+	for (int threads = 1; threads <= max_threads; threads++) {
+		JobSystem* jobs = job_system_create(threads - 1);
+		if (!jobs) {
+			break;
+		}
+		for (int i = 0; i < DYNAMIC_BENCH_WARMUP; i++) {
+			instance_sim_update(&sim, jobs, 1.0F / 60.0F, scratch,
+			                    sizeof(DynamicInstance));
+		}
+		PERF_MEASURE_MS(total_ms)
+		{
+			for (int i = 0; i < DYNAMIC_BENCH_ITERATIONS; i++) {
+				instance_sim_update(&sim, jobs, 1.0F / 60.0F,
+				                    scratch,
+				                    sizeof(DynamicInstance));
+			}
+		}
+		job_system_destroy(jobs);
+
+		const double ms = total_ms / DYNAMIC_BENCH_ITERATIONS;
+		if (threads == 1) {
+			single_ms = ms;
+		}
+		LOG_INFO("suckless-ogl.sim",
+		         "  %2d threads: %.3f ms (%.0f instances/ms, x%.2f)",
+		         threads, ms, ms > 0.0 ? (double)count / ms : 0.0,
+		         ms > 0.0 ? single_ms / ms : 0.0);
+	}
+
+	free(scratch);
+	instance_sim_cleanup(&sim);
+}
+
+/* Ctrl+L : positions float32 / snorm16 (tous les niveaux sont re-téléversés
+ * à la demande, le niveau affiché tout de suite) */
+static void app_toggle_position_format(App* app)
+{
+	const IcospherePositionFormat format =
+	    app->sphere_cache.format == ICOSPHERE_POSITION_FLOAT
+	        ? ICOSPHERE_POSITION_SNORM16
+	        : ICOSPHERE_POSITION_FLOAT;
+	if (icosphere_cache_set_format(&app->sphere_cache, format)) {
+		app_use_sphere_mesh(app);
+	}
+	LOG_INFO("suckless-ogl.app",
+	         "Sphere positions: %s (%zu bytes/vertex), %s indices",
+	         POSITION_FORMAT_NAMES[format],
+	         icosphere_position_stride(format),
+	         app->sphere_mesh.index_type == GL_UNSIGNED_SHORT ? "16-bit"
+	                                                          : "32-bit");
+}
+
+/* Ctrl+Shift+L : coût de l'étage sommets du maillage courant pour chaque
+ * format de position. La rastérisation est coupée pour que seuls le vertex
+ * fetch et le vertex shader comptent. Bloquant, le format est restauré. */
+static void app_vertex_fetch_benchmark(App* app)
+{
+	const IcospherePositionFormat saved = app->sphere_cache.format;
+	mat4 view;
+	mat4 proj;
+	vec3 camera_pos = {app->camera.position[0], app->camera.position[1],
+	                   app->camera.position[2]};
+	camera_get_view_matrix(&app->camera, view);
+	glm_perspective(glm_rad(FOV_ANGLE),
+	                (float)app->width / (float)app->height, NEAR_PLANE,
+	                FAR_PLANE, proj);
+
+	/* Ancien flux : positions + normales float, indices 32 bits */
+	const size_t legacy_bytes =
+	    (app->sphere_mesh.vertex_count * 2 * sizeof(vec3)) +
+	    (app->sphere_mesh.index_count * sizeof(uint32_t));
+	LOG_INFO("suckless-ogl.bench",
+	         "Vertex fetch: level %d, %zu vertices, %d instances (legacy "
+	         "streams: %zu bytes/instance)",
+	         app->sphere_cache.current, app->sphere_mesh.vertex_count,
+	         app->instance_count, legacy_bytes);
+
+	glEnable(GL_RASTERIZER_DISCARD);
+	for (int i = 0; i < ICOSPHERE_POSITION_FORMAT_COUNT; i++) {
+		const IcospherePositionFormat format =
+		    (IcospherePositionFormat)i;
+		if (icosphere_cache_set_format(&app->sphere_cache, format)) {
+			app_use_sphere_mesh(app);
+		}
+		for (int j = 0; j < VERTEX_BENCH_WARMUP; j++) {
+			app_render_instanced(app, view, proj, camera_pos);
+		}
+		GPU_MEASURE_MS(total_ms)
+		{
+			for (int j = 0; j < VERTEX_BENCH_ITERATIONS; j++) {
+				app_render_instanced(app, view, proj,
+				                     camera_pos);
+			}
+		}
+
+		const double ms = total_ms / VERTEX_BENCH_ITERATIONS;
+		const size_t bytes =
+		    icosphere_mesh_vertex_bytes(&app->sphere_mesh) +
+		    icosphere_mesh_index_bytes(&app->sphere_mesh);
+		/* Nominal : sans le cache post-transform ni le cache L2 */
+		const double streamed_gb =
+		    (double)bytes * (double)app->instance_count / 1e9;
+		LOG_INFO("suckless-ogl.bench",
+		         "  %s + %s indices: %zu bytes/instance (%.0f%% of "
+		         "legacy), %.3f ms, %.1f GB/s nominal",
+		         POSITION_FORMAT_NAMES[format],
+		         app->sphere_mesh.index_type == GL_UNSIGNED_SHORT
+		             ? "16-bit"
+		             : "32-bit",
+		         bytes, 100.0 * (double)bytes / (double)legacy_bytes,
+		         ms, ms > 0.0 ? streamed_gb / (ms / 1000.0) : 0.0);
+	}
+	glDisable(GL_RASTERIZER_DISCARD);
+
+	if (icosphere_cache_set_format(&app->sphere_cache, saved)) {
+		app_use_sphere_mesh(app);
+	}
+}
+
+/* Touche U : on/off, Shift+U : nombre d'instances suivant */
+static void app_dynamic_instances_toggle(App* app, int next_count)
+{
+	DynamicInstances* dyn = &app->dynamic;
+
+	if (next_count) {
+		dyn->step = (dyn->step + 1) % DYNAMIC_INSTANCE_STEPS;
+		if (!dyn->active) {
+			LOG_INFO("suckless-ogl.stream",
+			         "Dynamic instance count: %d",
+			         DYNAMIC_INSTANCE_COUNTS[dyn->step]);
+			return;
+		}
+	} else if (dyn->active) {
+		app_set_dynamic_instances(app, 0);
+		LOG_INFO("suckless-ogl.stream", "Dynamic instances: OFF");
+		return;
+	}
+
+	app_set_dynamic_instances(app, DYNAMIC_INSTANCE_COUNTS[dyn->step]);
+	LOG_INFO("suckless-ogl.stream", "Dynamic instances: %d (%s)",
+	         app->instance_count, dyn->active ? "ON" : "failed");
+}
+
+void app_init_instancing(App* app)
+{
+	app_set_instance_count(
+	    app, MIN(app->material_lib->count, DEFAULT_COLS * DEFAULT_COLS));
+}
+
+/* Textures IBL et uniformes d'éclairage (forward et résolution différée) */
+static void app_bind_ibl(App* app, Shader* current_shader, vec3 camera_pos)
 {
-	Shader* current_shader = app->pbr_billboard_shader;
 	shader_use(current_shader);
 
 	render_utils_bind_texture_safe(GL_TEXTURE0, app->irradiance_tex,
@@ -572,65 +1224,916 @@ void app_render_billboards(App* app, mat4 view, mat4 proj, vec3 camera_pos)
 	render_utils_bind_texture_safe(GL_TEXTURE2, app->brdf_lut_tex,
 	                               app->dummy_black_tex);
 
-	shader_set_int(current_shader, "irradianceMap", 0);
-	shader_set_int(current_shader, "prefilterMap", 1);
-	shader_set_int(current_shader, "brdfLUT", 2);
+	shader_set_int(current_shader, "irradianceMap", 0);
+	shader_set_int(current_shader, "prefilterMap", 1);
+	shader_set_int(current_shader, "brdfLUT", 2);
+
+	/* Pass PBR Debug Mode */
+	shader_set_int(current_shader, "debugMode", app->pbr_debug_mode);
+
+	shader_set_vec3(current_shader, "camPos", camera_pos);
+
+	/* Listes de lumières du dernier cull (lightCount = 0 si aucune) */
+	light_clusters_bind(&app->lights, current_shader);
+}
+
+/* Uniforms communs aux shaders PBR (mesh, billboard, SSBO) */
+static void app_bind_pbr_shader(App* app, Shader* current_shader, mat4 view,
+                                mat4 proj, vec3 camera_pos)
+{
+	app_bind_ibl(app, current_shader, camera_pos);
+	shader_set_mat4(current_shader, "projection", (float*)proj);
+	shader_set_mat4(current_shader, "view", (float*)view);
+
+	/* Pass Previous ViewProj for Velocity Buffer */
+	shader_set_mat4(
+	    current_shader, "previousViewProj",
+	    (float*)app->postprocess.motion_blur_fx.previous_view_proj);
+}
+
+void app_render_billboards(App* app, mat4 view, mat4 proj, vec3 camera_pos)
+{
+	Shader* current_shader = app->pbr_billboard_shader;
+#ifndef USE_SSBO_RENDERING
+	if (app->billboard_group.format == INSTANCE_FORMAT_COMPACT) {
+		current_shader = app->pbr_billboard_compact_shader;
+		material_table_bind(&app->material_table);
+	}
+#endif
+	if (!current_shader) {
+		return;
+	}
+
+	app_bind_pbr_shader(app, current_shader, view, proj, camera_pos);
+
+	// Draw Quads Instanced
+	// 4 vertices per quad (Triangle Strip) is handled
+	// inside billboard_rendering
+	billboard_group_draw(&app->billboard_group);
+}
+
+#ifndef USE_SSBO_RENDERING
+/* Tri front-to-back de la frame si demandé (groupe trié : format complet
+ * uniquement). Retourne 1 si les instances triées doivent être dessinées. */
+static int app_sort_sphere_instances(App* app, mat4 view, mat4 proj)
+{
+	if (!app->depth_sort || app->depth_sort_group.sorted.vao == 0) {
+		return 0;
+	}
+	depth_sort_group_sort(&app->depth_sort_group, view, proj,
+	                      app->sphere_mesh.index_count);
+	return 1;
+}
+
+static void app_draw_sphere_instances(App* app, int sorted)
+{
+	if (sorted) {
+		depth_sort_group_draw(&app->depth_sort_group);
+	} else {
+		instanced_group_draw(&app->instanced_group,
+		                     app->sphere_mesh.index_count);
+	}
+}
+
+/* Benchmarks : fragments ayant passé le test de profondeur dans la passe
+ * qui shade les sphères (forward) ou remplit le G-buffer (différé) */
+static int app_counts_fragments(const App* app)
+{
+	return app->depth_bench.active || app->deferred_bench.active;
+}
+
+static void app_fragment_query_begin(App* app)
+{
+	if (!app_counts_fragments(app)) {
+		return;
+	}
+	if (!app->fragment_query) {
+		glGenQueries(1, &app->fragment_query);
+	}
+	glBeginQuery(GL_SAMPLES_PASSED, app->fragment_query);
+}
+
+static void app_fragment_query_end(App* app)
+{
+	if (app_counts_fragments(app)) {
+		glEndQuery(GL_SAMPLES_PASSED);
+	}
+}
+
+/* Bloquant : benchmarks uniquement */
+static double app_fragment_query_result(App* app)
+{
+	GLuint64 samples = 0;
+	glGetQueryObjectui64v(app->fragment_query, GL_QUERY_RESULT, &samples);
+	return (double)samples;
+}
+
+/* Profondeur seule des instances mesh : la passe principale ne shade ensuite
+ * que le fragment visible de chaque pixel */
+static void app_render_depth_prepass(App* app, mat4 view, mat4 proj,
+                                     int sorted)
+{
+	Shader* shader = app->instanced_group.format == INSTANCE_FORMAT_COMPACT
+	                     ? app->depth_prepass_compact_shader
+	                     : app->depth_prepass_shader;
+	if (!shader) {
+		return;
+	}
+
+	GL_SCOPE_DEBUG_GROUP("Depth Pre-pass");
+
+	shader_use(shader);
+	shader_set_mat4(shader, "projection", (float*)proj);
+	shader_set_mat4(shader, "view", (float*)view);
+
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	app_draw_sphere_instances(app, sorted);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+#endif
+
+void app_render_instanced(App* app, mat4 view, mat4 proj, vec3 camera_pos)
+{
+	Shader* current_shader = NULL;
+#ifdef USE_SSBO_RENDERING
+	current_shader = app->pbr_ssbo_shader;
+	if (app->ssbo_group.format == INSTANCE_FORMAT_COMPACT) {
+		current_shader = app->pbr_ssbo_compact_shader;
+		material_table_bind(&app->material_table);
+	}
+#else
+	current_shader = app->pbr_instanced_shader;
+	if (app->instanced_group.format == INSTANCE_FORMAT_COMPACT) {
+		current_shader = app->pbr_compact_shader;
+		material_table_bind(&app->material_table);
+	}
+#endif
+	if (!current_shader) {
+		return;
+	}
+
+#ifdef USE_SSBO_RENDERING
+	app_bind_pbr_shader(app, current_shader, view, proj, camera_pos);
+	ssbo_group_draw(&app->ssbo_group, app->sphere_mesh.index_count);
+#else
+	const int sorted = app_sort_sphere_instances(app, view, proj);
+	if (app->depth_prepass) {
+		app_render_depth_prepass(app, view, proj, sorted);
+		/* Même profondeur (invariant gl_Position) : seul le fragment
+		 * le plus proche passe, sans réécrire le Z */
+		glDepthMask(GL_FALSE);
+		glDepthFunc(GL_LEQUAL);
+	}
+
+	app_bind_pbr_shader(app, current_shader, view, proj, camera_pos);
+
+	app_fragment_query_begin(app);
+	app_draw_sphere_instances(app, sorted);
+	app_fragment_query_end(app);
+
+	if (app->depth_prepass) {
+		glDepthFunc(GL_LESS);
+		glDepthMask(GL_TRUE);
+	}
+#endif
+}
+
+#ifndef USE_SSBO_RENDERING
+void app_render_hybrid(App* app, mat4 view, mat4 proj, vec3 camera_pos)
+{
+	/* 1. Culling + tri mesh/imposteur sur GPU (une seule passe) */
+	hybrid_group_classify(&app->hybrid_group, view, proj,
+	                      app->postprocess.render_height,
+	                      app->sphere_mesh.index_count);
+
+	/* 2. Sphères proches : maillage tessellé (silhouette exacte) */
+	app_bind_pbr_shader(app, app->pbr_instanced_shader, view, proj,
+	                    camera_pos);
+	hybrid_group_draw_mesh(&app->hybrid_group);
+
+	/* 3. Sphères lointaines : imposteurs ray-tracés (4 sommets) */
+	app_bind_pbr_shader(app, app->pbr_billboard_shader, view, proj,
+	                    camera_pos);
+	hybrid_group_draw_impostors(&app->hybrid_group);
+}
+
+/* G-buffer créé au premier usage (8 octets/pixel de plus que le forward) */
+static int app_ensure_deferred(App* app)
+{
+	if (app->deferred.gbuffer_fbo) {
+		return 1;
+	}
+	return deferred_init(&app->deferred, &app->postprocess);
+}
+
+void app_render_deferred(App* app, mat4 view, mat4 proj, vec3 camera_pos)
+{
+	DeferredRenderer* deferred = &app->deferred;
+	Shader* geometry_shader = deferred->geometry_shader;
+	if (app->instanced_group.format == INSTANCE_FORMAT_COMPACT) {
+		geometry_shader = deferred->geometry_compact_shader;
+		material_table_bind(&app->material_table);
+	}
+
+	/* 1. Géométrie : matériaux, normales, vélocité, profondeur */
+	{
+		GL_SCOPE_DEBUG_GROUP("Deferred Geometry");
+		const int sorted = app_sort_sphere_instances(app, view, proj);
+
+		deferred_begin_geometry(deferred);
+		shader_use(geometry_shader);
+		shader_set_mat4(geometry_shader, "projection", (float*)proj);
+		shader_set_mat4(geometry_shader, "view", (float*)view);
+		shader_set_mat4(
+		    geometry_shader, "previousViewProj",
+		    (float*)app->postprocess.motion_blur_fx.previous_view_proj);
+
+		app_fragment_query_begin(app);
+		app_draw_sphere_instances(app, sorted);
+		app_fragment_query_end(app);
+	}
+
+	/* 2. Éclairage IBL une seule fois par pixel couvert */
+	DeferredBenchmark* bench = &app->deferred_bench;
+	app_bind_ibl(app, deferred->resolve_shader, camera_pos);
+	if (bench->active) {
+		glBeginQuery(GL_SAMPLES_PASSED, bench->coverage_query);
+	}
+	deferred_resolve(deferred, view, proj);
+	if (bench->active) {
+		glEndQuery(GL_SAMPLES_PASSED);
+	}
+}
+#endif
+
+static void app_render_spheres(App* app, mat4 view, mat4 proj,
+                               vec3 camera_pos)
+{
+	switch (app->render_mode) {
+		case RENDER_MODE_BILLBOARD:
+			app_render_billboards(app, view, proj, camera_pos);
+			break;
+#ifndef USE_SSBO_RENDERING
+		case RENDER_MODE_HYBRID:
+			/* Le tri hybride ne lit que des SphereInstance */
+			if (app->instanced_group.format ==
+			    INSTANCE_FORMAT_COMPACT) {
+				app_render_instanced(app, view, proj,
+				                     camera_pos);
+				break;
+			}
+			app_render_hybrid(app, view, proj, camera_pos);
+			break;
+#endif
+		case RENDER_MODE_MESH:
+		default:
+#ifndef USE_SSBO_RENDERING
+			if (app->deferred_shading) {
+				app_render_deferred(app, view, proj,
+				                    camera_pos);
+				break;
+			}
+#endif
+			app_render_instanced(app, view, proj, camera_pos);
+			break;
+	}
+}
+
+void app_render_benchmark_start(App* app)
+{
+#ifdef USE_SSBO_RENDERING
+	LOG_WARN("suckless-ogl.bench",
+	         "Render mode benchmark requires the instanced VBO path");
+	(void)app;
+#else
+	RenderBenchmark* bench = &app->render_bench;
+	if (bench->active || app->depth_bench.active ||
+	    app->deferred_bench.active || app->light_bench.active ||
+	    app->tile_bench.active) {
+		return;
+	}
+
+	(void)memset(bench, 0, sizeof(*bench));
+	if (!app->billboard_stats.shader) {
+		billboard_stats_init(&app->billboard_stats);
+	}
+	bench->active = 1;
+	bench->saved_mode = app->render_mode;
+	bench->saved_instance_count = app->instance_count;
+
+	app_set_instance_count(app, RENDER_BENCH_INSTANCE_COUNTS[0]);
+	app->render_mode = RENDER_MODE_MESH;
+
+	LOG_INFO("suckless-ogl.bench",
+	         "Render mode benchmark started (%d warmup + %d measured "
+	         "frames per configuration)",
+	         RENDER_BENCH_WARMUP_FRAMES, RENDER_BENCH_MEASURED_FRAMES);
+#endif
+}
+
+static void app_render_benchmark_report(const RenderBenchmark* bench)
+{
+	LOG_INFO("suckless-ogl.bench",
+	         "Sphere pass GPU time (ms)    Mesh | Billboard |   Hybrid "
+	         "(mesh/impostor)");
+	for (int step = 0; step < RENDER_BENCH_STEPS; step++) {
+		LOG_INFO("suckless-ogl.bench",
+		         "%7d instances        %8.3f | %9.3f | %8.3f (%d/%d)",
+		         RENDER_BENCH_INSTANCE_COUNTS[step],
+		         bench->gpu_ms[step][RENDER_MODE_MESH],
+		         bench->gpu_ms[step][RENDER_MODE_BILLBOARD],
+		         bench->gpu_ms[step][RENDER_MODE_HYBRID],
+		         bench->hybrid_mesh_count[step],
+		         bench->hybrid_impostor_count[step]);
+	}
+
+	/* Impostor quads: fragments reaching the shader vs ray hits */
+	LOG_INFO("suckless-ogl.bench",
+	         "Billboard fragments/sphere   tight (hit %%) | legacy 3R quad "
+	         "(hit %%)");
+	for (int step = 0; step < RENDER_BENCH_STEPS; step++) {
+		const BillboardFragmentStats* tight = &bench->fragments[step];
+		const BillboardFragmentStats* legacy =
+		    &bench->legacy_fragments[step];
+		const double spheres = (double)RENDER_BENCH_INSTANCE_COUNTS[step];
+		LOG_INFO("suckless-ogl.bench",
+		         "%7d instances        %8.1f (%5.1f%%) | %8.1f (%5.1f%%)",
+		         RENDER_BENCH_INSTANCE_COUNTS[step],
+		         (double)tight->rasterized / spheres,
+		         tight->rasterized ? 100.0 * (double)tight->covered /
+		                                 (double)tight->rasterized
+		                           : 0.0,
+		         (double)legacy->rasterized / spheres,
+		         legacy->rasterized ? 100.0 * (double)legacy->covered /
+		                                  (double)legacy->rasterized
+		                            : 0.0);
+	}
+}
+
+/* Appelé après la passe sphères de chaque frame pendant le benchmark */
+static void app_render_benchmark_record(App* app, double gpu_ms, mat4 view,
+                                        mat4 proj, vec3 camera_pos)
+{
+	RenderBenchmark* bench = &app->render_bench;
+
+	bench->frame++;
+	if (bench->frame <= RENDER_BENCH_WARMUP_FRAMES) {
+		return;
+	}
+	bench->gpu_ms_sum += gpu_ms;
+	if (bench->frame <
+	    RENDER_BENCH_WARMUP_FRAMES + RENDER_BENCH_MEASURED_FRAMES) {
+		return;
+	}
+
+	/* Configuration terminée */
+	const double avg_ms =
+	    bench->gpu_ms_sum / (double)RENDER_BENCH_MEASURED_FRAMES;
+	bench->gpu_ms[bench->step][bench->mode] = avg_ms;
+#ifndef USE_SSBO_RENDERING
+	if (bench->mode == RENDER_MODE_HYBRID) {
+		hybrid_group_read_counts(
+		    &app->hybrid_group, &bench->hybrid_mesh_count[bench->step],
+		    &bench->hybrid_impostor_count[bench->step]);
+	}
+#endif
+	if (bench->mode == RENDER_MODE_BILLBOARD) {
+		billboard_stats_measure(&app->billboard_stats,
+		                        &app->billboard_group, view, proj,
+		                        camera_pos, 0,
+		                        &bench->fragments[bench->step]);
+		billboard_stats_measure(&app->billboard_stats,
+		                        &app->billboard_group, view, proj,
+		                        camera_pos, 1,
+		                        &bench->legacy_fragments[bench->step]);
+	}
+	LOG_INFO("suckless-ogl.bench", "%7d instances | %-9s | %.3f ms",
+	         RENDER_BENCH_INSTANCE_COUNTS[bench->step],
+	         RENDER_MODE_NAMES[bench->mode], avg_ms);
+
+	bench->frame = 0;
+	bench->gpu_ms_sum = 0.0;
+	bench->mode++;
+
+	if (bench->mode == RENDER_MODE_COUNT) {
+		bench->mode = RENDER_MODE_MESH;
+		bench->step++;
+
+		if (bench->step == RENDER_BENCH_STEPS) {
+			app_render_benchmark_report(bench);
+			bench->active = 0;
+			app->render_mode = bench->saved_mode;
+			app_set_instance_count(app,
+			                       bench->saved_instance_count);
+			return;
+		}
+		app_set_instance_count(app,
+		                       RENDER_BENCH_INSTANCE_COUNTS[bench->step]);
+	}
+
+	app->render_mode = bench->mode;
+}
+
+#ifndef USE_SSBO_RENDERING
+static void app_depth_benchmark_apply(App* app)
+{
+	const int config = app->depth_bench.config;
+	app->depth_prepass = (config & 1) != 0;
+	app->depth_sort = (config & 2) != 0;
+}
+#endif
+
+void app_depth_benchmark_start(App* app)
+{
+#ifdef USE_SSBO_RENDERING
+	LOG_WARN("suckless-ogl.bench",
+	         "Depth pre-pass benchmark requires the instanced VBO path");
+	(void)app;
+#else
+	DepthBenchmark* bench = &app->depth_bench;
+	if (bench->active || app->render_bench.active ||
+	    app->deferred_bench.active || app->light_bench.active ||
+	    app->tile_bench.active) {
+		return;
+	}
+
+	(void)memset(bench, 0, sizeof(*bench));
+	bench->active = 1;
+	bench->saved_mode = app->render_mode;
+	bench->saved_prepass = app->depth_prepass;
+	bench->saved_sort = app->depth_sort;
+
+	app->render_mode = RENDER_MODE_MESH;
+	app_depth_benchmark_apply(app);
+
+	if (!app->depth_sort_group.sorted.vao) {
+		LOG_WARN("suckless-ogl.bench",
+		         "Depth sort needs full instances: sorted "
+		         "configurations keep the buffer order");
+	}
+	LOG_INFO("suckless-ogl.bench",
+	         "Depth pre-pass benchmark started: %d instances (%d warmup + "
+	         "%d measured frames per configuration)",
+	         app->instance_count, DEPTH_BENCH_WARMUP_FRAMES,
+	         DEPTH_BENCH_MEASURED_FRAMES);
+#endif
+}
+
+#ifndef USE_SSBO_RENDERING
+static void app_depth_benchmark_report(const App* app)
+{
+	const DepthBenchmark* bench = &app->depth_bench;
+	const double pixels = (double)app->width * (double)app->height;
+
+	LOG_INFO("suckless-ogl.bench",
+	         "Configuration         sphere GPU ms | frame ms | shaded "
+	         "fragments (per pixel)");
+	for (int i = 0; i < DEPTH_BENCH_CONFIGS; i++) {
+		LOG_INFO("suckless-ogl.bench",
+		         "%-20s %13.3f | %8.3f | %12.0f (%.2f)",
+		         DEPTH_BENCH_CONFIG_NAMES[i], bench->gpu_ms[i],
+		         bench->frame_ms[i], bench->fragments[i],
+		         pixels > 0.0 ? bench->fragments[i] / pixels : 0.0);
+	}
+}
+#endif
+
+/* Appelé après la passe sphères de chaque frame pendant le benchmark */
+static void app_depth_benchmark_record(App* app, double gpu_ms)
+{
+#ifdef USE_SSBO_RENDERING
+	(void)app;
+	(void)gpu_ms;
+#else
+	DepthBenchmark* bench = &app->depth_bench;
+
+	bench->frame++;
+	if (bench->frame <= DEPTH_BENCH_WARMUP_FRAMES) {
+		return;
+	}
+
+	bench->gpu_ms_sum += gpu_ms;
+	bench->frame_ms_sum += app->delta_time * 1000.0;
+	bench->fragments_sum += app_fragment_query_result(app);
+	if (bench->frame <
+	    DEPTH_BENCH_WARMUP_FRAMES + DEPTH_BENCH_MEASURED_FRAMES) {
+		return;
+	}
+
+	/* Configuration terminée */
+	const int config = bench->config;
+	const double frames = (double)DEPTH_BENCH_MEASURED_FRAMES;
+	bench->gpu_ms[config] = bench->gpu_ms_sum / frames;
+	bench->frame_ms[config] = bench->frame_ms_sum / frames;
+	bench->fragments[config] = bench->fragments_sum / frames;
+	LOG_INFO("suckless-ogl.bench",
+	         "%-20s | sphere %.3f ms | frame %.3f ms | %.0f fragments",
+	         DEPTH_BENCH_CONFIG_NAMES[config], bench->gpu_ms[config],
+	         bench->frame_ms[config], bench->fragments[config]);
+
+	bench->frame = 0;
+	bench->gpu_ms_sum = 0.0;
+	bench->frame_ms_sum = 0.0;
+	bench->fragments_sum = 0.0;
+	bench->config++;
+
+	if (bench->config == DEPTH_BENCH_CONFIGS) {
+		app_depth_benchmark_report(app);
+		bench->active = 0;
+		app->render_mode = bench->saved_mode;
+		app->depth_prepass = bench->saved_prepass;
+		app->depth_sort = bench->saved_sort;
+		return;
+	}
+	app_depth_benchmark_apply(app);
+#endif
+}
+
+#ifndef USE_SSBO_RENDERING
+/* Régénère la scène de l'étape courante (overdraw croissant) */
+static void app_deferred_benchmark_setup(App* app)
+{
+	DeferredBenchmark* bench = &app->deferred_bench;
+	InstanceGenParams params = app->scale_test.params;
+	params.count = DEFERRED_BENCH_INSTANCES;
+	params.radius =
+	    params.spacing * DEFERRED_BENCH_RADIUS_SCALES[bench->step];
+	app_generate_instances(app, &params);
+	app->deferred_shading = bench->deferred;
+}
+#endif
+
+void app_deferred_benchmark_start(App* app)
+{
+#ifdef USE_SSBO_RENDERING
+	LOG_WARN("suckless-ogl.bench",
+	         "Deferred shading requires the instanced VBO path");
+	(void)app;
+#else
+	DeferredBenchmark* bench = &app->deferred_bench;
+	if (bench->active || app->render_bench.active ||
+	    app->depth_bench.active || app->light_bench.active ||
+	    app->tile_bench.active) {
+		return;
+	}
+	if (app->dynamic.active) {
+		LOG_WARN("suckless-ogl.bench",
+		         "Deferred benchmark needs static instances (U)");
+		return;
+	}
+	if (!app_ensure_deferred(app)) {
+		return;
+	}
+
+	GLuint query = bench->coverage_query;
+	(void)memset(bench, 0, sizeof(*bench));
+	if (!query) {
+		glGenQueries(1, &query);
+	}
+	bench->coverage_query = query;
+	bench->active = 1;
+	bench->saved_mode = app->render_mode;
+	bench->saved_deferred = app->deferred_shading;
+
+	app->render_mode = RENDER_MODE_MESH;
+	app_deferred_benchmark_setup(app);
+
+	LOG_INFO("suckless-ogl.bench",
+	         "Forward/deferred benchmark started: %d instances, radius "
+	         "%.1f..%.1f x spacing (%d warmup + %d measured frames)",
+	         DEFERRED_BENCH_INSTANCES, DEFERRED_BENCH_RADIUS_SCALES[0],
+	         DEFERRED_BENCH_RADIUS_SCALES[DEFERRED_BENCH_STEPS - 1],
+	         DEFERRED_BENCH_WARMUP_FRAMES, DEFERRED_BENCH_MEASURED_FRAMES);
+#endif
+}
+
+#ifndef USE_SSBO_RENDERING
+static void app_deferred_benchmark_report(const DeferredBenchmark* bench)
+{
+	LOG_INFO("suckless-ogl.bench",
+	         "Radius/spacing  overdraw | Forward ms | Deferred ms | IBL "
+	         "evaluations (forward/deferred)");
+	for (int step = 0; step < DEFERRED_BENCH_STEPS; step++) {
+		const double covered = bench->covered[step];
+		const double shaded = bench->fragments[step][0];
+		LOG_INFO("suckless-ogl.bench",
+		         "%14.1f %9.2f | %10.3f | %11.3f | %.0f / %.0f",
+		         DEFERRED_BENCH_RADIUS_SCALES[step],
+		         covered > 0.0 ? shaded / covered : 0.0,
+		         bench->gpu_ms[step][0], bench->gpu_ms[step][1],
+		         shaded, covered);
+	}
+}
+#endif
+
+/* Appelé après la passe sphères de chaque frame pendant le benchmark */
+static void app_deferred_benchmark_record(App* app, double gpu_ms)
+{
+#ifdef USE_SSBO_RENDERING
+	(void)app;
+	(void)gpu_ms;
+#else
+	DeferredBenchmark* bench = &app->deferred_bench;
+
+	bench->frame++;
+	if (bench->frame <= DEFERRED_BENCH_WARMUP_FRAMES) {
+		return;
+	}
+
+	bench->gpu_ms_sum += gpu_ms;
+	bench->fragments_sum += app_fragment_query_result(app);
+	if (bench->deferred) {
+		GLuint64 covered = 0;
+		glGetQueryObjectui64v(bench->coverage_query, GL_QUERY_RESULT,
+		                      &covered);
+		bench->coverage_sum += (double)covered;
+	}
+	if (bench->frame <
+	    DEFERRED_BENCH_WARMUP_FRAMES + DEFERRED_BENCH_MEASURED_FRAMES) {
+		return;
+	}
+
+	/* Chemin terminé pour cette étape */
+	const int step = bench->step;
+	const int path = bench->deferred;
+	const double frames = (double)DEFERRED_BENCH_MEASURED_FRAMES;
+	bench->gpu_ms[step][path] = bench->gpu_ms_sum / frames;
+	bench->fragments[step][path] = bench->fragments_sum / frames;
+	if (path) {
+		bench->covered[step] = bench->coverage_sum / frames;
+	}
+	LOG_INFO("suckless-ogl.bench",
+	         "radius %.1f x spacing | %-8s | %.3f ms | %.0f fragments",
+	         DEFERRED_BENCH_RADIUS_SCALES[step], SHADING_PATH_NAMES[path],
+	         bench->gpu_ms[step][path], bench->fragments[step][path]);
+
+	bench->frame = 0;
+	bench->gpu_ms_sum = 0.0;
+	bench->fragments_sum = 0.0;
+	bench->coverage_sum = 0.0;
+
+	if (!bench->deferred) {
+		bench->deferred = 1;
+		app->deferred_shading = 1;
+		return;
+	}
+
+	bench->deferred = 0;
+	bench->step++;
+	if (bench->step == DEFERRED_BENCH_STEPS) {
+		app_deferred_benchmark_report(bench);
+		bench->active = 0;
+		app->render_mode = bench->saved_mode;
+		app->deferred_shading = bench->saved_deferred;
+		if (app->scale_test.step == 0) {
+			app_init_instancing(app);
+		} else {
+			app_generate_instances(app, &app->scale_test.params);
+		}
+		return;
+	}
+	app_deferred_benchmark_setup(app);
+#endif
+}
+
+void app_set_light_count(App* app, int count)
+{
+	if (count > 0 && !app->lights.cull_shader &&
+	    !light_clusters_init(&app->lights)) {
+		return;
+	}
+	if (count <= 0) {
+		light_clusters_upload(&app->lights, NULL, 0);
+		return;
+	}
+
+	AnalyticLight* lights = malloc((size_t)count * sizeof(AnalyticLight));
+	if (!lights) {
+		LOG_ERROR("suckless-ogl.app", "Failed to allocate %d lights",
+		          count);
+		return;
+	}
+
+	/* Boîte de la grille d'instances, une cellule de marge autour et
+	 * de part et d'autre du plan des sphères */
+	const float half_extent =
+	    ((0.5F * (float)instance_generator_columns(app->instance_count)) +
+	     1.0F) *
+	    DEFAULT_SPACING;
+	const vec3 bounds_min = {-half_extent, -half_extent, -DEFAULT_SPACING};
+	const vec3 bounds_max = {half_extent, half_extent,
+	                         2.0F * DEFAULT_SPACING};
+	light_clusters_generate(lights, count, bounds_min, bounds_max,
+	                        LIGHT_SEED);
+	light_clusters_upload(&app->lights, lights, count);
+	free(lights);
+}
+
+void app_light_benchmark_start(App* app)
+{
+	LightBenchmark* bench = &app->light_bench;
+	if (bench->active || app->render_bench.active ||
+	    app->depth_bench.active || app->deferred_bench.active ||
+	    app->tile_bench.active) {
+		return;
+	}
+
+	(void)memset(bench, 0, sizeof(*bench));
+	bench->active = 1;
+	bench->saved_step = app->light_step;
+	app_set_light_count(app, LIGHT_STEP_COUNTS[0]);
+
+	LOG_INFO("suckless-ogl.bench",
+	         "Clustered lights benchmark started: %d..%d lights, %d "
+	         "instances (%d warmup + %d measured frames per count)",
+	         LIGHT_STEP_COUNTS[0], LIGHT_STEP_COUNTS[LIGHT_STEPS - 1],
+	         app->instance_count, LIGHT_BENCH_WARMUP_FRAMES,
+	         LIGHT_BENCH_MEASURED_FRAMES);
+}
+
+static void app_light_benchmark_report(const LightBenchmark* bench)
+{
+	LOG_INFO("suckless-ogl.bench",
+	         "Lights | cull GPU ms | sphere GPU ms | lights/cluster");
+	for (int step = 0; step < LIGHT_STEPS; step++) {
+		LOG_INFO("suckless-ogl.bench", "%6d | %11.3f | %13.3f | %.1f",
+		         LIGHT_STEP_COUNTS[step], bench->cull_ms[step],
+		         bench->gpu_ms[step], bench->lights_per_cluster[step]);
+	}
+}
+
+/* Appelé après la passe sphères de chaque frame pendant le benchmark */
+static void app_light_benchmark_record(App* app, double cull_ms,
+                                       double gpu_ms)
+{
+	LightBenchmark* bench = &app->light_bench;
+
+	bench->frame++;
+	if (bench->frame <= LIGHT_BENCH_WARMUP_FRAMES) {
+		return;
+	}
+
+	bench->cull_ms_sum += cull_ms;
+	bench->gpu_ms_sum += gpu_ms;
+	if (bench->frame <
+	    LIGHT_BENCH_WARMUP_FRAMES + LIGHT_BENCH_MEASURED_FRAMES) {
+		return;
+	}
+
+	/* Nombre de lumières terminé */
+	const int step = bench->step;
+	const double frames = (double)LIGHT_BENCH_MEASURED_FRAMES;
+	bench->cull_ms[step] = bench->cull_ms_sum / frames;
+	bench->gpu_ms[step] = bench->gpu_ms_sum / frames;
+	if (app->lights.light_count > 0) {
+		bench->lights_per_cluster[step] =
+		    (double)light_clusters_read_index_count(&app->lights) /
+		    (double)LIGHT_CLUSTER_COUNT;
+	}
+	LOG_INFO("suckless-ogl.bench",
+	         "%d lights | cull %.3f ms | sphere %.3f ms | %.1f "
+	         "lights/cluster",
+	         LIGHT_STEP_COUNTS[step], bench->cull_ms[step],
+	         bench->gpu_ms[step], bench->lights_per_cluster[step]);
+
+	bench->frame = 0;
+	bench->cull_ms_sum = 0.0;
+	bench->gpu_ms_sum = 0.0;
+	bench->step++;
+
+	if (bench->step == LIGHT_STEPS) {
+		app_light_benchmark_report(bench);
+		bench->active = 0;
+		app->light_step = bench->saved_step;
+		app_set_light_count(app, LIGHT_STEP_COUNTS[app->light_step]);
+		return;
+	}
+	app_set_light_count(app, LIGHT_STEP_COUNTS[bench->step]);
+}
 
-	shader_set_int(current_shader, "debugMode", app->pbr_debug_mode);
+void app_tile_benchmark_start(App* app)
+{
+	TileBenchmark* bench = &app->tile_bench;
+	if (bench->active || app->render_bench.active ||
+	    app->depth_bench.active || app->deferred_bench.active ||
+	    app->light_bench.active) {
+		return;
+	}
 
-	shader_set_vec3(current_shader, "camPos", camera_pos);
-	shader_set_mat4(current_shader, "projection", (float*)proj);
-	shader_set_mat4(current_shader, "view", (float*)view);
-	shader_set_mat4(
-	    current_shader, "previousViewProj",
-	    (float*)app->postprocess.motion_blur_fx.previous_view_proj);
+	PostProcess* post = &app->postprocess;
+	if (!post->composite_compute_shader ||
+	    !post->tile_classify_fx.classify_shader) {
+		LOG_WARN("suckless-ogl.bench",
+		         "Tile classes benchmark needs the compute composite");
+		return;
+	}
 
-	// Draw Quads Instanced
-	// Draw Quads Instanced
-	// 4 vertices per quad (Triangle Strip) is handled
-	// inside billboard_rendering
-	billboard_group_draw(&app->billboard_group);
+	(void)memset(bench, 0, sizeof(*bench));
+	bench->active = 1;
+	bench->saved_compute = post->compute_composite;
+	bench->saved_tiled = post->tile_classify_fx.enabled;
+	bench->saved_effects = post->active_effects;
+	bench->saved_yaw = app->camera.yaw_target;
+
+	postprocess_enable(post, POSTFX_DOF);
+	postprocess_enable(post, POSTFX_MOTION_BLUR);
+	(void)postprocess_set_compute_composite(post, 1);
+	(void)postprocess_set_tile_classification(post, 0);
+
+	LOG_INFO("suckless-ogl.bench",
+	         "Tile classes benchmark started: composite with DoF + motion "
+	         "blur, static then panning camera (%d warmup + %d measured "
+	         "frames per path)",
+	         TILE_BENCH_WARMUP_FRAMES, TILE_BENCH_MEASURED_FRAMES);
 }
 
-void app_render_instanced(App* app, mat4 view, mat4 proj, vec3 camera_pos)
+static void app_tile_benchmark_report(const TileBenchmark* bench)
 {
-	Shader* current_shader = NULL;
-#ifdef USE_SSBO_RENDERING
-	current_shader = app->pbr_ssbo_shader;
-#else
-	current_shader = app->pbr_instanced_shader;
-#endif
+	LOG_INFO("suckless-ogl.bench",
+	         "Camera  | full-screen ms | tile classes ms | tiles "
+	         "skip/cheap/full");
+	for (int step = 0; step < TILE_BENCH_STEPS; step++) {
+		LOG_INFO("suckless-ogl.bench",
+		         "%-7s | %14.3f | %15.3f | %u/%u/%u",
+		         TILE_BENCH_STEP_NAMES[step], bench->gpu_ms[step][0],
+		         bench->gpu_ms[step][1],
+		         bench->tiles[step][TILE_CLASS_SKIP],
+		         bench->tiles[step][TILE_CLASS_CHEAP],
+		         bench->tiles[step][TILE_CLASS_FULL]);
+	}
+}
 
-	shader_use(current_shader);
+/* Appelé après le post-processing de chaque frame pendant le benchmark */
+static void app_tile_benchmark_record(App* app, double gpu_ms)
+{
+	TileBenchmark* bench = &app->tile_bench;
+	PostProcess* post = &app->postprocess;
 
-	render_utils_bind_texture_safe(GL_TEXTURE0, app->irradiance_tex,
-	                               app->dummy_black_tex);
-	render_utils_bind_texture_safe(GL_TEXTURE1, app->spec_prefiltered_tex,
-	                               app->dummy_black_tex);
-	render_utils_bind_texture_safe(GL_TEXTURE2, app->brdf_lut_tex,
-	                               app->dummy_black_tex);
+	/* Panoramique : rotation constante, vélocités partout à l'écran */
+	if (bench->step == 1) {
+		app->camera.yaw += TILE_BENCH_PAN_DEGREES;
+		app->camera.yaw_target = app->camera.yaw;
+	}
 
-	shader_set_int(current_shader, "irradianceMap", 0);
-	shader_set_int(current_shader, "prefilterMap", 1);
-	shader_set_int(current_shader, "brdfLUT", 2);
+	bench->frame++;
+	if (bench->frame <= TILE_BENCH_WARMUP_FRAMES) {
+		return;
+	}
 
-	/* Pass PBR Debug Mode */
-	shader_set_int(current_shader, "debugMode", app->pbr_debug_mode);
+	bench->gpu_ms_sum += gpu_ms;
+	if (bench->frame <
+	    TILE_BENCH_WARMUP_FRAMES + TILE_BENCH_MEASURED_FRAMES) {
+		return;
+	}
 
-	shader_set_vec3(current_shader, "camPos", camera_pos);
-	shader_set_mat4(current_shader, "projection", (float*)proj);
-	shader_set_mat4(current_shader, "view", (float*)view);
+	/* Chemin terminé */
+	const int step = bench->step;
+	bench->gpu_ms[step][bench->tiled] =
+	    bench->gpu_ms_sum / (double)TILE_BENCH_MEASURED_FRAMES;
+	if (bench->tiled) {
+		(void)memcpy(bench->tiles[step], post->tile_classify_fx.counts,
+		             sizeof(bench->tiles[step]));
+	}
+	LOG_INFO("suckless-ogl.bench", "%s camera | %s | post %.3f ms",
+	         TILE_BENCH_STEP_NAMES[step],
+	         TILE_BENCH_PATH_NAMES[bench->tiled],
+	         bench->gpu_ms[step][bench->tiled]);
+
+	bench->frame = 0;
+	bench->gpu_ms_sum = 0.0;
+	bench->tiled = !bench->tiled;
+	if (!bench->tiled) {
+		bench->step++;
+	}
 
-	/* Pass Previous ViewProj for Velocity Buffer */
-	shader_set_mat4(
-	    current_shader, "previousViewProj",
-	    (float*)app->postprocess.motion_blur_fx.previous_view_proj);
+	if (bench->step == TILE_BENCH_STEPS) {
+		app_tile_benchmark_report(bench);
+		bench->active = 0;
+		post->active_effects = bench->saved_effects;
+		(void)postprocess_set_compute_composite(post,
+		                                        bench->saved_compute);
+		(void)postprocess_set_tile_classification(post,
+		                                          bench->saved_tiled);
+		app->camera.yaw = bench->saved_yaw;
+		app->camera.yaw_target = bench->saved_yaw;
+		return;
+	}
+	(void)postprocess_set_tile_classification(post, bench->tiled);
+}
 
-#ifdef USE_SSBO_RENDERING
-	ssbo_group_draw(&app->ssbo_group, app->geometry.indices.size);
-#else
-	instanced_group_draw(&app->instanced_group, app->geometry.indices.size);
-#endif
+void app_set_dynamic_resolution(App* app, int enabled)
+{
+	app->dynamic_resolution = enabled;
+	dynamic_resolution_set_target(&app->drs,
+	                              DRS_TARGET_MS[app->drs_target_step]);
+	/* Repart de la résolution native dans les deux cas */
+	dynamic_resolution_reset(&app->drs);
+	postprocess_set_render_scale(&app->postprocess, app->drs.scale);
+	LOG_INFO("suckless-ogl.drs",
+	         "Dynamic resolution: %s (GPU budget %.1f ms, scale "
+	         "%.2f..%.2f)",
+	         enabled ? "ON" : "OFF", DRS_TARGET_MS[app->drs_target_step],
+	         app->drs.min_scale, app->drs.max_scale);
 }
 
 void app_cleanup(App* app)
@@ -638,15 +2141,55 @@ void app_cleanup(App* app)
 	icosphere_free(&app->geometry);
 	skybox_cleanup(&app->skybox);
 
+	/* Possède les buffers VBO/NBO/EBO de tous les niveaux */
+	icosphere_cache_cleanup(&app->sphere_cache);
 	glDeleteVertexArrays(1, &app->sphere_vao);
 	glDeleteVertexArrays(1, &app->empty_vao);
-	glDeleteBuffers(1, &app->sphere_vbo);
-	glDeleteBuffers(1, &app->sphere_nbo);
-	glDeleteBuffers(1, &app->sphere_ebo);
+
+	depth_sort_group_cleanup(&app->depth_sort_group);
+	hybrid_group_cleanup(&app->hybrid_group);
+	billboard_group_cleanup(&app->billboard_group);
+	instanced_group_cleanup(&app->instanced_group);
+	billboard_stats_cleanup(&app->billboard_stats);
+	instance_generator_cleanup(&app->instance_gen);
+	instance_stream_cleanup(&app->instance_stream);
+	instance_sim_cleanup(&app->instance_sim);
+	material_table_cleanup(&app->material_table);
+#ifdef USE_SSBO_RENDERING
+	ssbo_group_cleanup(&app->ssbo_group);
+	if (app->pbr_ssbo_shader) {
+		shader_destroy(app->pbr_ssbo_shader);
+	}
+	if (app->pbr_ssbo_compact_shader) {
+		shader_destroy(app->pbr_ssbo_compact_shader);
+	}
+#endif
+	if (app->pbr_compact_shader) {
+		shader_destroy(app->pbr_compact_shader);
+	}
+	if (app->pbr_billboard_compact_shader) {
+		shader_destroy(app->pbr_billboard_compact_shader);
+	}
+	if (app->depth_prepass_shader) {
+		shader_destroy(app->depth_prepass_shader);
+	}
+	if (app->depth_prepass_compact_shader) {
+		shader_destroy(app->depth_prepass_compact_shader);
+	}
+	if (app->fragment_query) {
+		glDeleteQueries(1, &app->fragment_query);
+	}
+	if (app->deferred_bench.coverage_query) {
+		glDeleteQueries(1, &app->deferred_bench.coverage_query);
+	}
+	deferred_cleanup(&app->deferred);
+	light_clusters_cleanup(&app->lights);
+	dynamic_resolution_cleanup(&app->drs);
 
 	ui_destroy(&app->ui);
 
 	postprocess_cleanup(&app->postprocess);
+	gpu_readback_cleanup(&app->readback);
 	adaptive_sampler_cleanup(&app->fps_sampler);
 
 	/* Delete textures LAST because postprocess_cleanup might use dummy
@@ -659,20 +2202,26 @@ void app_cleanup(App* app)
 	glDeleteTextures(1, &app->dummy_white_tex);
 
 	async_loader_shutdown();
+	job_system_destroy(app->jobs);
+	app->jobs = NULL;
 
 	window_destroy(app->window);
 }
 
 void app_run(App* app)
 {
-	int last_subdiv = -1;
-
 	while (!glfwWindowShouldClose(app->window)) {
 		app->frame_count++;
+		/* Résultats GPU des frames précédentes, sans attente */
+		gpu_readback_poll(&app->readback);
 		double current_time = glfwGetTime();
 		app->delta_time = current_time - app->last_frame_time;
 		app->last_frame_time = current_time;
 		fps_update(&app->fps_counter, app->delta_time, current_time);
+#ifndef USE_SSBO_RENDERING
+		app_scale_test_update(app);
+#endif
+		app_dynamic_instances_update(app);
 		// Adaptive Sampling of Frame Time
 		adaptive_sampler_should_sample(
 		    &app->fps_sampler, (float)app->delta_time, current_time);
@@ -687,6 +2236,20 @@ void app_run(App* app)
 			         "Window Finished. Samples: "
 			         "%zu, Avg FPS: %.2f",
 			         count, avg);
+			if (app->dynamic_resolution && app->drs.has_sample) {
+				LOG_INFO("suckless-ogl.drs",
+				         "Render scale %.2f (%dx%d): "
+				         "scene %.2f ms + post %.2f ms "
+				         "/ %.1f ms",
+				         app->drs.scale,
+				         app->postprocess.render_width,
+				         app->postprocess.render_height,
+				         app->drs.scene_ms, app->drs.post_ms,
+				         app->drs.target_ms);
+			}
+			postprocess_variants_report(
+			    &app->postprocess.variants);
+			frame_graph_report(&app->postprocess.frame_graph);
 			adaptive_sampler_reset(&app->fps_sampler, current_time);
 		}
 
@@ -718,24 +2281,11 @@ void app_run(App* app)
 		// 3. Mise à jour des vecteurs de la caméra
 		camera_update_vectors(&app->camera);
 
-		/* Regenerate icosphere if subdivision level
-		 * changed */
-		if (app->subdivisions != last_subdiv) {
-			icosphere_generate(&app->geometry, app->subdivisions);
-
-			/* Upload to GPU */
-			app_update_gpu_buffers(app);
-
-#ifdef USE_SSBO_RENDERING
-			ssbo_group_bind_mesh(&app->ssbo_group, app->sphere_vbo,
-			                     app->sphere_nbo, app->sphere_ebo);
-#else
-			instanced_group_bind_mesh(
-			    &app->instanced_group, app->sphere_vbo,
-			    app->sphere_nbo, app->sphere_ebo);
-#endif
-
-			last_subdiv = app->subdivisions;
+		/* Subdivision : génération sur un worker, l'ancien maillage
+		 * reste dessiné jusqu'à l'échange */
+		if (icosphere_cache_request(&app->sphere_cache,
+		                            app->subdivisions)) {
+			app_use_sphere_mesh(app);
 		}
 
 		app_render(app);
@@ -781,12 +2331,9 @@ static void app_finalize_environment_load(App* app, AsyncRequest* req)
 }
 
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
-static void app_process_ibl_state_machine(App* app)
+static void app_ibl_step(App* app)
 {
 	IBLContext* ctx = &app->ibl_ctx;
-	if (ctx->state == IBL_STATE_IDLE) {
-		return;
-	}
 
 	switch (ctx->state) {
 		case IBL_STATE_LUMINANCE: {
@@ -797,18 +2344,21 @@ static void app_process_ibl_state_machine(App* app)
 				         "[Frame %llu] - "
 				         "Luminance...",
 				         (unsigned long long)app->frame_count);
-				ctx->threshold = compute_mean_luminance_gpu(
+				/* Seuil validé sur GPU, lu par spmap/irmap ;
+				 * la copie CPU n'arrive qu'au DONE */
+				ctx->luminance =
+				    (PbrLuminanceThreshold){0.0F, 0.0F};
+				(void)dispatch_mean_luminance_gpu(
 				    app->shader_lum_pass1,
-				    app->shader_lum_pass2, ctx->pending_hdr_tex,
-				    ctx->width, ctx->height,
-				    DEFAULT_CLAMP_MULTIPLIER, app->lum_ssbo);
+				    app->shader_lum_pass2,
+				    ctx->pending_hdr_tex, ctx->width,
+				    ctx->height, DEFAULT_CLAMP_MULTIPLIER,
+				    DEFAULT_AUTO_THRESHOLD, app->lum_ssbo);
+				ctx->luminance_ticket = gpu_readback_buffer(
+				    &app->readback, app->lum_ssbo[1], 0,
+				    sizeof(ctx->luminance), NULL,
+				    &ctx->luminance);
 			}
-
-			if (ctx->threshold < 1.0F || isnan(ctx->threshold) ||
-			    isinf(ctx->threshold)) {
-				ctx->threshold = DEFAULT_AUTO_THRESHOLD;
-			}
-			app->auto_threshold = ctx->threshold;
 			ctx->state = IBL_STATE_SPECULAR_INIT;
 			break;
 		}
@@ -853,7 +2403,7 @@ static void app_process_ibl_state_machine(App* app)
 						    PREFILTERED_SPECULAR_MAP_SIZE,
 						    PREFILTERED_SPECULAR_MAP_SIZE,
 						    mip, ctx->total_mips, 0, 1,
-						    ctx->threshold);
+						    app->lum_ssbo[1]);
 					}
 				}
 				/* Jump to next state immediately */
@@ -891,7 +2441,8 @@ static void app_process_ibl_state_machine(App* app)
 					    PREFILTERED_SPECULAR_MAP_SIZE,
 					    ctx->current_mip, ctx->total_mips,
 					    ctx->current_slice,
-					    ctx->total_slices, ctx->threshold);
+					    ctx->total_slices,
+					    app->lum_ssbo[1]);
 				}
 
 				ctx->current_slice++;
@@ -928,7 +2479,7 @@ static void app_process_ibl_state_machine(App* app)
 				    app->shader_irmap, ctx->pending_hdr_tex,
 				    ctx->pending_irr_tex, IRIDIANCE_MAP_SIZE,
 				    ctx->current_slice, ctx->total_slices,
-				    ctx->threshold);
+				    app->lum_ssbo[1]);
 			}
 
 			ctx->current_slice++;
@@ -939,6 +2490,18 @@ static void app_process_ibl_state_machine(App* app)
 		}
 
 		case IBL_STATE_DONE: {
+			/* Relecture en retard (rare) : une frame de plus.
+			 * Ticket 0 (anneau plein) : le GPU avait son seuil,
+			 * le CPU garde la valeur par défaut */
+			if (ctx->luminance_ticket != 0 &&
+			    !gpu_readback_done(&app->readback,
+			                       ctx->luminance_ticket)) {
+				break;
+			}
+			ctx->threshold = ctx->luminance_ticket != 0
+			                     ? ctx->luminance.clamp_threshold
+			                     : DEFAULT_AUTO_THRESHOLD;
+			app->auto_threshold = ctx->threshold;
 			postprocess_set_exposure(&app->postprocess,
 			                         ctx->threshold);
 
@@ -980,6 +2543,24 @@ static void app_process_ibl_state_machine(App* app)
 	}
 }
 
+static void app_process_ibl_state_machine(App* app)
+{
+	IBLContext* ctx = &app->ibl_ctx;
+	if (ctx->state == IBL_STATE_IDLE) {
+		return;
+	}
+
+	/* Luminance et allocation ne font qu'émettre du travail GPU : elles
+	 * partagent la frame de la première tranche spéculaire (le seuil est
+	 * lu sur GPU, aucune attente) */
+	IBLState previous = IBL_STATE_IDLE;
+	do {
+		previous = ctx->state;
+		app_ibl_step(app);
+	} while (previous == IBL_STATE_LUMINANCE ||
+	         previous == IBL_STATE_SPECULAR_INIT);
+}
+
 void app_update(App* app)
 {
 	AsyncRequest req;
@@ -991,35 +2572,73 @@ void app_update(App* app)
 	app_process_ibl_state_machine(app);
 }
 
-void app_update_gpu_buffers(App* app)
+/* Rend courant le maillage du cache : VAO principal et groupes re-liés
+ * aux buffers du niveau (les autres niveaux restent en VRAM) */
+void app_use_sphere_mesh(App* app)
 {
-	glBindVertexArray(app->sphere_vao);
+	const IcosphereMesh* mesh = icosphere_cache_current(&app->sphere_cache);
+	if (!mesh) {
+		return;
+	}
 
-	glBindBuffer(GL_ARRAY_BUFFER, app->sphere_vbo);
-	glBufferData(GL_ARRAY_BUFFER,
-	             (GLsizeiptr)(app->geometry.vertices.size * sizeof(vec3)),
-	             app->geometry.vertices.data, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(vec3), (void*)0);
-	glEnableVertexAttribArray(0);
-
-	glBindBuffer(GL_ARRAY_BUFFER, app->sphere_nbo);
-	glBufferData(GL_ARRAY_BUFFER,
-	             (GLsizeiptr)(app->geometry.normals.size * sizeof(vec3)),
-	             app->geometry.normals.data, GL_STATIC_DRAW);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(vec3), (void*)0);
-	glEnableVertexAttribArray(1);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, app->sphere_ebo);
-	glBufferData(
-	    GL_ELEMENT_ARRAY_BUFFER,
-	    (GLsizeiptr)(app->geometry.indices.size * sizeof(unsigned int)),
-	    app->geometry.indices.data, GL_STATIC_DRAW);
+	app->sphere_mesh = *mesh;
 
+	glBindVertexArray(app->sphere_vao);
+	icosphere_mesh_setup_vao(&app->sphere_mesh);
 	glBindVertexArray(0);
+
+#ifdef USE_SSBO_RENDERING
+	if (app->ssbo_group.vao) {
+		ssbo_group_bind_mesh(&app->ssbo_group, &app->sphere_mesh);
+	}
+#else
+	if (app->instanced_group.instance_vbo) {
+		instanced_group_bind_mesh(&app->instanced_group,
+		                          &app->sphere_mesh);
+	}
+	if (app->hybrid_group.mesh.instance_vbo) {
+		hybrid_group_bind_mesh(&app->hybrid_group, &app->sphere_mesh);
+	}
+	if (app->depth_sort_group.sorted.instance_vbo) {
+		depth_sort_group_bind_mesh(&app->depth_sort_group,
+		                           &app->sphere_mesh);
+	}
+#endif
+}
+
+/* Chemin synchrone : app->geometry devient le niveau app->subdivisions */
+void app_update_gpu_buffers(App* app)
+{
+	icosphere_cache_store(&app->sphere_cache, app->subdivisions,
+	                      &app->geometry);
+	app_use_sphere_mesh(app);
+}
+
+/* Post-processing encadré par les timestamps de la résolution dynamique */
+static void app_postprocess_end(App* app)
+{
+	if (app->dynamic_resolution) {
+		dynamic_resolution_mark(&app->drs, DRS_STAMP_POST);
+	}
+	postprocess_end(&app->postprocess);
+	if (app->dynamic_resolution) {
+		dynamic_resolution_mark(&app->drs, DRS_STAMP_END);
+	}
 }
 
 void app_render(App* app)
 {
+	/* Échelle de la frame d'après les timestamps déjà revenus (jamais
+	 * d'attente sur le GPU) */
+	if (app->dynamic_resolution) {
+		postprocess_set_render_scale(
+		    &app->postprocess, dynamic_resolution_update(&app->drs));
+		dynamic_resolution_mark(&app->drs, DRS_STAMP_SCENE);
+	}
+	dynamic_resolution_trace_marker(app->postprocess.render_scale,
+	                                app->postprocess.render_width,
+	                                app->postprocess.render_height);
+
 	/* Commencer le rendu dans le framebuffer de
 	 * post-processing */
 	postprocess_begin(&app->postprocess);
@@ -1042,7 +2661,7 @@ void app_render(App* app)
 		glBindVertexArray(0);
 
 		/* Terminer et appliquer le post-processing */
-		postprocess_end(&app->postprocess);
+		app_postprocess_end(app);
 
 		return;
 	}
@@ -1079,10 +2698,48 @@ void app_render(App* app)
 	 * depth buffer for early-Z culling) */
 	glPolygonMode(GL_FRONT_AND_BACK, app->wireframe ? GL_LINE : GL_FILL);
 
-	if (app->billboard_mode) {
-		app_render_billboards(app, view, proj, camera_pos);
+	/* Listes de lumières par cluster, lues par toutes les passes PBR */
+	if (!app->light_bench.active) {
+		light_clusters_cull(&app->lights, view, proj,
+		                    app->postprocess.render_width,
+		                    app->postprocess.render_height);
+	}
+
+	if (app->render_bench.active) {
+		GPUTimer sphere_timer = {0};
+		gpu_timer_start(&sphere_timer);
+		app_render_spheres(app, view, proj, camera_pos);
+		double sphere_ms = gpu_timer_elapsed_ms(&sphere_timer, 1);
+		gpu_timer_cleanup(&sphere_timer);
+		app_render_benchmark_record(app, sphere_ms, view, proj,
+		                            camera_pos);
+	} else if (app->depth_bench.active) {
+		GPU_MEASURE_MS(sphere_ms)
+		{
+			app_render_spheres(app, view, proj, camera_pos);
+		}
+		app_depth_benchmark_record(app, sphere_ms);
+	} else if (app->deferred_bench.active) {
+		GPU_MEASURE_MS(sphere_ms)
+		{
+			app_render_spheres(app, view, proj, camera_pos);
+		}
+		app_deferred_benchmark_record(app, sphere_ms);
+	} else if (app->light_bench.active) {
+		GPU_MEASURE_MS(cull_ms)
+		{
+			light_clusters_cull(
+			    &app->lights, view, proj,
+			    app->postprocess.render_width,
+			    app->postprocess.render_height);
+		}
+		GPU_MEASURE_MS(sphere_ms)
+		{
+			app_render_spheres(app, view, proj, camera_pos);
+		}
+		app_light_benchmark_record(app, cull_ms, sphere_ms);
 	} else {
-		app_render_instanced(app, view, proj, camera_pos);
+		app_render_spheres(app, view, proj, camera_pos);
 	}
 
 	/* 2. Render skybox LAST (using LEQUAL to fill
@@ -1097,7 +2754,15 @@ void app_render(App* app)
 	}
 
 	/* 4. Post-processing */
-	postprocess_end(&app->postprocess);
+	if (app->tile_bench.active) {
+		GPU_MEASURE_MS(post_ms)
+		{
+			app_postprocess_end(app);
+		}
+		app_tile_benchmark_record(app, post_ms);
+	} else {
+		app_postprocess_end(app);
+	}
 
 	/* Update Matrices for next frame (Velocity Buffer) */
 	postprocess_update_matrices(&app->postprocess, view_proj);
@@ -1141,9 +2806,58 @@ static void app_draw_help_overlay(App* app)
 	ui_layout_text(&layout, "[H] Toggle UI/Help", HELP_COLOR);
 	ui_layout_text(&layout, "[J] Toggle Auto-Exposure", HELP_COLOR);
 	ui_layout_text(&layout, "[B] Toggle Bloom", HELP_COLOR);
+	ui_layout_text(&layout, "[Shift + B] Bloom Mip Levels (3..8)",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Shift + G] Color LUT 64/32/Analytic",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Ctrl + G] Color LUT Error Report",
+	               HELP_COLOR);
 	ui_layout_text(&layout, "[M] Toggle Motion Blur", HELP_COLOR);
-	ui_layout_text(&layout, "[L] Toggle Billboard Mode", HELP_COLOR);
+	ui_layout_text(&layout, "[L] Cycle Mesh/Billboard/Hybrid", HELP_COLOR);
+	ui_layout_text(&layout, "[Shift + L] Benchmark Render Modes",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Ctrl + L] Sphere Positions f32/snorm16",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Ctrl + Shift + L] Benchmark Vertex Fetch",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[O] Toggle Depth Pre-pass", HELP_COLOR);
+	ui_layout_text(&layout, "[Shift + O] Toggle Front-to-Back Sort",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Ctrl + O] Benchmark Pre-pass/Sort",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[I] Mesh Shading Forward/Deferred",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Ctrl + I] Benchmark Forward/Deferred",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[T] Analytic Lights (0..10^4)", HELP_COLOR);
+	ui_layout_text(&layout, "[Ctrl + T] Benchmark Clustered Lights",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[N] GPU Scale Test (10^3..10^6)", HELP_COLOR);
+	ui_layout_text(&layout, "[Shift + N] Scale Test Grid/Poisson",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Ctrl + N] Scale Test Full/Compact",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[U] Dynamic Instances (Streaming)",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Shift + U] Dynamic Instance Count",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Ctrl + U] Benchmark Simulation Threads",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Y] Dynamic Resolution", HELP_COLOR);
+	ui_layout_text(&layout, "[Ctrl + Y] Postprocess Permutations/Uber",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Shift + Y] DRS GPU Budget (16.7/8.3/4.2)",
+	               HELP_COLOR);
 	ui_layout_text(&layout, "[K] Toggle Envmap", HELP_COLOR);
+	ui_layout_text(&layout, "[Ctrl + K] Composite Fragment/Compute",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Alt + Num*] Select Material", HELP_COLOR);
+	ui_layout_text(&layout, "[Alt + Num+/-] Material Roughness",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Shift + K] Compute Composite Tile Classes",
+	               HELP_COLOR);
+	ui_layout_text(&layout, "[Ctrl + Shift + K] Benchmark Tile Classes",
+	               HELP_COLOR);
 
 	ui_layout_separator(&layout, HELP_SECTION_PADDING);
 
@@ -1170,11 +2884,7 @@ static void app_draw_help_overlay(App* app)
 
 static void draw_exposure_debug_text(App* app)
 {
-	float exposure_val = 0.0F;
-	glBindTexture(GL_TEXTURE_2D,
-	              app->postprocess.auto_exposure_fx.exposure_tex);
-	glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, &exposure_val);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	const float exposure_val = postprocess_get_exposure(&app->postprocess);
 
 	char debug_text[DEBUG_TEXT_BUFFER_SIZE];
 	float luminance =
@@ -1192,52 +2902,35 @@ static void draw_exposure_debug_text(App* app)
 static int compute_luminance_histogram(App* app, int* buckets, int size,
                                        float* min_lum, float* max_lum)
 {
-	const int MAP_SIZE = 64;
-	const int TOTAL_PIXELS = MAP_SIZE * MAP_SIZE;
-	float* lum_data = malloc((size_t)TOTAL_PIXELS * sizeof(float));
-
-	if (!lum_data) {
+	unsigned int bins[LUM_HISTOGRAM_BINS];
+	if (!fx_auto_exposure_read_histogram(&app->postprocess, bins)) {
 		return 0;
 	}
 
-	glBindTexture(GL_TEXTURE_2D,
-	              app->postprocess.auto_exposure_fx.downsample_tex);
-	glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, lum_data);
-	glBindTexture(GL_TEXTURE_2D, 0);
-
 	for (int i = 0; i < size; i++) {
 		buckets[i] = 0;
 	}
 
-	static const float HISTO_MIN_INIT = 1000.0F;
-	static const float HISTO_MAX_INIT = -1000.0F;
-	*min_lum = HISTO_MIN_INIT;
-	*max_lum = HISTO_MAX_INIT;
-
-	for (int i = 0; i < TOTAL_PIXELS; i++) {
-		float val = lum_data[i];
-		if (val < *min_lum) {
-			*min_lum = val;
-		}
-		if (val > *max_lum) {
-			*max_lum = val;
-		}
-
-		static const float RANGE_OFFSET = 5.0F;
-		static const float RANGE_SCALE = 10.0F;
-		float norm = (val + RANGE_OFFSET) / RANGE_SCALE;
-		int idx = (int)(norm * (float)size);
-		if (idx < 0) {
-			idx = 0;
+	/* Bins 1..255 regroupés en `size` barres ; le bin 0 (trop sombre,
+	 * hors moyenne) n'est pas affiché */
+	const AutoExposureParams* params = &app->postprocess.auto_exposure;
+	int first = 0;
+	int last = 0;
+	for (int bin = 1; bin < LUM_HISTOGRAM_BINS; bin++) {
+		if (bins[bin] == 0) {
+			continue;
 		}
-		if (idx >= size) {
-			idx = size - 1;
+		if (first == 0) {
+			first = bin;
 		}
+		last = bin;
 
-		buckets[idx]++;
+		const int idx = (bin - 1) * size / (LUM_HISTOGRAM_BINS - 1);
+		buckets[idx] += (int)bins[bin];
 	}
 
-	free(lum_data);
+	*min_lum = first ? fx_auto_exposure_bin_log_lum(params, first) : 0.0F;
+	*max_lum = last ? fx_auto_exposure_bin_log_lum(params, last) : 0.0F;
 	return 1;
 }
 
@@ -1360,6 +3053,19 @@ void app_render_ui(App* app)
 
 		ui_layout_text(&layout, fps_text, DEFAULT_FONT_COLOR);
 
+		/* Échelle choisie par la résolution dynamique */
+		if (app->dynamic_resolution) {
+			char drs_text[DEBUG_TEXT_BUFFER_SIZE];
+			(void)safe_snprintf(
+			    drs_text, sizeof(drs_text),
+			    "Render scale: %.0f%% (%dx%d) GPU %.2f + %.2f ms",
+			    app->drs.scale * 100.0F,
+			    app->postprocess.render_width,
+			    app->postprocess.render_height, app->drs.scene_ms,
+			    app->drs.post_ms);
+			ui_layout_text(&layout, drs_text, DEFAULT_FONT_COLOR);
+		}
+
 		/* Adaptive Sampler Debug */
 		if (app->text_overlay_mode >= 2) {
 			static const size_t SAMPLER_BUF_SIZE = 256;
@@ -1422,31 +3128,9 @@ void app_render_ui(App* app)
 		float exposure_val = 0.0F;
 		if (postprocess_is_enabled(&app->postprocess,
 		                           POSTFX_AUTO_EXPOSURE)) {
-			/* Async Readback using PBO to avoid
-			 * pipeline stall */
-			glBindBuffer(GL_PIXEL_PACK_BUFFER, app->exposure_pbo);
-
-			/* 1. Read PREVIOUS frame's data (if
-			 * available) */
-			float* ptr = (float*)glMapBuffer(GL_PIXEL_PACK_BUFFER,
-			                                 GL_READ_ONLY);
-			if (ptr) {
-				app->current_exposure = *ptr;
-				glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
-			}
-
-			/* 2. Trigger async read for CURRENT
-			 * frame */
-			glBindTexture(
-			    GL_TEXTURE_2D,
-			    app->postprocess.auto_exposure_fx.exposure_tex);
-			glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT,
-			              0); /* Offset 0 */
-			glBindTexture(GL_TEXTURE_2D, 0);
-
-			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-
-			exposure_val = app->current_exposure;
+			/* Relue par GpuReadback, sans stall */
+			exposure_val =
+			    postprocess_get_exposure(&app->postprocess);
 		} else {
 			exposure_val = app->postprocess.exposure.exposure;
 		}
@@ -1456,6 +3140,15 @@ void app_render_ui(App* app)
 		                    "Exposure: %.3f", exposure_val);
 
 		ui_layout_text(&layout, exposure_text, ENV_TEXT_COLOR);
+
+		/* Cibles de post-process : scène + effets actifs (pool) */
+		static const float BYTES_PER_MB = 1024.0F * 1024.0F;
+		char vram_text[DEBUG_TEXT_BUFFER_SIZE];
+		(void)safe_snprintf(
+		    vram_text, sizeof(vram_text), "Post VRAM: %.1f MB",
+		    (double)((float)postprocess_vram_bytes(&app->postprocess) /
+		             BYTES_PER_MB));
+		ui_layout_text(&layout, vram_text, ENV_TEXT_COLOR);
 	}
 
 	/* 5. IBL Processing Indicator (Bottom-Right) */
@@ -1568,6 +3261,24 @@ static void handle_preset_input(App* app, int key)
 	}
 }
 
+/* Écart LUT couleur / chemin analytique (réglages courants) */
+static void app_report_color_lut_error(App* app)
+{
+	PostProcess* post = &app->postprocess;
+	ColorLutError error;
+	if (!fx_color_lut_measure_error(post, &error)) {
+		LOG_INFO("suckless-ogl.app",
+		         "Color LUT error: no baked LUT (analytic path)");
+		return;
+	}
+	LOG_INFO("suckless-ogl.app",
+	         "Color LUT %d^3 vs analytic: max %.2f levels, %.2f%% > 0.5, "
+	         "%.2f%% > 1 (%u samples)",
+	         post->color_lut_fx.size, error.max_error,
+	         100.0 * error.above_half, 100.0 * error.above_one,
+	         error.samples);
+}
+
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 static void handle_postprocess_input(App* app, int key)
 {
@@ -1582,7 +3293,39 @@ static void handle_postprocess_input(App* app, int key)
 			             : "OFF");
 			break;
 
-		case GLFW_KEY_G: /* Toggle Grain */
+		case GLFW_KEY_G: /* Toggle Grain / Color LUT */
+			if (glfwGetKey(app->window, GLFW_KEY_LEFT_CONTROL) ==
+			        GLFW_PRESS ||
+			    glfwGetKey(app->window, GLFW_KEY_RIGHT_CONTROL) ==
+			        GLFW_PRESS) {
+				app_report_color_lut_error(app);
+				break;
+			}
+			if (glfwGetKey(app->window, GLFW_KEY_LEFT_SHIFT) ==
+			        GLFW_PRESS ||
+			    glfwGetKey(app->window, GLFW_KEY_RIGHT_SHIFT) ==
+			        GLFW_PRESS) {
+				/* 64³ -> 32³ -> analytique -> 64³ */
+				PostProcess* post = &app->postprocess;
+				int size = COLOR_LUT_SIZE_LARGE;
+				if (post->color_lut_fx.size ==
+				    COLOR_LUT_SIZE_LARGE) {
+					size = COLOR_LUT_SIZE_SMALL;
+				} else if (post->color_lut_fx.size ==
+				           COLOR_LUT_SIZE_SMALL) {
+					size = 0;
+				}
+				size = postprocess_set_color_lut(post, size);
+				if (size) {
+					LOG_INFO("suckless-ogl.app",
+					         "Color pipeline: %d^3 LUT",
+					         size);
+				} else {
+					LOG_INFO("suckless-ogl.app",
+					         "Color pipeline: analytic");
+				}
+				break;
+			}
 			postprocess_toggle(&app->postprocess, POSTFX_GRAIN);
 			LOG_INFO("suckless-ogl.app", "Grain: %s",
 			         postprocess_is_enabled(&app->postprocess,
@@ -1591,7 +3334,22 @@ static void handle_postprocess_input(App* app, int key)
 			             : "OFF");
 			break;
 
-		case GLFW_KEY_B: /* Toggle Bloom */
+		case GLFW_KEY_B: /* Toggle Bloom / Mip Levels */
+			if (glfwGetKey(app->window, GLFW_KEY_LEFT_SHIFT) ==
+			        GLFW_PRESS ||
+			    glfwGetKey(app->window, GLFW_KEY_RIGHT_SHIFT) ==
+			        GLFW_PRESS) {
+				PostProcess* post = &app->postprocess;
+				int levels = post->bloom_fx.levels + 1;
+				if (levels > BLOOM_MAX_MIP_LEVELS) {
+					levels = BLOOM_MIN_CYCLE_LEVELS;
+				}
+				levels =
+				    postprocess_set_bloom_levels(post, levels);
+				LOG_INFO("suckless-ogl.app",
+				         "Bloom mip levels: %d", levels);
+				break;
+			}
 			postprocess_toggle(&app->postprocess, POSTFX_BLOOM);
 			LOG_INFO("suckless-ogl.app", "Bloom: %s",
 			         postprocess_is_enabled(&app->postprocess,
@@ -1785,6 +3543,34 @@ static void app_handle_env_input(App* app, int action, int mods, int key)
 	}
 }
 
+/*
+ * Édition d'un matériau de la bibliothèque : seule son entrée de la table
+ * GPU est re-téléversée, les instances compactes la relisent par index.
+ */
+static void app_handle_material_edit(App* app, int key)
+{
+	MaterialLib* lib = app->material_lib;
+	if (lib == NULL || lib->count <= 0) {
+		return;
+	}
+
+	if (key == GLFW_KEY_KP_MULTIPLY) {
+		app->edited_material = (app->edited_material + 1) % lib->count;
+	} else {
+		PBRMaterial* mat = &lib->materials[app->edited_material];
+		float step = key == GLFW_KEY_KP_ADD ? MATERIAL_ROUGHNESS_STEP
+		                                    : -MATERIAL_ROUGHNESS_STEP;
+		mat->roughness = fminf(fmaxf(mat->roughness + step, 0.0F),
+		                       1.0F);
+		material_table_update(&app->material_table, lib,
+		                      app->edited_material);
+	}
+
+	const PBRMaterial* mat = &lib->materials[app->edited_material];
+	LOG_INFO("suckless-ogl.app", "Material %d (%s): roughness %.2f",
+	         app->edited_material, mat->name, mat->roughness);
+}
+
 static void handle_app_input(App* app, int key, int mods)
 {
 	switch (key) {
@@ -1848,16 +3634,168 @@ static void handle_app_input(App* app, int key, int mods)
 			app_toggle_fullscreen(app, app->window);
 			break;
 		case GLFW_KEY_L:
-			app->billboard_mode = !app->billboard_mode;
-			app_update_instancing_mode(app);
-			LOG_INFO("suckless-ogl.app", "Billboard Mode: %s",
-			         app->billboard_mode ? "ON" : "OFF");
+			if (check_flag(mods, GLFW_MOD_CONTROL)) {
+				if (check_flag(mods, GLFW_MOD_SHIFT)) {
+					app_vertex_fetch_benchmark(app);
+				} else {
+					app_toggle_position_format(app);
+				}
+				break;
+			}
+			if (check_flag(mods, GLFW_MOD_SHIFT)) {
+				app_render_benchmark_start(app);
+				break;
+			}
+			app->render_mode =
+			    (app->render_mode + 1) % RENDER_MODE_COUNT;
+#ifdef USE_SSBO_RENDERING
+			/* Hybrid classification reads the mesh instance VBO */
+			if (app->render_mode == RENDER_MODE_HYBRID) {
+				app->render_mode = RENDER_MODE_MESH;
+			}
+#endif
+			LOG_INFO("suckless-ogl.app", "Render Mode: %s",
+			         RENDER_MODE_NAMES[app->render_mode]);
+			break;
+		case GLFW_KEY_O:
+			if (check_flag(mods, GLFW_MOD_CONTROL)) {
+				app_depth_benchmark_start(app);
+				break;
+			}
+#ifdef USE_SSBO_RENDERING
+			LOG_WARN("suckless-ogl.app",
+			         "Depth pre-pass/sort unavailable in SSBO "
+			         "rendering mode");
+#else
+			if (check_flag(mods, GLFW_MOD_SHIFT)) {
+				app->depth_sort = !app->depth_sort;
+				LOG_INFO("suckless-ogl.app",
+				         "Front-to-back sort (mesh): %s",
+				         app->depth_sort ? "ON" : "OFF");
+			} else {
+				app->depth_prepass = !app->depth_prepass;
+				LOG_INFO("suckless-ogl.app",
+				         "Depth pre-pass (mesh): %s",
+				         app->depth_prepass ? "ON" : "OFF");
+			}
+#endif
+			break;
+		case GLFW_KEY_I:
+			if (check_flag(mods, GLFW_MOD_CONTROL)) {
+				app_deferred_benchmark_start(app);
+				break;
+			}
+#ifdef USE_SSBO_RENDERING
+			LOG_WARN("suckless-ogl.app",
+			         "Deferred shading unavailable in SSBO "
+			         "rendering mode");
+#else
+			if (!app->deferred_shading &&
+			    !app_ensure_deferred(app)) {
+				break;
+			}
+			app->deferred_shading = !app->deferred_shading;
+			LOG_INFO("suckless-ogl.app", "Mesh shading: %s",
+			         SHADING_PATH_NAMES[app->deferred_shading]);
+#endif
+			break;
+		case GLFW_KEY_T:
+			if (check_flag(mods, GLFW_MOD_CONTROL)) {
+				app_light_benchmark_start(app);
+				break;
+			}
+			if (app->light_bench.active) {
+				break;
+			}
+			app->light_step = (app->light_step + 1) % LIGHT_STEPS;
+			app_set_light_count(app,
+			                    LIGHT_STEP_COUNTS[app->light_step]);
+			LOG_INFO("suckless-ogl.app",
+			         "Analytic lights (clustered): %d",
+			         app->lights.light_count);
+			break;
+		case GLFW_KEY_U:
+			if (check_flag(mods, GLFW_MOD_CONTROL)) {
+				app_dynamic_instances_benchmark(app);
+				break;
+			}
+			app_dynamic_instances_toggle(
+			    app, check_flag(mods, GLFW_MOD_SHIFT));
+			break;
+		case GLFW_KEY_N:
+#ifdef USE_SSBO_RENDERING
+			LOG_WARN("suckless-ogl.app",
+			         "Scale test unavailable in SSBO rendering mode");
+#else
+			app_scale_test_next(app, mods);
+#endif
+			break;
+		case GLFW_KEY_Y:
+			if (check_flag(mods, GLFW_MOD_CONTROL)) {
+				app->postprocess.variants.enabled =
+				    !app->postprocess.variants.enabled;
+				LOG_INFO("suckless-ogl.app",
+				         "Postprocess shader: %s",
+				         app->postprocess.variants.enabled
+				             ? "permutations"
+				             : "uber-shader");
+				break;
+			}
+			if (check_flag(mods, GLFW_MOD_SHIFT)) {
+				app->drs_target_step =
+				    (app->drs_target_step + 1) %
+				    DRS_TARGET_STEPS;
+				app_set_dynamic_resolution(app, 1);
+				break;
+			}
+			app_set_dynamic_resolution(app,
+			                           !app->dynamic_resolution);
 			break;
 		case GLFW_KEY_K:
+			if (check_flag(mods, GLFW_MOD_CONTROL) &&
+			    check_flag(mods, GLFW_MOD_SHIFT)) {
+				app_tile_benchmark_start(app);
+				break;
+			}
+			if (check_flag(mods, GLFW_MOD_SHIFT)) {
+				PostProcess* post = &app->postprocess;
+				const TileClassifyFX* tiles =
+				    &post->tile_classify_fx;
+				postprocess_set_tile_classification(
+				    post, !tiles->enabled);
+				LOG_INFO("suckless-ogl.app",
+				         "Compute composite tiles: %s "
+				         "(skip/cheap/full %u/%u/%u)",
+				         tiles->enabled ? "classes"
+				                        : "full-screen",
+				         tiles->counts[TILE_CLASS_SKIP],
+				         tiles->counts[TILE_CLASS_CHEAP],
+				         tiles->counts[TILE_CLASS_FULL]);
+				break;
+			}
+			if (check_flag(mods, GLFW_MOD_CONTROL)) {
+				PostProcess* post = &app->postprocess;
+				postprocess_set_compute_composite(
+				    post, !post->compute_composite);
+				LOG_INFO("suckless-ogl.app", "Composite: %s",
+				         post->compute_composite
+				             ? "compute (shared tile)"
+				             : "fragment");
+				break;
+			}
 			app->show_envmap = !app->show_envmap;
 			LOG_INFO("suckless-ogl.app", "Envmap: %s",
 			         app->show_envmap ? "ON" : "OFF");
 			break;
+		case GLFW_KEY_KP_ADD:
+		case GLFW_KEY_KP_SUBTRACT:
+		case GLFW_KEY_KP_MULTIPLY:
+			if (check_flag(mods, GLFW_MOD_ALT)) {
+				app_handle_material_edit(app, key);
+				break;
+			}
+			handle_postprocess_input(app, key);
+			break;
 		default:
 			handle_postprocess_input(app, key);
 			break;
@@ -1978,6 +3916,12 @@ static void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 
 	/* Redimensionner le post-processing */
 	postprocess_resize(&app->postprocess, width, height);
+
+	/* Le G-buffer référence les textures de scène recréées */
+	if (app->deferred.gbuffer_fbo &&
+	    !deferred_resize(&app->deferred, &app->postprocess)) {
+		LOG_ERROR("suckless-ogl.app", "Failed to resize G-buffer");
+	}
 }
 
 static void app_save_raw_frame(App* app, const char* filename)
@@ -2,6 +2,8 @@
 
 #include "gl_common.h"
 #include "instanced_rendering.h"
+#include "log.h"
+#include "shader.h"
 #include <cglm/types.h>
 #include <stddef.h>
 
@@ -10,6 +12,8 @@ void billboard_group_init(BillboardGroup* group, const SphereInstance* data,
 {
 	group->instance_count = count;
 	group->vao = 0;
+	group->format = INSTANCE_FORMAT_FULL;
+	group->stream = NULL;
 
 	/* Create and upload instance buffer */
 	glGenBuffers(1, &group->instance_vbo);
@@ -20,35 +24,31 @@ void billboard_group_init(BillboardGroup* group, const SphereInstance* data,
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-static void setup_billboard_instance_attributes()
+void billboard_group_init_compact(BillboardGroup* group,
+                                  const SphereInstanceCompact* data,
+                                  int count)
 {
-	GLsizei size_instance = (GLsizei)sizeof(SphereInstance);
-	GLuint index_vattrib = 2; /* Start at 2 (0=Pos, 1=unused/Normal) */
-
-	/* mat4 model (Locations 2, 3, 4, 5) */
-	for (int i = 0; i < 4; i++) {
-		glEnableVertexAttribArray(index_vattrib);
-		glVertexAttribPointer(index_vattrib, 4, GL_FLOAT, GL_FALSE,
-		                      size_instance,
-		                      BUFFER_OFFSET(i * sizeof(vec4)));
-		glVertexAttribDivisor(index_vattrib, 1);
-		index_vattrib++;
-	}
+	group->instance_count = count;
+	group->vao = 0;
+	group->format = INSTANCE_FORMAT_COMPACT;
+	group->stream = NULL;
 
-	/* Albedo (6) */
-	glEnableVertexAttribArray(index_vattrib);
-	glVertexAttribPointer(index_vattrib, 3, GL_FLOAT, GL_FALSE,
-	                      size_instance,
-	                      BUFFER_OFFSET(offsetof(SphereInstance, albedo)));
-	glVertexAttribDivisor(index_vattrib, 1);
-	index_vattrib++;
-
-	/* PBR (7) */
-	glEnableVertexAttribArray(index_vattrib);
-	glVertexAttribPointer(
-	    index_vattrib, 3, GL_FLOAT, GL_FALSE, size_instance,
-	    BUFFER_OFFSET(offsetof(SphereInstance, metallic)));
-	glVertexAttribDivisor(index_vattrib, 1);
+	glGenBuffers(1, &group->instance_vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, group->instance_vbo);
+	glBufferData(GL_ARRAY_BUFFER,
+	             (GLsizeiptr)((size_t)count * sizeof(SphereInstanceCompact)),
+	             data, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void billboard_group_init_stream(BillboardGroup* group, InstanceStream* stream,
+                                 InstanceFormat format, int count)
+{
+	group->instance_count = count;
+	group->vao = 0;
+	group->format = format;
+	group->stream = stream;
+	group->instance_vbo = stream->buffer;
 }
 
 void billboard_group_prepare(BillboardGroup* group, GLuint quad_vbo)
@@ -71,15 +71,14 @@ void billboard_group_prepare(BillboardGroup* group, GLuint quad_vbo)
 	/* CRITICAL: Explicitly set divisor to 0 for geometry attributes */
 	glVertexAttribDivisor(0, 0);
 
-	/* Layout 1: Normals (unused in billboards but kept for signature
-	 * consistency) */
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+	/* Layout 1: unused, as in the mesh VAOs (no normal stream) */
+	glDisableVertexAttribArray(1);
 	glVertexAttribDivisor(1, 0);
 
 	/* -- INSTANCES -- */
 	glBindBuffer(GL_ARRAY_BUFFER, group->instance_vbo);
-	setup_billboard_instance_attributes();
+	/* Same instance slots as the mesh path */
+	instanced_setup_attributes(group->format);
 
 	/* Explicitly disable and reset any higher slots that might have been
 	 * used by other shaders to keep the state "clean" for the driver.
@@ -107,7 +106,10 @@ void billboard_group_draw(BillboardGroup* group)
 	glDisable(GL_CULL_FACE);
 
 	/* Draw 4 vertices (Triangle Strip) -> 2 triangles (Quad) */
-	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, group->instance_count);
+	GLuint base_instance =
+	    group->stream ? instance_stream_base_instance(group->stream) : 0;
+	glDrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, 4,
+	                                  group->instance_count, base_instance);
 
 	/* Restore Face Culling only if it was enabled */
 	if (culling_was_enabled) {
@@ -119,12 +121,87 @@ void billboard_group_draw(BillboardGroup* group)
 
 void billboard_group_cleanup(BillboardGroup* group)
 {
-	if (group->instance_vbo) {
+	/* Le buffer d'un stream appartient au stream */
+	if (group->instance_vbo && !group->stream) {
 		glDeleteBuffers(1, &group->instance_vbo);
-		group->instance_vbo = 0;
 	}
+	group->instance_vbo = 0;
+	group->stream = NULL;
 	if (group->vao) {
 		glDeleteVertexArrays(1, &group->vao);
 		group->vao = 0;
 	}
 }
+
+int billboard_stats_init(BillboardStatsPass* pass)
+{
+	pass->shader = shader_load("shaders/pbr_ibl_billboard.vert",
+	                           "shaders/billboard_stats.frag");
+	if (!pass->shader) {
+		LOG_ERROR("suckless-ogl.billboard",
+		          "Failed to load billboard stats shader");
+		return 0;
+	}
+
+	glGenBuffers(1, &pass->counter_ssbo);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, pass->counter_ssbo);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(BillboardFragmentStats),
+	             NULL, GL_DYNAMIC_READ);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	return 1;
+}
+
+void billboard_stats_measure(BillboardStatsPass* pass, BillboardGroup* group,
+                             mat4 view, mat4 proj, vec3 camera_pos,
+                             int legacy_bounds, BillboardFragmentStats* out)
+{
+	BillboardFragmentStats stats = {0, 0};
+
+	if (!pass->shader || group->vao == 0) {
+		*out = stats;
+		return;
+	}
+
+	GL_SCOPE_DEBUG_GROUP("Billboard Fragment Stats");
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, pass->counter_ssbo);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(stats), &stats);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, pass->counter_ssbo);
+
+	shader_use(pass->shader);
+	shader_set_mat4(pass->shader, "projection", (float*)proj);
+	shader_set_mat4(pass->shader, "view", (float*)view);
+	shader_set_vec3(pass->shader, "camPos", camera_pos);
+	shader_set_int(pass->shader, "legacyBounds", legacy_bounds);
+
+	GLboolean depth_was_enabled = glIsEnabled(GL_DEPTH_TEST);
+	glDisable(GL_DEPTH_TEST);
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glDepthMask(GL_FALSE);
+
+	billboard_group_draw(group);
+
+	glDepthMask(GL_TRUE);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	if (depth_was_enabled) {
+		glEnable(GL_DEPTH_TEST);
+	}
+
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+	glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(stats), &stats);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	*out = stats;
+}
+
+void billboard_stats_cleanup(BillboardStatsPass* pass)
+{
+	if (pass->counter_ssbo) {
+		glDeleteBuffers(1, &pass->counter_ssbo);
+		pass->counter_ssbo = 0;
+	}
+	if (pass->shader) {
+		shader_destroy(pass->shader);
+		pass->shader = NULL;
+	}
+}
@@ -182,6 +182,17 @@ void camera_get_view_matrix(Camera* cam, mat4 view)
 	glm_lookat(cam->position, target, cam->up, view);
 }
 
+/* glm_perspective: proj[3][2] = 2fn/(n-f), proj[2][2] = (f+n)/(n-f) */
+float camera_projection_near(mat4 proj)
+{
+	return proj[3][2] / (proj[2][2] - 1.0F);
+}
+
+float camera_projection_far(mat4 proj)
+{
+	return proj[3][2] / (proj[2][2] + 1.0F);
+}
+
 void camera_process_scroll(Camera* cam, float yoffset)
 {
 	vec3 impulse;
@@ -0,0 +1,208 @@
+#include "deferred.h"
+
+#include "gl_common.h"
+#include "log.h"
+#include "postprocess.h"
+#include "render_utils.h"
+#include "shader.h"
+#include <cglm/cglm.h>
+#include <stddef.h>
+
+enum { DEFERRED_GBUFFER_ATTACHMENTS = 4, DEFERRED_FULLSCREEN_VERTICES = 3 };
+
+/* RGBA8 + RG16 + RG8 */
+static const size_t DEFERRED_BYTES_PER_PIXEL = 4 + 4 + 2;
+
+static GLuint create_target(int width, int height, GLenum internal_format,
+                            GLenum format, GLenum type, const char* label)
+{
+	GLuint texture = 0;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glObjectLabel(GL_TEXTURE, texture, -1, label);
+	glTexImage2D(GL_TEXTURE_2D, 0, (GLint)internal_format, width, height,
+	             0, format, type, NULL);
+	/* Lu par texelFetch uniquement */
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	return texture;
+}
+
+static void destroy_targets(DeferredRenderer* deferred)
+{
+	GLuint textures[] = {deferred->albedo_ao_tex, deferred->normal_tex,
+	                     deferred->material_tex};
+	glDeleteTextures(3, textures);
+	deferred->albedo_ao_tex = 0;
+	deferred->normal_tex = 0;
+	deferred->material_tex = 0;
+
+	GLuint framebuffers[] = {deferred->gbuffer_fbo, deferred->resolve_fbo};
+	glDeleteFramebuffers(2, framebuffers);
+	deferred->gbuffer_fbo = 0;
+	deferred->resolve_fbo = 0;
+}
+
+int deferred_resize(DeferredRenderer* deferred, const PostProcess* post)
+{
+	destroy_targets(deferred);
+
+	/* Ensure Unit 0 is active for initial texture setup */
+	glActiveTexture(GL_TEXTURE0);
+
+	const int width = post->width;
+	const int height = post->height;
+	deferred->width = width;
+	deferred->height = height;
+	deferred->depth_tex = post->scene_depth_tex;
+	deferred->scene_fbo = post->scene_fbo;
+
+	deferred->albedo_ao_tex =
+	    create_target(width, height, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE,
+	                  "G-Buffer Albedo/AO (RGBA8)");
+	deferred->normal_tex =
+	    create_target(width, height, GL_RG16, GL_RG, GL_UNSIGNED_SHORT,
+	                  "G-Buffer Normal (RG16 octahedral)");
+	deferred->material_tex =
+	    create_target(width, height, GL_RG8, GL_RG, GL_UNSIGNED_BYTE,
+	                  "G-Buffer Metallic/Roughness (RG8)");
+
+	/* Mêmes locations que pbr_ibl_instanced.frag pour la vélocité (1) */
+	glGenFramebuffers(1, &deferred->gbuffer_fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, deferred->gbuffer_fbo);
+	glObjectLabel(GL_FRAMEBUFFER, deferred->gbuffer_fbo, -1, "G-Buffer");
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+	                       GL_TEXTURE_2D, deferred->albedo_ao_tex, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1,
+	                       GL_TEXTURE_2D, post->velocity_tex, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2,
+	                       GL_TEXTURE_2D, deferred->normal_tex, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT3,
+	                       GL_TEXTURE_2D, deferred->material_tex, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+	                       GL_TEXTURE_2D, post->scene_depth_tex, 0);
+	const GLenum draw_buffers[DEFERRED_GBUFFER_ATTACHMENTS] = {
+	    GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2,
+	    GL_COLOR_ATTACHMENT3};
+	glDrawBuffers(DEFERRED_GBUFFER_ATTACHMENTS, draw_buffers);
+	int complete = render_utils_check_framebuffer("Deferred G-Buffer");
+
+	/* La résolution lit la profondeur : elle ne doit pas être attachée */
+	glGenFramebuffers(1, &deferred->resolve_fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, deferred->resolve_fbo);
+	glObjectLabel(GL_FRAMEBUFFER, deferred->resolve_fbo, -1,
+	              "Deferred Resolve");
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+	                       GL_TEXTURE_2D, post->scene_color_tex, 0);
+	complete &= render_utils_check_framebuffer("Deferred Resolve");
+
+	glBindFramebuffer(GL_FRAMEBUFFER, post->scene_fbo);
+	return complete;
+}
+
+int deferred_init(DeferredRenderer* deferred, const PostProcess* post)
+{
+	deferred->geometry_shader = shader_load(
+	    "shaders/pbr_ibl_instanced.vert", "shaders/gbuffer.frag");
+	deferred->geometry_compact_shader = shader_load(
+	    "shaders/pbr_ibl_instanced_compact.vert", "shaders/gbuffer.frag");
+	deferred->resolve_shader = shader_load(
+	    "shaders/deferred_resolve.vert", "shaders/deferred_resolve.frag");
+	if (!deferred->geometry_shader || !deferred->geometry_compact_shader ||
+	    !deferred->resolve_shader) {
+		LOG_ERROR("suckless-ogl.deferred",
+		          "Failed to load deferred shading shaders");
+		deferred_cleanup(deferred);
+		return 0;
+	}
+
+	render_utils_create_empty_vao(&deferred->empty_vao);
+	if (!deferred_resize(deferred, post)) {
+		deferred_cleanup(deferred);
+		return 0;
+	}
+
+	LOG_INFO("suckless-ogl.deferred",
+	         "G-buffer %dx%d: %zu bytes/pixel (%.1f MiB) + velocity/depth",
+	         deferred->width, deferred->height, DEFERRED_BYTES_PER_PIXEL,
+	         (double)DEFERRED_BYTES_PER_PIXEL * (double)deferred->width *
+	             (double)deferred->height / (1024.0 * 1024.0));
+	return 1;
+}
+
+void deferred_begin_geometry(DeferredRenderer* deferred)
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, deferred->gbuffer_fbo);
+}
+
+void deferred_resolve(DeferredRenderer* deferred, mat4 view, mat4 proj)
+{
+	GL_SCOPE_DEBUG_GROUP("Deferred Resolve");
+
+	Shader* shader = deferred->resolve_shader;
+	mat4 inv_view_proj;
+	glm_mat4_mul(proj, view, inv_view_proj);
+	glm_mat4_inv(inv_view_proj, inv_view_proj);
+	shader_set_mat4(shader, "invViewProj", (float*)inv_view_proj);
+
+	/* Viewport de la scène (plus petit que le G-buffer en résolution
+	 * dynamique) pour reconstruire les UV */
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	shader_set_vec2(shader, "viewportSize",
+	                (vec2){(float)viewport[2], (float)viewport[3]});
+
+	glActiveTexture(GL_TEXTURE0 + DEFERRED_TEX_UNIT_ALBEDO_AO);
+	glBindTexture(GL_TEXTURE_2D, deferred->albedo_ao_tex);
+	shader_set_int(shader, "gAlbedoAO", DEFERRED_TEX_UNIT_ALBEDO_AO);
+	glActiveTexture(GL_TEXTURE0 + DEFERRED_TEX_UNIT_NORMAL);
+	glBindTexture(GL_TEXTURE_2D, deferred->normal_tex);
+	shader_set_int(shader, "gNormal", DEFERRED_TEX_UNIT_NORMAL);
+	glActiveTexture(GL_TEXTURE0 + DEFERRED_TEX_UNIT_MATERIAL);
+	glBindTexture(GL_TEXTURE_2D, deferred->material_tex);
+	shader_set_int(shader, "gMaterial", DEFERRED_TEX_UNIT_MATERIAL);
+	glActiveTexture(GL_TEXTURE0 + DEFERRED_TEX_UNIT_DEPTH);
+	glBindTexture(GL_TEXTURE_2D, deferred->depth_tex);
+	shader_set_int(shader, "gDepth", DEFERRED_TEX_UNIT_DEPTH);
+
+	/* Le wireframe ne concerne que la passe géométrie */
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, deferred->resolve_fbo);
+	glBindVertexArray(deferred->empty_vao);
+	glDrawArrays(GL_TRIANGLES, 0, DEFERRED_FULLSCREEN_VERTICES);
+	glBindVertexArray(0);
+
+	/* La skybox se dessine ensuite avec le Z de la scène */
+	glBindFramebuffer(GL_FRAMEBUFFER, deferred->scene_fbo);
+}
+
+size_t deferred_gbuffer_bytes_per_pixel(void)
+{
+	return DEFERRED_BYTES_PER_PIXEL;
+}
+
+void deferred_cleanup(DeferredRenderer* deferred)
+{
+	destroy_targets(deferred);
+	if (deferred->empty_vao) {
+		glDeleteVertexArrays(1, &deferred->empty_vao);
+		deferred->empty_vao = 0;
+	}
+	if (deferred->geometry_shader) {
+		shader_destroy(deferred->geometry_shader);
+		deferred->geometry_shader = NULL;
+	}
+	if (deferred->geometry_compact_shader) {
+		shader_destroy(deferred->geometry_compact_shader);
+		deferred->geometry_compact_shader = NULL;
+	}
+	if (deferred->resolve_shader) {
+		shader_destroy(deferred->resolve_shader);
+		deferred->resolve_shader = NULL;
+	}
+	deferred->depth_tex = 0;
+	deferred->scene_fbo = 0;
+}
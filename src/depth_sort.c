@@ -0,0 +1,206 @@
+#include "depth_sort.h"
+
+#include "camera.h"
+#include "gl_common.h"
+#include "hybrid_rendering.h"
+#include "instanced_rendering.h"
+#include "log.h"
+#include "shader.h"
+#include <cglm/cglm.h>
+#include <math.h>
+#include <stddef.h>
+
+/* Doit correspondre à local_size_x de shaders/depth_sort.comp */
+enum { DEPTH_SORT_GROUP_SIZE = 256 };
+
+enum DepthSortPasses {
+	DEPTH_SORT_PASS_HISTOGRAM = 0,
+	DEPTH_SORT_PASS_SCAN = 1,
+	DEPTH_SORT_PASS_SCATTER = 2
+};
+
+enum DepthSortBindings {
+	DEPTH_SORT_BINDING_SOURCE = 0,
+	DEPTH_SORT_BINDING_SORTED = 1,
+	DEPTH_SORT_BINDING_KEYS = 2,
+	DEPTH_SORT_BINDING_BINS = 3,
+	DEPTH_SORT_BINDING_COMMAND = 4
+};
+
+static GLuint create_storage_buffer(GLenum target, size_t size, GLenum usage)
+{
+	GLuint buffer = 0;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(target, buffer);
+	glBufferData(target, (GLsizeiptr)size, NULL, usage);
+	glBindBuffer(target, 0);
+	return buffer;
+}
+
+int depth_sort_group_init(DepthSortGroup* group, GLuint source_buffer,
+                          int count)
+{
+	group->source_buffer = source_buffer;
+	group->source_offset = 0;
+	group->instance_count = count;
+
+	group->sort_shader =
+	    shader_load_compute_program("shaders/depth_sort.comp");
+	if (!group->sort_shader) {
+		LOG_ERROR("suckless-ogl.depth_sort",
+		          "Failed to load depth sort compute shader");
+		return 0;
+	}
+
+	group->sorted.vao = 0;
+	group->sorted.instance_count = count;
+	group->sorted.format = INSTANCE_FORMAT_FULL;
+	group->sorted.stream = NULL;
+	group->sorted.index_type = GL_UNSIGNED_INT;
+	/* Réécrit par la passe de scatter à chaque frame */
+	group->sorted.instance_vbo = create_storage_buffer(
+	    GL_ARRAY_BUFFER, (size_t)count * sizeof(SphereInstance),
+	    GL_DYNAMIC_COPY);
+
+	group->keys_buffer = create_storage_buffer(
+	    GL_SHADER_STORAGE_BUFFER, (size_t)count * sizeof(GLuint),
+	    GL_DYNAMIC_COPY);
+	group->bins_buffer = create_storage_buffer(
+	    GL_SHADER_STORAGE_BUFFER, 2 * DEPTH_SORT_BINS * sizeof(GLuint),
+	    GL_DYNAMIC_COPY);
+	group->command_buffer = create_storage_buffer(
+	    GL_DRAW_INDIRECT_BUFFER, sizeof(DrawElementsIndirectCommand),
+	    GL_DYNAMIC_DRAW);
+
+	LOG_INFO("suckless-ogl.depth_sort",
+	         "Depth sort group initialized: %d instances, %d bins", count,
+	         DEPTH_SORT_BINS);
+	return 1;
+}
+
+void depth_sort_group_bind_mesh(DepthSortGroup* group,
+                                const IcosphereMesh* mesh)
+{
+	instanced_group_bind_mesh(&group->sorted, mesh);
+}
+
+void depth_sort_group_sort(DepthSortGroup* group, mat4 view, mat4 proj,
+                           size_t index_count)
+{
+	if (group->instance_count <= 0 || !group->sort_shader) {
+		return;
+	}
+
+	GL_SCOPE_DEBUG_GROUP("Depth Sort");
+
+	DrawElementsIndirectCommand command = {(GLuint)index_count, 0, 0, 0,
+	                                       0};
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, group->command_buffer);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(command),
+	                &command);
+	/* Seuls les compteurs ont besoin d'être remis à zéro */
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, group->bins_buffer);
+	glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, 0,
+	                     DEPTH_SORT_BINS * sizeof(GLuint), GL_RED_INTEGER,
+	                     GL_UNSIGNED_INT, NULL);
+
+	mat4 view_proj;
+	vec4 planes[6];
+	glm_mat4_mul(proj, view, view_proj);
+	glm_frustum_planes(view_proj, planes);
+
+	const float near_plane = camera_projection_near(proj);
+	const float far_plane = camera_projection_far(proj);
+	const float bin_scale =
+	    (float)DEPTH_SORT_BINS / logf(far_plane / near_plane);
+
+	Shader* shader = group->sort_shader;
+	shader_use(shader);
+	shader_set_int(shader, "instanceCount", group->instance_count);
+	shader_set_mat4(shader, "view", (float*)view);
+	shader_set_vec4_array(shader, "frustumPlanes", (const float*)planes, 6);
+	shader_set_float(shader, "nearPlane", near_plane);
+	shader_set_float(shader, "binScale", bin_scale);
+
+	const size_t source_size =
+	    (size_t)group->instance_count * sizeof(SphereInstance);
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, DEPTH_SORT_BINDING_SOURCE,
+	                  group->source_buffer, group->source_offset,
+	                  (GLsizeiptr)source_size);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DEPTH_SORT_BINDING_SORTED,
+	                 group->sorted.instance_vbo);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DEPTH_SORT_BINDING_KEYS,
+	                 group->keys_buffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DEPTH_SORT_BINDING_BINS,
+	                 group->bins_buffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DEPTH_SORT_BINDING_COMMAND,
+	                 group->command_buffer);
+
+	GLuint groups =
+	    ((GLuint)group->instance_count + (DEPTH_SORT_GROUP_SIZE - 1)) /
+	    DEPTH_SORT_GROUP_SIZE;
+
+	shader_set_int(shader, "sortPass", DEPTH_SORT_PASS_HISTOGRAM);
+	glDispatchCompute(groups, 1, 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	shader_set_int(shader, "sortPass", DEPTH_SORT_PASS_SCAN);
+	glDispatchCompute(1, 1, 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	shader_set_int(shader, "sortPass", DEPTH_SORT_PASS_SCATTER);
+	glDispatchCompute(groups, 1, 1);
+
+	/* Instances lues comme attributs, commande en indirect */
+	glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+	                GL_COMMAND_BARRIER_BIT);
+}
+
+void depth_sort_group_draw(DepthSortGroup* group)
+{
+	if (group->sorted.vao == 0) {
+		return;
+	}
+
+	glBindVertexArray(group->sorted.vao);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, group->command_buffer);
+	glDrawElementsIndirect(GL_TRIANGLES, group->sorted.index_type,
+	                       BUFFER_OFFSET(0));
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+int depth_sort_group_read_count(DepthSortGroup* group)
+{
+	DrawElementsIndirectCommand command = {0};
+
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, group->command_buffer);
+	glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(command),
+	                   &command);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	return (int)command.instance_count;
+}
+
+void depth_sort_group_cleanup(DepthSortGroup* group)
+{
+	/* Le buffer trié appartient au sous-groupe */
+	instanced_group_cleanup(&group->sorted);
+	group->sorted.vao = 0;
+	group->sorted.instance_vbo = 0;
+
+	GLuint buffers[] = {group->keys_buffer, group->bins_buffer,
+	                    group->command_buffer};
+	glDeleteBuffers(3, buffers);
+	group->keys_buffer = 0;
+	group->bins_buffer = 0;
+	group->command_buffer = 0;
+
+	if (group->sort_shader) {
+		shader_destroy(group->sort_shader);
+		group->sort_shader = NULL;
+	}
+	group->source_buffer = 0;
+	group->source_offset = 0;
+	group->instance_count = 0;
+}
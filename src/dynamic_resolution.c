@@ -0,0 +1,127 @@
+#include "dynamic_resolution.h"
+
+#include "gl_common.h"
+#include "utils.h"
+#include <cglm/cglm.h>
+#include <math.h>
+
+/* Gains du régulateur (erreur relative -> fraction de pixels par frame) */
+static const float DRS_KP = 0.3F;
+static const float DRS_KI = 0.1F;
+/* Zone morte : +/- 5 % autour du budget */
+static const float DRS_DEADBAND = 0.05F;
+
+enum { DRS_TRACE_MARKER_SIZE = 64 };
+
+static float drs_clamp_area(const DynamicResolution* drs, float area)
+{
+	return glm_clamp(area, drs->min_scale * drs->min_scale,
+	                 drs->max_scale * drs->max_scale);
+}
+
+void dynamic_resolution_init(DynamicResolution* drs, float target_ms,
+                             float min_scale, float max_scale)
+{
+	*drs = (DynamicResolution){0};
+	drs->target_ms = target_ms;
+	drs->max_scale = glm_clamp(max_scale, 0.0F, 1.0F);
+	drs->min_scale = glm_clamp(min_scale, 0.0F, drs->max_scale);
+	dynamic_resolution_reset(drs);
+}
+
+void dynamic_resolution_set_target(DynamicResolution* drs, float target_ms)
+{
+	drs->target_ms = target_ms;
+}
+
+void dynamic_resolution_reset(DynamicResolution* drs)
+{
+	drs->scale = drs->max_scale;
+	drs->integral = drs->max_scale * drs->max_scale;
+	drs->has_sample = 0;
+	gpu_timestamp_ring_discard(&drs->timestamps);
+}
+
+void dynamic_resolution_mark(DynamicResolution* drs, DrsStamp stamp)
+{
+	if (!gpu_timestamp_ring_init(&drs->timestamps, DRS_STAMP_COUNT)) {
+		return;
+	}
+
+	if (stamp == DRS_STAMP_SCENE) {
+		gpu_timestamp_ring_begin(&drs->timestamps);
+	}
+	gpu_timestamp_ring_stamp(&drs->timestamps, stamp);
+	if (stamp == DRS_STAMP_END) {
+		gpu_timestamp_ring_end(&drs->timestamps, 1);
+	}
+}
+
+float dynamic_resolution_update(DynamicResolution* drs)
+{
+	/* Du plus ancien au plus récent : la dernière frame lue l'emporte */
+	GLuint64 stamps[DRS_STAMP_COUNT];
+	int fresh = 0;
+	while (gpu_timestamp_ring_try_read(&drs->timestamps, stamps, NULL) >=
+	       0) {
+		drs->scene_ms =
+		    (double)(stamps[DRS_STAMP_POST] - stamps[DRS_STAMP_SCENE]) /
+		    NS_PER_MS;
+		drs->post_ms =
+		    (double)(stamps[DRS_STAMP_END] - stamps[DRS_STAMP_POST]) /
+		    NS_PER_MS;
+		fresh = 1;
+	}
+
+	if (!fresh) {
+		return drs->scale;
+	}
+	drs->has_sample = 1;
+	return dynamic_resolution_step(drs, drs->scene_ms + drs->post_ms);
+}
+
+float dynamic_resolution_step(DynamicResolution* drs, double gpu_ms)
+{
+	if (drs->target_ms <= 0.0F) {
+		return drs->scale;
+	}
+
+	/* > 0 : marge disponible, < 0 : budget dépassé (borné pour qu'un
+	 * pic isolé ne vide pas l'intégrale) */
+	float error = (drs->target_ms - (float)gpu_ms) / drs->target_ms;
+	error = glm_clamp(error, -1.0F, 1.0F);
+	if (fabsf(error) < DRS_DEADBAND) {
+		error = 0.0F;
+	}
+
+	/* Intégrale bornée aux aires atteignables (anti-windup) */
+	drs->integral = drs_clamp_area(drs, drs->integral + (DRS_KI * error));
+	const float area =
+	    drs_clamp_area(drs, drs->integral + (DRS_KP * error));
+	const float wanted = sqrtf(area);
+
+	/* Hystérésis : petits écarts ignorés, sauf pour rejoindre une borne */
+	const int at_bound =
+	    wanted <= drs->min_scale || wanted >= drs->max_scale;
+	if (fabsf(wanted - drs->scale) >= DRS_SCALE_STEP ||
+	    (at_bound && wanted != drs->scale)) {
+		drs->scale = wanted;
+	}
+	return drs->scale;
+}
+
+void dynamic_resolution_trace_marker(float scale, int width, int height)
+{
+	char marker[DRS_TRACE_MARKER_SIZE];
+	(void)safe_snprintf(marker, sizeof(marker),
+	                    DRS_TRACE_MARKER_PREFIX "%.3f %dx%d", scale, width,
+	                    height);
+	/* NOTIFICATION : ignoré par le callback de debug (gl_debug.c) */
+	glDebugMessageInsert(GL_DEBUG_SOURCE_APPLICATION, GL_DEBUG_TYPE_MARKER,
+	                     0, GL_DEBUG_SEVERITY_NOTIFICATION, -1, marker);
+}
+
+void dynamic_resolution_cleanup(DynamicResolution* drs)
+{
+	gpu_timestamp_ring_cleanup(&drs->timestamps);
+}
@@ -1,41 +1,33 @@
 #include "fx_auto_exposure.h"
 
 #include "gl_common.h"
+#include "gpu_readback.h"
 #include "log.h"
 #include "postprocess.h"
 #include "shader.h"
+#include <math.h>
 #include <stddef.h>
+#include <string.h>
 
 /* Auto Exposure Constants */
-enum { LUM_DOWNSAMPLE_SIZE = 64 };
+enum {
+	LUM_HISTOGRAM_GROUP_SIZE = 16, /* 16x16 = un bin par invocation */
+	LUM_BINDING_HISTOGRAM = 0,
+	LUM_IMAGE_UNIT_EXPOSURE = 1
+};
 static const float EXPOSURE_INITIAL_VAL = 1.20F;
 
 int fx_auto_exposure_init(PostProcess* post_processing)
 {
 	AutoExposureFX* auto_exp = &post_processing->auto_exposure_fx;
 
-	/* 1. Downsample Logic (64x64 R16F) */
-	glGenFramebuffers(1, &auto_exp->downsample_fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, auto_exp->downsample_fbo);
-
-	glGenTextures(1, &auto_exp->downsample_tex);
-	glBindTexture(GL_TEXTURE_2D, auto_exp->downsample_tex);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, LUM_DOWNSAMPLE_SIZE,
-	             LUM_DOWNSAMPLE_SIZE, 0, GL_RED, GL_FLOAT, NULL);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-	                       GL_TEXTURE_2D, auto_exp->downsample_tex, 0);
-
-	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) !=
-	    GL_FRAMEBUFFER_COMPLETE) {
-		LOG_ERROR("suckless-ogl.postprocess.ae",
-		          "Lum Downsample FBO incomplete!");
-		return 0;
-	}
+	/* 1. Histogramme (bins + copie debug), remis à zéro par le GPU */
+	static const GLuint zero_bins[2 * LUM_HISTOGRAM_BINS] = {0};
+	glGenBuffers(1, &auto_exp->histogram_ssbo);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, auto_exp->histogram_ssbo);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(zero_bins), zero_bins,
+	             GL_DYNAMIC_COPY);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
 	/* 2. Adaptation Storage (1x1 RGBA32F) */
 	glGenTextures(1, &auto_exp->exposure_tex);
@@ -48,19 +40,22 @@ int fx_auto_exposure_init(PostProcess* post_processing)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
+	auto_exp->exposure = EXPOSURE_INITIAL_VAL;
+	auto_exp->avg_log_lum = 0.0F;
+	auto_exp->histogram_valid = 0;
+
 	/* 3. Load Shaders */
-	auto_exp->downsample_shader = shader_load(
-	    "shaders/postprocess.vert", "shaders/lum_downsample.frag");
+	auto_exp->histogram_shader =
+	    shader_load_compute_program("shaders/lum_histogram.comp");
 	auto_exp->adapt_shader =
 	    shader_load_compute_program("shaders/lum_adapt.comp");
 
-	if (!auto_exp->downsample_shader || !auto_exp->adapt_shader) {
+	if (!auto_exp->histogram_shader || !auto_exp->adapt_shader) {
 		LOG_ERROR("suckless-ogl.postprocess.ae",
 		          "Failed to load auto-exposure shaders");
 		return 0;
 	}
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 	return 1;
 }
 
@@ -68,21 +63,17 @@ void fx_auto_exposure_cleanup(PostProcess* post_processing)
 {
 	AutoExposureFX* auto_exp = &post_processing->auto_exposure_fx;
 
-	if (auto_exp->downsample_fbo) {
-		glDeleteFramebuffers(1, &auto_exp->downsample_fbo);
-		auto_exp->downsample_fbo = 0;
-	}
-	if (auto_exp->downsample_tex) {
-		glDeleteTextures(1, &auto_exp->downsample_tex);
-		auto_exp->downsample_tex = 0;
+	if (auto_exp->histogram_ssbo) {
+		glDeleteBuffers(1, &auto_exp->histogram_ssbo);
+		auto_exp->histogram_ssbo = 0;
 	}
 	if (auto_exp->exposure_tex) {
 		glDeleteTextures(1, &auto_exp->exposure_tex);
 		auto_exp->exposure_tex = 0;
 	}
-	if (auto_exp->downsample_shader) {
-		shader_destroy(auto_exp->downsample_shader);
-		auto_exp->downsample_shader = NULL;
+	if (auto_exp->histogram_shader) {
+		shader_destroy(auto_exp->histogram_shader);
+		auto_exp->histogram_shader = NULL;
 	}
 	if (auto_exp->adapt_shader) {
 		shader_destroy(auto_exp->adapt_shader);
@@ -90,6 +81,59 @@ void fx_auto_exposure_cleanup(PostProcess* post_processing)
 	}
 }
 
+static void exposure_readback_done(void* user, const void* data,
+                                   size_t size)
+{
+	AutoExposureFX* auto_exp = user;
+	float texel[4];
+	if (size != sizeof(texel)) {
+		return;
+	}
+	memcpy(texel, data, sizeof(texel));
+	auto_exp->exposure = texel[0];
+	auto_exp->avg_log_lum = texel[1];
+}
+
+static void histogram_readback_done(void* user, const void* data,
+                                    size_t size)
+{
+	AutoExposureFX* auto_exp = user;
+	if (size != sizeof(auto_exp->histogram)) {
+		return;
+	}
+	memcpy(auto_exp->histogram, data, size);
+	auto_exp->histogram_valid = 1;
+}
+
+static void request_readbacks(PostProcess* post_processing)
+{
+	AutoExposureFX* auto_exp = &post_processing->auto_exposure_fx;
+	GpuReadback* readback = post_processing->readback;
+
+	(void)gpu_readback_texture(readback, auto_exp->exposure_tex, 0,
+	                           GL_RGBA, GL_FLOAT, 4 * sizeof(float),
+	                           exposure_readback_done, auto_exp);
+
+	/* Copie debug : seconde moitié du buffer */
+	if (postprocess_is_enabled(post_processing, POSTFX_EXPOSURE_DEBUG)) {
+		(void)gpu_readback_buffer(
+		    readback, auto_exp->histogram_ssbo,
+		    (GLintptr)sizeof(auto_exp->histogram),
+		    sizeof(auto_exp->histogram), histogram_readback_done,
+		    auto_exp);
+	}
+}
+
+/* Plage log2 de l'histogramme = plage de clamp de la luminance */
+static void upload_histogram_range(Shader* shader,
+                                   const AutoExposureParams* params)
+{
+	const float min_log = log2f(params->min_luminance);
+	shader_set_float(shader, "minLogLum", min_log);
+	shader_set_float(shader, "logLumRange",
+	                 log2f(params->max_luminance) - min_log);
+}
+
 void fx_auto_exposure_render(PostProcess* post_processing)
 {
 	if (!postprocess_is_enabled(post_processing, POSTFX_AUTO_EXPOSURE)) {
@@ -97,58 +141,81 @@ void fx_auto_exposure_render(PostProcess* post_processing)
 	}
 
 	AutoExposureFX* auto_exp = &post_processing->auto_exposure_fx;
+	const AutoExposureParams* params = &post_processing->auto_exposure;
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LUM_BINDING_HISTOGRAM,
+	                 auto_exp->histogram_ssbo);
 
-	/* 1. Downsample Scene -> 64x64 Log Luminance */
-	glViewport(0, 0, LUM_DOWNSAMPLE_SIZE, LUM_DOWNSAMPLE_SIZE);
-	glBindFramebuffer(GL_FRAMEBUFFER, auto_exp->downsample_fbo);
+	/* 1. Histogramme : un pixel par invocation, région rendue seulement
+	 * (résolution dynamique) */
+	Shader* histogram = auto_exp->histogram_shader;
+	shader_use(histogram);
+	upload_histogram_range(histogram, params);
+	shader_set_vec2(histogram, "renderSize",
+	                (vec2){(float)post_processing->render_width,
+	                       (float)post_processing->render_height});
 
-	shader_use(auto_exp->downsample_shader);
 	glActiveTexture(GL_TEXTURE0);
+	/* Scène écrite en attachement : cohérente pour le sampler */
 	glBindTexture(GL_TEXTURE_2D, post_processing->scene_color_tex);
-	shader_set_int(auto_exp->downsample_shader, "sceneTexture", 0);
 
-	glBindVertexArray(post_processing->screen_quad_vao);
-	glDrawArrays(GL_TRIANGLES, 0, SCREEN_QUAD_VERTEX_COUNT);
-	glBindVertexArray(0);
-
-	/* 2. Compute Adaptation */
-	shader_use(auto_exp->adapt_shader);
-
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, auto_exp->downsample_tex);
-	shader_set_int(auto_exp->adapt_shader, "lumTexture", 0);
-
-	glBindImageTexture(1, auto_exp->exposure_tex, 0, GL_FALSE, 0,
-	                   GL_READ_WRITE, GL_RGBA32F);
-
-	shader_set_float(auto_exp->adapt_shader, "deltaTime",
-	                 post_processing->delta_time);
-	shader_set_float(auto_exp->adapt_shader, "minLuminance",
-	                 post_processing->auto_exposure.min_luminance);
-	shader_set_float(auto_exp->adapt_shader, "maxLuminance",
-	                 post_processing->auto_exposure.max_luminance);
-	shader_set_float(auto_exp->adapt_shader, "speedUp",
-	                 post_processing->auto_exposure.speed_up);
-	shader_set_float(auto_exp->adapt_shader, "speedDown",
-	                 post_processing->auto_exposure.speed_down);
-	shader_set_float(auto_exp->adapt_shader, "keyValue",
-	                 post_processing->auto_exposure.key_value);
-
-	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+	glDispatchCompute(
+	    (GLuint)((post_processing->render_width +
+	              LUM_HISTOGRAM_GROUP_SIZE - 1) /
+	             LUM_HISTOGRAM_GROUP_SIZE),
+	    (GLuint)((post_processing->render_height +
+	              LUM_HISTOGRAM_GROUP_SIZE - 1) /
+	             LUM_HISTOGRAM_GROUP_SIZE),
+	    1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	/* 2. Percentiles + moyenne + adaptation : un groupe de 256 */
+	Shader* adapt = auto_exp->adapt_shader;
+	shader_use(adapt);
+	upload_histogram_range(adapt, params);
+
+	glBindImageTexture(LUM_IMAGE_UNIT_EXPOSURE, auto_exp->exposure_tex, 0,
+	                   GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+
+	shader_set_float(adapt, "deltaTime", post_processing->delta_time);
+	shader_set_float(adapt, "minLuminance", params->min_luminance);
+	shader_set_float(adapt, "maxLuminance", params->max_luminance);
+	shader_set_float(adapt, "speedUp", params->speed_up);
+	shader_set_float(adapt, "speedDown", params->speed_down);
+	shader_set_float(adapt, "keyValue", params->key_value);
+	shader_set_float(adapt, "lowPercent", EXPOSURE_HISTOGRAM_LOW_PERCENT);
+	shader_set_float(adapt, "highPercent",
+	                 EXPOSURE_HISTOGRAM_HIGH_PERCENT);
+
+	/* Visibilité pour le composite et la frame suivante : graphe */
 	glDispatchCompute(1, 1, 1);
-	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
-	                GL_TEXTURE_FETCH_BARRIER_BIT);
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	glViewport(0, 0, post_processing->width, post_processing->height);
+	/* 3. Relectures pour le CPU, livrées quelques frames plus tard */
+	if (post_processing->readback) {
+		request_readbacks(post_processing);
+	}
 }
 
 float fx_auto_exposure_get_current_exposure(PostProcess* post_processing)
 {
-	AutoExposureFX* auto_exp = &post_processing->auto_exposure_fx;
-	float pixel[4];
-	glBindTexture(GL_TEXTURE_2D, auto_exp->exposure_tex);
-	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_FLOAT, pixel);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	return pixel[0];
+	return post_processing->auto_exposure_fx.exposure;
+}
+
+int fx_auto_exposure_read_histogram(PostProcess* post_processing,
+                                    unsigned int bins[LUM_HISTOGRAM_BINS])
+{
+	const AutoExposureFX* auto_exp = &post_processing->auto_exposure_fx;
+	if (!auto_exp->histogram_valid) {
+		return 0;
+	}
+	memcpy(bins, auto_exp->histogram, sizeof(auto_exp->histogram));
+	return 1;
+}
+
+float fx_auto_exposure_bin_log_lum(const AutoExposureParams* params, int bin)
+{
+	const float min_log = log2f(params->min_luminance);
+	const float range = log2f(params->max_luminance) - min_log;
+	return min_log + (((float)bin - 0.5F) /
+	                  (float)(LUM_HISTOGRAM_BINS - 1) * range);
 }
@@ -12,6 +12,13 @@ struct PostProcess;
 #define EXPOSURE_SPEED_UP 2.0F
 #define EXPOSURE_SPEED_DOWN 1.0F
 #define EXPOSURE_DEFAULT_KEY_VALUE 0.20F
+/* Percentiles conservés dans l'histogramme (ombres et reflets écartés) */
+#define EXPOSURE_HISTOGRAM_LOW_PERCENT 0.50F
+#define EXPOSURE_HISTOGRAM_HIGH_PERCENT 0.95F
+
+/* Bins de shaders/lum_histogram.glsl ; le bin 0 reçoit les pixels sous
+ * min_luminance, 1..255 couvrent [log2(min), log2(max)] */
+enum { LUM_HISTOGRAM_BINS = 256 };
 
 /* Paramètres pour l'Auto Exposure (Eye Adaptation) */
 typedef struct {
@@ -25,11 +32,17 @@ typedef struct {
 
 /* Structure regroupant les ressources graphiques de l'Auto Exposure */
 typedef struct {
-	GLuint downsample_fbo;
-	GLuint downsample_tex;
+	/* bins[256] (frame en cours) + copie pour l'overlay */
+	GLuint histogram_ssbo;
 	GLuint exposure_tex;
-	Shader* downsample_shader;
+	Shader* histogram_shader;
 	Shader* adapt_shader;
+
+	/* Dernières valeurs relues (GpuReadback, sans synchronisation) */
+	float exposure;
+	float avg_log_lum;
+	unsigned int histogram[LUM_HISTOGRAM_BINS];
+	int histogram_valid;
 } AutoExposureFX;
 
 /* Initialisation des ressources Auto Exposure */
@@ -38,11 +51,19 @@ int fx_auto_exposure_init(struct PostProcess* post_processing);
 /* Libération des ressources */
 void fx_auto_exposure_cleanup(struct PostProcess* post_processing);
 
-/* Rendu de l'effet (Downsample + Adaptation) */
+/* Rendu de l'effet (Histogramme + Adaptation), compute uniquement */
 void fx_auto_exposure_render(struct PostProcess* post_processing);
 
-/* Récupère la valeur d'exposition actuelle (du GPU) */
+/* Dernière exposition relue du GPU (valeur initiale sans GpuReadback) */
 float fx_auto_exposure_get_current_exposure(
     struct PostProcess* post_processing);
 
+/* Dernier histogramme relu, demandé tant que POSTFX_EXPOSURE_DEBUG est
+ * actif ; 0 si aucun n'est encore arrivé */
+int fx_auto_exposure_read_histogram(struct PostProcess* post_processing,
+                                    unsigned int bins[LUM_HISTOGRAM_BINS]);
+
+/* log2 de la luminance au centre du bin (1..LUM_HISTOGRAM_BINS-1) */
+float fx_auto_exposure_bin_log_lum(const AutoExposureParams* params, int bin);
+
 #endif /* FX_AUTO_EXPOSURE_H */
@@ -3,40 +3,27 @@
 #include "gl_common.h"
 #include "log.h"
 #include "postprocess.h"
+#include "render_target_pool.h"
 #include "shader.h"
 #include <cglm/types.h>
 #include <stddef.h>
 
-int fx_bloom_init(PostProcess* post_processing)
-{
-	/* Ensure Unit 0 is active for initial texture setup */
-	glActiveTexture(GL_TEXTURE0);
+enum {
+	BLOOM_GROUP_SIZE = 16, /* local_size des deux compute shaders */
+	BLOOM_SPD_TILE = 64,   /* Texels du niveau 0 par groupe et par côté */
+	BLOOM_BINDING_COUNTER = 0,
+	/* Niveaux assez petits pour être remontés par un seul groupe */
+	BLOOM_TAIL_MAX_TEXELS = 8192
+};
 
+/* Dimensions de la chaîne, les textures sont prises au premier rendu */
+static void bloom_layout_mips(PostProcess* post_processing)
+{
 	BloomFX* bloom = &post_processing->bloom_fx;
-
-	/* Load Shaders */
-	bloom->prefilter_shader = shader_load("shaders/postprocess.vert",
-	                                      "shaders/bloom_prefilter.frag");
-	bloom->downsample_shader = shader_load("shaders/postprocess.vert",
-	                                       "shaders/bloom_downsample.frag");
-	bloom->upsample_shader = shader_load("shaders/postprocess.vert",
-	                                     "shaders/bloom_upsample.frag");
-
-	if (!bloom->prefilter_shader || !bloom->downsample_shader ||
-	    !bloom->upsample_shader) {
-		LOG_ERROR("suckless-ogl.postprocess.bloom",
-		          "Failed to load bloom shaders");
-		return 0;
-	}
-
-	/* Create Resources */
-	glGenFramebuffers(1, &bloom->fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, bloom->fbo);
-
 	int width = post_processing->width;
 	int height = post_processing->height;
 
-	for (int i = 0; i < BLOOM_MIP_LEVELS; i++) {
+	for (int i = 0; i < bloom->levels; i++) {
 		width /= 2;
 		height /= 2;
 		if (width < 1) {
@@ -48,22 +35,66 @@ int fx_bloom_init(PostProcess* post_processing)
 
 		bloom->mips[i].width = width;
 		bloom->mips[i].height = height;
+	}
+}
+
+static void bloom_acquire_mips(PostProcess* post_processing)
+{
+	BloomFX* bloom = &post_processing->bloom_fx;
+	for (int i = 0; i < bloom->levels; i++) {
+		if (!bloom->mips[i].texture) {
+			bloom->mips[i].texture = render_target_pool_acquire(
+			    &post_processing->target_pool, bloom->mips[i].width,
+			    bloom->mips[i].height, GL_R11F_G11F_B10F,
+			    GL_LINEAR, BLOOM_TARGET_OWNER);
+		}
+	}
+}
+
+/* Rend la chaîne au pool */
+void fx_bloom_release(PostProcess* post_processing)
+{
+	BloomFX* bloom = &post_processing->bloom_fx;
+	for (int i = 0; i < BLOOM_MAX_MIP_LEVELS; i++) {
+		render_target_pool_release(&post_processing->target_pool,
+		                           bloom->mips[i].texture);
+		bloom->mips[i].texture = 0;
+	}
+}
 
-		glGenTextures(1, &bloom->mips[i].texture);
-		glBindTexture(GL_TEXTURE_2D, bloom->mips[i].texture);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, width, height,
-		             0, GL_RGB, GL_FLOAT, NULL);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
-		                GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
-		                GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
-		                GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,
-		                GL_CLAMP_TO_EDGE);
-	}
-
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+int fx_bloom_init(PostProcess* post_processing)
+{
+	BloomFX* bloom = &post_processing->bloom_fx;
+	if (bloom->levels == 0) {
+		bloom->levels = BLOOM_MIP_LEVELS;
+	}
+
+	/* Load Shaders */
+	bloom->spd_shader =
+	    shader_load_compute_program("shaders/bloom_downsample.comp");
+	bloom->upsample_compute_shader =
+	    shader_load_compute_program("shaders/bloom_upsample.comp");
+	bloom->downsample_shader = shader_load("shaders/postprocess.vert",
+	                                       "shaders/bloom_downsample.frag");
+	bloom->upsample_shader = shader_load("shaders/postprocess.vert",
+	                                     "shaders/bloom_upsample.frag");
+
+	if (!bloom->spd_shader || !bloom->upsample_compute_shader ||
+	    !bloom->downsample_shader || !bloom->upsample_shader) {
+		LOG_ERROR("suckless-ogl.postprocess.bloom",
+		          "Failed to load bloom shaders");
+		return 0;
+	}
+
+	/* Create Resources */
+	const GLuint zero = 0;
+	glGenBuffers(1, &bloom->spd_counter_ssbo);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, bloom->spd_counter_ssbo);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(zero), &zero,
+	             GL_DYNAMIC_COPY);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	bloom_layout_mips(post_processing);
 	return 1;
 }
 
@@ -71,21 +102,20 @@ void fx_bloom_cleanup(PostProcess* post_processing)
 {
 	BloomFX* bloom = &post_processing->bloom_fx;
 
-	if (bloom->fbo) {
-		glDeleteFramebuffers(1, &bloom->fbo);
-		bloom->fbo = 0;
-	}
+	fx_bloom_release(post_processing);
 
-	for (int i = 0; i < BLOOM_MIP_LEVELS; i++) {
-		if (bloom->mips[i].texture) {
-			glDeleteTextures(1, &bloom->mips[i].texture);
-			bloom->mips[i].texture = 0;
-		}
+	if (bloom->spd_counter_ssbo) {
+		glDeleteBuffers(1, &bloom->spd_counter_ssbo);
+		bloom->spd_counter_ssbo = 0;
 	}
 
-	if (bloom->prefilter_shader) {
-		shader_destroy(bloom->prefilter_shader);
-		bloom->prefilter_shader = NULL;
+	if (bloom->spd_shader) {
+		shader_destroy(bloom->spd_shader);
+		bloom->spd_shader = NULL;
+	}
+	if (bloom->upsample_compute_shader) {
+		shader_destroy(bloom->upsample_compute_shader);
+		bloom->upsample_compute_shader = NULL;
 	}
 	if (bloom->downsample_shader) {
 		shader_destroy(bloom->downsample_shader);
@@ -97,85 +127,128 @@ void fx_bloom_cleanup(PostProcess* post_processing)
 	}
 }
 
-void fx_bloom_render(PostProcess* post_processing)
+int fx_bloom_set_levels(PostProcess* post_processing, int levels)
 {
-	if (!postprocess_is_enabled(post_processing, POSTFX_BLOOM)) {
-		return;
-	}
-
 	BloomFX* bloom = &post_processing->bloom_fx;
-	glBindFramebuffer(GL_FRAMEBUFFER, bloom->fbo);
-	glDisable(GL_DEPTH_TEST);
-
-	/* 1. Prefilter */
-	shader_use(bloom->prefilter_shader);
-	shader_set_float(bloom->prefilter_shader, "threshold",
-	                 post_processing->bloom.threshold);
-	shader_set_float(bloom->prefilter_shader, "knee",
-	                 post_processing->bloom.soft_threshold);
+	if (levels < 1) {
+		levels = 1;
+	}
+	if (levels > BLOOM_MAX_MIP_LEVELS) {
+		levels = BLOOM_MAX_MIP_LEVELS;
+	}
+	if (levels == bloom->levels) {
+		return levels;
+	}
 
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, post_processing->scene_color_tex);
-	shader_set_int(bloom->prefilter_shader, "srcTexture", 0);
+	fx_bloom_release(post_processing);
+	for (int i = levels; i < BLOOM_MAX_MIP_LEVELS; i++) {
+		bloom->mips[i] = (BloomMip){0};
+	}
+	bloom->levels = levels;
+	bloom_layout_mips(post_processing);
+	return levels;
+}
 
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-	                       GL_TEXTURE_2D, bloom->mips[0].texture, 0);
-	glViewport(0, 0, bloom->mips[0].width, bloom->mips[0].height);
+void fx_bloom_resize(PostProcess* post_processing)
+{
+	fx_bloom_release(post_processing);
+	bloom_layout_mips(post_processing);
+}
 
-	glBindVertexArray(post_processing->screen_quad_vao);
-	glDrawArrays(GL_TRIANGLES, 0, SCREEN_QUAD_VERTEX_COUNT);
+static int bloom_mip_texels(const BloomMip* mip)
+{
+	return mip->width * mip->height;
+}
 
-	/* 2. Downsample */
-	shader_use(bloom->downsample_shader);
-	shader_set_int(bloom->downsample_shader, "srcTexture", 0);
+static GLuint bloom_groups(int size, int group_size)
+{
+	return (GLuint)((size + group_size - 1) / group_size);
+}
 
-	for (int i = 0; i < BLOOM_MIP_LEVELS - 1; i++) {
-		const BloomMip* mip_src = &bloom->mips[i];
-		const BloomMip* mip_dst = &bloom->mips[i + 1];
+static void bloom_bind_mips(const BloomFX* bloom)
+{
+	for (int i = 0; i < bloom->levels; i++) {
+		glBindImageTexture((GLuint)i, bloom->mips[i].texture, 0,
+		                   GL_FALSE, 0, GL_READ_WRITE,
+		                   GL_R11F_G11F_B10F);
+	}
+}
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, mip_src->texture);
+/* Remontée additive des niveaux levels-2 .. 1 : les petits niveaux
+ * s'enchaînent dans un seul groupe, les grands ont chacun leur dispatch */
+static void bloom_upsample(PostProcess* post_processing)
+{
+	BloomFX* bloom = &post_processing->bloom_fx;
+	Shader* shader = bloom->upsample_compute_shader;
 
-		vec2 resolution = {(float)mip_src->width,
-		                   (float)mip_src->height};
-		shader_set_vec2(bloom->downsample_shader, "srcResolution",
-		                resolution);
+	shader_use(shader);
+	shader_set_float(shader, "filterRadius",
+	                 post_processing->bloom.radius);
 
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-		                       GL_TEXTURE_2D, mip_dst->texture, 0);
-		glViewport(0, 0, mip_dst->width, mip_dst->height);
+	int level = bloom->levels - 2;
+	while (level >= 1) {
+		const BloomMip* mip = &bloom->mips[level];
+		int first = level;
+		GLuint groups_x = 1;
+		GLuint groups_y = 1;
+
+		if (bloom_mip_texels(mip) <= BLOOM_TAIL_MAX_TEXELS) {
+			while (first > 1 &&
+			       bloom_mip_texels(&bloom->mips[first - 1]) <=
+			           BLOOM_TAIL_MAX_TEXELS) {
+				first--;
+			}
+		} else {
+			groups_x = bloom_groups(mip->width, BLOOM_GROUP_SIZE);
+			groups_y = bloom_groups(mip->height, BLOOM_GROUP_SIZE);
+		}
 
-		glDrawArrays(GL_TRIANGLES, 0, SCREEN_QUAD_VERTEX_COUNT);
+		shader_set_int(shader, "firstLevel", first);
+		shader_set_int(shader, "lastLevel", level);
+		glDispatchCompute(groups_x, groups_y, 1);
+		level = first - 1;
+		/* Après le niveau 1, la barrière vers le composite est posée
+		 * par le graphe */
+		if (level >= 1) {
+			glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
+			                GL_TEXTURE_FETCH_BARRIER_BIT);
+		}
 	}
+}
 
-	/* 3. Upsample with Blending */
-	shader_use(bloom->upsample_shader);
-	shader_set_int(bloom->upsample_shader, "srcTexture", 0);
-	shader_set_float(bloom->upsample_shader, "filterRadius",
-	                 post_processing->bloom.radius);
-
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_ONE, GL_ONE);
-	glBlendEquation(GL_FUNC_ADD);
-
-	for (int i = BLOOM_MIP_LEVELS - 2; i >= 0; i--) {
-		const BloomMip* mip_src = &bloom->mips[i + 1];
-		const BloomMip* mip_dst = &bloom->mips[i];
+void fx_bloom_render(PostProcess* post_processing)
+{
+	if (!postprocess_is_enabled(post_processing, POSTFX_BLOOM)) {
+		fx_bloom_release(post_processing);
+		return;
+	}
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, mip_src->texture);
+	BloomFX* bloom = &post_processing->bloom_fx;
+	Shader* spd = bloom->spd_shader;
+	bloom_acquire_mips(post_processing);
 
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-		                       GL_TEXTURE_2D, mip_dst->texture, 0);
-		glViewport(0, 0, mip_dst->width, mip_dst->height);
+	/* 1. Seuil + tous les niveaux descendants : un seul dispatch */
+	shader_use(spd);
+	shader_set_float(spd, "threshold", post_processing->bloom.threshold);
+	shader_set_float(spd, "knee", post_processing->bloom.soft_threshold);
+	shader_set_int(spd, "levelCount", bloom->levels);
 
-		glDrawArrays(GL_TRIANGLES, 0, SCREEN_QUAD_VERTEX_COUNT);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, post_processing->scene_color_tex);
+	bloom_bind_mips(bloom);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BLOOM_BINDING_COUNTER,
+	                 bloom->spd_counter_ssbo);
+
+	glDispatchCompute(bloom_groups(bloom->mips[0].width, BLOOM_SPD_TILE),
+	                  bloom_groups(bloom->mips[0].height, BLOOM_SPD_TILE),
+	                  1);
+
+	/* 2. Remontée jusqu'au niveau 1, le composite fait 1 -> 0 */
+	if (bloom->levels > 2) {
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
+		                GL_TEXTURE_FETCH_BARRIER_BIT);
+		bloom_upsample(post_processing);
 	}
-
-	glDisable(GL_BLEND);
-	glBindVertexArray(0);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	glViewport(0, 0, post_processing->width, post_processing->height);
 }
 
 void fx_bloom_upload_params(Shader* shader, const BloomParams* params)
@@ -7,7 +7,15 @@
 /* Forward declaration */
 struct PostProcess;
 
-enum { BLOOM_MIP_LEVELS = 5 };
+enum {
+	BLOOM_MIP_LEVELS = 5, /* Nombre de niveaux par défaut */
+	/* Un image unit par niveau : 8 = minimum garanti de
+	 * GL_MAX_COMPUTE_IMAGE_UNIFORMS (cf. shaders/bloom_mips.glsl) */
+	BLOOM_MAX_MIP_LEVELS = 8
+};
+
+/* Propriétaire des niveaux dans le pool de cibles (rapport VRAM) */
+#define BLOOM_TARGET_OWNER "Bloom"
 
 /* Paramètres pour le Bloom (Physically Based) */
 typedef struct {
@@ -19,18 +27,23 @@ typedef struct {
 
 /* Structure pour un niveau de mip du Bloom */
 typedef struct {
-	GLuint texture;
+	GLuint texture; /* Prêtée par le pool, 0 : bloom éteint */
 	int width;
 	int height;
 } BloomMip;
 
 /* Structure regroupant les ressources graphiques du Bloom */
 typedef struct {
-	Shader* prefilter_shader;
+	/* Seuil + chaîne descendante en un dispatch (compute) */
+	Shader* spd_shader;
+	/* Remontée additive, niveaux 1+ (1 -> 0 fait par le composite) */
+	Shader* upsample_compute_shader;
+	GLuint spd_counter_ssbo; /* Groupes terminés (remis à 0 par le GPU) */
+	/* Passes fragment, réutilisées par le DoF */
 	Shader* downsample_shader;
 	Shader* upsample_shader;
-	GLuint fbo;
-	BloomMip mips[BLOOM_MIP_LEVELS];
+	int levels; /* 1..BLOOM_MAX_MIP_LEVELS, conservé au redimensionnement */
+	BloomMip mips[BLOOM_MAX_MIP_LEVELS];
 } BloomFX;
 
 /* Initialisation des ressources Bloom */
@@ -39,7 +52,19 @@ int fx_bloom_init(struct PostProcess* post_processing);
 /* Libération des ressources */
 void fx_bloom_cleanup(struct PostProcess* post_processing);
 
-/* Rendu de l'effet */
+/* Change le nombre de niveaux (borné), rend la chaîne au pool ; retourne
+ * le nombre retenu */
+int fx_bloom_set_levels(struct PostProcess* post_processing, int levels);
+
+/* Redimensionnement : chaîne rendue au pool, reprise au prochain rendu */
+void fx_bloom_resize(struct PostProcess* post_processing);
+
+/* Rend la chaîne au pool (effet éteint ou passe éliminée) */
+void fx_bloom_release(struct PostProcess* post_processing);
+
+/* Rendu de l'effet : prend la chaîne au pool au premier rendu actif, la
+ * rend dès que l'effet est désactivé. Les écritures du dernier dispatch
+ * sont rendues visibles par le graphe de frame. */
 void fx_bloom_render(struct PostProcess* post_processing);
 
 /* Upload des paramètres vers le shader principal */
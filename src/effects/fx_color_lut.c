@@ -0,0 +1,195 @@
+#include "fx_color_lut.h"
+
+#include "gl_common.h"
+#include "log.h"
+#include "postprocess.h"
+#include "shader.h"
+#include <stddef.h>
+#include <string.h>
+
+enum {
+	COLOR_LUT_IMAGE_UNIT = 0,
+	COLOR_LUT_BINDING_ERROR = 2 /* SSBO transitoire */
+};
+
+/* Compteurs de postprocess_lut_error.comp (std430) */
+typedef struct {
+	GLuint max_error_bits; /* floatBitsToUint, niveaux 8 bits */
+	GLuint above_half;
+	GLuint above_one;
+	GLuint samples;
+} ColorLutErrorCounters;
+
+int fx_color_lut_init(PostProcess* post_processing)
+{
+	ColorLutFX* lut = &post_processing->color_lut_fx;
+
+	lut->bake_shader =
+	    shader_load_compute_program("shaders/postprocess_lut.comp");
+	lut->error_shader =
+	    shader_load_compute_program("shaders/postprocess_lut_error.comp");
+	if (!lut->bake_shader || !lut->error_shader) {
+		LOG_WARN("suckless-ogl.postprocess.lut",
+		         "Color LUT unavailable, analytic color pipeline only");
+		fx_color_lut_cleanup(post_processing);
+		return 0;
+	}
+
+	/* 64³ : écart sous le niveau 8 bits, 32³ le dépasse autour des
+	 * tons moyens (fx_color_lut_measure_error) */
+	return fx_color_lut_set_size(post_processing, COLOR_LUT_SIZE_LARGE) !=
+	       0;
+}
+
+static void color_lut_destroy_texture(ColorLutFX* lut)
+{
+	if (lut->texture) {
+		glDeleteTextures(1, &lut->texture);
+		lut->texture = 0;
+	}
+	lut->size = 0;
+	lut->baked = 0;
+}
+
+void fx_color_lut_cleanup(PostProcess* post_processing)
+{
+	ColorLutFX* lut = &post_processing->color_lut_fx;
+
+	color_lut_destroy_texture(lut);
+	if (lut->bake_shader) {
+		shader_destroy(lut->bake_shader);
+		lut->bake_shader = NULL;
+	}
+	if (lut->error_shader) {
+		shader_destroy(lut->error_shader);
+		lut->error_shader = NULL;
+	}
+}
+
+int fx_color_lut_set_size(PostProcess* post_processing, int size)
+{
+	ColorLutFX* lut = &post_processing->color_lut_fx;
+
+	if (size != COLOR_LUT_SIZE_SMALL && size != COLOR_LUT_SIZE_LARGE) {
+		size = 0;
+	}
+	if (!lut->bake_shader) {
+		return 0;
+	}
+	if (size == lut->size) {
+		return size;
+	}
+
+	color_lut_destroy_texture(lut);
+	if (size == 0) {
+		return 0;
+	}
+
+	glGenTextures(1, &lut->texture);
+	glBindTexture(GL_TEXTURE_3D, lut->texture);
+	glTexStorage3D(GL_TEXTURE_3D, 1, GL_RGBA16F, size, size, size);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_3D, 0);
+	glObjectLabel(GL_TEXTURE, lut->texture, -1, "Color LUT");
+
+	lut->size = size;
+	lut->baked = 0;
+	return size;
+}
+
+/* Tout ce que lit la cuisson, dans un ordre fixe */
+static void color_lut_collect_inputs(const PostProcess* post_processing,
+                                     float inputs[COLOR_LUT_INPUT_COUNT])
+{
+	const WhiteBalanceParams* wb = &post_processing->white_balance;
+	const ColorGradingParams* cg = &post_processing->color_grading;
+	const TonemapParams* tm = &post_processing->tonemapper;
+	const int grading =
+	    (post_processing->active_effects & POSTFX_COLOR_GRADING) != 0;
+
+	const float values[COLOR_LUT_INPUT_COUNT] = {
+	    wb->temperature, wb->tint,         cg->saturation,
+	    cg->contrast,    cg->gamma,        cg->gain,
+	    cg->offset,      tm->slope,        tm->toe,
+	    tm->shoulder,    tm->black_clip,   tm->white_clip,
+	    grading ? 1.0F : 0.0F};
+	memcpy(inputs, values, sizeof(values));
+}
+
+void fx_color_lut_render(PostProcess* post_processing)
+{
+	ColorLutFX* lut = &post_processing->color_lut_fx;
+	if (!lut->size) {
+		return;
+	}
+
+	float inputs[COLOR_LUT_INPUT_COUNT];
+	color_lut_collect_inputs(post_processing, inputs);
+	if (lut->baked && memcmp(inputs, lut->inputs, sizeof(inputs)) == 0) {
+		return;
+	}
+
+	/* Paramètres lus dans l'UBO du composite */
+	const GLuint groups = (GLuint)(lut->size / COLOR_LUT_GROUP_SIZE);
+	shader_use(lut->bake_shader);
+	glBindImageTexture(COLOR_LUT_IMAGE_UNIT, lut->texture, 0, GL_TRUE, 0,
+	                   GL_WRITE_ONLY, GL_RGBA16F);
+	glDispatchCompute(groups, groups, groups);
+
+	memcpy(lut->inputs, inputs, sizeof(inputs));
+	lut->baked = 1;
+	lut->bake_count++;
+	LOG_INFO("suckless-ogl.postprocess.lut", "Color LUT baked (%d^3)",
+	         lut->size);
+}
+
+int fx_color_lut_measure_error(PostProcess* post_processing,
+                               ColorLutError* error)
+{
+	ColorLutFX* lut = &post_processing->color_lut_fx;
+	*error = (ColorLutError){0};
+	if (!lut->baked || !lut->error_shader) {
+		return 0;
+	}
+
+	const ColorLutErrorCounters zero = {0};
+	GLuint ssbo = 0;
+	glGenBuffers(1, &ssbo);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(zero), &zero,
+	             GL_DYNAMIC_READ);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COLOR_LUT_BINDING_ERROR,
+	                 ssbo);
+
+	glActiveTexture(GL_TEXTURE0 + COLOR_LUT_TEX_UNIT);
+	glBindTexture(GL_TEXTURE_3D, lut->texture);
+
+	const GLuint groups =
+	    (COLOR_LUT_ERROR_SAMPLES + COLOR_LUT_GROUP_SIZE - 1) /
+	    COLOR_LUT_GROUP_SIZE;
+	shader_use(lut->error_shader);
+	shader_set_int(lut->error_shader, "samplesPerAxis",
+	               COLOR_LUT_ERROR_SAMPLES);
+	glDispatchCompute(groups, groups, groups);
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	ColorLutErrorCounters counters;
+	glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(counters),
+	                   &counters);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glDeleteBuffers(1, &ssbo);
+
+	if (counters.samples == 0) {
+		return 0;
+	}
+	memcpy(&error->max_error, &counters.max_error_bits, sizeof(float));
+	error->above_half =
+	    (float)counters.above_half / (float)counters.samples;
+	error->above_one = (float)counters.above_one / (float)counters.samples;
+	error->samples = counters.samples;
+	return 1;
+}
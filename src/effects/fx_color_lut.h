@@ -0,0 +1,69 @@
+#ifndef FX_COLOR_LUT_H
+#define FX_COLOR_LUT_H
+
+#include "gl_common.h"
+#include "shader.h"
+
+/* Forward declaration */
+struct PostProcess;
+
+enum {
+	COLOR_LUT_SIZE_SMALL = 32,
+	COLOR_LUT_SIZE_LARGE = 64,
+	COLOR_LUT_GROUP_SIZE = 4, /* = postprocess_lut.comp (4x4x4) */
+	COLOR_LUT_TEX_UNIT = 8,   /* = color_lut.glsl */
+	/* Températures, teinte, grading (5), tonemapper (5), grading actif */
+	COLOR_LUT_INPUT_COUNT = 13,
+	/* Entrées testées par axe (entre les noeuds de la LUT) */
+	COLOR_LUT_ERROR_SAMPLES = 48
+};
+
+/* Écart LUT / chemin analytique, en niveaux 8 bits */
+typedef struct {
+	float max_error;
+	float above_half; /* Fraction des échantillons > 0.5 niveau */
+	float above_one;  /* Fraction des échantillons > 1 niveau */
+	unsigned int samples;
+} ColorLutError;
+
+/**
+ * LUT 3D de la chaîne couleur du composite.
+ *
+ * White balance, color grading, tonemapper filmique et gamma ne dépendent
+ * que de la couleur exposée et de paramètres qui changent rarement (édition,
+ * preset). Une passe compute les cuit dans une LUT size³ RGBA16F, entrée
+ * encodée en log (color_lut.glsl) ; le composite fait un seul fetch
+ * trilinéaire. La cuisson n'a lieu que si une entrée a changé.
+ */
+typedef struct {
+	Shader* bake_shader;
+	Shader* error_shader;
+	GLuint texture;
+	int size; /* 0 : chemin analytique */
+	int baked; /* La LUT correspond à `inputs` */
+	float inputs[COLOR_LUT_INPUT_COUNT];
+	int bake_count;
+} ColorLutFX;
+
+/* Initialisation (taille COLOR_LUT_SIZE_LARGE), 0 si les shaders manquent :
+ * le composite reste analytique */
+int fx_color_lut_init(struct PostProcess* post_processing);
+
+/* Libération des ressources */
+void fx_color_lut_cleanup(struct PostProcess* post_processing);
+
+/* 0 (analytique), COLOR_LUT_SIZE_SMALL ou COLOR_LUT_SIZE_LARGE ; retourne
+ * la taille retenue */
+int fx_color_lut_set_size(struct PostProcess* post_processing, int size);
+
+/* Recuit la LUT si ses entrées ont changé (UBO du composite déjà à
+ * jour) */
+void fx_color_lut_render(struct PostProcess* post_processing);
+
+/* Compare LUT et chemin analytique sur COLOR_LUT_ERROR_SAMPLES³ couleurs,
+ * avec les réglages du dernier composite (bloquant : rapport à la demande,
+ * tests). 0 sans LUT cuite. */
+int fx_color_lut_measure_error(struct PostProcess* post_processing,
+                               ColorLutError* error);
+
+#endif /* FX_COLOR_LUT_H */
@@ -7,6 +7,9 @@
 /* Forward declaration */
 struct PostProcess;
 
+/* Propriétaire des cibles dans le pool (rapport VRAM) */
+#define DOF_TARGET_OWNER "DoF"
+
 /* Paramètres pour le Depth of Field */
 typedef struct {
 	float focal_distance; /* Distance de mise au point (unités monde) */
@@ -17,8 +20,10 @@ typedef struct {
 /* Structure regroupant les ressources graphiques du DoF */
 typedef struct {
 	GLuint fbo;
-	GLuint blur_tex; /* 1/4 Res Blurred Texture (Final) */
-	GLuint temp_tex; /* 1/4 Res Intermediate Texture (Ping-Pong) */
+	/* 1/4 Res Blurred Texture (Final), prêtée par le pool, 0 : DoF
+	 * éteint. L'intermédiaire (ping-pong) n'est emprunté que pendant le
+	 * rendu. */
+	GLuint blur_tex;
 } DoFFX;
 
 /* Initialisation des ressources DoF */
@@ -30,7 +35,16 @@ void fx_dof_cleanup(struct PostProcess* post_processing);
 /* Redimensionnement des ressources */
 int fx_dof_resize(struct PostProcess* post_processing);
 
-/* Rendu de l'effet */
+/* Rend le flou final au pool */
+void fx_dof_release(struct PostProcess* post_processing);
+
+/* Taille du flou (1/4 de résolution), cible de la passe DoF */
+void fx_dof_target_size(const struct PostProcess* post_processing,
+                        int* width, int* height);
+
+/* Rendu de l'effet (cibles prises au pool au premier rendu actif, rendues
+ * dès que l'effet est désactivé), dof->fbo lié au viewport
+ * fx_dof_target_size() */
 void fx_dof_render(struct PostProcess* post_processing);
 
 /* Upload des paramètres vers le shader principal */
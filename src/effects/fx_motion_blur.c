@@ -3,6 +3,7 @@
 #include "gl_common.h"
 #include "log.h"
 #include "postprocess.h"
+#include "render_target_pool.h"
 #include "shader.h"
 #include <cglm/mat4.h>
 #include <cglm/types.h>
@@ -37,25 +38,25 @@ int fx_motion_blur_init(PostProcess* post_processing)
 		return 0;
 	}
 
-	/* 3. Initialiser les matrices */
+	/* 3. Initialiser les matrices (textures prises au premier rendu) */
 	glm_mat4_identity(mb_fx->previous_view_proj);
+	return 1;
+}
+
+void fx_motion_blur_release(PostProcess* post_processing)
+{
+	MotionBlurFX* mb_fx = &post_processing->motion_blur_fx;
 
-	/* 4. Créer les textures */
-	return fx_motion_blur_resize(post_processing);
+	render_target_pool_release(&post_processing->target_pool,
+	                           mb_fx->neighbor_max_tex);
+	mb_fx->neighbor_max_tex = 0;
 }
 
 void fx_motion_blur_cleanup(PostProcess* post_processing)
 {
 	MotionBlurFX* mb_fx = &post_processing->motion_blur_fx;
 
-	if (mb_fx->tile_max_tex) {
-		glDeleteTextures(1, &mb_fx->tile_max_tex);
-		mb_fx->tile_max_tex = 0;
-	}
-	if (mb_fx->neighbor_max_tex) {
-		glDeleteTextures(1, &mb_fx->neighbor_max_tex);
-		mb_fx->neighbor_max_tex = 0;
-	}
+	fx_motion_blur_release(post_processing);
 	if (mb_fx->tile_max_shader) {
 		shader_destroy(mb_fx->tile_max_shader);
 		mb_fx->tile_max_shader = NULL;
@@ -68,72 +69,40 @@ void fx_motion_blur_cleanup(PostProcess* post_processing)
 
 int fx_motion_blur_resize(PostProcess* post_processing)
 {
-	/* Ensure Unit 0 is active for initial texture setup */
-	glActiveTexture(GL_TEXTURE0);
-
-	MotionBlurFX* mb_fx = &post_processing->motion_blur_fx;
-
-	int tile_width =
-	    (post_processing->width + (MB_COMPUTE_GROUP_SIZE - 1)) /
-	    MB_COMPUTE_GROUP_SIZE;
-	int tile_height =
-	    (post_processing->height + (MB_COMPUTE_GROUP_SIZE - 1)) /
-	    MB_COMPUTE_GROUP_SIZE;
-
-	if (tile_width < 1) {
-		tile_width = 1;
-	}
-	if (tile_height < 1) {
-		tile_height = 1;
-	}
-
-	/* Tile Max Texture (RG16F) */
-	if (mb_fx->tile_max_tex) {
-		glDeleteTextures(1, &mb_fx->tile_max_tex);
-	}
-	glGenTextures(1, &mb_fx->tile_max_tex);
-	glBindTexture(GL_TEXTURE_2D, mb_fx->tile_max_tex);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, tile_width, tile_height, 0,
-	             GL_RG, GL_FLOAT, NULL);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-	/* Neighbor Max Texture (RG16F) */
-	if (mb_fx->neighbor_max_tex) {
-		glDeleteTextures(1, &mb_fx->neighbor_max_tex);
-	}
-	glGenTextures(1, &mb_fx->neighbor_max_tex);
-	glBindTexture(GL_TEXTURE_2D, mb_fx->neighbor_max_tex);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, tile_width, tile_height, 0,
-	             GL_RG, GL_FLOAT, NULL);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
+	/* Repris à la nouvelle taille au prochain rendu */
+	fx_motion_blur_release(post_processing);
 	return 1;
 }
 
 void fx_motion_blur_render(PostProcess* post_processing)
 {
 	MotionBlurFX* mb_fx = &post_processing->motion_blur_fx;
+	RenderTargetPool* pool = &post_processing->target_pool;
 
 	int groups_x = (post_processing->width + (MB_COMPUTE_GROUP_SIZE - 1)) /
 	               MB_COMPUTE_GROUP_SIZE;
 	int groups_y = (post_processing->height + (MB_COMPUTE_GROUP_SIZE - 1)) /
 	               MB_COMPUTE_GROUP_SIZE;
 
+	/* Une texel (RG16F) par tuile. Le tile max n'est lu que par la passe
+	 * 2 : emprunté pour ces deux dispatchs seulement */
+	if (!mb_fx->neighbor_max_tex) {
+		mb_fx->neighbor_max_tex = render_target_pool_acquire(
+		    pool, groups_x, groups_y, GL_RG16F, GL_NEAREST,
+		    MOTION_BLUR_TARGET_OWNER);
+	}
+	const GLuint tile_max_tex = render_target_pool_acquire(
+	    pool, groups_x, groups_y, GL_RG16F, GL_NEAREST,
+	    MOTION_BLUR_TARGET_OWNER);
+
 	/* Pass 1: Tile Max Velocity */
 	shader_use(mb_fx->tile_max_shader);
 
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, post_processing->velocity_tex);
-	shader_set_int(mb_fx->tile_max_shader, "velocityTexture", 0);
 
-	glBindImageTexture(1, mb_fx->tile_max_tex, 0, GL_FALSE, 0,
-	                   GL_WRITE_ONLY, GL_RG16F);
+	glBindImageTexture(1, tile_max_tex, 0, GL_FALSE, 0, GL_WRITE_ONLY,
+	                   GL_RG16F);
 
 	glDispatchCompute((GLuint)groups_x, (GLuint)groups_y, 1);
 	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
@@ -143,14 +112,14 @@ void fx_motion_blur_render(PostProcess* post_processing)
 	shader_use(mb_fx->neighbor_max_shader);
 
 	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, mb_fx->tile_max_tex);
-	shader_set_int(mb_fx->neighbor_max_shader, "tileMaxTexture", 0);
+	glBindTexture(GL_TEXTURE_2D, tile_max_tex);
 
 	glBindImageTexture(1, mb_fx->neighbor_max_tex, 0, GL_FALSE, 0,
 	                   GL_WRITE_ONLY, GL_RG16F);
 
+	/* Lecture par le composite : barrière posée par le graphe */
 	glDispatchCompute((GLuint)groups_x, (GLuint)groups_y, 1);
-	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+	render_target_pool_release(pool, tile_max_tex);
 }
 
 void fx_motion_blur_update_matrices(PostProcess* post_processing,
@@ -8,6 +8,9 @@
 /* Forward declaration */
 struct PostProcess;
 
+/* Propriétaire des cibles dans le pool (rapport VRAM) */
+#define MOTION_BLUR_TARGET_OWNER "Motion Blur"
+
 /* Paramètres pour le Motion Blur */
 typedef struct {
 	float intensity;
@@ -17,7 +20,8 @@ typedef struct {
 
 /* Structure regroupant les ressources graphiques du Motion Blur */
 typedef struct {
-	GLuint tile_max_tex;
+	/* Prêtée par le pool, 0 : pré-passe inactive. Le tile max n'est
+	 * emprunté que pendant le rendu. */
 	GLuint neighbor_max_tex;
 	Shader* tile_max_shader;
 	Shader* neighbor_max_shader;
@@ -30,9 +34,12 @@ int fx_motion_blur_init(struct PostProcess* post_processing);
 /* Libération des ressources */
 void fx_motion_blur_cleanup(struct PostProcess* post_processing);
 
-/* Redimensionnement des textures (tile/neighbor max) */
+/* Redimensionnement : neighbor max rendu au pool, repris au rendu */
 int fx_motion_blur_resize(struct PostProcess* post_processing);
 
+/* Rend le neighbor max au pool (pré-passe inutilisée) */
+void fx_motion_blur_release(struct PostProcess* post_processing);
+
 /* Rendu de l'effet (Passes Compute pour Tile/Neighbor Max) */
 void fx_motion_blur_render(struct PostProcess* post_processing);
 
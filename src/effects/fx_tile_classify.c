@@ -0,0 +1,194 @@
+#include "fx_tile_classify.h"
+
+#include "gl_common.h"
+#include "gpu_readback.h"
+#include "log.h"
+#include "postprocess.h"
+#include "postprocess_variants.h"
+#include "shader.h"
+#include "utils.h"
+#include <stddef.h>
+#include <string.h>
+
+enum { TILE_CLASSIFY_DEFINES_SIZE = 96 };
+
+static const char* const TILE_CLASS_NAMES[TILE_CLASS_COUNT] = {
+    "skip", "cheap", "full"};
+
+/* Effets retirés de la permutation de chaque classe */
+static const unsigned int TILE_CLASS_STRIPPED[TILE_CLASS_COUNT] = {
+    POSTFX_DOF | POSTFX_DOF_DEBUG | POSTFX_MOTION_BLUR |
+        POSTFX_MOTION_BLUR_DEBUG,
+    POSTFX_MOTION_BLUR | POSTFX_MOTION_BLUR_DEBUG, 0};
+
+void fx_tile_classify_defines(TileClass tile_class, char* out, size_t size)
+{
+	const unsigned int mask =
+	    POSTPROCESS_VARIANT_KEY_MASK & ~TILE_CLASS_STRIPPED[tile_class];
+	(void)safe_snprintf(out, size,
+	                    "#define POSTFX_TILE_CLASS %d\n"
+	                    "#define POSTFX_TILE_EFFECT_MASK 0x%03xu\n",
+	                    (int)tile_class, mask);
+}
+
+int fx_tile_classify_init(PostProcess* post_processing)
+{
+	TileClassifyFX* tiles = &post_processing->tile_classify_fx;
+
+	tiles->classify_shader =
+	    shader_load_compute_program("shaders/postprocess_classify.comp");
+	int loaded = tiles->classify_shader != NULL;
+	for (int i = 0; i < TILE_CLASS_COUNT && loaded; i++) {
+		char defines[TILE_CLASSIFY_DEFINES_SIZE];
+		char name[64];
+		fx_tile_classify_defines((TileClass)i, defines,
+		                         sizeof(defines));
+		(void)safe_snprintf(name, sizeof(name),
+		                    "shaders/postprocess.comp [tiles: %s]",
+		                    TILE_CLASS_NAMES[i]);
+		tiles->composite_shaders[i] =
+		    shader_load_compute_program_with_defines(
+		        "shaders/postprocess.comp", defines, name);
+		loaded = tiles->composite_shaders[i] != NULL;
+	}
+
+	if (!loaded) {
+		LOG_WARN("suckless-ogl.postprocess.tiles",
+		         "Tile classification unavailable, full-screen "
+		         "compute composite only");
+		fx_tile_classify_cleanup(post_processing);
+		return 0;
+	}
+
+	tiles->enabled = 1;
+	return fx_tile_classify_resize(post_processing);
+}
+
+static void tile_classify_destroy_buffers(TileClassifyFX* tiles)
+{
+	if (tiles->lists_ssbo) {
+		glDeleteBuffers(1, &tiles->lists_ssbo);
+		tiles->lists_ssbo = 0;
+	}
+	if (tiles->velocity_ssbo) {
+		glDeleteBuffers(1, &tiles->velocity_ssbo);
+		tiles->velocity_ssbo = 0;
+	}
+}
+
+void fx_tile_classify_cleanup(PostProcess* post_processing)
+{
+	TileClassifyFX* tiles = &post_processing->tile_classify_fx;
+
+	tile_classify_destroy_buffers(tiles);
+	if (tiles->classify_shader) {
+		shader_destroy(tiles->classify_shader);
+		tiles->classify_shader = NULL;
+	}
+	for (int i = 0; i < TILE_CLASS_COUNT; i++) {
+		if (tiles->composite_shaders[i]) {
+			shader_destroy(tiles->composite_shaders[i]);
+			tiles->composite_shaders[i] = NULL;
+		}
+	}
+	tiles->enabled = 0;
+}
+
+int fx_tile_classify_resize(PostProcess* post_processing)
+{
+	TileClassifyFX* tiles = &post_processing->tile_classify_fx;
+	if (!tiles->classify_shader) {
+		return 0;
+	}
+
+	const GLuint tiles_x =
+	    (GLuint)(post_processing->width + TILE_CLASSIFY_TILE_SIZE - 1) /
+	    TILE_CLASSIFY_TILE_SIZE;
+	const GLuint tiles_y =
+	    (GLuint)(post_processing->height + TILE_CLASSIFY_TILE_SIZE - 1) /
+	    TILE_CLASSIFY_TILE_SIZE;
+	const GLuint capacity = tiles_x * tiles_y;
+
+	tile_classify_destroy_buffers(tiles);
+	tiles->header = (TileClassifyHeader){0};
+	for (int i = 0; i < TILE_CLASS_COUNT; i++) {
+		tiles->header.dispatch[i][1] = 1;
+		tiles->header.dispatch[i][2] = 1;
+	}
+	tiles->header.grid[0] = tiles_x;
+	tiles->header.grid[1] = tiles_y;
+	tiles->header.grid[2] = capacity;
+	memset(tiles->counts, 0, sizeof(tiles->counts));
+
+	/* En-tête réécrit chaque frame (glBufferSubData), listes et
+	 * vélocités écrites par le GPU seulement */
+	const size_t lists_size = sizeof(TileClassifyHeader) +
+	                          ((size_t)TILE_CLASS_COUNT * capacity *
+	                           sizeof(GLuint));
+	glGenBuffers(1, &tiles->lists_ssbo);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, tiles->lists_ssbo);
+	glBufferStorage(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)lists_size,
+	                NULL, GL_DYNAMIC_STORAGE_BIT);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(tiles->header),
+	                &tiles->header);
+	glObjectLabel(GL_BUFFER, tiles->lists_ssbo, -1, "Composite Tile Lists");
+
+	glGenBuffers(1, &tiles->velocity_ssbo);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, tiles->velocity_ssbo);
+	glBufferStorage(GL_SHADER_STORAGE_BUFFER,
+	                (GLsizeiptr)(capacity * 2 * sizeof(float)), NULL, 0);
+	glObjectLabel(GL_BUFFER, tiles->velocity_ssbo, -1,
+	              "Composite Tile Velocity");
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	return 1;
+}
+
+static void counts_readback_done(void* user, const void* data, size_t size)
+{
+	TileClassifyFX* tiles = user;
+	TileClassifyHeader header;
+	if (size != sizeof(header.dispatch)) {
+		return;
+	}
+	memcpy(header.dispatch, data, size);
+	for (int i = 0; i < TILE_CLASS_COUNT; i++) {
+		tiles->counts[i] = header.dispatch[i][0];
+	}
+}
+
+void fx_tile_classify_render(PostProcess* post_processing)
+{
+	TileClassifyFX* tiles = &post_processing->tile_classify_fx;
+
+	/* 1. Compteurs à zéro (y = z = 1 conservés) */
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, tiles->lists_ssbo);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(tiles->header),
+	                &tiles->header);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TILE_CLASSIFY_BINDING_LISTS,
+	                 tiles->lists_ssbo);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER,
+	                 TILE_CLASSIFY_BINDING_VELOCITY, tiles->velocity_ssbo);
+
+	/* 2. Classification : une tuile par groupe */
+	shader_use(tiles->classify_shader);
+	glDispatchCompute(tiles->header.grid[0], tiles->header.grid[1], 1);
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+	if (post_processing->readback) {
+		(void)gpu_readback_buffer(post_processing->readback,
+		                          tiles->lists_ssbo, 0,
+		                          sizeof(tiles->header.dispatch),
+		                          counts_readback_done, tiles);
+	}
+
+	/* 3. Une permutation par classe, sur ses seules tuiles */
+	glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, tiles->lists_ssbo);
+	for (int i = 0; i < TILE_CLASS_COUNT; i++) {
+		shader_use(tiles->composite_shaders[i]);
+		glDispatchComputeIndirect(
+		    (GLintptr)(i * sizeof(tiles->header.dispatch[0])));
+	}
+	glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+}
@@ -0,0 +1,72 @@
+#ifndef FX_TILE_CLASSIFY_H
+#define FX_TILE_CLASSIFY_H
+
+#include "gl_common.h"
+#include "shader.h"
+
+/* Forward declaration */
+struct PostProcess;
+
+/* Classes de tuiles du composite compute (= tile_classes.glsl) */
+typedef enum {
+	TILE_CLASS_SKIP = 0, /* Ni DoF ni motion blur */
+	TILE_CLASS_CHEAP,    /* DoF seul : mélange avec le flou 1/4 res */
+	TILE_CLASS_FULL,     /* Motion blur (+ DoF) */
+	TILE_CLASS_COUNT
+} TileClass;
+
+enum {
+	TILE_CLASSIFY_TILE_SIZE = 16, /* = groupe de postprocess.comp */
+	TILE_CLASSIFY_BINDING_LISTS = 3,
+	TILE_CLASSIFY_BINDING_VELOCITY = 4
+};
+
+/* En-tête du buffer des listes (std430, TileLists dans tile_classes.glsl),
+ * suivi des TILE_CLASS_COUNT listes de `capacity` tuiles (x | y << 16) */
+typedef struct {
+	/* x : tuiles de la classe, y = z = 1 (glDispatchComputeIndirect) */
+	GLuint dispatch[TILE_CLASS_COUNT][4];
+	GLuint grid[4]; /* Tuiles en x, en y, capacité d'une liste, 0 */
+} TileClassifyHeader;
+
+/**
+ * Composite compute par classes de tuiles.
+ *
+ * Une passe de classification (une tuile 16x16 par groupe) réduit la
+ * vélocité max du voisinage et le facteur de flou DoF max de la tuile, puis
+ * ajoute la tuile à la liste de sa classe. Chaque classe est ensuite
+ * composée par glDispatchComputeIndirect avec une permutation de
+ * postprocess.comp dont les effets inutiles sont retirés à la compilation :
+ * les zones nettes et immobiles ne paient ni les taps de motion blur ni le
+ * CoC. La classification est exacte (mêmes seuils que les early exits des
+ * effets), l'image est identique au composite plein écran.
+ */
+typedef struct {
+	Shader* classify_shader;
+	Shader* composite_shaders[TILE_CLASS_COUNT];
+	GLuint lists_ssbo;    /* TileClassifyHeader + listes */
+	GLuint velocity_ssbo; /* vec2 par tuile, lue par la classe FULL */
+	TileClassifyHeader header; /* Remis dans le buffer à chaque frame */
+	int enabled;
+	/* Tuiles par classe, relues de façon asynchrone */
+	unsigned int counts[TILE_CLASS_COUNT];
+} TileClassifyFX;
+
+/* Initialisation (0 : chemin indisponible, le composite reste plein
+ * écran) */
+int fx_tile_classify_init(struct PostProcess* post_processing);
+
+/* Libération des ressources */
+void fx_tile_classify_cleanup(struct PostProcess* post_processing);
+
+/* Redimensionnement des listes (grille de tuiles) */
+int fx_tile_classify_resize(struct PostProcess* post_processing);
+
+/* Classification puis un dispatch indirect par classe, vers l'image du
+ * composite déjà liée. Textures et UBO du composite déjà liés. */
+void fx_tile_classify_render(struct PostProcess* post_processing);
+
+/* Bloc #define de la permutation de postprocess.comp pour une classe */
+void fx_tile_classify_defines(TileClass tile_class, char* out, size_t size);
+
+#endif /* FX_TILE_CLASSIFY_H */
@@ -0,0 +1,428 @@
+#include "frame_graph.h"
+
+#include "gl_common.h"
+#include "log.h"
+#include "perf_timer.h"
+
+/* Simulation des barrières : écriture incohérente en attente, et bits
+ * déjà émis depuis */
+typedef struct {
+	int pending;
+	GLbitfield flushed;
+} ResourceState;
+
+void frame_graph_init(FrameGraph* graph)
+{
+	*graph = (FrameGraph){0};
+}
+
+void frame_graph_reset(FrameGraph* graph)
+{
+	graph->resource_count = 0;
+	graph->pass_count = 0;
+	graph->step_count = 0;
+	graph->compiled = 0;
+	graph->barrier_count = 0;
+	graph->target_switches = 0;
+}
+
+int frame_graph_add_resource(FrameGraph* graph, const char* name,
+                             FrameGraphResourceType type, int exported)
+{
+	if (graph->resource_count == FRAME_GRAPH_MAX_RESOURCES) {
+		LOG_ERROR("suckless-ogl.framegraph",
+		          "Too many resources, '%s' dropped", name);
+		return -1;
+	}
+	graph->resources[graph->resource_count] = (FrameGraphResource){
+	    .name = name, .type = type, .exported = exported};
+	graph->compiled = 0;
+	return graph->resource_count++;
+}
+
+int frame_graph_add_pass(FrameGraph* graph, const char* name,
+                         FrameGraphCallback execute,
+                         FrameGraphCallback culled, void* user)
+{
+	if (graph->pass_count == FRAME_GRAPH_MAX_PASSES) {
+		LOG_ERROR("suckless-ogl.framegraph",
+		          "Too many passes, '%s' dropped", name);
+		return -1;
+	}
+	graph->passes[graph->pass_count] =
+	    (FrameGraphPass){.name = name,
+	                     .execute = execute,
+	                     .culled = culled,
+	                     .user = user,
+	                     .enabled = 1,
+	                     .framebuffer = FRAME_GRAPH_NO_TARGET};
+	graph->compiled = 0;
+	return graph->pass_count++;
+}
+
+void frame_graph_set_target(FrameGraph* graph, int pass, GLint framebuffer,
+                            int width, int height)
+{
+	if (pass < 0) {
+		return;
+	}
+	FrameGraphPass* target = &graph->passes[pass];
+	target->framebuffer = framebuffer;
+	target->width = width;
+	target->height = height;
+	graph->compiled = 0;
+}
+
+static int graph_use(FrameGraph* graph, int pass, int resource,
+                     FrameGraphAccess access, int write)
+{
+	if (pass < 0 || resource < 0) {
+		return 0;
+	}
+	FrameGraphPass* user = &graph->passes[pass];
+	if (user->use_count == FRAME_GRAPH_MAX_USES) {
+		LOG_ERROR("suckless-ogl.framegraph",
+		          "Pass '%s': too many resource uses", user->name);
+		return 0;
+	}
+	user->uses[user->use_count++] = (FrameGraphUse){
+	    .resource = resource, .access = access, .write = write};
+	graph->compiled = 0;
+	return 1;
+}
+
+int frame_graph_read(FrameGraph* graph, int pass, int resource,
+                     FrameGraphAccess access)
+{
+	return graph_use(graph, pass, resource, access, 0);
+}
+
+int frame_graph_write(FrameGraph* graph, int pass, int resource,
+                      FrameGraphAccess access)
+{
+	return graph_use(graph, pass, resource, access, 1);
+}
+
+GLbitfield frame_graph_barrier_bits(FrameGraphAccess access,
+                                    FrameGraphResourceType type)
+{
+	switch (access) {
+	case FRAME_GRAPH_SAMPLED:
+		return GL_TEXTURE_FETCH_BARRIER_BIT;
+	case FRAME_GRAPH_IMAGE:
+		return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+	case FRAME_GRAPH_STORAGE:
+		return GL_SHADER_STORAGE_BARRIER_BIT;
+	case FRAME_GRAPH_UNIFORM:
+		return GL_UNIFORM_BARRIER_BIT;
+	case FRAME_GRAPH_INDIRECT:
+		return GL_COMMAND_BARRIER_BIT;
+	case FRAME_GRAPH_ATTACHMENT:
+		return GL_FRAMEBUFFER_BARRIER_BIT;
+	case FRAME_GRAPH_TRANSFER:
+		return type == FRAME_GRAPH_TEXTURE
+		           ? GL_TEXTURE_UPDATE_BARRIER_BIT
+		           : GL_BUFFER_UPDATE_BARRIER_BIT;
+	default:
+		return 0;
+	}
+}
+
+/* Seules les écritures image et SSBO échappent à la cohérence implicite
+ * de GL */
+static int access_incoherent(FrameGraphAccess access)
+{
+	return access == FRAME_GRAPH_IMAGE || access == FRAME_GRAPH_STORAGE;
+}
+
+/* Une passe vit si elle est active et écrit une ressource exportée ou lue
+ * par une passe vivante déclarée après elle */
+static void graph_cull(FrameGraph* graph)
+{
+	int needed[FRAME_GRAPH_MAX_RESOURCES];
+	for (int i = 0; i < graph->resource_count; i++) {
+		needed[i] = graph->resources[i].exported;
+	}
+
+	for (int p = graph->pass_count - 1; p >= 0; p--) {
+		FrameGraphPass* pass = &graph->passes[p];
+		pass->live = 0;
+		if (!pass->enabled) {
+			continue;
+		}
+		for (int u = 0; u < pass->use_count; u++) {
+			if (pass->uses[u].write &&
+			    needed[pass->uses[u].resource]) {
+				pass->live = 1;
+			}
+		}
+		if (!pass->live) {
+			continue;
+		}
+		for (int u = 0; u < pass->use_count; u++) {
+			if (!pass->uses[u].write) {
+				needed[pass->uses[u].resource] = 1;
+			}
+		}
+	}
+}
+
+/* Lecture après écriture, écriture après écriture et écriture après
+ * lecture, dans l'ordre de déclaration : deps[p] ne vise que des passes
+ * vivantes déclarées avant p, le graphe est acyclique par construction */
+static void graph_dependencies(const FrameGraph* graph, unsigned int* deps)
+{
+	int last_writer[FRAME_GRAPH_MAX_RESOURCES];
+	unsigned int readers[FRAME_GRAPH_MAX_RESOURCES];
+	for (int i = 0; i < graph->resource_count; i++) {
+		last_writer[i] = -1;
+		readers[i] = 0;
+	}
+
+	for (int p = 0; p < graph->pass_count; p++) {
+		const FrameGraphPass* pass = &graph->passes[p];
+		deps[p] = 0;
+		if (!pass->live) {
+			continue;
+		}
+		for (int u = 0; u < pass->use_count; u++) {
+			const FrameGraphUse* use = &pass->uses[u];
+			if (last_writer[use->resource] >= 0) {
+				deps[p] |= 1U << last_writer[use->resource];
+			}
+			if (use->write) {
+				deps[p] |= readers[use->resource];
+			}
+		}
+		deps[p] &= ~(1U << p);
+
+		for (int u = 0; u < pass->use_count; u++) {
+			if (!pass->uses[u].write) {
+				readers[pass->uses[u].resource] |= 1U << p;
+			}
+		}
+		for (int u = 0; u < pass->use_count; u++) {
+			if (pass->uses[u].write) {
+				last_writer[pass->uses[u].resource] = p;
+				readers[pass->uses[u].resource] = 0;
+			}
+		}
+	}
+}
+
+static int pass_keeps_target(const FrameGraphPass* pass, int bound,
+                             const FrameGraphPass* current)
+{
+	if (pass->framebuffer == FRAME_GRAPH_NO_TARGET) {
+		return 1;
+	}
+	return bound && pass->framebuffer == current->framebuffer &&
+	       pass->width == current->width &&
+	       pass->height == current->height;
+}
+
+/* Tri topologique : parmi les passes prêtes, d'abord celles qui gardent le
+ * framebuffer lié, puis l'ordre de déclaration */
+static void graph_order(FrameGraph* graph, const unsigned int* deps)
+{
+	unsigned int remaining = 0;
+	unsigned int done = 0;
+	const FrameGraphPass* current = NULL;
+
+	for (int p = 0; p < graph->pass_count; p++) {
+		if (graph->passes[p].live) {
+			remaining |= 1U << p;
+		}
+	}
+
+	graph->step_count = 0;
+	graph->target_switches = 0;
+	while (remaining) {
+		int best = -1;
+		int best_keeps = 0;
+		for (int p = 0; p < graph->pass_count; p++) {
+			if (!(remaining & (1U << p)) || (deps[p] & ~done)) {
+				continue;
+			}
+			const int keeps = pass_keeps_target(
+			    &graph->passes[p], current != NULL, current);
+			if (best < 0 || (keeps && !best_keeps)) {
+				best = p;
+				best_keeps = keeps;
+			}
+			if (keeps) {
+				break;
+			}
+		}
+
+		const FrameGraphPass* pass = &graph->passes[best];
+		graph->steps[graph->step_count++] =
+		    (FrameGraphStep){.pass = best, .bind_target = !best_keeps};
+		if (!best_keeps) {
+			current = pass;
+			graph->target_switches++;
+		}
+		done |= 1U << best;
+		remaining &= ~(1U << best);
+	}
+}
+
+static GLbitfield graph_step_barriers(const FrameGraph* graph,
+                                      const FrameGraphPass* pass,
+                                      ResourceState* states)
+{
+	GLbitfield bits = 0;
+	for (int u = 0; u < pass->use_count; u++) {
+		const FrameGraphUse* use = &pass->uses[u];
+		const ResourceState* state = &states[use->resource];
+		if (state->pending) {
+			bits |= frame_graph_barrier_bits(
+			            use->access,
+			            graph->resources[use->resource].type) &
+			        ~state->flushed;
+		}
+	}
+
+	/* Une barrière vaut pour toutes les écritures déjà faites */
+	if (bits) {
+		for (int i = 0; i < graph->resource_count; i++) {
+			if (states[i].pending) {
+				states[i].flushed |= bits;
+			}
+		}
+	}
+
+	/* Une écriture cohérente (attachement, transfert) ne rend pas visible
+	 * une écriture incohérente antérieure : son état reste en attente
+	 * jusqu'à ce qu'une barrière couvre le type d'accès du lecteur */
+	for (int u = 0; u < pass->use_count; u++) {
+		const FrameGraphUse* use = &pass->uses[u];
+		if (use->write && access_incoherent(use->access)) {
+			states[use->resource].pending = 1;
+			states[use->resource].flushed = 0;
+		}
+	}
+	return bits;
+}
+
+int frame_graph_compile(FrameGraph* graph)
+{
+	unsigned int deps[FRAME_GRAPH_MAX_PASSES];
+	ResourceState states[FRAME_GRAPH_MAX_RESOURCES] = {{0}};
+
+	graph_cull(graph);
+	graph_dependencies(graph, deps);
+	graph_order(graph, deps);
+
+	/* Frame 1 à froid, frame 2 en régime permanent : ses barrières
+	 * couvrent aussi les écritures de la frame précédente */
+	for (int frame = 0; frame < 2; frame++) {
+		for (int i = 0; i < graph->step_count; i++) {
+			FrameGraphStep* step = &graph->steps[i];
+			step->barriers = graph_step_barriers(
+			    graph, &graph->passes[step->pass], states);
+		}
+	}
+
+	graph->barrier_count = 0;
+	for (int i = 0; i < graph->step_count; i++) {
+		if (graph->steps[i].barriers) {
+			graph->barrier_count++;
+		}
+	}
+
+	for (int p = 0; p < graph->pass_count; p++) {
+		const FrameGraphPass* pass = &graph->passes[p];
+		if (!pass->live && pass->culled) {
+			pass->culled(pass->user);
+		}
+	}
+
+	graph->compiled = 1;
+	graph->generation++;
+	LOG_INFO("suckless-ogl.framegraph",
+	         "Compiled %d/%d passes: %d barriers, %d target switches",
+	         graph->step_count, graph->pass_count, graph->barrier_count,
+	         graph->target_switches);
+	return graph->step_count;
+}
+
+/* Du plus ancien au plus récent, sans jamais attendre le GPU */
+static void graph_read_timeline(FrameGraph* graph)
+{
+	GLuint64 stamps[FRAME_GRAPH_MAX_PASSES + 1];
+	int generation = 0;
+
+	while (gpu_timestamp_ring_try_read(&graph->timestamps, stamps,
+	                                   &generation) >= 0) {
+		/* Posés par une autre configuration : étapes différentes */
+		if (generation != graph->generation) {
+			continue;
+		}
+		for (int s = 0; s < graph->step_count; s++) {
+			FrameGraphStep* step = &graph->steps[s];
+			step->start_ms =
+			    (double)(stamps[s] - stamps[0]) / NS_PER_MS;
+			step->gpu_ms =
+			    (double)(stamps[s + 1] - stamps[s]) / NS_PER_MS;
+			step->gpu_ms_sum += step->gpu_ms;
+			step->gpu_samples++;
+		}
+	}
+}
+
+void frame_graph_execute(FrameGraph* graph)
+{
+	if (!graph->compiled) {
+		(void)frame_graph_compile(graph);
+	}
+	(void)gpu_timestamp_ring_init(&graph->timestamps,
+	                              FRAME_GRAPH_MAX_PASSES + 1);
+
+	graph_read_timeline(graph);
+	gpu_timestamp_ring_begin(&graph->timestamps);
+
+	for (int i = 0; i < graph->step_count; i++) {
+		const FrameGraphStep* step = &graph->steps[i];
+		const FrameGraphPass* pass = &graph->passes[step->pass];
+
+		gpu_timestamp_ring_stamp(&graph->timestamps, i);
+		GL_DEBUG_PUSH(pass->name);
+		if (step->bind_target) {
+			glBindFramebuffer(GL_FRAMEBUFFER,
+			                  (GLuint)pass->framebuffer);
+			glViewport(0, 0, pass->width, pass->height);
+		}
+		if (step->barriers) {
+			glMemoryBarrier(step->barriers);
+		}
+		pass->execute(pass->user);
+		GL_DEBUG_POP();
+	}
+	gpu_timestamp_ring_stamp(&graph->timestamps, graph->step_count);
+	gpu_timestamp_ring_end(&graph->timestamps, graph->generation);
+}
+
+void frame_graph_report(FrameGraph* graph)
+{
+	for (int i = 0; i < graph->step_count; i++) {
+		FrameGraphStep* step = &graph->steps[i];
+		if (step->gpu_samples == 0) {
+			continue;
+		}
+		LOG_INFO("suckless-ogl.framegraph",
+		         "#%d %s: %.3f ms GPU (+%.3f ms, barrier 0x%x, "
+		         "%d frames)",
+		         i, graph->passes[step->pass].name,
+		         step->gpu_ms_sum / (double)step->gpu_samples,
+		         step->start_ms, step->barriers, step->gpu_samples);
+		step->gpu_ms_sum = 0.0;
+		step->gpu_samples = 0;
+	}
+}
+
+void frame_graph_cleanup(FrameGraph* graph)
+{
+	gpu_timestamp_ring_cleanup(&graph->timestamps);
+	*graph = (FrameGraph){0};
+}
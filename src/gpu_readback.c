@@ -0,0 +1,217 @@
+#include "gpu_readback.h"
+
+#include "gl_common.h"
+#include "log.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Attente bornée de gpu_readback_flush avant de réessayer (1 ms) */
+#define READBACK_FLUSH_TIMEOUT_NS 1000000ULL
+
+static size_t align_up(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+int gpu_readback_init(GpuReadback* readback, size_t capacity)
+{
+	*readback = (GpuReadback){0};
+	readback->next_ticket = 1;
+	if (capacity == 0) {
+		return 0;
+	}
+	readback->capacity = align_up(capacity, GPU_READBACK_ALIGNMENT);
+
+	const GLbitfield flags =
+	    GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	glGenBuffers(1, &readback->buffer);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, readback->buffer);
+	glBufferStorage(GL_COPY_WRITE_BUFFER, (GLsizeiptr)readback->capacity,
+	                NULL, flags | GL_CLIENT_STORAGE_BIT);
+	readback->mapped = glMapBufferRange(
+	    GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr)readback->capacity, flags);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	if (!readback->mapped) {
+		LOG_ERROR("suckless-ogl.readback",
+		          "Failed to map persistent readback buffer");
+		gpu_readback_cleanup(readback);
+		return 0;
+	}
+	glObjectLabel(GL_BUFFER, readback->buffer, -1, "Readback Ring");
+	return 1;
+}
+
+/* Réserve `size` octets dans l'anneau, NULL si plein */
+static GpuReadbackRequest* readback_reserve(GpuReadback* readback,
+                                            size_t size)
+{
+	if (!readback->mapped || size == 0 ||
+	    readback->count == GPU_READBACK_MAX_REQUESTS) {
+		readback->dropped++;
+		return NULL;
+	}
+
+	const size_t needed = align_up(size, GPU_READBACK_ALIGNMENT);
+	size_t skipped = 0;
+	if (readback->head + needed > readback->capacity) {
+		skipped = readback->capacity - readback->head; /* Bouclage */
+	}
+	if (readback->used + skipped + needed > readback->capacity) {
+		readback->dropped++;
+		return NULL;
+	}
+
+	const int slot =
+	    (readback->first + readback->count) % GPU_READBACK_MAX_REQUESTS;
+	GpuReadbackRequest* request = &readback->requests[slot];
+	*request = (GpuReadbackRequest){0};
+	request->offset = skipped ? 0 : readback->head;
+	request->size = size;
+	request->span = skipped + needed;
+	request->frame = readback->frame;
+
+	readback->head = request->offset + needed;
+	readback->used += request->span;
+	readback->count++;
+	return request;
+}
+
+static unsigned long long readback_submit(GpuReadback* readback,
+                                          GpuReadbackRequest* request,
+                                          GpuReadbackCallback callback,
+                                          void* user)
+{
+	request->callback = callback;
+	request->user = user;
+	request->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	return readback->next_ticket++;
+}
+
+unsigned long long gpu_readback_buffer(GpuReadback* readback, GLuint buffer,
+                                       GLintptr offset, size_t size,
+                                       GpuReadbackCallback callback,
+                                       void* user)
+{
+	GpuReadbackRequest* request = readback_reserve(readback, size);
+	if (!request) {
+		return 0;
+	}
+
+	/* Écritures shader (SSBO) visibles par la copie */
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+	glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, readback->buffer);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset,
+	                    (GLintptr)request->offset, (GLsizeiptr)size);
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	return readback_submit(readback, request, callback, user);
+}
+
+unsigned long long gpu_readback_texture(GpuReadback* readback, GLuint texture,
+                                        GLint level, GLenum format,
+                                        GLenum type, size_t size,
+                                        GpuReadbackCallback callback,
+                                        void* user)
+{
+	GpuReadbackRequest* request = readback_reserve(readback, size);
+	if (!request) {
+		return 0;
+	}
+
+	/* Écritures image (imageStore) visibles par la lecture */
+	glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->buffer);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glGetTexImage(GL_TEXTURE_2D, level, format, type,
+	              (void*)(uintptr_t)request->offset);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	return readback_submit(readback, request, callback, user);
+}
+
+static void readback_deliver(GpuReadback* readback)
+{
+	GpuReadbackRequest* request = &readback->requests[readback->first];
+	const unsigned char* data = readback->mapped + request->offset;
+
+	if (request->callback) {
+		request->callback(request->user, data, request->size);
+	} else if (request->user) {
+		memcpy(request->user, data, request->size);
+	}
+
+	glDeleteSync(request->fence);
+	readback->last_latency = (int)(readback->frame - request->frame);
+	readback->used -= request->span;
+	readback->first = (readback->first + 1) % GPU_READBACK_MAX_REQUESTS;
+	readback->count--;
+	readback->delivered_ticket++;
+	if (readback->count == 0) {
+		readback->head = 0;
+		readback->used = 0;
+	}
+}
+
+void gpu_readback_poll(GpuReadback* readback)
+{
+	readback->frame++;
+	while (readback->count > 0) {
+		const GpuReadbackRequest* request =
+		    &readback->requests[readback->first];
+		/* Timeout 0 : simple test, le fence a été soumis par le swap */
+		const GLenum status = glClientWaitSync(request->fence, 0, 0);
+		if (status != GL_ALREADY_SIGNALED &&
+		    status != GL_CONDITION_SATISFIED) {
+			break; /* Les suivantes non plus (ordre GPU) */
+		}
+		readback_deliver(readback);
+	}
+}
+
+int gpu_readback_done(const GpuReadback* readback, unsigned long long ticket)
+{
+	return ticket != 0 && ticket <= readback->delivered_ticket;
+}
+
+void gpu_readback_flush(GpuReadback* readback)
+{
+	while (readback->count > 0) {
+		const GpuReadbackRequest* request =
+		    &readback->requests[readback->first];
+		const GLenum status =
+		    glClientWaitSync(request->fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+		                     READBACK_FLUSH_TIMEOUT_NS);
+		if (status == GL_WAIT_FAILED) {
+			LOG_ERROR("suckless-ogl.readback",
+			          "glClientWaitSync failed");
+			return;
+		}
+		if (status != GL_TIMEOUT_EXPIRED) {
+			readback_deliver(readback);
+		}
+	}
+}
+
+void gpu_readback_cleanup(GpuReadback* readback)
+{
+	for (int i = 0; i < readback->count; i++) {
+		const int slot =
+		    (readback->first + i) % GPU_READBACK_MAX_REQUESTS;
+		glDeleteSync(readback->requests[slot].fence);
+	}
+	if (readback->buffer) {
+		glBindBuffer(GL_COPY_WRITE_BUFFER, readback->buffer);
+		if (readback->mapped) {
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		glDeleteBuffers(1, &readback->buffer);
+	}
+	*readback = (GpuReadback){0};
+}
@@ -0,0 +1,219 @@
+#include "hybrid_rendering.h"
+
+#include "billboard_rendering.h"
+#include "camera.h"
+#include "gl_common.h"
+#include "instanced_rendering.h"
+#include "log.h"
+#include "shader.h"
+#include <cglm/cglm.h>
+#include <stddef.h>
+
+enum { HYBRID_CLASSIFY_GROUP_SIZE = 64, HYBRID_QUAD_VERTICES = 4 };
+
+enum HybridBindings {
+	HYBRID_BINDING_SOURCE = 0,
+	HYBRID_BINDING_MESH = 1,
+	HYBRID_BINDING_IMPOSTOR = 2,
+	HYBRID_BINDING_COMMANDS = 3
+};
+
+static GLuint create_bucket_buffer(int count)
+{
+	GLuint buffer = 0;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	/* Written by the classification pass every frame */
+	glBufferData(GL_ARRAY_BUFFER,
+	             (GLsizeiptr)((size_t)count * sizeof(SphereInstance)), NULL,
+	             GL_DYNAMIC_COPY);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	return buffer;
+}
+
+int hybrid_group_init(HybridGroup* group, GLuint source_buffer, int count)
+{
+	group->source_buffer = source_buffer;
+	group->source_offset = 0;
+	group->instance_count = count;
+	group->mesh_threshold_px = HYBRID_DEFAULT_MESH_THRESHOLD_PX;
+
+	group->classify_shader =
+	    shader_load_compute_program("shaders/hybrid_classify.comp");
+	if (!group->classify_shader) {
+		LOG_ERROR("suckless-ogl.hybrid",
+		          "Failed to load classification compute shader");
+		return 0;
+	}
+
+	/* Both buckets must be able to hold every instance */
+	group->mesh.vao = 0;
+	group->mesh.instance_count = count;
+	group->mesh.format = INSTANCE_FORMAT_FULL;
+	group->mesh.stream = NULL;
+	group->mesh.index_type = GL_UNSIGNED_INT;
+	group->mesh.instance_vbo = create_bucket_buffer(count);
+
+	group->impostor.vao = 0;
+	group->impostor.instance_count = count;
+	group->impostor.format = INSTANCE_FORMAT_FULL;
+	group->impostor.stream = NULL;
+	group->impostor.instance_vbo = create_bucket_buffer(count);
+
+	glGenBuffers(1, &group->command_buffer);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, group->command_buffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(HybridDrawCommands), NULL,
+	             GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	LOG_INFO("suckless-ogl.hybrid",
+	         "Hybrid group initialized: %d instances (2 x %zu bytes)",
+	         count, (size_t)count * sizeof(SphereInstance));
+	return 1;
+}
+
+void hybrid_group_bind_mesh(HybridGroup* group, const IcosphereMesh* mesh)
+{
+	instanced_group_bind_mesh(&group->mesh, mesh);
+}
+
+void hybrid_group_prepare_impostor(HybridGroup* group, GLuint quad_vbo)
+{
+	billboard_group_prepare(&group->impostor, quad_vbo);
+}
+
+void hybrid_group_classify(HybridGroup* group, mat4 view, mat4 proj,
+                           int viewport_height, size_t index_count)
+{
+	if (group->instance_count <= 0 || !group->classify_shader) {
+		return;
+	}
+
+	GL_SCOPE_DEBUG_GROUP("Hybrid Classification");
+
+	/* Reset both commands: counts are rebuilt by atomics */
+	HybridDrawCommands commands = {
+	    .mesh = {(GLuint)index_count, 0, 0, 0, 0},
+	    .impostor = {HYBRID_QUAD_VERTICES, 0, 0, 0},
+	};
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, group->command_buffer);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(commands),
+	                &commands);
+
+	mat4 view_proj;
+	vec4 planes[6];
+	glm_mat4_mul(proj, view, view_proj);
+	glm_frustum_planes(view_proj, planes);
+
+	const float near_plane = camera_projection_near(proj);
+	const float pixel_scale = 0.5F * (float)viewport_height * proj[1][1];
+
+	Shader* shader = group->classify_shader;
+	shader_use(shader);
+	shader_set_int(shader, "instanceCount", group->instance_count);
+	shader_set_mat4(shader, "view", (float*)view);
+	shader_set_vec4_array(shader, "frustumPlanes", (const float*)planes, 6);
+	shader_set_float(shader, "pixelScale", pixel_scale);
+	shader_set_float(shader, "nearPlane", near_plane);
+	shader_set_float(shader, "meshThresholdPx", group->mesh_threshold_px);
+
+	glBindBufferRange(
+	    GL_SHADER_STORAGE_BUFFER, HYBRID_BINDING_SOURCE,
+	    group->source_buffer, group->source_offset,
+	    (GLsizeiptr)((size_t)group->instance_count * sizeof(SphereInstance)));
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, HYBRID_BINDING_MESH,
+	                 group->mesh.instance_vbo);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, HYBRID_BINDING_IMPOSTOR,
+	                 group->impostor.instance_vbo);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, HYBRID_BINDING_COMMANDS,
+	                 group->command_buffer);
+
+	GLuint groups =
+	    ((GLuint)group->instance_count + (HYBRID_CLASSIFY_GROUP_SIZE - 1)) /
+	    HYBRID_CLASSIFY_GROUP_SIZE;
+	glDispatchCompute(groups, 1, 1);
+
+	/* Buckets are consumed as vertex attributes, commands as indirect */
+	glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+	                GL_COMMAND_BARRIER_BIT);
+}
+
+void hybrid_group_draw_mesh(HybridGroup* group)
+{
+	if (group->mesh.vao == 0) {
+		return;
+	}
+
+	glBindVertexArray(group->mesh.vao);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, group->command_buffer);
+	glDrawElementsIndirect(
+	    GL_TRIANGLES, group->mesh.index_type,
+	    BUFFER_OFFSET(offsetof(HybridDrawCommands, mesh)));
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+void hybrid_group_draw_impostors(HybridGroup* group)
+{
+	if (group->impostor.vao == 0) {
+		return;
+	}
+
+	glBindVertexArray(group->impostor.vao);
+
+	/* Same culling rule as billboard_group_draw */
+	GLboolean culling_was_enabled = glIsEnabled(GL_CULL_FACE);
+	glDisable(GL_CULL_FACE);
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, group->command_buffer);
+	glDrawArraysIndirect(
+	    GL_TRIANGLE_STRIP,
+	    BUFFER_OFFSET(offsetof(HybridDrawCommands, impostor)));
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	if (culling_was_enabled) {
+		glEnable(GL_CULL_FACE);
+	}
+
+	glBindVertexArray(0);
+}
+
+void hybrid_group_read_counts(HybridGroup* group, int* mesh_count,
+                              int* impostor_count)
+{
+	HybridDrawCommands commands = {0};
+
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, group->command_buffer);
+	glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(commands),
+	                   &commands);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	if (mesh_count) {
+		*mesh_count = (int)commands.mesh.instance_count;
+	}
+	if (impostor_count) {
+		*impostor_count = (int)commands.impostor.instance_count;
+	}
+}
+
+void hybrid_group_cleanup(HybridGroup* group)
+{
+	/* The bucket buffers are owned by the sub-groups */
+	instanced_group_cleanup(&group->mesh);
+	group->mesh.vao = 0;
+	group->mesh.instance_vbo = 0;
+	billboard_group_cleanup(&group->impostor);
+
+	if (group->command_buffer) {
+		glDeleteBuffers(1, &group->command_buffer);
+		group->command_buffer = 0;
+	}
+	if (group->classify_shader) {
+		shader_destroy(group->classify_shader);
+		group->classify_shader = NULL;
+	}
+	group->source_buffer = 0;
+	group->source_offset = 0;
+	group->instance_count = 0;
+}
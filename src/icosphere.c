@@ -1,16 +1,22 @@
 #include "icosphere.h"
 
+#include "job_system.h"
+#include "log.h"
+#include "mesh_optimize.h"
 #include <cglm/types.h>
 #include <cglm/vec3.h>
+#include <math.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 enum {
+	SNORM16_MAX = 32767,
+	SHORT_INDEX_LIMIT = 65536,
 	INITIAL_VEC3_CAPACITY = 128,
 	INITIAL_UINT_CAPACITY = 256,
 	ICOSAHEDRON_VERTEX_COUNT = 12,
-	ICOSAHEDRON_INDEX_COUNT = 60,
-	INDEX_SHIFT = 32
+	ICOSAHEDRON_INDEX_COUNT = 60
 };
 
 #define X 0.525731112119133606F
@@ -81,139 +87,243 @@ void uintarray_free(UintArray* array)
 	array->capacity = 0;
 }
 
+static int vec3array_reserve(Vec3Array* array, size_t capacity)
+{
+	if (array->capacity >= capacity) {
+		return 1;
+	}
+	vec3* data = realloc(array->data, sizeof(vec3) * capacity);
+	if (!data) {
+		return 0;
+	}
+	array->data = data;
+	array->capacity = capacity;
+	return 1;
+}
+
+static int uintarray_reserve(UintArray* array, size_t capacity)
+{
+	if (array->capacity >= capacity) {
+		return 1;
+	}
+	unsigned int* data =
+	    realloc(array->data, sizeof(unsigned int) * capacity);
+	if (!data) {
+		return 0;
+	}
+	array->data = data;
+	array->capacity = capacity;
+	return 1;
+}
+
 /* Math helpers */
 static void normalize_vec3(vec3 vertex, vec3 out)
 {
 	glm_vec3_normalize_to(vertex, out);
 }
 
-/* Hash table for midpoint caching */
-typedef struct {
-	unsigned int a, b;
-	unsigned int midpoint;
-} EdgeEntry;
+/*
+ * Subdivision sans table de hachage.
+ *
+ * Chaque face connaît ses 3 voisines (EdgeLink = face << 2 | arête locale).
+ * Une arête appartient à la face de plus petit index qui la partage : c'est
+ * la première à la rencontrer dans l'ancien parcours séquentiel, les sommets
+ * milieux reçoivent donc exactement les mêmes index qu'avant
+ * (base + somme préfixe des arêtes possédées + rang local).
+ * Les deux passes par niveau sont indépendantes par face (parallel-for).
+ */
+typedef uint32_t EdgeLink;
 
-typedef struct {
-	EdgeEntry* entries;
-	size_t capacity;
-	size_t count;
-} EdgeHash;
+enum {
+	EDGE_LINK_SHIFT = 2,
+	EDGE_LINK_MASK = 3,
+	FACE_EDGES = 3,
+	CHILD_FACES = 4,
+	SUBDIVIDE_GRAIN = 2048 /* Faces par job */
+};
 
-static void edge_hash_init(EdgeHash* hash, size_t capacity)
+static EdgeLink edge_link(uint32_t face, uint32_t edge)
 {
-	hash->capacity = capacity;
-	hash->count = 0;
-	hash->entries = calloc(capacity, sizeof(EdgeEntry));
+	return (face << EDGE_LINK_SHIFT) | edge;
 }
 
-static void edge_hash_free(EdgeHash* hash)
+/* Voisinage de l'icosaèdre (20 faces, orientation cohérente :
+ * l'arête (a, b) d'une face est (b, a) chez sa voisine) */
+static int build_base_adjacency(EdgeLink* adjacency)
 {
-	free(hash->entries);
+	const int faces = ICOSAHEDRON_INDEX_COUNT / FACE_EDGES;
+	for (int f = 0; f < faces; f++) {
+		for (int k = 0; k < FACE_EDGES; k++) {
+			const unsigned int a = icosahedron_indices[(f * 3) + k];
+			const unsigned int b =
+			    icosahedron_indices[(f * 3) + ((k + 1) % 3)];
+			int found = 0;
+			for (int g = 0; g < faces && !found; g++) {
+				for (int j = 0; j < FACE_EDGES; j++) {
+					if (icosahedron_indices[(g * 3) + j] ==
+					        b &&
+					    icosahedron_indices
+					            [(g * 3) + ((j + 1) % 3)] ==
+					        a) {
+						adjacency[(f * 3) + k] =
+						    edge_link((uint32_t)g,
+						              (uint32_t)j);
+						found = 1;
+						break;
+					}
+				}
+			}
+			if (!found) {
+				return 0;
+			}
+		}
+	}
+	return 1;
 }
 
-static unsigned int get_midpoint(unsigned int point1, unsigned int point2,
-                                 Vec3Array* vertices, EdgeHash* hash)
+typedef struct {
+	const unsigned int* indices; /* Niveau courant */
+	const EdgeLink* adjacency;
+	unsigned char* owned;     /* Bit k : la face possède l'arête k */
+	uint32_t* offsets;        /* Somme préfixe des arêtes possédées */
+	vec3* vertices;
+	unsigned int base_vertex; /* Premier sommet milieu du niveau */
+	unsigned int* out_indices;
+	EdgeLink* out_adjacency; /* NULL au dernier niveau */
+} SubdivideLevel;
+
+static void subdivide_count(void* user_data, int begin, int end)
 {
-	/* Order indices to ensure unique key */
-	unsigned int idx_a = point1 < point2 ? point1 : point2;
-	unsigned int idx_b = point1 < point2 ? point2 : point1;
-
-	/* Simple hash for vertex pair */
-	uint64_t key = ((uint64_t)idx_a << (uint32_t)INDEX_SHIFT) | idx_b;
-	size_t index = (size_t)(key % hash->capacity);
-
-	/* Open addressing with linear probing */
-	while (hash->entries[index].midpoint != 0) {
-		if (hash->entries[index].a == idx_a &&
-		    hash->entries[index].b == idx_b) {
-			return hash->entries[index].midpoint;
+	SubdivideLevel* level = user_data;
+	for (int f = begin; f < end; f++) {
+		unsigned char mask = 0;
+		for (unsigned k = 0; k < FACE_EDGES; k++) {
+			const EdgeLink link = level->adjacency[(f * 3) + k];
+			if ((link >> EDGE_LINK_SHIFT) > (uint32_t)f) {
+				mask |= (unsigned char)(1U << k);
+			}
 		}
-		index = (index + 1) % hash->capacity;
+		level->owned[f] = mask;
 	}
+}
+
+static unsigned int owned_rank(unsigned char mask, unsigned edge)
+{
+	return (unsigned int)__builtin_popcount(mask & ((1U << edge) - 1U));
+}
 
-	/* Not found, create new vertex */
-	vec3 vertex1;
-	vec3 vertex2;
-	vec3 midpoint_vec;
-	glm_vec3_copy(vertices->data[point1], vertex1);
-	glm_vec3_copy(vertices->data[point2], vertex2);
-	glm_vec3_add(vertex1, vertex2, midpoint_vec);
+static unsigned int edge_midpoint(const SubdivideLevel* level, uint32_t face,
+                                  unsigned edge)
+{
+	const unsigned char mask = level->owned[face];
+	if (mask & (1U << edge)) {
+		return level->base_vertex + level->offsets[face] +
+		       owned_rank(mask, edge);
+	}
+	const EdgeLink link = level->adjacency[(face * 3) + edge];
+	const uint32_t owner = link >> EDGE_LINK_SHIFT;
+	return level->base_vertex + level->offsets[owner] +
+	       owned_rank(level->owned[owner], link & EDGE_LINK_MASK);
+}
 
+static void subdivide_write(void* user_data, int begin, int end)
+{
+	SubdivideLevel* level = user_data;
 	static const float MIDPOINT_SCALE = 0.5F;
-	glm_vec3_scale(midpoint_vec, MIDPOINT_SCALE, midpoint_vec);
-	glm_vec3_normalize(midpoint_vec);
-	vec3array_push(vertices, midpoint_vec);
 
-	unsigned int midpoint = (unsigned int)(vertices->size - 1);
+	for (int f = begin; f < end; f++) {
+		const unsigned int* tri = &level->indices[f * 3];
+		unsigned int mid[FACE_EDGES];
+
+		for (unsigned k = 0; k < FACE_EDGES; k++) {
+			mid[k] = edge_midpoint(level, (uint32_t)f, k);
+			if (!(level->owned[f] & (1U << k))) {
+				continue;
+			}
+			/* Même calcul que l'ancien get_midpoint (bit à bit) */
+			vec3 midpoint_vec;
+			glm_vec3_add(level->vertices[tri[k]],
+			             level->vertices[tri[(k + 1) % 3]],
+			             midpoint_vec);
+			glm_vec3_scale(midpoint_vec, MIDPOINT_SCALE,
+			               midpoint_vec);
+			glm_vec3_normalize(midpoint_vec);
+			glm_vec3_copy(midpoint_vec, level->vertices[mid[k]]);
+		}
 
-	/* Store in hash table (assume enough capacity for now) */
-	hash->entries[index].a = idx_a;
-	hash->entries[index].b = idx_b;
-	hash->entries[index].midpoint = midpoint;
-	hash->count++;
+		/* 4 triangles, même ordre qu'avant */
+		const unsigned int children[CHILD_FACES * FACE_EDGES] = {
+		    tri[0], mid[0], mid[2], tri[1], mid[1], mid[0],
+		    tri[2], mid[2], mid[1], mid[0], mid[1], mid[2]};
+		(void)memcpy(&level->out_indices[(size_t)f * 12], children,
+		             sizeof(children));
 
-	return midpoint;
-}
+		if (!level->out_adjacency) {
+			continue;
+		}
 
-static void subdivide(Vec3Array* vertices, UintArray* indices, int depth)
-{
-	for (int d_idx = 0; d_idx < depth; d_idx++) {
-		UintArray new_indices;
-		uintarray_init(&new_indices);
-
-		/* The number of unique edges is at most 3 * number of
-		   triangles. Use a generous factor for the hash table to avoid
-		   collisions. */
-		EdgeHash hash;
-		edge_hash_init(&hash, indices->size * 4);
-
-		for (size_t i = 0; i < indices->size; i += 3) {
-			unsigned int vertex0_idx = indices->data[i + 0];
-			unsigned int vertex1_idx = indices->data[i + 1];
-			unsigned int vertex2_idx = indices->data[i + 2];
-
-			unsigned int mid0_idx = get_midpoint(
-			    vertex0_idx, vertex1_idx, vertices, &hash);
-			unsigned int mid1_idx = get_midpoint(
-			    vertex1_idx, vertex2_idx, vertices, &hash);
-			unsigned int mid2_idx = get_midpoint(
-			    vertex2_idx, vertex0_idx, vertices, &hash);
-
-			/* Create 4 new triangles */
-			uintarray_push(&new_indices, vertex0_idx);
-			uintarray_push(&new_indices, mid0_idx);
-			uintarray_push(&new_indices, mid2_idx);
-
-			uintarray_push(&new_indices, vertex1_idx);
-			uintarray_push(&new_indices, mid1_idx);
-			uintarray_push(&new_indices, mid0_idx);
-
-			uintarray_push(&new_indices, vertex2_idx);
-			uintarray_push(&new_indices, mid2_idx);
-			uintarray_push(&new_indices, mid1_idx);
-
-			uintarray_push(&new_indices, mid0_idx);
-			uintarray_push(&new_indices, mid1_idx);
-			uintarray_push(&new_indices, mid2_idx);
+		/* Voisinage des enfants : c3 (central) touche c0, c1, c2 par
+		 * leur arête 1 ; l'arête k du parent est coupée entre c_k
+		 * (arête 0) et c_(k+1) (arête 2), qui touchent les enfants de
+		 * la voisine (g, j) : c'_(j+1) arête 2 et c'_j arête 0. */
+		EdgeLink* out = &level->out_adjacency[(size_t)f * 12];
+		const uint32_t child = (uint32_t)f * CHILD_FACES;
+		out[(0 * 3) + 1] = edge_link(child + 3, 2);
+		out[(1 * 3) + 1] = edge_link(child + 3, 0);
+		out[(2 * 3) + 1] = edge_link(child + 3, 1);
+		out[(3 * 3) + 0] = edge_link(child + 1, 1);
+		out[(3 * 3) + 1] = edge_link(child + 2, 1);
+		out[(3 * 3) + 2] = edge_link(child + 0, 1);
+
+		for (unsigned k = 0; k < FACE_EDGES; k++) {
+			const EdgeLink link = level->adjacency[(f * 3) + k];
+			const uint32_t g = (link >> EDGE_LINK_SHIFT) * CHILD_FACES;
+			const uint32_t j = link & EDGE_LINK_MASK;
+			out[(k * 3) + 0] = edge_link(g + ((j + 1) % 3), 2);
+			out[(((k + 1) % 3) * 3) + 2] = edge_link(g + j, 0);
 		}
+	}
+}
 
-		free(indices->data);
-		*indices = new_indices;
-		edge_hash_free(&hash);
+static void normals_range(void* user_data, int begin, int end)
+{
+	IcosphereGeometry* geom = user_data;
+	for (int i = begin; i < end; i++) {
+		normalize_vec3(geom->vertices.data[i], geom->normals.data[i]);
 	}
 }
 
-static void compute_normals(Vec3Array* vertices, Vec3Array* normals)
+static void run_range(JobSystem* jobs, int count, JobRangeFn fn,
+                      void* user_data)
 {
-	normals->size = 0;
-	for (size_t i = 0; i < vertices->size; i++) {
-		vec3 normal;
-		normalize_vec3(vertices->data[i], normal);
-		vec3array_push(normals, normal);
+	if (!jobs) {
+		fn(user_data, 0, count);
+		return;
 	}
+	job_system_parallel_for(jobs, count, SUBDIVIDE_GRAIN, fn, user_data,
+	                        JOB_PRIORITY_NORMAL);
+}
+
+size_t icosphere_vertex_count(int subdivisions)
+{
+	return (10U << (2U * (unsigned)subdivisions)) + 2U;
+}
+
+size_t icosphere_index_count(int subdivisions)
+{
+	return (size_t)ICOSAHEDRON_INDEX_COUNT << (2U * (unsigned)subdivisions);
 }
 
 /* Icosphere operations */
+int icosphere_reserve(IcosphereGeometry* geom, int subdivisions)
+{
+	const size_t vertices = icosphere_vertex_count(subdivisions);
+	return vec3array_reserve(&geom->vertices, vertices) &&
+	       vec3array_reserve(&geom->normals, vertices) &&
+	       uintarray_reserve(&geom->indices,
+	                         icosphere_index_count(subdivisions));
+}
+
 void icosphere_init(IcosphereGeometry* geom)
 {
 	vec3array_init(&geom->vertices);
@@ -222,30 +332,106 @@ void icosphere_init(IcosphereGeometry* geom)
 }
 
 void icosphere_generate(IcosphereGeometry* geom, int subdivisions)
+{
+	icosphere_generate_parallel(geom, subdivisions, NULL);
+}
+
+void icosphere_generate_parallel(IcosphereGeometry* geom, int subdivisions,
+                                 JobSystem* jobs)
 {
 	/* Reset arrays */
 	geom->vertices.size = 0;
 	geom->normals.size = 0;
 	geom->indices.size = 0;
 
-	/* Add base icosahedron vertices */
-	for (int i = 0; i < ICOSAHEDRON_VERTEX_COUNT; i++) {
-		vec3array_push(&geom->vertices,
-		               (vec3){icosahedron_vertices[i][0],
-		                      icosahedron_vertices[i][1],
-		                      icosahedron_vertices[i][2]});
+	const size_t index_count = icosphere_index_count(subdivisions);
+	const size_t last_faces =
+	    subdivisions > 0 ? icosphere_index_count(subdivisions - 1) / 3 : 0;
+
+	/* Tout est dimensionné d'avance : indices et voisinage en ping-pong */
+	unsigned int* scratch = malloc(sizeof(unsigned int) * index_count);
+	EdgeLink* adjacency = malloc(sizeof(EdgeLink) * (last_faces * 3 + 60));
+	EdgeLink* next_adjacency =
+	    malloc(sizeof(EdgeLink) * (last_faces * 3 + 60));
+	unsigned char* owned = malloc(last_faces + 20);
+	uint32_t* offsets = malloc(sizeof(uint32_t) * (last_faces + 20));
+	if (!icosphere_reserve(geom, subdivisions) || !scratch || !adjacency ||
+	    !next_adjacency || !owned || !offsets ||
+	    !build_base_adjacency(adjacency)) {
+		LOG_ERROR("suckless-ogl.icosphere",
+		          "Failed to prepare subdivision level %d",
+		          subdivisions);
+		free(scratch);
+		free(adjacency);
+		free(next_adjacency);
+		free(owned);
+		free(offsets);
+		return;
 	}
 
-	/* Add base icosahedron indices */
-	for (int i = 0; i < ICOSAHEDRON_INDEX_COUNT; i++) {
-		uintarray_push(&geom->indices, icosahedron_indices[i]);
-	}
+	/* Add base icosahedron vertices and indices */
+	(void)memcpy(geom->vertices.data, icosahedron_vertices,
+	             sizeof(icosahedron_vertices));
+	(void)memcpy(geom->indices.data, icosahedron_indices,
+	             sizeof(icosahedron_indices));
+	size_t vertex_count = ICOSAHEDRON_VERTEX_COUNT;
+	size_t face_count = ICOSAHEDRON_INDEX_COUNT / FACE_EDGES;
+	unsigned int* current = geom->indices.data;
+	unsigned int* next = scratch;
 
 	/* Subdivide */
-	subdivide(&geom->vertices, &geom->indices, subdivisions);
+	for (int depth = 0; depth < subdivisions; depth++) {
+		SubdivideLevel level = {
+		    .indices = current,
+		    .adjacency = adjacency,
+		    .owned = owned,
+		    .offsets = offsets,
+		    .vertices = geom->vertices.data,
+		    .base_vertex = (unsigned int)vertex_count,
+		    .out_indices = next,
+		    .out_adjacency =
+		        depth + 1 < subdivisions ? next_adjacency : NULL,
+		};
+
+		run_range(jobs, (int)face_count, subdivide_count, &level);
+
+		/* Somme préfixe séquentielle (au plus 327680 faces) */
+		uint32_t running = 0;
+		for (size_t f = 0; f < face_count; f++) {
+			offsets[f] = running;
+			running += (uint32_t)__builtin_popcount(owned[f]);
+		}
+
+		run_range(jobs, (int)face_count, subdivide_write, &level);
+
+		vertex_count += running;
+		face_count *= CHILD_FACES;
+		unsigned int* swap_indices = current;
+		current = next;
+		next = swap_indices;
+		EdgeLink* swap_adjacency = adjacency;
+		adjacency = next_adjacency;
+		next_adjacency = swap_adjacency;
+	}
+
+	/* Le résultat final peut être dans le tampon de travail */
+	if (current != geom->indices.data) {
+		scratch = geom->indices.data;
+		geom->indices.data = current;
+		geom->indices.capacity = index_count;
+	}
+	geom->vertices.size = vertex_count;
+	geom->indices.size = face_count * FACE_EDGES;
 
 	/* Compute normals */
-	compute_normals(&geom->vertices, &geom->normals);
+	geom->normals.size = vertex_count;
+	run_range(jobs, (int)vertex_count, normals_range, geom);
+
+	free(scratch);
+	free(adjacency);
+	free(next_adjacency);
+	free(owned);
+	free(offsets);
 }
 
 void icosphere_free(IcosphereGeometry* geom)
@@ -254,3 +440,84 @@ void icosphere_free(IcosphereGeometry* geom)
 	vec3array_free(&geom->normals);
 	uintarray_free(&geom->indices);
 }
+
+int icosphere_optimize(IcosphereGeometry* geom, MeshCacheStats* before,
+                       MeshCacheStats* after)
+{
+	const size_t vertex_count = geom->vertices.size;
+	if (before) {
+		*before = mesh_analyze_vertex_cache(
+		    geom->indices.data, geom->indices.size, vertex_count,
+		    MESH_OPTIMIZE_CACHE_SIZE);
+	}
+
+	unsigned int* remap = malloc(vertex_count * sizeof(unsigned int));
+	if (!remap || !mesh_optimize_vertex_cache(geom->indices.data,
+	                                          geom->indices.size,
+	                                          vertex_count)) {
+		free(remap);
+		return 0;
+	}
+	mesh_optimize_vertex_fetch_remap(geom->indices.data, geom->indices.size,
+	                                 vertex_count, remap);
+	const int remapped =
+	    mesh_remap_vec3(geom->vertices.data, vertex_count, remap) &&
+	    mesh_remap_vec3(geom->normals.data, geom->normals.size, remap);
+	free(remap);
+	if (!remapped) {
+		LOG_ERROR("suckless-ogl.icosphere",
+		          "Vertex remap failed: out of memory");
+		return 0;
+	}
+
+	if (after) {
+		*after = mesh_analyze_vertex_cache(
+		    geom->indices.data, geom->indices.size, vertex_count,
+		    MESH_OPTIMIZE_CACHE_SIZE);
+	}
+	return 1;
+}
+
+size_t icosphere_position_stride(IcospherePositionFormat format)
+{
+	return format == ICOSPHERE_POSITION_SNORM16 ? 4 * sizeof(int16_t)
+	                                            : sizeof(vec3);
+}
+
+/* Conversion GL : f = max(c / 32767, -1) */
+static int16_t pack_snorm16(float value)
+{
+	const float clamped = fminf(fmaxf(value, -1.0F), 1.0F);
+	return (int16_t)lrintf(clamped * (float)SNORM16_MAX);
+}
+
+void icosphere_pack_positions(const IcosphereGeometry* geom,
+                              IcospherePositionFormat format, void* out)
+{
+	if (format != ICOSPHERE_POSITION_SNORM16) {
+		(void)memcpy(out, geom->vertices.data,
+		             geom->vertices.size * sizeof(vec3));
+		return;
+	}
+
+	int16_t* packed = out;
+	for (size_t i = 0; i < geom->vertices.size; i++) {
+		packed[(i * 4) + 0] = pack_snorm16(geom->vertices.data[i][0]);
+		packed[(i * 4) + 1] = pack_snorm16(geom->vertices.data[i][1]);
+		packed[(i * 4) + 2] = pack_snorm16(geom->vertices.data[i][2]);
+		packed[(i * 4) + 3] = 0; /* Alignement 4 octets des attributs */
+	}
+}
+
+int icosphere_fits_short_indices(size_t vertex_count)
+{
+	return vertex_count <= SHORT_INDEX_LIMIT;
+}
+
+void icosphere_pack_short_indices(const IcosphereGeometry* geom,
+                                  uint16_t* out)
+{
+	for (size_t i = 0; i < geom->indices.size; i++) {
+		out[i] = (uint16_t)geom->indices.data[i];
+	}
+}
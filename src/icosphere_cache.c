@@ -0,0 +1,296 @@
+#include "icosphere_cache.h"
+
+#include "gl_common.h"
+#include "icosphere.h"
+#include "job_system.h"
+#include "log.h"
+#include "mesh_optimize.h"
+#include "perf_timer.h"
+#include <cglm/types.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int clamp_level(int level)
+{
+	if (level < 0) {
+		return 0;
+	}
+	return level > ICOSPHERE_MAX_SUBDIVISIONS ? ICOSPHERE_MAX_SUBDIVISIONS
+	                                          : level;
+}
+
+static GLuint create_static_buffer(GLenum target, size_t size,
+                                   const void* data)
+{
+	GLuint buffer = 0;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(target, buffer);
+	/* Immutable : jamais réécrit, un nouveau niveau = nouveaux buffers */
+	glBufferStorage(target, (GLsizeiptr)size, data, 0);
+	glBindBuffer(target, 0);
+	return buffer;
+}
+
+static void mesh_release(IcosphereMesh* mesh)
+{
+	if (mesh->vbo) {
+		glDeleteBuffers(1, &mesh->vbo);
+		glDeleteBuffers(1, &mesh->ebo);
+	}
+	(void)memset(mesh, 0, sizeof(*mesh));
+}
+
+static void mesh_upload(IcosphereMesh* mesh, const IcosphereGeometry* geom,
+                        IcospherePositionFormat format)
+{
+	mesh_release(mesh);
+	mesh->vertex_count = geom->vertices.size;
+	mesh->index_count = geom->indices.size;
+	mesh->position_format = format;
+	mesh->index_type = icosphere_fits_short_indices(mesh->vertex_count)
+	                       ? GL_UNSIGNED_SHORT
+	                       : GL_UNSIGNED_INT;
+
+	/* Les formats compacts passent par un tampon temporaire */
+	const size_t vertex_bytes = icosphere_mesh_vertex_bytes(mesh);
+	const size_t index_bytes = icosphere_mesh_index_bytes(mesh);
+	void* positions = geom->vertices.data;
+	void* indices = geom->indices.data;
+	if (format != ICOSPHERE_POSITION_FLOAT) {
+		positions = malloc(vertex_bytes);
+		if (positions) {
+			icosphere_pack_positions(geom, format, positions);
+		}
+	}
+	if (mesh->index_type == GL_UNSIGNED_SHORT) {
+		indices = malloc(index_bytes);
+		if (indices) {
+			icosphere_pack_short_indices(geom, indices);
+		}
+	}
+
+	if (positions && indices) {
+		mesh->vbo = create_static_buffer(GL_ARRAY_BUFFER, vertex_bytes,
+		                                 positions);
+		mesh->ebo = create_static_buffer(GL_ELEMENT_ARRAY_BUFFER,
+		                                 index_bytes, indices);
+	} else {
+		LOG_ERROR("suckless-ogl.icosphere",
+		          "Failed to pack %zu vertices for upload",
+		          mesh->vertex_count);
+		mesh->vertex_count = 0;
+		mesh->index_count = 0;
+	}
+
+	if (positions != geom->vertices.data) {
+		free(positions);
+	}
+	if (indices != geom->indices.data) {
+		free(indices);
+	}
+}
+
+size_t icosphere_mesh_vertex_bytes(const IcosphereMesh* mesh)
+{
+	return mesh->vertex_count *
+	       icosphere_position_stride(mesh->position_format);
+}
+
+size_t icosphere_mesh_index_bytes(const IcosphereMesh* mesh)
+{
+	return mesh->index_count * (mesh->index_type == GL_UNSIGNED_SHORT
+	                                ? sizeof(uint16_t)
+	                                : sizeof(uint32_t));
+}
+
+void icosphere_mesh_setup_vao(const IcosphereMesh* mesh)
+{
+	const GLsizei stride =
+	    (GLsizei)icosphere_position_stride(mesh->position_format);
+
+	glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+	if (mesh->position_format == ICOSPHERE_POSITION_SNORM16) {
+		glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, stride,
+		                      (void*)0);
+	} else {
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride,
+		                      (void*)0);
+	}
+	glEnableVertexAttribArray(0);
+	glVertexAttribDivisor(0, 0);
+
+	/* Normale dérivée de la position dans les shaders */
+	glDisableVertexAttribArray(1);
+	glVertexAttribDivisor(1, 0);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ebo);
+}
+
+void icosphere_cache_init(IcosphereCache* cache, JobSystem* jobs)
+{
+	(void)memset(cache, 0, sizeof(*cache));
+	cache->jobs = jobs;
+	cache->current = -1;
+	cache->wanted = -1;
+	cache->pending_level = -1;
+	icosphere_init(&cache->pending);
+}
+
+/* Job : génération CPU seule (aucun appel GL hors du thread de rendu) */
+static void generate_job(void* user_data)
+{
+	IcosphereCache* cache = user_data;
+	PERF_MEASURE_MS(generate_ms)
+	{
+		icosphere_generate_parallel(&cache->pending,
+		                            cache->pending_level, cache->jobs);
+		icosphere_optimize(&cache->pending, &cache->pending_before,
+		                   &cache->pending_after);
+	}
+	cache->pending_ms = generate_ms;
+}
+
+int icosphere_cache_busy(const IcosphereCache* cache)
+{
+	return cache->pending_level >= 0 &&
+	       __atomic_load_n(&cache->counter.pending, __ATOMIC_ACQUIRE) > 0;
+}
+
+/* Téléverse la génération terminée ; 1 si un niveau a été ajouté */
+static int finish_pending(IcosphereCache* cache)
+{
+	if (cache->pending_level < 0 || icosphere_cache_busy(cache)) {
+		return 0;
+	}
+
+	const int level = cache->pending_level;
+	IcosphereMesh* mesh = &cache->levels[level];
+	PERF_MEASURE_MS(upload_ms)
+	{
+		mesh_upload(mesh, &cache->pending, cache->format);
+	}
+	LOG_INFO("suckless-ogl.icosphere",
+	         "Level %d ready: %zu vertices, %zu triangles, %zu + %zu "
+	         "bytes (generate %.2f ms off-thread, upload %.2f ms)",
+	         level, mesh->vertex_count, mesh->index_count / 3,
+	         icosphere_mesh_vertex_bytes(mesh),
+	         icosphere_mesh_index_bytes(mesh), cache->pending_ms,
+	         upload_ms);
+	LOG_INFO("suckless-ogl.icosphere",
+	         "Level %d vertex cache (FIFO %d): ACMR %.3f -> %.3f, ATVR "
+	         "%.3f -> %.3f",
+	         level, MESH_OPTIMIZE_CACHE_SIZE, cache->pending_before.acmr,
+	         cache->pending_after.acmr, cache->pending_before.atvr,
+	         cache->pending_after.atvr);
+
+	/* Le CPU n'a plus besoin de la géométrie : la VRAM sert de cache */
+	icosphere_free(&cache->pending);
+	icosphere_init(&cache->pending);
+	cache->pending_level = -1;
+	return 1;
+}
+
+/* Sans worker (job_system_create(-1) sur un seul cœur), un job soumis
+ * n'avancerait que dans un job_system_wait() : on génère sur place */
+static int cache_synchronous(const IcosphereCache* cache)
+{
+	return !cache->jobs || job_system_thread_count(cache->jobs) == 1;
+}
+
+static void start_pending(IcosphereCache* cache, int level)
+{
+	cache->pending_level = level;
+	if (cache_synchronous(cache)) {
+		generate_job(cache);
+		return;
+	}
+	/* Workers seuls : un job_system_wait() du thread de rendu (simulation
+	 * des instances, etc.) ne doit pas exécuter la génération sur place */
+	job_system_submit_background(cache->jobs, generate_job, cache,
+	                             JOB_PRIORITY_NORMAL, &cache->counter);
+}
+
+int icosphere_cache_request(IcosphereCache* cache, int level)
+{
+	cache->wanted = clamp_level(level);
+	finish_pending(cache);
+
+	if (cache->levels[cache->wanted].vbo) {
+		if (cache->current != cache->wanted) {
+			cache->current = cache->wanted;
+			return 1;
+		}
+		return 0;
+	}
+
+	/* Un seul job : une demande intermédiaire (touches répétées) est
+	 * ignorée, le niveau final part dès que le job précédent est fini */
+	if (cache->pending_level < 0) {
+		start_pending(cache, cache->wanted);
+		if (cache_synchronous(cache)) {
+			return icosphere_cache_request(cache, level);
+		}
+	}
+	return 0;
+}
+
+int icosphere_cache_store(IcosphereCache* cache, int level,
+                          const IcosphereGeometry* geom)
+{
+	level = clamp_level(level);
+	mesh_upload(&cache->levels[level], geom, cache->format);
+	cache->wanted = level;
+	cache->current = level;
+	return 1;
+}
+
+int icosphere_cache_load(IcosphereCache* cache, int level)
+{
+	IcosphereGeometry geom;
+	icosphere_init(&geom);
+	icosphere_generate_parallel(&geom, clamp_level(level), cache->jobs);
+	icosphere_optimize(&geom, NULL, NULL);
+	icosphere_cache_store(cache, level, &geom);
+	icosphere_free(&geom);
+	return 1;
+}
+
+int icosphere_cache_set_format(IcosphereCache* cache,
+                               IcospherePositionFormat format)
+{
+	if (format == cache->format) {
+		return 0;
+	}
+
+	/* Un job en cours ne dépend pas du format : il sera téléversé au
+	 * nouveau format par le poll suivant */
+	cache->format = format;
+	for (int i = 0; i < ICOSPHERE_CACHE_LEVELS; i++) {
+		mesh_release(&cache->levels[i]);
+	}
+	if (cache->current < 0) {
+		return 0;
+	}
+	return icosphere_cache_load(cache, cache->current);
+}
+
+const IcosphereMesh* icosphere_cache_current(const IcosphereCache* cache)
+{
+	return cache->current >= 0 ? &cache->levels[cache->current] : NULL;
+}
+
+void icosphere_cache_cleanup(IcosphereCache* cache)
+{
+	if (cache->pending_level >= 0 && cache->jobs) {
+		job_system_wait(cache->jobs, &cache->counter);
+	}
+	icosphere_free(&cache->pending);
+	for (int i = 0; i < ICOSPHERE_CACHE_LEVELS; i++) {
+		mesh_release(&cache->levels[i]);
+	}
+	cache->current = -1;
+	cache->wanted = -1;
+	cache->pending_level = -1;
+}
@@ -0,0 +1,88 @@
+#include "instance_generator.h"
+
+#include "app_settings.h"
+#include "gl_common.h"
+#include "log.h"
+#include "material.h"
+#include "shader.h"
+#include <math.h>
+#include <stddef.h>
+
+enum { INSTANCE_GEN_GROUP_SIZE = 256 };
+
+/* Material table: MATERIAL_TABLE_BINDING */
+enum InstanceGenBindings {
+	INSTANCE_GEN_BINDING_INSTANCES = 0,
+	INSTANCE_GEN_BINDING_COMPACT = 1
+};
+
+int instance_generator_columns(int count)
+{
+	if (count <= DEFAULT_COLS * DEFAULT_COLS) {
+		return DEFAULT_COLS;
+	}
+	return (int)ceilf(sqrtf((float)count));
+}
+
+int instance_generator_init(InstanceGenerator* gen)
+{
+	gen->shader =
+	    shader_load_compute_program("shaders/instance_generate.comp");
+	if (!gen->shader) {
+		LOG_ERROR("suckless-ogl.instance_gen",
+		          "Failed to load instance generation shader");
+		return 0;
+	}
+	return 1;
+}
+
+void instance_generator_run(InstanceGenerator* gen,
+                            const InstanceGenParams* params,
+                            const MaterialTable* materials,
+                            GLuint dest_buffer)
+{
+	if (!gen->shader || params->count <= 0 || materials->count <= 0) {
+		return;
+	}
+
+	GL_SCOPE_DEBUG_GROUP("Instance Generation");
+
+	Shader* shader = gen->shader;
+	shader_use(shader);
+	shader_set_int(shader, "instanceCount", params->count);
+	shader_set_int(shader, "layoutMode", (int)params->layout);
+	shader_set_int(shader, "columns",
+	               instance_generator_columns(params->count));
+	shader_set_float(shader, "spacing", params->spacing);
+	shader_set_float(shader, "radius", params->radius);
+	shader_set_int(shader, "materialIndex", params->material_index);
+	shader_set_int(shader, "materialCount", materials->count);
+	shader_set_int(shader, "seed", (int)params->seed);
+
+	const int compact = params->format == INSTANCE_FORMAT_COMPACT;
+	shader_set_int(shader, "compactOutput", compact);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER,
+	                 compact ? INSTANCE_GEN_BINDING_COMPACT
+	                         : INSTANCE_GEN_BINDING_INSTANCES,
+	                 dest_buffer);
+	material_table_bind(materials);
+
+	GLuint groups =
+	    ((GLuint)params->count + (INSTANCE_GEN_GROUP_SIZE - 1)) /
+	    INSTANCE_GEN_GROUP_SIZE;
+	glDispatchCompute(groups, 1, 1);
+
+	/* Consumed as vertex attributes, SSBO (hybrid) or copy source */
+	glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+	                GL_SHADER_STORAGE_BARRIER_BIT |
+	                GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+void instance_generator_cleanup(InstanceGenerator* gen)
+{
+	if (gen->shader) {
+		shader_destroy(gen->shader);
+		gen->shader = NULL;
+	}
+}
@@ -0,0 +1,405 @@
+#include "instance_sim.h"
+
+#include "gl_common.h"
+#include "instance_generator.h"
+#include "job_system.h"
+#include "log.h"
+#include "material.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+enum { SIM_AXES = 3, SIM_FLOATS_PER_COLUMN = 4 };
+
+/* Vitesse initiale max (unités/s) et marge verticale de la boîte */
+#define SIM_MAX_SPEED 2.0F
+#define SIM_DEPTH_SPACINGS 2.0F
+
+/* xorshift32 : vitesses reproductibles d'un run à l'autre */
+static uint32_t sim_random(uint32_t* state)
+{
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+static float sim_random_signed(uint32_t* state)
+{
+	return ((float)(sim_random(state) >> 8) / 8388608.0F) - 1.0F;
+}
+
+static void* sim_alloc(size_t count, size_t size)
+{
+	void* ptr = NULL;
+	if (posix_memalign(&ptr, SIMD_ALIGNMENT, count * size) != 0) {
+		return NULL;
+	}
+	(void)memset(ptr, 0, count * size);
+	return ptr;
+}
+
+int instance_sim_init(InstanceSim* sim, const MaterialLib* lib, int count,
+                      float spacing, float radius, uint32_t seed)
+{
+	(void)memset(sim, 0, sizeof(*sim));
+	if (!lib || lib->count <= 0 || count <= 0) {
+		return 0;
+	}
+
+	/* Rembourrage : les kernels vectoriels lisent toujours LANES entrées */
+	const size_t padded = ((size_t)count + INSTANCE_SIM_LANES - 1) /
+	                      INSTANCE_SIM_LANES * INSTANCE_SIM_LANES;
+
+	sim->pos_x = sim_alloc(padded, sizeof(float));
+	sim->pos_y = sim_alloc(padded, sizeof(float));
+	sim->pos_z = sim_alloc(padded, sizeof(float));
+	sim->vel_x = sim_alloc(padded, sizeof(float));
+	sim->vel_y = sim_alloc(padded, sizeof(float));
+	sim->vel_z = sim_alloc(padded, sizeof(float));
+	sim->scale = sim_alloc(padded, sizeof(float));
+	sim->material = sim_alloc(padded, sizeof(uint32_t));
+	sim->material_rows = sim_alloc(
+	    (size_t)lib->count * INSTANCE_SIM_MATERIAL_FLOATS, sizeof(float));
+	if (!sim->pos_x || !sim->pos_y || !sim->pos_z || !sim->vel_x ||
+	    !sim->vel_y || !sim->vel_z || !sim->scale || !sim->material ||
+	    !sim->material_rows) {
+		LOG_ERROR("suckless-ogl.sim", "Failed to allocate %d instances",
+		          count);
+		instance_sim_cleanup(sim);
+		return 0;
+	}
+
+	for (int i = 0; i < lib->count; i++) {
+		const PBRMaterial* mat = &lib->materials[i];
+		float* row =
+		    &sim->material_rows[(size_t)i * INSTANCE_SIM_MATERIAL_FLOATS];
+		row[0] = mat->albedo[0];
+		row[1] = mat->albedo[1];
+		row[2] = mat->albedo[2];
+		row[3] = mat->metallic;
+		row[4] = mat->roughness;
+		row[5] = 1.0F; /* ao */
+	}
+	sim->material_count = lib->count;
+	sim->count = count;
+
+	const int cols = instance_generator_columns(count);
+	const int rows = (count + cols - 1) / cols;
+	const float half_w = (float)(cols - 1) * spacing * 0.5F;
+	const float half_h = (float)(rows - 1) * spacing * 0.5F;
+
+	/* Boîte = grille + une cellule de marge, épaisseur fixe en Z */
+	sim->bounds_min[0] = -half_w - spacing;
+	sim->bounds_min[1] = -half_h - spacing;
+	sim->bounds_min[2] = -spacing * SIM_DEPTH_SPACINGS;
+	sim->bounds_max[0] = half_w + spacing;
+	sim->bounds_max[1] = half_h + spacing;
+	sim->bounds_max[2] = spacing * SIM_DEPTH_SPACINGS;
+
+	uint32_t state = seed ? seed : 1U;
+	for (int i = 0; i < count; i++) {
+		sim->pos_x[i] = ((float)(i % cols) * spacing) - half_w;
+		sim->pos_y[i] = half_h - ((float)(i / cols) * spacing);
+		sim->pos_z[i] = 0.0F;
+		sim->vel_x[i] = sim_random_signed(&state) * SIM_MAX_SPEED;
+		sim->vel_y[i] = sim_random_signed(&state) * SIM_MAX_SPEED;
+		sim->vel_z[i] = sim_random_signed(&state) * SIM_MAX_SPEED;
+		sim->scale[i] = radius;
+		sim->material[i] = (uint32_t)(i % lib->count);
+	}
+
+	LOG_INFO("suckless-ogl.sim",
+	         "Instance sim: %d instances, SoA %.1f MiB, %s kernels", count,
+	         (double)(padded * (7 * sizeof(float) + sizeof(uint32_t))) /
+	             (1024.0 * 1024.0),
+	         instance_sim_simd_name());
+	return 1;
+}
+
+const char* instance_sim_simd_name(void)
+{
+#if defined(__AVX__)
+	return "AVX";
+#elif defined(__SSE2__)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+/* Rebond sur un axe : renvoie 1 si la sphère a touché une paroi */
+static int sim_bounce_axis(float* pos, float* vel, float lo, float hi)
+{
+	if (*pos < lo) {
+		*pos = lo;
+		*vel = *vel < 0.0F ? -*vel : *vel;
+		return 1;
+	}
+	if (*pos > hi) {
+		*pos = hi;
+		*vel = *vel > 0.0F ? -*vel : *vel;
+		return 1;
+	}
+	return 0;
+}
+
+static void sim_next_material(InstanceSim* sim, int i)
+{
+	uint32_t next = sim->material[i] + 1U;
+	sim->material[i] =
+	    next >= (uint32_t)sim->material_count ? 0U : next;
+}
+
+/* Référence scalaire (têtes/queues de plage et cibles sans SIMD) */
+static void sim_step_scalar(InstanceSim* sim, int i, float dt)
+{
+	float* pos[SIM_AXES] = {&sim->pos_x[i], &sim->pos_y[i],
+	                        &sim->pos_z[i]};
+	float* vel[SIM_AXES] = {&sim->vel_x[i], &sim->vel_y[i],
+	                        &sim->vel_z[i]};
+	const float radius = sim->scale[i];
+	int bounced = 0;
+
+	for (int axis = 0; axis < SIM_AXES; axis++) {
+		*pos[axis] += *vel[axis] * dt;
+		bounced |= sim_bounce_axis(pos[axis], vel[axis],
+		                           sim->bounds_min[axis] + radius,
+		                           sim->bounds_max[axis] - radius);
+	}
+	if (bounced) {
+		sim_next_material(sim, i);
+	}
+}
+
+#if defined(__AVX__)
+typedef __m256 SimVec;
+#define SIM_LOAD(ptr) _mm256_load_ps(ptr)
+#define SIM_STORE(ptr, v) _mm256_store_ps((ptr), (v))
+#define SIM_SET1(x) _mm256_set1_ps(x)
+#define SIM_ADD(a, b) _mm256_add_ps((a), (b))
+#define SIM_SUB(a, b) _mm256_sub_ps((a), (b))
+#define SIM_MUL(a, b) _mm256_mul_ps((a), (b))
+#define SIM_MIN(a, b) _mm256_min_ps((a), (b))
+#define SIM_MAX(a, b) _mm256_max_ps((a), (b))
+#define SIM_LT(a, b) _mm256_cmp_ps((a), (b), _CMP_LT_OQ)
+#define SIM_GT(a, b) _mm256_cmp_ps((a), (b), _CMP_GT_OQ)
+#define SIM_OR(a, b) _mm256_or_ps((a), (b))
+#define SIM_AND(a, b) _mm256_and_ps((a), (b))
+#define SIM_ANDNOT(a, b) _mm256_andnot_ps((a), (b))
+#define SIM_MOVEMASK(a) _mm256_movemask_ps(a)
+#elif defined(__SSE2__)
+typedef __m128 SimVec;
+#define SIM_LOAD(ptr) _mm_load_ps(ptr)
+#define SIM_STORE(ptr, v) _mm_store_ps((ptr), (v))
+#define SIM_SET1(x) _mm_set1_ps(x)
+#define SIM_ADD(a, b) _mm_add_ps((a), (b))
+#define SIM_SUB(a, b) _mm_sub_ps((a), (b))
+#define SIM_MUL(a, b) _mm_mul_ps((a), (b))
+#define SIM_MIN(a, b) _mm_min_ps((a), (b))
+#define SIM_MAX(a, b) _mm_max_ps((a), (b))
+#define SIM_LT(a, b) _mm_cmplt_ps((a), (b))
+#define SIM_GT(a, b) _mm_cmpgt_ps((a), (b))
+#define SIM_OR(a, b) _mm_or_ps((a), (b))
+#define SIM_AND(a, b) _mm_and_ps((a), (b))
+#define SIM_ANDNOT(a, b) _mm_andnot_ps((a), (b))
+#define SIM_MOVEMASK(a) _mm_movemask_ps(a)
+#endif
+
+#if INSTANCE_SIM_LANES > 1
+/* Un axe pour LANES instances ; renvoie le masque des rebonds */
+static SimVec sim_step_axis(float* pos_ptr, float* vel_ptr, SimVec radius,
+                            SimVec dt, float min_bound, float max_bound)
+{
+	const SimVec sign_mask = SIM_SET1(-0.0F);
+	SimVec pos = SIM_LOAD(pos_ptr);
+	SimVec vel = SIM_LOAD(vel_ptr);
+	const SimVec lo = SIM_ADD(SIM_SET1(min_bound), radius);
+	const SimVec hi = SIM_SUB(SIM_SET1(max_bound), radius);
+
+	pos = SIM_ADD(pos, SIM_MUL(vel, dt));
+	const SimVec below = SIM_LT(pos, lo);
+	const SimVec above = SIM_GT(pos, hi);
+
+	/* below : +|v|, above : -|v|, sinon v inchangé (sans branche) */
+	const SimVec abs_vel = SIM_ANDNOT(sign_mask, vel);
+	const SimVec neg_abs_vel = SIM_OR(sign_mask, vel);
+	vel = SIM_OR(SIM_ANDNOT(SIM_OR(below, above), vel),
+	             SIM_OR(SIM_AND(below, abs_vel),
+	                    SIM_AND(above, neg_abs_vel)));
+	pos = SIM_MIN(SIM_MAX(pos, lo), hi);
+
+	SIM_STORE(pos_ptr, pos);
+	SIM_STORE(vel_ptr, vel);
+	return SIM_OR(below, above);
+}
+#endif
+
+void instance_sim_step(InstanceSim* sim, int begin, int end, float dt)
+{
+	int i = begin;
+
+#if INSTANCE_SIM_LANES > 1
+	while (i < end && (i % INSTANCE_SIM_LANES) != 0) {
+		sim_step_scalar(sim, i, dt);
+		i++;
+	}
+
+	const SimVec dt_v = SIM_SET1(dt);
+	for (; i + INSTANCE_SIM_LANES <= end; i += INSTANCE_SIM_LANES) {
+		const SimVec radius = SIM_LOAD(&sim->scale[i]);
+		SimVec bounced = sim_step_axis(
+		    &sim->pos_x[i], &sim->vel_x[i], radius, dt_v,
+		    sim->bounds_min[0], sim->bounds_max[0]);
+		bounced = SIM_OR(bounced, sim_step_axis(&sim->pos_y[i],
+		                                        &sim->vel_y[i], radius,
+		                                        dt_v, sim->bounds_min[1],
+		                                        sim->bounds_max[1]));
+		bounced = SIM_OR(bounced, sim_step_axis(&sim->pos_z[i],
+		                                        &sim->vel_z[i], radius,
+		                                        dt_v, sim->bounds_min[2],
+		                                        sim->bounds_max[2]));
+
+		/* Rebonds rares : mise à jour scalaire des seuls bits levés */
+		int mask = SIM_MOVEMASK(bounced);
+		while (mask) {
+			const int lane = __builtin_ctz((unsigned)mask);
+			sim_next_material(sim, i + lane);
+			mask &= mask - 1;
+		}
+	}
+#endif
+
+	for (; i < end; i++) {
+		sim_step_scalar(sim, i, dt);
+	}
+}
+
+void instance_sim_write(const InstanceSim* sim, void* out, size_t stride,
+                        int begin, int end)
+{
+	unsigned char* dst = (unsigned char*)out + (size_t)begin * stride;
+
+#if defined(__AVX__)
+	/* 3 stores de 32 octets : (col0, col1), (col2, col3), matériau */
+	const int streaming = ((uintptr_t)dst % 32U) == 0 && stride % 32U == 0;
+	for (int i = begin; i < end; i++, dst += stride) {
+		const float s = sim->scale[i];
+		const __m256 col01 =
+		    _mm256_setr_ps(s, 0.0F, 0.0F, 0.0F, 0.0F, s, 0.0F, 0.0F);
+		const __m256 col23 =
+		    _mm256_setr_ps(0.0F, 0.0F, s, 0.0F, sim->pos_x[i],
+		                   sim->pos_y[i], sim->pos_z[i], 1.0F);
+		const __m256 mat = _mm256_load_ps(
+		    &sim->material_rows[(size_t)sim->material[i] *
+		                        INSTANCE_SIM_MATERIAL_FLOATS]);
+		float* f = (float*)dst;
+		if (streaming) {
+			_mm256_stream_ps(f, col01);
+			_mm256_stream_ps(f + 8, col23);
+			_mm256_stream_ps(f + 16, mat);
+		} else {
+			_mm256_storeu_ps(f, col01);
+			_mm256_storeu_ps(f + 8, col23);
+			_mm256_storeu_ps(f + 16, mat);
+		}
+	}
+	_mm_sfence();
+#elif defined(__SSE2__)
+	const int streaming = ((uintptr_t)dst % 16U) == 0 && stride % 16U == 0;
+	const __m128 zero = _mm_setzero_ps();
+	for (int i = begin; i < end; i++, dst += stride) {
+		const __m128 s = _mm_set_ss(sim->scale[i]);
+		const float* row = &sim->material_rows[(size_t)sim->material[i] *
+		                                       INSTANCE_SIM_MATERIAL_FLOATS];
+		__m128 cols[6];
+		cols[0] = _mm_move_ss(zero, s);
+		cols[1] = _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 0, 1));
+		cols[2] = _mm_shuffle_ps(zero, s, _MM_SHUFFLE(1, 0, 0, 0));
+		cols[3] = _mm_setr_ps(sim->pos_x[i], sim->pos_y[i],
+		                      sim->pos_z[i], 1.0F);
+		cols[4] = _mm_load_ps(row);
+		cols[5] = _mm_load_ps(row + SIM_FLOATS_PER_COLUMN);
+		float* f = (float*)dst;
+		for (int c = 0; c < 6; c++) {
+			if (streaming) {
+				_mm_stream_ps(f + (c * SIM_FLOATS_PER_COLUMN),
+				              cols[c]);
+			} else {
+				_mm_storeu_ps(f + (c * SIM_FLOATS_PER_COLUMN),
+				              cols[c]);
+			}
+		}
+	}
+	_mm_sfence();
+#else
+	for (int i = begin; i < end; i++, dst += stride) {
+		const float s = sim->scale[i];
+		const float* row = &sim->material_rows[(size_t)sim->material[i] *
+		                                       INSTANCE_SIM_MATERIAL_FLOATS];
+		float values[24] = {s, 0.0F, 0.0F, 0.0F, 0.0F, s, 0.0F, 0.0F,
+		                    0.0F, 0.0F, s, 0.0F, sim->pos_x[i],
+		                    sim->pos_y[i], sim->pos_z[i], 1.0F};
+		(void)memcpy(&values[16], row,
+		             INSTANCE_SIM_MATERIAL_FLOATS * sizeof(float));
+		(void)memcpy(dst, values, sizeof(values));
+	}
+#endif
+}
+
+typedef struct {
+	InstanceSim* sim;
+	float dt;
+	void* out;
+	size_t stride;
+} SimUpdateJob;
+
+/* step puis write sur la même tranche : données encore en cache L1/L2.
+ * Les indices sont des numéros de tranche : les coupes restent alignées
+ * sur INSTANCE_SIM_LANES quel que soit le découpage du job system. */
+static void sim_update_chunks(void* user_data, int first_chunk, int end_chunk)
+{
+	SimUpdateJob* job = user_data;
+	const int begin = first_chunk * INSTANCE_SIM_CHUNK;
+	int end = end_chunk * INSTANCE_SIM_CHUNK;
+	if (end > job->sim->count) {
+		end = job->sim->count;
+	}
+	instance_sim_step(job->sim, begin, end, job->dt);
+	instance_sim_write(job->sim, job->out, job->stride, begin, end);
+}
+
+void instance_sim_update(InstanceSim* sim, JobSystem* jobs, float dt,
+                         void* out, size_t stride)
+{
+	SimUpdateJob job = {sim, dt, out, stride};
+	const int chunks =
+	    (sim->count + INSTANCE_SIM_CHUNK - 1) / INSTANCE_SIM_CHUNK;
+	if (!jobs) {
+		sim_update_chunks(&job, 0, chunks);
+		return;
+	}
+	job_system_parallel_for(jobs, chunks, 1, sim_update_chunks, &job,
+	                        JOB_PRIORITY_HIGH);
+}
+
+void instance_sim_cleanup(InstanceSim* sim)
+{
+	free(sim->pos_x);
+	free(sim->pos_y);
+	free(sim->pos_z);
+	free(sim->vel_x);
+	free(sim->vel_y);
+	free(sim->vel_z);
+	free(sim->scale);
+	free(sim->material);
+	free(sim->material_rows);
+	(void)memset(sim, 0, sizeof(*sim));
+}
@@ -0,0 +1,162 @@
+#include "instance_stream.h"
+
+#include "gl_common.h"
+#include "log.h"
+#include "perf_timer.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/* Attente maximale par appel avant de réessayer (1 ms) */
+#define FENCE_TIMEOUT_NS 1000000ULL
+
+static size_t gcd_size(size_t lhs, size_t rhs)
+{
+	while (rhs != 0) {
+		size_t tmp = lhs % rhs;
+		lhs = rhs;
+		rhs = tmp;
+	}
+	return lhs;
+}
+
+int instance_stream_init(InstanceStream* stream, size_t stride, int count)
+{
+	stream->buffer = 0;
+	stream->mapped = NULL;
+	stream->stride = stride;
+	stream->region = -1;
+	stream->last_wait_ms = 0.0;
+	for (int i = 0; i < INSTANCE_STREAM_FRAMES; i++) {
+		stream->fences[i] = NULL;
+	}
+
+	if (stride == 0 || count <= 0) {
+		return 0;
+	}
+
+	/* Chaque région doit pouvoir être liée en SSBO : on arrondit la
+	 * capacité pour que capacity * stride soit multiple de l'alignement */
+	GLint ssbo_alignment = 1;
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT,
+	              &ssbo_alignment);
+	const size_t alignment = ssbo_alignment > 0 ? (size_t)ssbo_alignment : 1;
+	const size_t granularity = alignment / gcd_size(stride, alignment);
+	const size_t capacity =
+	    (((size_t)count + granularity - 1) / granularity) * granularity;
+
+	stream->capacity = (int)capacity;
+	stream->region_size = capacity * stride;
+
+	const GLbitfield flags =
+	    GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	const GLsizeiptr total =
+	    (GLsizeiptr)(stream->region_size * INSTANCE_STREAM_FRAMES);
+
+	glGenBuffers(1, &stream->buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, stream->buffer);
+	glBufferStorage(GL_ARRAY_BUFFER, total, NULL, flags);
+	stream->mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, total, flags);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	if (!stream->mapped) {
+		LOG_ERROR("suckless-ogl.stream",
+		          "Failed to map persistent instance buffer");
+		instance_stream_cleanup(stream);
+		return 0;
+	}
+	glObjectLabel(GL_BUFFER, stream->buffer, -1, "Instance Stream");
+
+	LOG_INFO("suckless-ogl.stream",
+	         "Instance stream: %d x %d instances (%zu bytes each), "
+	         "%.1f MiB persistent",
+	         INSTANCE_STREAM_FRAMES, stream->capacity, stride,
+	         (double)total / (1024.0 * 1024.0));
+	return 1;
+}
+
+static double wait_fence(GLsync* fence)
+{
+	if (*fence == NULL) {
+		return 0.0;
+	}
+
+	PerfTimer timer;
+	perf_timer_start(&timer);
+
+	GLbitfield wait_flags = 0;
+	for (;;) {
+		GLenum status =
+		    glClientWaitSync(*fence, wait_flags, FENCE_TIMEOUT_NS);
+		if (status == GL_ALREADY_SIGNALED ||
+		    status == GL_CONDITION_SATISFIED) {
+			break;
+		}
+		if (status == GL_WAIT_FAILED) {
+			LOG_ERROR("suckless-ogl.stream",
+			          "glClientWaitSync failed");
+			break;
+		}
+		/* Timeout : s'assurer que le fence finira par être soumis */
+		wait_flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	}
+
+	glDeleteSync(*fence);
+	*fence = NULL;
+	return perf_timer_elapsed_ms(&timer);
+}
+
+void* instance_stream_next(InstanceStream* stream)
+{
+	if (!stream->mapped) {
+		return NULL;
+	}
+
+	/* Les draws de la frame précédente lisent encore cette région */
+	if (stream->region >= 0) {
+		stream->fences[stream->region] =
+		    glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	stream->region = (stream->region + 1) % INSTANCE_STREAM_FRAMES;
+	stream->last_wait_ms = wait_fence(&stream->fences[stream->region]);
+
+	return stream->mapped + (size_t)stream->region * stream->region_size;
+}
+
+GLuint instance_stream_base_instance(const InstanceStream* stream)
+{
+	if (stream->region < 0) {
+		return 0;
+	}
+	return (GLuint)(stream->region * stream->capacity);
+}
+
+GLintptr instance_stream_offset(const InstanceStream* stream)
+{
+	if (stream->region < 0) {
+		return 0;
+	}
+	return (GLintptr)((size_t)stream->region * stream->region_size);
+}
+
+void instance_stream_cleanup(InstanceStream* stream)
+{
+	for (int i = 0; i < INSTANCE_STREAM_FRAMES; i++) {
+		if (stream->fences[i]) {
+			glDeleteSync(stream->fences[i]);
+			stream->fences[i] = NULL;
+		}
+	}
+	if (stream->buffer) {
+		if (stream->mapped) {
+			glBindBuffer(GL_ARRAY_BUFFER, stream->buffer);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+		glDeleteBuffers(1, &stream->buffer);
+		stream->buffer = 0;
+	}
+	stream->mapped = NULL;
+	stream->region = -1;
+	stream->capacity = 0;
+}
@@ -2,12 +2,66 @@
 
 #include "gl_common.h"
 #include <stddef.h>
+#include <stdint.h>
+
+enum {
+	HALF_SHIFT = 16,
+	MATERIAL_INDEX_MASK = SPHERE_INSTANCE_MAX_MATERIALS - 1,
+	COMPACT_SCALE_ATTRIB = 3,
+	INSTANCE_ATTRIB_LAST = 7
+};
+
+/* float -> half IEEE 754 (arrondi au plus proche, sans dénormaux) */
+static uint16_t float_to_half(float value)
+{
+	union {
+		float f;
+		uint32_t u;
+	} bits = {.f = value};
+
+	const uint32_t sign = (bits.u >> 16) & 0x8000U;
+	const int32_t exponent = (int32_t)((bits.u >> 23) & 0xFFU) - 127 + 15;
+	uint32_t mantissa = bits.u & 0x7FFFFFU;
+
+	if (exponent <= 0) {
+		return (uint16_t)sign;
+	}
+	if (exponent >= 31) {
+		return (uint16_t)(sign | 0x7C00U);
+	}
+
+	/* Arrondi : la retenue peut légitimement incrémenter l'exposant */
+	mantissa += 0x1000U;
+	return (uint16_t)(sign + (((uint32_t)exponent << 10) +
+	                          (mantissa >> 13)));
+}
+
+void sphere_instance_compact_pack(SphereInstanceCompact* out,
+                                  const vec3 position, float scale,
+                                  uint32_t material_index)
+{
+	out->position[0] = position[0];
+	out->position[1] = position[1];
+	out->position[2] = position[2];
+	out->scale_material = ((uint32_t)float_to_half(scale) << HALF_SHIFT) |
+	                      (material_index & MATERIAL_INDEX_MASK);
+}
+
+size_t instance_format_stride(InstanceFormat format)
+{
+	return format == INSTANCE_FORMAT_COMPACT
+	           ? sizeof(SphereInstanceCompact)
+	           : sizeof(SphereInstance);
+}
 
 void instanced_group_init(InstancedGroup* group, const SphereInstance* data,
                           int count)
 {
 	group->instance_count = count;
 	group->vao = 0;  // Sera créé dans bind_mesh
+	group->format = INSTANCE_FORMAT_FULL;
+	group->stream = NULL;
+	group->index_type = GL_UNSIGNED_INT;
 
 	glGenBuffers(1, &group->instance_vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, group->instance_vbo);
@@ -16,8 +70,67 @@ void instanced_group_init(InstancedGroup* group, const SphereInstance* data,
 	             GL_STATIC_DRAW);
 }
 
+void instanced_group_init_compact(InstancedGroup* group,
+                                  const SphereInstanceCompact* data,
+                                  int count)
+{
+	group->instance_count = count;
+	group->vao = 0;
+	group->format = INSTANCE_FORMAT_COMPACT;
+	group->stream = NULL;
+	group->index_type = GL_UNSIGNED_INT;
+
+	glGenBuffers(1, &group->instance_vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, group->instance_vbo);
+	glBufferData(GL_ARRAY_BUFFER,
+	             (GLsizeiptr)((size_t)count * sizeof(SphereInstanceCompact)),
+	             data, GL_STATIC_DRAW);
+}
+
+void instanced_group_init_stream(InstancedGroup* group, InstanceStream* stream,
+                                 InstanceFormat format, int count)
+{
+	group->instance_count = count;
+	group->vao = 0;
+	group->format = format;
+	group->stream = stream;
+	group->index_type = GL_UNSIGNED_INT;
+	group->instance_vbo = stream->buffer;
+}
+
+/* Première instance lue par le draw (région courante du stream) */
+static GLuint instanced_group_base_instance(const InstancedGroup* group)
+{
+	return group->stream ? instance_stream_base_instance(group->stream)
+	                     : 0;
+}
+
+/* vec3 position (2) + uint scale/matériau (3), slots 4..7 inutilisés */
+static void setup_compact_instance_attributes(void)
+{
+	GLsizei size_instance = (GLsizei)sizeof(SphereInstanceCompact);
+
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(
+	    2, 3, GL_FLOAT, GL_FALSE, size_instance,
+	    BUFFER_OFFSET(offsetof(SphereInstanceCompact, position)));
+	glVertexAttribDivisor(2, 1);
+
+	glEnableVertexAttribArray(COMPACT_SCALE_ATTRIB);
+	glVertexAttribIPointer(
+	    COMPACT_SCALE_ATTRIB, 1, GL_UNSIGNED_INT, size_instance,
+	    BUFFER_OFFSET(offsetof(SphereInstanceCompact, scale_material)));
+	glVertexAttribDivisor(COMPACT_SCALE_ATTRIB, 1);
+
+	for (GLuint i = COMPACT_SCALE_ATTRIB + 1; i <= INSTANCE_ATTRIB_LAST;
+	     i++) {
+		glDisableVertexAttribArray(i);
+		glVertexAttribDivisor(i, 0);
+	}
+}
+
 // Helper interne pour configurer les attributs d'instance
-static void setup_instance_attributes()
+static void setup_instance_attributes(void)
 {
 	GLsizei size_instance = (GLsizei)sizeof(SphereInstance);
 	GLuint index_vattrib = 2;  // Start at 2 (0=Pos, 1=Norm usually)
@@ -47,8 +160,17 @@ static void setup_instance_attributes()
 	glVertexAttribDivisor(index_vattrib, 1);
 }
 
-void instanced_group_bind_mesh(InstancedGroup* group, GLuint vbo, GLuint nbo,
-                               GLuint ebo)
+void instanced_setup_attributes(InstanceFormat format)
+{
+	if (format == INSTANCE_FORMAT_COMPACT) {
+		setup_compact_instance_attributes();
+	} else {
+		setup_instance_attributes();
+	}
+}
+
+void instanced_group_bind_mesh(InstancedGroup* group,
+                               const IcosphereMesh* mesh)
 {
 	// Si on régénère l'icosphère, l'ancien VAO n'est plus valide
 	if (group->vao != 0) {
@@ -59,22 +181,13 @@ void instanced_group_bind_mesh(InstancedGroup* group, GLuint vbo, GLuint nbo,
 	glGenVertexArrays(1, &group->vao);
 	glBindVertexArray(group->vao);
 
-	// -- GÉOMÉTRIE (Empruntée à l'App) --
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-	glEnableVertexAttribArray(0);
-	glVertexAttribDivisor(0, 0);
-
-	glBindBuffer(GL_ARRAY_BUFFER, nbo);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribDivisor(1, 0);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+	// -- GÉOMÉTRIE (Empruntée au cache d'icosphères) --
+	icosphere_mesh_setup_vao(mesh);
+	group->index_type = mesh->index_type;
 
 	/* -- INSTANCES (VBO Interne) -- */
 	glBindBuffer(GL_ARRAY_BUFFER, group->instance_vbo);
-	setup_instance_attributes();
+	instanced_setup_attributes(group->format);
 
 	/* CRITICAL: Explicitly disable and reset all higher slots (8-15)
 	 * to ensure a stable global attribute signature on NVIDIA. */
@@ -102,14 +215,13 @@ void instanced_group_bind_billboard(InstancedGroup* group, GLuint vbo)
 	glEnableVertexAttribArray(0);
 	glVertexAttribDivisor(0, 0);
 
-	/* Ensure unused attribute 1 has divisor 0 */
+	/* Attribut 1 inutilisé (plus de flux de normales) */
+	glDisableVertexAttribArray(1);
 	glVertexAttribDivisor(1, 0);
 
-	// Pas de normales (index 1) pour les billboards
-
 	// -- INSTANCES --
 	glBindBuffer(GL_ARRAY_BUFFER, group->instance_vbo);
-	setup_instance_attributes();
+	instanced_setup_attributes(group->format);
 
 	glBindVertexArray(0);
 }
@@ -118,21 +230,28 @@ void instanced_group_draw_arrays(InstancedGroup* group, GLenum mode, int first,
                                  int count)
 {
 	glBindVertexArray(group->vao);
-	glDrawArraysInstanced(mode, first, count, group->instance_count);
+	glDrawArraysInstancedBaseInstance(mode, first, count,
+	                                  group->instance_count,
+	                                  instanced_group_base_instance(group));
 	glBindVertexArray(0);
 }
 
 void instanced_group_draw(InstancedGroup* group, size_t index_count)
 {
 	glBindVertexArray(group->vao);
-	glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)index_count,
-	                        GL_UNSIGNED_INT, 0, group->instance_count);
+	glDrawElementsInstancedBaseInstance(
+	    GL_TRIANGLES, (GLsizei)index_count, group->index_type, 0,
+	    group->instance_count, instanced_group_base_instance(group));
 	glBindVertexArray(0);
 }
 
 void instanced_group_cleanup(InstancedGroup* group)
 {
-	glDeleteBuffers(1, &group->instance_vbo);
+	/* Le buffer d'un stream appartient au stream */
+	if (!group->stream) {
+		glDeleteBuffers(1, &group->instance_vbo);
+	}
+	group->stream = NULL;
 	if (group->vao) {
 		glDeleteVertexArrays(1, &group->vao);
 	}
@@ -0,0 +1,459 @@
+#include "job_system.h"
+
+#include "log.h"
+#include "utils.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+enum {
+	JOB_DEQUE_MASK = JOB_DEQUE_CAPACITY - 1,
+	JOB_IDLE_SPINS = 64, /* sched_yield() avant de s'endormir */
+	JOB_CACHE_LINE = 64,
+	JOB_INJECT_INITIAL = 64
+};
+
+/* Worker du thread courant (NULL : thread extérieur au système) */
+static __thread JobWorker* tls_worker = NULL;
+
+int job_system_cpu_count(void)
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	if (count < 1) {
+		return 1;
+	}
+	return count > JOB_SYSTEM_MAX_WORKERS + 1 ? JOB_SYSTEM_MAX_WORKERS + 1
+	                                          : (int)count;
+}
+
+/* --- Deque Chase-Lev (Lê et al., "Correct and Efficient Work-Stealing for
+ * Weak Memory Models", 2013), capacité fixe --- */
+
+static int deque_push(JobDeque* deque, const Job* job)
+{
+	long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+	long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+	if (bottom - top >= JOB_DEQUE_CAPACITY) {
+		return 0;
+	}
+	deque->jobs[bottom & JOB_DEQUE_MASK] = *job;
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+	return 1;
+}
+
+static int deque_pop(JobDeque* deque, Job* out)
+{
+	long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+	__atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	long top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+	if (top > bottom) {
+		/* Vide */
+		__atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+		return 0;
+	}
+
+	*out = deque->jobs[bottom & JOB_DEQUE_MASK];
+	if (top == bottom) {
+		/* Dernier élément : course avec les voleurs */
+		int won = __atomic_compare_exchange_n(&deque->top, &top, top + 1,
+		                                      0, __ATOMIC_SEQ_CST,
+		                                      __ATOMIC_RELAXED);
+		__atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+		return won;
+	}
+	return 1;
+}
+
+static int deque_steal(JobDeque* deque, Job* out)
+{
+	long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+
+	if (top >= bottom) {
+		return 0;
+	}
+
+	/* Copie spéculative : invalidée par la CAS si le slot a été repris */
+	Job job = deque->jobs[top & JOB_DEQUE_MASK];
+	if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, 0,
+	                                 __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+		return 0;
+	}
+	*out = job;
+	return 1;
+}
+
+/* --- Ordonnancement --- */
+
+static void job_system_wake(JobSystem* system)
+{
+	__atomic_fetch_add(&system->work_epoch, 1U, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&system->sleepers, __ATOMIC_SEQ_CST) > 0) {
+		pthread_mutex_lock(&system->sleep_mutex);
+		pthread_cond_signal(&system->sleep_cond);
+		pthread_mutex_unlock(&system->sleep_mutex);
+	}
+}
+
+static int queue_push(JobSystem* system, JobQueue* queue, int* has_jobs,
+                      const Job* job)
+{
+	pthread_mutex_lock(&system->inject_mutex);
+	if (queue->count == queue->capacity) {
+		int capacity = queue->capacity * 2;
+		if (capacity == 0) {
+			capacity = JOB_INJECT_INITIAL;
+		}
+		Job* grown =
+		    realloc(queue->jobs, (size_t)capacity * sizeof(Job));
+		if (!grown) {
+			pthread_mutex_unlock(&system->inject_mutex);
+			return 0;
+		}
+		queue->jobs = grown;
+		queue->capacity = capacity;
+	}
+	queue->jobs[queue->count++] = *job;
+	__atomic_fetch_add(has_jobs, 1, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&system->inject_mutex);
+	return 1;
+}
+
+static int queue_pop(JobSystem* system, JobQueue* queue, int* has_jobs,
+                     Job* out)
+{
+	if (__atomic_load_n(has_jobs, __ATOMIC_ACQUIRE) == 0) {
+		return 0;
+	}
+
+	int found = 0;
+	pthread_mutex_lock(&system->inject_mutex);
+	if (queue->count > 0) {
+		*out = queue->jobs[--queue->count];
+		__atomic_fetch_sub(has_jobs, 1, __ATOMIC_RELEASE);
+		found = 1;
+	}
+	pthread_mutex_unlock(&system->inject_mutex);
+	return found;
+}
+
+static void execute_job(JobSystem* system, Job* job);
+
+/* Place un job : deque locale si le thread appartient au système, file
+ * injectée sinon. Deque pleine : exécution immédiate (jamais de perte). */
+static void push_job(JobSystem* system, Job* job)
+{
+	if (job->counter) {
+		__atomic_fetch_add(&job->counter->pending, 1, __ATOMIC_RELAXED);
+	}
+
+	JobWorker* worker = tls_worker;
+	if (worker && worker->system == system) {
+		if (!deque_push(&worker->deques[job->priority], job)) {
+			execute_job(system, job);
+			return;
+		}
+	} else if (!queue_push(system, &system->injected[job->priority],
+	                       &system->has_injected, job)) {
+		execute_job(system, job);
+		return;
+	}
+	job_system_wake(system);
+}
+
+static void execute_job(JobSystem* system, Job* job)
+{
+	if (job->range_fn) {
+		/* Garde la moitié gauche, publie la droite (volable) */
+		while (job->end - job->begin > job->grain) {
+			Job right = *job;
+			right.begin = job->begin + ((job->end - job->begin) / 2);
+			job->end = right.begin;
+			push_job(system, &right);
+		}
+		job->range_fn(job->user_data, job->begin, job->end);
+	} else {
+		job->fn(job->user_data);
+	}
+
+	if (tls_worker && tls_worker->system == system) {
+		tls_worker->executed++;
+	}
+	if (job->counter) {
+		__atomic_fetch_sub(&job->counter->pending, 1, __ATOMIC_RELEASE);
+	}
+}
+
+static int steal_job(JobSystem* system, JobWorker* self, int priority,
+                     Job* out)
+{
+	const int slots = system->slot_count;
+	unsigned start = 0;
+
+	if (self) {
+		/* xorshift : victimes différentes d'un worker à l'autre */
+		self->rng ^= self->rng << 13;
+		self->rng ^= self->rng >> 17;
+		self->rng ^= self->rng << 5;
+		start = self->rng;
+	}
+
+	for (int i = 0; i < slots; i++) {
+		JobWorker* victim =
+		    &system->workers[(start + (unsigned)i) % (unsigned)slots];
+		if (victim == self) {
+			continue;
+		}
+		if (deque_steal(&victim->deques[priority], out)) {
+			if (self) {
+				self->stolen++;
+			}
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* Un job au plus, priorité décroissante ; 0 si rien à faire.
+ * Les files background ne sont servies que par les workers (index > 0) */
+static int try_run_one(JobSystem* system, JobWorker* self)
+{
+	const int is_worker = self && self->index > 0;
+	Job job;
+
+	for (int priority = 0; priority < JOB_PRIORITY_COUNT; priority++) {
+		if ((self && deque_pop(&self->deques[priority], &job)) ||
+		    queue_pop(system, &system->injected[priority],
+		              &system->has_injected, &job) ||
+		    (is_worker &&
+		     queue_pop(system, &system->background[priority],
+		               &system->has_background, &job)) ||
+		    steal_job(system, self, priority, &job)) {
+			execute_job(system, &job);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static void* worker_main(void* arg)
+{
+	JobWorker* self = arg;
+	JobSystem* system = self->system;
+	int idle = 0;
+
+	tls_worker = self;
+	while (!__atomic_load_n(&system->shutdown, __ATOMIC_ACQUIRE)) {
+		const unsigned epoch =
+		    __atomic_load_n(&system->work_epoch, __ATOMIC_SEQ_CST);
+		if (try_run_one(system, self)) {
+			idle = 0;
+			continue;
+		}
+		if (++idle < JOB_IDLE_SPINS) {
+			sched_yield();
+			continue;
+		}
+
+		/* Rien depuis `epoch` : dormir jusqu'à la prochaine soumission */
+		pthread_mutex_lock(&system->sleep_mutex);
+		__atomic_fetch_add(&system->sleepers, 1, __ATOMIC_SEQ_CST);
+		while (!system->shutdown &&
+		       __atomic_load_n(&system->work_epoch, __ATOMIC_SEQ_CST) ==
+		           epoch) {
+			pthread_cond_wait(&system->sleep_cond,
+			                  &system->sleep_mutex);
+		}
+		__atomic_fetch_sub(&system->sleepers, 1, __ATOMIC_SEQ_CST);
+		pthread_mutex_unlock(&system->sleep_mutex);
+		idle = 0;
+	}
+	tls_worker = NULL;
+	return NULL;
+}
+
+/* --- API --- */
+
+JobSystem* job_system_create(int worker_count)
+{
+	if (worker_count < 0) {
+		worker_count = job_system_cpu_count() - 1;
+	}
+	if (worker_count > JOB_SYSTEM_MAX_WORKERS) {
+		worker_count = JOB_SYSTEM_MAX_WORKERS;
+	}
+
+	JobSystem* system = safe_calloc(1, sizeof(JobSystem));
+	if (!system) {
+		return NULL;
+	}
+
+	/* Deques alignées : top/bottom ne partagent pas de ligne de cache */
+	void* workers = NULL;
+	const size_t workers_size = (size_t)(worker_count + 1) * sizeof(JobWorker);
+	if (posix_memalign(&workers, JOB_CACHE_LINE, workers_size) != 0) {
+		free(system);
+		return NULL;
+	}
+	(void)memset(workers, 0, workers_size);
+	system->workers = workers;
+	system->slot_count = worker_count + 1;
+
+	pthread_mutex_init(&system->inject_mutex, NULL);
+	pthread_mutex_init(&system->sleep_mutex, NULL);
+	pthread_cond_init(&system->sleep_cond, NULL);
+
+	for (int i = 0; i <= worker_count; i++) {
+		system->workers[i].system = system;
+		system->workers[i].index = i;
+		system->workers[i].rng = 0x9E3779B9U * (unsigned)(i + 1);
+	}
+
+	/* Le thread créateur possède le slot 0 (s'il n'en possède pas déjà un :
+	 * il reste sinon un thread extérieur, servi par la file injectée) */
+	if (!tls_worker) {
+		tls_worker = &system->workers[0];
+	}
+
+	for (int i = 0; i < worker_count; i++) {
+		if (pthread_create(&system->threads[i], NULL, worker_main,
+		                   &system->workers[i + 1]) != 0) {
+			LOG_WARN("suckless-ogl.jobs",
+			         "Worker creation failed, using %d workers", i);
+			break;
+		}
+		system->worker_count++;
+	}
+
+	LOG_INFO("suckless-ogl.jobs", "Job system: %d workers + caller",
+	         system->worker_count);
+	return system;
+}
+
+void job_system_destroy(JobSystem* system)
+{
+	if (!system) {
+		return;
+	}
+
+	pthread_mutex_lock(&system->sleep_mutex);
+	__atomic_store_n(&system->shutdown, 1, __ATOMIC_RELEASE);
+	pthread_cond_broadcast(&system->sleep_cond);
+	pthread_mutex_unlock(&system->sleep_mutex);
+
+	for (int i = 0; i < system->worker_count; i++) {
+		pthread_join(system->threads[i], NULL);
+	}
+	if (tls_worker && tls_worker->system == system) {
+		tls_worker = NULL;
+	}
+
+	for (int priority = 0; priority < JOB_PRIORITY_COUNT; priority++) {
+		free(system->injected[priority].jobs);
+		free(system->background[priority].jobs);
+	}
+	pthread_mutex_destroy(&system->inject_mutex);
+	pthread_mutex_destroy(&system->sleep_mutex);
+	pthread_cond_destroy(&system->sleep_cond);
+	free(system->workers);
+	free(system);
+}
+
+void job_system_submit(JobSystem* system, JobFn fn, void* user_data,
+                       JobPriority priority, JobCounter* counter)
+{
+	Job job = {0};
+	job.fn = fn;
+	job.user_data = user_data;
+	job.priority = priority;
+	job.counter = counter;
+	push_job(system, &job);
+}
+
+void job_system_submit_background(JobSystem* system, JobFn fn,
+                                  void* user_data, JobPriority priority,
+                                  JobCounter* counter)
+{
+	Job job = {0};
+	job.fn = fn;
+	job.user_data = user_data;
+	job.priority = priority;
+	job.counter = counter;
+
+	if (counter) {
+		__atomic_fetch_add(&counter->pending, 1, __ATOMIC_RELAXED);
+	}
+	if (system->worker_count == 0 ||
+	    !queue_push(system, &system->background[priority],
+	                &system->has_background, &job)) {
+		execute_job(system, &job);
+		return;
+	}
+	job_system_wake(system);
+}
+
+void job_system_wait(JobSystem* system, JobCounter* counter)
+{
+	JobWorker* self =
+	    (tls_worker && tls_worker->system == system) ? tls_worker : NULL;
+
+	while (__atomic_load_n(&counter->pending, __ATOMIC_ACQUIRE) > 0) {
+		if (!try_run_one(system, self)) {
+			sched_yield();
+		}
+	}
+}
+
+void job_system_parallel_for(JobSystem* system, int count, int grain,
+                             JobRangeFn fn, void* user_data,
+                             JobPriority priority)
+{
+	if (count <= 0) {
+		return;
+	}
+	if (grain <= 0) {
+		grain = 1;
+	}
+
+	JobCounter counter = {0};
+	Job job = {0};
+	job.range_fn = fn;
+	job.user_data = user_data;
+	job.begin = 0;
+	job.end = count;
+	job.grain = grain;
+	job.priority = priority;
+	job.counter = &counter;
+
+	/* Exécuté sur place : le découpage publie les moitiés droites */
+	__atomic_fetch_add(&counter.pending, 1, __ATOMIC_RELAXED);
+	execute_job(system, &job);
+	job_system_wait(system, &counter);
+}
+
+int job_system_thread_count(const JobSystem* system)
+{
+	return system ? system->worker_count + 1 : 1;
+}
+
+void job_system_stats(const JobSystem* system, JobSystemStats* stats)
+{
+	stats->executed = 0;
+	stats->stolen = 0;
+	if (!system) {
+		return;
+	}
+	for (int i = 0; i < system->slot_count; i++) {
+		const JobWorker* worker = &system->workers[i];
+		stats->executed +=
+		    __atomic_load_n(&worker->executed, __ATOMIC_RELAXED);
+		stats->stolen +=
+		    __atomic_load_n(&worker->stolen, __ATOMIC_RELAXED);
+	}
+}
@@ -0,0 +1,283 @@
+#include "light_clusters.h"
+
+#include "camera.h"
+#include "gl_common.h"
+#include "log.h"
+#include "shader.h"
+#include <cglm/cglm.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Une lumière sur SPOT_EVERY est un spot */
+enum { LIGHT_SPOT_EVERY = 4 };
+
+/* Lumières vues en moyenne par un point de la boîte (cf. generate) */
+#define LIGHT_TARGET_OVERLAP 16.0F
+#define LIGHT_MIN_RANGE 0.5F
+#define LIGHT_MAX_RANGE 8.0F
+#define LIGHT_INTENSITY_SCALE 0.5F
+#define LIGHT_COLOR_MIN 0.25F
+#define LIGHT_SPOT_SPREAD 0.3F
+#define LIGHT_SPOT_INNER_DEG 20.0F
+#define LIGHT_SPOT_OUTER_DEG 30.0F
+
+/* En-tête du buffer de clusters (miroir du bloc LightClusters) */
+typedef struct {
+	GLuint index_count;
+	GLuint index_capacity;
+} LightClusterHeader;
+
+static const size_t LIGHT_RANGES_OFFSET = sizeof(LightClusterHeader);
+static const size_t LIGHT_INDICES_OFFSET =
+    sizeof(LightClusterHeader) + (LIGHT_CLUSTER_COUNT * 2 * sizeof(GLuint));
+
+/* xorshift32 : mêmes lumières d'un run à l'autre */
+static uint32_t light_random(uint32_t* state)
+{
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+static float light_random_unit(uint32_t* state)
+{
+	return (float)(light_random(state) >> 8) / 16777216.0F;
+}
+
+int light_clusters_init(LightClusters* clusters)
+{
+	clusters->light_buffer = 0;
+	clusters->cluster_buffer = 0;
+	clusters->light_count = 0;
+	clusters->light_capacity = 0;
+	clusters->viewport_width = 0;
+	clusters->viewport_height = 0;
+	clusters->near_plane = 0.0F;
+	clusters->far_plane = 0.0F;
+
+	clusters->cull_shader =
+	    shader_load_compute_program("shaders/light_cull.comp");
+	if (!clusters->cull_shader) {
+		LOG_ERROR("suckless-ogl.lights",
+		          "Failed to load light culling compute shader");
+		return 0;
+	}
+
+	const size_t size =
+	    LIGHT_INDICES_OFFSET + (LIGHT_INDEX_CAPACITY * sizeof(GLuint));
+	LightClusterHeader header = {0, LIGHT_INDEX_CAPACITY};
+
+	glGenBuffers(1, &clusters->cluster_buffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusters->cluster_buffer);
+	/* Réécrit par le compute à chaque frame */
+	glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)size, NULL,
+	             GL_DYNAMIC_COPY);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(header), &header);
+	/* Aucune lumière tant que le premier cull n'a pas eu lieu */
+	glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI,
+	                     (GLintptr)LIGHT_RANGES_OFFSET,
+	                     LIGHT_CLUSTER_COUNT * 2 * sizeof(GLuint),
+	                     GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	LOG_INFO("suckless-ogl.lights",
+	         "Light clusters initialized: %dx%dx%d grid, %zu KB",
+	         LIGHT_CLUSTER_X, LIGHT_CLUSTER_Y, LIGHT_CLUSTER_Z,
+	         size / 1024);
+	return 1;
+}
+
+void light_clusters_upload(LightClusters* clusters,
+                           const AnalyticLight* lights, int count)
+{
+	const size_t size = (size_t)count * sizeof(AnalyticLight);
+	if (count > clusters->light_capacity) {
+		if (clusters->light_buffer) {
+			glDeleteBuffers(1, &clusters->light_buffer);
+		}
+		glGenBuffers(1, &clusters->light_buffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusters->light_buffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)size, NULL,
+		             GL_STATIC_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		clusters->light_capacity = count;
+	}
+
+	if (count > 0) {
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusters->light_buffer);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, (GLsizeiptr)size,
+		                lights);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+	clusters->light_count = count;
+}
+
+void light_clusters_generate(AnalyticLight* lights, int count,
+                             const vec3 bounds_min, const vec3 bounds_max,
+                             uint32_t seed)
+{
+	if (count <= 0) {
+		return;
+	}
+
+	vec3 extent;
+	glm_vec3_sub((float*)bounds_max, (float*)bounds_min, extent);
+	const float volume = extent[0] * extent[1] * extent[2];
+
+	/* count * (4/3 pi r^3) = overlap * volume */
+	float range = cbrtf(LIGHT_TARGET_OVERLAP * volume /
+	                    ((float)count * (4.0F / 3.0F) * GLM_PIf));
+	range = glm_clamp(range, LIGHT_MIN_RANGE, LIGHT_MAX_RANGE);
+	const float intensity = LIGHT_INTENSITY_SCALE * range * range;
+
+	const float cos_inner = cosf(glm_rad(LIGHT_SPOT_INNER_DEG));
+	const float cos_outer = cosf(glm_rad(LIGHT_SPOT_OUTER_DEG));
+
+	uint32_t state = seed ? seed : 1U; /* xorshift bloque sur 0 */
+	for (int i = 0; i < count; i++) {
+		AnalyticLight* light = &lights[i];
+		for (int axis = 0; axis < 3; axis++) {
+			light->position_range[axis] =
+			    bounds_min[axis] +
+			    (light_random_unit(&state) * extent[axis]);
+			light->color_cos_inner[axis] =
+			    intensity *
+			    (LIGHT_COLOR_MIN + ((1.0F - LIGHT_COLOR_MIN) *
+			                        light_random_unit(&state)));
+		}
+		light->position_range[3] = range;
+
+		if (i % LIGHT_SPOT_EVERY == 0) {
+			vec3 axis = {
+			    ((2.0F * light_random_unit(&state)) - 1.0F) *
+			        LIGHT_SPOT_SPREAD,
+			    ((2.0F * light_random_unit(&state)) - 1.0F) *
+			        LIGHT_SPOT_SPREAD,
+			    -1.0F};
+			glm_vec3_normalize(axis);
+			glm_vec3_copy(axis, light->direction_cos_outer);
+			light->direction_cos_outer[3] = cos_outer;
+			light->color_cos_inner[3] = cos_inner;
+		} else {
+			glm_vec3_zero(light->direction_cos_outer);
+			light->direction_cos_outer[3] = LIGHT_POINT_COS_OUTER;
+			light->color_cos_inner[3] = 1.0F;
+		}
+	}
+}
+
+int light_clusters_slice(float view_depth, float near_plane, float far_plane)
+{
+	if (view_depth <= near_plane) {
+		return 0;
+	}
+	const float scale =
+	    (float)LIGHT_CLUSTER_Z / logf(far_plane / near_plane);
+	const int slice = (int)(logf(view_depth / near_plane) * scale);
+	return slice < LIGHT_CLUSTER_Z ? slice : LIGHT_CLUSTER_Z - 1;
+}
+
+void light_clusters_cull(LightClusters* clusters, mat4 view, mat4 proj,
+                         int width, int height)
+{
+	clusters->near_plane = camera_projection_near(proj);
+	clusters->far_plane = camera_projection_far(proj);
+	clusters->viewport_width = width;
+	clusters->viewport_height = height;
+
+	if (clusters->light_count <= 0 || !clusters->cull_shader) {
+		return;
+	}
+
+	GL_SCOPE_DEBUG_GROUP("Light Culling");
+
+	/* Seul le compteur global est remis à zéro, chaque cluster réécrit
+	 * sa plage */
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusters->cluster_buffer);
+	glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, 0,
+	                     sizeof(GLuint), GL_RED_INTEGER, GL_UNSIGNED_INT,
+	                     NULL);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	Shader* shader = clusters->cull_shader;
+	shader_use(shader);
+	shader_set_int(shader, "lightCount", clusters->light_count);
+	shader_set_mat4(shader, "view", (float*)view);
+	/* Point vue à la distance d d'un NDC : ndc * d / proj[i][i] */
+	shader_set_vec2(shader, "ndcToView",
+	                (vec2){1.0F / proj[0][0], 1.0F / proj[1][1]});
+	shader_set_vec2(shader, "clusterPlanes",
+	                (vec2){clusters->near_plane, clusters->far_plane});
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_BINDING_LIGHTS,
+	                 clusters->light_buffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_BINDING_CLUSTERS,
+	                 clusters->cluster_buffer);
+
+	glDispatchCompute(LIGHT_CLUSTER_X, LIGHT_CLUSTER_Y, LIGHT_CLUSTER_Z);
+
+	/* Listes lues par les fragment shaders */
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void light_clusters_bind(const LightClusters* clusters, Shader* shader)
+{
+	const int active = clusters->light_count > 0 &&
+	                   clusters->viewport_width > 0 &&
+	                   clusters->viewport_height > 0;
+	shader_set_int(shader, "lightCount",
+	               active ? clusters->light_count : 0);
+	if (!active) {
+		return;
+	}
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_BINDING_LIGHTS,
+	                 clusters->light_buffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_BINDING_CLUSTERS,
+	                 clusters->cluster_buffer);
+
+	shader_set_vec2(
+	    shader, "clusterTileScale",
+	    (vec2){(float)LIGHT_CLUSTER_X / (float)clusters->viewport_width,
+	           (float)LIGHT_CLUSTER_Y / (float)clusters->viewport_height});
+	shader_set_vec3(
+	    shader, "clusterDepth",
+	    (vec3){clusters->near_plane, clusters->far_plane,
+	           (float)LIGHT_CLUSTER_Z /
+	               logf(clusters->far_plane / clusters->near_plane)});
+}
+
+int light_clusters_read_index_count(LightClusters* clusters)
+{
+	LightClusterHeader header = {0, 0};
+
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusters->cluster_buffer);
+	glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(header),
+	                   &header);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	/* Le compteur continue d'avancer quand la capacité est dépassée */
+	return (int)(header.index_count < header.index_capacity
+	                 ? header.index_count
+	                 : header.index_capacity);
+}
+
+void light_clusters_cleanup(LightClusters* clusters)
+{
+	GLuint buffers[] = {clusters->light_buffer, clusters->cluster_buffer};
+	glDeleteBuffers(2, buffers);
+	clusters->light_buffer = 0;
+	clusters->cluster_buffer = 0;
+	clusters->light_count = 0;
+	clusters->light_capacity = 0;
+
+	if (clusters->cull_shader) {
+		shader_destroy(clusters->cull_shader);
+		clusters->cull_shader = NULL;
+	}
+}
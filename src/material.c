@@ -1,6 +1,7 @@
 #include "material.h"
 
 #include "log.h"
+#include "utils.h"
 #include <cJSON.h>
 #include <limits.h>
 #include <stdint.h>
@@ -246,4 +247,89 @@ void material_free_lib(MaterialLib* lib)
 
 	free(lib);
 	LOG_INFO("material", "Material library memory freed successfully.");
-}
\ No newline at end of file
+}
+
+void material_gpu_pack(const PBRMaterial* material, MaterialGPU* out)
+{
+	out->albedo_metallic[0] = material->albedo[0];
+	out->albedo_metallic[1] = material->albedo[1];
+	out->albedo_metallic[2] = material->albedo[2];
+	out->albedo_metallic[3] = material->metallic;
+	out->roughness_ao[0] = material->roughness;
+	out->roughness_ao[1] = 1.0F; /* ao */
+	out->roughness_ao[2] = 0.0F;
+	out->roughness_ao[3] = 0.0F;
+}
+
+int material_table_init(MaterialTable* table, const MaterialLib* lib)
+{
+	table->ssbo = 0;
+	table->count = 0;
+
+	if (lib == NULL || lib->count <= 0) {
+		LOG_ERROR("material", "Cannot build table from empty library");
+		return 0;
+	}
+
+	CLEANUP_FREE MaterialGPU* entries =
+	    safe_calloc((size_t)lib->count, sizeof(MaterialGPU));
+	if (entries == NULL) {
+		LOG_ERROR("material", "Failed to allocate material table");
+		return 0;
+	}
+
+	for (int i = 0; i < lib->count; i++) {
+		material_gpu_pack(&lib->materials[i], &entries[i]);
+	}
+
+	/* DYNAMIC : les éditions passent par material_table_update() */
+	glGenBuffers(1, &table->ssbo);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, table->ssbo);
+	glBufferData(GL_SHADER_STORAGE_BUFFER,
+	             (GLsizeiptr)((size_t)lib->count * sizeof(MaterialGPU)),
+	             entries, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glObjectLabel(GL_BUFFER, table->ssbo, -1, "Material Table");
+
+	table->count = lib->count;
+
+	LOG_INFO("material", "Material table: %d entries (%zu bytes)",
+	         table->count, (size_t)table->count * sizeof(MaterialGPU));
+	return 1;
+}
+
+int material_table_update(MaterialTable* table, const MaterialLib* lib,
+                          int index)
+{
+	if (table->ssbo == 0 || lib == NULL || index < 0 ||
+	    index >= table->count || index >= lib->count) {
+		LOG_ERROR("material", "Invalid material table update: %d",
+		          index);
+		return 0;
+	}
+
+	MaterialGPU entry;
+	material_gpu_pack(&lib->materials[index], &entry);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, table->ssbo);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+	                (GLintptr)((size_t)index * sizeof(MaterialGPU)),
+	                (GLsizeiptr)sizeof(MaterialGPU), &entry);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	return 1;
+}
+
+void material_table_bind(const MaterialTable* table)
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MATERIAL_TABLE_BINDING,
+	                 table->ssbo);
+}
+
+void material_table_cleanup(MaterialTable* table)
+{
+	if (table->ssbo) {
+		glDeleteBuffers(1, &table->ssbo);
+		table->ssbo = 0;
+	}
+	table->count = 0;
+}
@@ -0,0 +1,319 @@
+#include "mesh_optimize.h"
+
+#include "log.h"
+#include <cglm/types.h>
+#include <cglm/vec3.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+	TRI_VERTICES = 3,
+	FORSYTH_MAX_VALENCE = 64,
+	/* Le cache déborde de 3 sommets pendant l'insertion d'un triangle */
+	FORSYTH_CACHE_SLOTS = MESH_OPTIMIZE_CACHE_SIZE + TRI_VERTICES
+};
+
+/* Paramètres de l'article de Forsyth */
+static const float FORSYTH_CACHE_DECAY_POWER = 1.5F;
+static const float FORSYTH_LAST_TRI_SCORE = 0.75F;
+static const float FORSYTH_VALENCE_BOOST_SCALE = 2.0F;
+static const float FORSYTH_VALENCE_BOOST_POWER = 0.5F;
+
+static const unsigned int REMAP_UNUSED = ~0U;
+
+MeshCacheStats mesh_analyze_vertex_cache(const unsigned int* indices,
+                                         size_t index_count,
+                                         size_t vertex_count,
+                                         int cache_size)
+{
+	MeshCacheStats stats = {0, 0.0, 0.0};
+	if (index_count < TRI_VERTICES || vertex_count == 0) {
+		return stats;
+	}
+
+	/* Horodatage d'entrée dans le FIFO (0 : jamais transformé) */
+	unsigned int* entered = calloc(vertex_count, sizeof(unsigned int));
+	if (!entered) {
+		return stats;
+	}
+
+	size_t unique = 0;
+	unsigned int clock = (unsigned int)cache_size + 1;
+	for (size_t i = 0; i < index_count; i++) {
+		const unsigned int vertex = indices[i];
+		if (entered[vertex] == 0) {
+			unique++;
+		}
+		if (entered[vertex] == 0 ||
+		    clock - entered[vertex] > (unsigned int)cache_size) {
+			entered[vertex] = clock++;
+			stats.transformed++;
+		}
+	}
+	free(entered);
+
+	stats.acmr = (double)stats.transformed /
+	             (double)(index_count / TRI_VERTICES);
+	stats.atvr = (double)stats.transformed / (double)unique;
+	return stats;
+}
+
+typedef struct {
+	float cache[MESH_OPTIMIZE_CACHE_SIZE];
+	float valence[FORSYTH_MAX_VALENCE];
+} ForsythTables;
+
+static void forsyth_tables_init(ForsythTables* tables)
+{
+	const float scaler =
+	    1.0F / (float)(MESH_OPTIMIZE_CACHE_SIZE - TRI_VERTICES);
+	for (int i = 0; i < MESH_OPTIMIZE_CACHE_SIZE; i++) {
+		if (i < TRI_VERTICES) {
+			/* Les 3 sommets du dernier triangle : score fixe,
+			 * sinon il serait re-choisi immédiatement */
+			tables->cache[i] = FORSYTH_LAST_TRI_SCORE;
+		} else {
+			tables->cache[i] =
+			    powf(1.0F - ((float)(i - TRI_VERTICES) * scaler),
+			         FORSYTH_CACHE_DECAY_POWER);
+		}
+	}
+	tables->valence[0] = 0.0F;
+	for (int i = 1; i < FORSYTH_MAX_VALENCE; i++) {
+		/* Favorise les sommets presque terminés (évite les îlots) */
+		tables->valence[i] =
+		    FORSYTH_VALENCE_BOOST_SCALE *
+		    powf((float)i, -FORSYTH_VALENCE_BOOST_POWER);
+	}
+}
+
+static float forsyth_vertex_score(const ForsythTables* tables, int cache_pos,
+                                  unsigned int live)
+{
+	if (live == 0) {
+		return -1.0F; /* Plus aucun triangle à émettre */
+	}
+	float score = cache_pos >= 0 ? tables->cache[cache_pos] : 0.0F;
+	score += tables->valence[live < FORSYTH_MAX_VALENCE
+	                             ? live
+	                             : FORSYTH_MAX_VALENCE - 1];
+	return score;
+}
+
+/* État de travail de l'algorithme */
+typedef struct {
+	unsigned int* adjacency;    /* Triangles vivants par sommet */
+	unsigned int* offsets;      /* Début de la liste d'un sommet */
+	unsigned int* live;         /* Triangles restants par sommet */
+	int* cache_pos;             /* Position dans le cache, -1 : absent */
+	float* vertex_score;
+	unsigned char* emitted;
+} ForsythState;
+
+static void forsyth_remove_triangle(ForsythState* state, unsigned int vertex,
+                                    unsigned int tri)
+{
+	unsigned int* list = &state->adjacency[state->offsets[vertex]];
+	const unsigned int count = state->live[vertex];
+	for (unsigned int i = 0; i < count; i++) {
+		if (list[i] == tri) {
+			list[i] = list[count - 1];
+			break;
+		}
+	}
+	state->live[vertex] = count - 1;
+}
+
+int mesh_optimize_vertex_cache(unsigned int* indices, size_t index_count,
+                               size_t vertex_count)
+{
+	const size_t tri_count = index_count / TRI_VERTICES;
+	if (tri_count == 0) {
+		return 1;
+	}
+
+	ForsythState state;
+	unsigned int* source = malloc(index_count * sizeof(unsigned int));
+	state.adjacency = malloc(index_count * sizeof(unsigned int));
+	state.offsets = malloc(vertex_count * sizeof(unsigned int));
+	state.live = calloc(vertex_count, sizeof(unsigned int));
+	state.cache_pos = malloc(vertex_count * sizeof(int));
+	state.vertex_score = malloc(vertex_count * sizeof(float));
+	state.emitted = calloc(tri_count, 1);
+	if (!source || !state.adjacency || !state.offsets || !state.live ||
+	    !state.cache_pos || !state.vertex_score || !state.emitted) {
+		LOG_ERROR("suckless-ogl.mesh",
+		          "Vertex cache optimization: out of memory (%zu "
+		          "triangles)",
+		          tri_count);
+		free(source);
+		free(state.adjacency);
+		free(state.offsets);
+		free(state.live);
+		free(state.cache_pos);
+		free(state.vertex_score);
+		free(state.emitted);
+		return 0;
+	}
+	(void)memcpy(source, indices, index_count * sizeof(unsigned int));
+
+	ForsythTables tables;
+	forsyth_tables_init(&tables);
+
+	/* Listes d'adjacence sommet -> triangles (comptage puis remplissage) */
+	for (size_t i = 0; i < index_count; i++) {
+		state.live[source[i]]++;
+	}
+	unsigned int running = 0;
+	for (size_t v = 0; v < vertex_count; v++) {
+		state.offsets[v] = running;
+		running += state.live[v];
+		state.live[v] = 0;
+	}
+	for (size_t t = 0; t < tri_count; t++) {
+		for (int k = 0; k < TRI_VERTICES; k++) {
+			const unsigned int v = source[(t * 3) + k];
+			state.adjacency[state.offsets[v] + state.live[v]++] =
+			    (unsigned int)t;
+		}
+	}
+
+	for (size_t v = 0; v < vertex_count; v++) {
+		state.cache_pos[v] = -1;
+		state.vertex_score[v] =
+		    forsyth_vertex_score(&tables, -1, state.live[v]);
+	}
+	size_t best = 0;
+	float best_score = -1.0F;
+	for (size_t t = 0; t < tri_count; t++) {
+		const float score = state.vertex_score[source[(t * 3) + 0]] +
+		                    state.vertex_score[source[(t * 3) + 1]] +
+		                    state.vertex_score[source[(t * 3) + 2]];
+		if (score > best_score) {
+			best_score = score;
+			best = t;
+		}
+	}
+
+	unsigned int cache[FORSYTH_CACHE_SLOTS];
+	unsigned int next_cache[FORSYTH_CACHE_SLOTS];
+	int cache_count = 0;
+	size_t scan = 0; /* Repli quand le cache ne propose plus rien */
+	int has_best = 1;
+
+	for (size_t out = 0; out < tri_count; out++) {
+		if (!has_best) {
+			while (state.emitted[scan]) {
+				scan++;
+			}
+			best = scan;
+		}
+
+		const unsigned int* tri = &source[best * 3];
+		(void)memcpy(&indices[out * 3], tri,
+		             TRI_VERTICES * sizeof(unsigned int));
+		state.emitted[best] = 1;
+
+		/* Le triangle émis passe en tête du cache (LRU) */
+		int next_count = 0;
+		for (int k = 0; k < TRI_VERTICES; k++) {
+			forsyth_remove_triangle(&state, tri[k],
+			                        (unsigned int)best);
+			next_cache[next_count++] = tri[k];
+		}
+		for (int i = 0; i < cache_count; i++) {
+			const unsigned int v = cache[i];
+			if (v != tri[0] && v != tri[1] && v != tri[2]) {
+				next_cache[next_count++] = v;
+			}
+		}
+
+		/* Nouveaux scores des sommets touchés (y compris ceux qui
+		 * sortent du cache), puis des triangles qui les utilisent */
+		for (int i = 0; i < next_count; i++) {
+			const unsigned int v = next_cache[i];
+			state.cache_pos[v] =
+			    i < MESH_OPTIMIZE_CACHE_SIZE ? i : -1;
+			state.vertex_score[v] = forsyth_vertex_score(
+			    &tables, state.cache_pos[v], state.live[v]);
+		}
+
+		has_best = 0;
+		best_score = -1.0F;
+		for (int i = 0; i < next_count; i++) {
+			const unsigned int v = next_cache[i];
+			const unsigned int* list =
+			    &state.adjacency[state.offsets[v]];
+			for (unsigned int j = 0; j < state.live[v]; j++) {
+				const unsigned int t = list[j];
+				const unsigned int* verts = &source[t * 3];
+				const float score =
+				    state.vertex_score[verts[0]] +
+				    state.vertex_score[verts[1]] +
+				    state.vertex_score[verts[2]];
+				if (score > best_score) {
+					best_score = score;
+					best = t;
+					has_best = 1;
+				}
+			}
+		}
+
+		cache_count = next_count < MESH_OPTIMIZE_CACHE_SIZE
+		                  ? next_count
+		                  : MESH_OPTIMIZE_CACHE_SIZE;
+		(void)memcpy(cache, next_cache,
+		             (size_t)cache_count * sizeof(unsigned int));
+	}
+
+	free(source);
+	free(state.adjacency);
+	free(state.offsets);
+	free(state.live);
+	free(state.cache_pos);
+	free(state.vertex_score);
+	free(state.emitted);
+	return 1;
+}
+
+void mesh_optimize_vertex_fetch_remap(unsigned int* indices,
+                                      size_t index_count, size_t vertex_count,
+                                      unsigned int* remap)
+{
+	for (size_t v = 0; v < vertex_count; v++) {
+		remap[v] = REMAP_UNUSED;
+	}
+
+	unsigned int next = 0;
+	for (size_t i = 0; i < index_count; i++) {
+		unsigned int* slot = &remap[indices[i]];
+		if (*slot == REMAP_UNUSED) {
+			*slot = next++;
+		}
+		indices[i] = *slot;
+	}
+
+	for (size_t v = 0; v < vertex_count; v++) {
+		if (remap[v] == REMAP_UNUSED) {
+			remap[v] = next++;
+		}
+	}
+}
+
+int mesh_remap_vec3(vec3* data, size_t vertex_count,
+                    const unsigned int* remap)
+{
+	vec3* scratch = malloc(vertex_count * sizeof(vec3));
+	if (!scratch) {
+		return 0;
+	}
+	for (size_t v = 0; v < vertex_count; v++) {
+		glm_vec3_copy(data[v], scratch[remap[v]]);
+	}
+	(void)memcpy(data, scratch, vertex_count * sizeof(vec3));
+	free(scratch);
+	return 1;
+}
@@ -35,7 +35,8 @@ GLuint pbr_prefilter_init(int width, int height)
 
 void pbr_prefilter_mip(GLuint shader, GLuint env_hdr_tex, GLuint dest_tex,
                        int width, int height, int level, int total_levels,
-                       int slice_index, int total_slices, float threshold)
+                       int slice_index, int total_slices,
+                       GLuint threshold_ssbo)
 {
 	if (shader == 0 || dest_tex == 0) {
 		return;
@@ -51,7 +52,6 @@ void pbr_prefilter_mip(GLuint shader, GLuint env_hdr_tex, GLuint dest_tex,
 
 	GLint u_roughness = glGetUniformLocation(shader, "roughnessValue");
 	GLint u_mip = glGetUniformLocation(shader, "currentMipLevel");
-	GLint u_threshold = glGetUniformLocation(shader, "clampThreshold");
 	GLint u_offset_y = glGetUniformLocation(shader, "u_offset_y");
 	GLint u_max_y = glGetUniformLocation(shader, "u_max_y");
 
@@ -72,9 +72,6 @@ void pbr_prefilter_mip(GLuint shader, GLuint env_hdr_tex, GLuint dest_tex,
 	if (u_mip >= 0) {
 		glUniform1i(u_mip, level);
 	}
-	if (u_threshold >= 0) {
-		glUniform1f(u_threshold, threshold);
-	}
 
 	int lines_per_slice = ((int)mip_h + total_slices - 1) / total_slices;
 	int y_start = slice_index * lines_per_slice;
@@ -100,6 +97,8 @@ void pbr_prefilter_mip(GLuint shader, GLuint env_hdr_tex, GLuint dest_tex,
 
 	glBindImageTexture(1, dest_tex, level, GL_FALSE, 0, GL_WRITE_ONLY,
 	                   GL_RGBA16F);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PBR_THRESHOLD_BINDING,
+	                 threshold_ssbo);
 
 	uint32_t groups_x =
 	    (mip_w + (COMPUTE_GROUP_SIZE_PBR - 1)) / COMPUTE_GROUP_SIZE_PBR;
@@ -108,14 +107,17 @@ void pbr_prefilter_mip(GLuint shader, GLuint env_hdr_tex, GLuint dest_tex,
 	    COMPUTE_GROUP_SIZE_PBR;
 
 	glDispatchCompute(groups_x, groups_y, 1);
-	glMemoryBarrier(GL_ALL_BARRIER_BITS);
+	/* La carte n'est ensuite que samplée (les mips suivants lisent
+	 * l'environnement, pas cette carte) */
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
 
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 GLuint build_prefiltered_specular_map(GLuint shader, GLuint env_hdr_tex,
-                                      int width, int height, float threshold)
+                                      int width, int height,
+                                      GLuint threshold_ssbo)
 {
 	if (shader == 0) {
 		return 0;
@@ -129,7 +131,7 @@ GLuint build_prefiltered_specular_map(GLuint shader, GLuint env_hdr_tex,
 
 	for (int level = 0; level < levels; level++) {
 		pbr_prefilter_mip(shader, env_hdr_tex, spec_tex, width, height,
-		                  level, levels, 0, 1, threshold);
+		                  level, levels, 0, 1, threshold_ssbo);
 	}
 
 	return spec_tex;
@@ -154,18 +156,13 @@ GLuint pbr_irradiance_init(int size)
 
 void pbr_irradiance_slice_compute(GLuint shader, GLuint env_hdr_tex,
                                   GLuint dest_tex, int size, int slice_index,
-                                  int total_slices, float threshold)
+                                  int total_slices, GLuint threshold_ssbo)
 {
 	if (shader == 0 || dest_tex == 0 || total_slices <= 0) {
 		return;
 	}
 
 	GL_SCOPE_USE_PROGRAM(shader);
-	GLint u_threshold = glGetUniformLocation(shader, "clamp_threshold");
-	if (u_threshold >= 0) {
-		glUniform1f(u_threshold, threshold);
-	}
-
 	GLint u_offset_y = glGetUniformLocation(shader, "u_offset_y");
 	int lines_per_slice = (size + total_slices - 1) / total_slices;
 	int y_start = slice_index * lines_per_slice;
@@ -192,6 +189,8 @@ void pbr_irradiance_slice_compute(GLuint shader, GLuint env_hdr_tex,
 	glBindTexture(GL_TEXTURE_2D, env_hdr_tex);
 	glBindImageTexture(1, dest_tex, 0, GL_FALSE, 0, GL_WRITE_ONLY,
 	                   GL_RGBA16F);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PBR_THRESHOLD_BINDING,
+	                 threshold_ssbo);
 
 	int groups_x = (size + (int)COMPUTE_GROUP_SIZE_PBR - 1) /
 	               (int)COMPUTE_GROUP_SIZE_PBR;
@@ -199,11 +198,12 @@ void pbr_irradiance_slice_compute(GLuint shader, GLuint env_hdr_tex,
 	               (int)COMPUTE_GROUP_SIZE_PBR;
 
 	glDispatchCompute(groups_x, groups_y, 1);
-	glMemoryBarrier(GL_ALL_BARRIER_BITS);
+	/* Tranches disjointes : seul le sampling final attend */
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
 }
 
 GLuint build_irradiance_map(GLuint shader, GLuint env_hdr_tex, int size,
-                            float threshold)
+                            GLuint threshold_ssbo)
 {
 	if (shader == 0) {
 		return 0;
@@ -225,23 +225,21 @@ GLuint build_irradiance_map(GLuint shader, GLuint env_hdr_tex, int size,
 
 	{
 		GL_SCOPE_USE_PROGRAM(shader);
-		GLint u_threshold =
-		    glGetUniformLocation(shader, "clamp_threshold");
-		if (u_threshold >= 0) {
-			glUniform1f(u_threshold, threshold);
-		}
 
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, env_hdr_tex);
 		glBindImageTexture(1, irr_tex, 0, GL_FALSE, 0, GL_WRITE_ONLY,
 		                   GL_RGBA16F);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER,
+		                 PBR_THRESHOLD_BINDING, threshold_ssbo);
 
 		uint32_t groups =
 		    ((uint32_t)size + (COMPUTE_GROUP_SIZE_PBR - 1)) /
 		    COMPUTE_GROUP_SIZE_PBR;
 		glDispatchCompute(groups, groups, 1);
 
-		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+		/* Samplée par la scène, jamais relue en image */
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
 	}
 
 	glActiveTexture(GL_TEXTURE0);
@@ -250,28 +248,29 @@ GLuint build_irradiance_map(GLuint shader, GLuint env_hdr_tex, int size,
 	return irr_tex;
 }
 
-float compute_mean_luminance_gpu(GLuint shader_pass1, GLuint shader_pass2,
-                                 GLuint hdr_tex, int width, int height,
-                                 float clamp_multiplier, GLuint ssbos[2])
+GLuint pbr_threshold_buffer_create(float threshold)
 {
-	if (shader_pass1 == 0 || shader_pass2 == 0) {
-		return 0.0F;
-	}
-
-	float mean = 0.0F;
-	HYBRID_FUNC_TIMER("IBL: Luminance Reduction");
-	GL_SCOPE_DEBUG_GROUP("IBL: Luminance Reduction");
-
-	uint32_t group_x = ((uint32_t)width + (COMPUTE_GROUP_SIZE_LUM - 1)) /
-	                   COMPUTE_GROUP_SIZE_LUM;
-	uint32_t group_y = ((uint32_t)height + (COMPUTE_GROUP_SIZE_LUM - 1)) /
-	                   COMPUTE_GROUP_SIZE_LUM;
-	uint32_t num_groups = group_x * group_y;
-	uint32_t num_pixels = (uint32_t)width * (uint32_t)height;
+	const PbrLuminanceThreshold data = {0.0F, threshold};
+	GLuint ssbo = 0;
+	glGenBuffers(1, &ssbo);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+	/* Relu par copie vers l'anneau GpuReadback, réécrit par
+	 * glBufferSubData si la réduction est impossible */
+	glBufferStorage(GL_SHADER_STORAGE_BUFFER, sizeof(data), &data,
+	                GL_DYNAMIC_STORAGE_BIT);
+	glObjectLabel(GL_BUFFER, ssbo, -1, "Luminance Threshold");
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	return ssbo;
+}
 
+int dispatch_mean_luminance_gpu(GLuint shader_pass1, GLuint shader_pass2,
+                                GLuint hdr_tex, int width, int height,
+                                float clamp_multiplier,
+                                float default_threshold, GLuint ssbos[2])
+{
 	/* Lazy initialization of SSBOs if not yet created */
 	if (ssbos[0] == 0) {
-		glGenBuffers(2, ssbos);
+		glGenBuffers(1, &ssbos[0]);
 
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbos[0]);
 		/* Use glBufferStorage for stable memory placement in 4.4+ */
@@ -284,19 +283,32 @@ float compute_mean_luminance_gpu(GLuint shader_pass1, GLuint shader_pass2,
 		                flags);
 		glObjectLabel(GL_BUFFER, ssbos[0], -1,
 		              "Luminance Reduct. (Step 1)");
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
+		ssbos[1] = pbr_threshold_buffer_create(default_threshold);
+	}
+
+	if (shader_pass1 == 0 || shader_pass2 == 0) {
+		/* Le bake lit quand même un seuil valide */
+		const PbrLuminanceThreshold fallback = {0.0F,
+		                                        default_threshold};
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbos[1]);
-		/* GL_CLIENT_STORAGE_BIT hints to keep it in system memory for
-		 * fast readback */
-		GLbitfield read_flags = GL_MAP_READ_BIT |
-		                        GL_CLIENT_STORAGE_BIT |
-		                        GL_DYNAMIC_STORAGE_BIT;
-		glBufferStorage(GL_SHADER_STORAGE_BUFFER, sizeof(float), NULL,
-		                read_flags);
-		glObjectLabel(GL_BUFFER, ssbos[1], -1,
-		              "Luminance Reduct. (Step 2)");
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(fallback),
+		                &fallback);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		return 0;
 	}
 
+	HYBRID_FUNC_TIMER("IBL: Luminance Reduction");
+	GL_SCOPE_DEBUG_GROUP("IBL: Luminance Reduction");
+
+	uint32_t group_x = ((uint32_t)width + (COMPUTE_GROUP_SIZE_LUM - 1)) /
+	                   COMPUTE_GROUP_SIZE_LUM;
+	uint32_t group_y = ((uint32_t)height + (COMPUTE_GROUP_SIZE_LUM - 1)) /
+	                   COMPUTE_GROUP_SIZE_LUM;
+	uint32_t num_groups = group_x * group_y;
+	uint32_t num_pixels = (uint32_t)width * (uint32_t)height;
+
 	/* Pass 1: Initial reduction (no uniforms needed by pass1 shader) */
 	{
 		GL_SCOPE_USE_PROGRAM(shader_pass1);
@@ -309,7 +321,7 @@ float compute_mean_luminance_gpu(GLuint shader_pass1, GLuint shader_pass2,
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 	}
 
-	/* Pass 2: Final reduction to single float */
+	/* Pass 2: Final reduction + validated clamp threshold */
 	{
 		GL_SCOPE_USE_PROGRAM(shader_pass2);
 		GLint u_numGroups =
@@ -322,21 +334,27 @@ float compute_mean_luminance_gpu(GLuint shader_pass1, GLuint shader_pass2,
 		if (u_numPixels >= 0) {
 			glUniform1ui(u_numPixels, num_pixels);
 		}
+		GLint u_multiplier =
+		    glGetUniformLocation(shader_pass2, "clampMultiplier");
+		if (u_multiplier >= 0) {
+			glUniform1f(u_multiplier, clamp_multiplier);
+		}
+		GLint u_default =
+		    glGetUniformLocation(shader_pass2, "defaultThreshold");
+		if (u_default >= 0) {
+			glUniform1f(u_default, default_threshold);
+		}
 
 		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssbos[0]);
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, ssbos[1]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER,
+		                 PBR_THRESHOLD_BINDING, ssbos[1]);
 
 		glDispatchCompute(1, 1, 1);
-		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
-
-		/* Fetch result robustly without mapping overhead for a single
-		 * float */
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbos[1]);
-		glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(float),
-		                   &mean);
+		/* Lu par spmap/irmap dans la même frame */
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 	}
 
-	return mean * clamp_multiplier;
+	return 1;
 }
 
 GLuint build_brdf_lut_map(int size)
@@ -369,7 +387,8 @@ GLuint build_brdf_lut_map(int size)
 		    ((uint32_t)size + (COMPUTE_GROUP_SIZE_PBR - 1)) /
 		    COMPUTE_GROUP_SIZE_PBR;
 		glDispatchCompute(groups, groups, 1);
-		glMemoryBarrier(GL_ALL_BARRIER_BITS);
+		/* Samplée par le shader PBR */
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
 	}
 
 	glDeleteProgram(shader);
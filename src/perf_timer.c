@@ -1,20 +1,14 @@
 #include "perf_timer.h"
 
 #include "log.h"
+#include "utils.h"
+#include <stdlib.h>
 #include <time.h>  // Pour clock_gettime et CLOCK_MONOTONIC
 
 // ============================================================================
 // Time conversion constants
 // ============================================================================
 
-enum TimeConversionFactors {
-	NS_PER_MS = 1000000,    // Nanoseconds per millisecond
-	NS_PER_US = 1000,       // Nanoseconds per microsecond
-	NS_PER_S = 1000000000,  // Nanoseconds per second
-	US_PER_S = 1000000,     // Microseconds per second
-	MS_PER_S = 1000         // Milliseconds per second
-};
-
 static const double NS_TO_MS = 1.0 / (double)NS_PER_MS;
 static const double NS_TO_US = 1.0 / (double)NS_PER_US;
 static const double NS_TO_S = 1.0 / (double)NS_PER_S;
@@ -176,6 +170,109 @@ void gpu_timer_cleanup(GPUTimer* timer)
 	timer->active = 0;
 }
 
+// ============================================================================
+// GPU Timestamp Ring Implementation
+// ============================================================================
+
+int gpu_timestamp_ring_init(GPUTimestampRing* ring, int stamp_count)
+{
+	if (ring->queries) {
+		return 1;
+	}
+	if (stamp_count <= 0) {
+		return 0;
+	}
+
+	const int total = GPU_TIMESTAMP_RING_FRAMES * stamp_count;
+	ring->queries = safe_calloc((size_t)total, sizeof(GLuint));
+	if (!ring->queries) {
+		return 0;
+	}
+	glGenQueries(total, ring->queries);
+	ring->stamp_count = stamp_count;
+	gpu_timestamp_ring_discard(ring);
+	return 1;
+}
+
+void gpu_timestamp_ring_begin(GPUTimestampRing* ring)
+{
+	ring->slot = (ring->slot + 1) % GPU_TIMESTAMP_RING_FRAMES;
+	/* Frame jamais relue (GPU trop en retard) : abandonnée */
+	ring->pending[ring->slot] = 0;
+	ring->last[ring->slot] = -1;
+}
+
+void gpu_timestamp_ring_stamp(GPUTimestampRing* ring, int stamp)
+{
+	if (!ring->queries || stamp < 0 || stamp >= ring->stamp_count) {
+		return;
+	}
+	glQueryCounter(ring->queries[(ring->slot * ring->stamp_count) + stamp],
+	               GL_TIMESTAMP);
+	ring->last[ring->slot] = stamp;
+}
+
+void gpu_timestamp_ring_end(GPUTimestampRing* ring, int tag)
+{
+	if (ring->last[ring->slot] >= 0) {
+		ring->pending[ring->slot] = tag;
+	}
+}
+
+int gpu_timestamp_ring_try_read(GPUTimestampRing* ring, GLuint64* stamps,
+                                int* tag)
+{
+	if (!ring->queries) {
+		return -1;
+	}
+
+	/* Du plus ancien au plus récent */
+	for (int i = 1; i <= GPU_TIMESTAMP_RING_FRAMES; i++) {
+		const int slot = (ring->slot + i) % GPU_TIMESTAMP_RING_FRAMES;
+		if (!ring->pending[slot]) {
+			continue;
+		}
+
+		const GLuint* queries =
+		    &ring->queries[slot * ring->stamp_count];
+		GLint available = 0;
+		glGetQueryObjectiv(queries[ring->last[slot]],
+		                   GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			return -1; /* Les frames suivantes non plus */
+		}
+
+		for (int stamp = 0; stamp <= ring->last[slot]; stamp++) {
+			glGetQueryObjectui64v(queries[stamp], GL_QUERY_RESULT,
+			                      &stamps[stamp]);
+		}
+		if (tag) {
+			*tag = ring->pending[slot];
+		}
+		ring->pending[slot] = 0;
+		return slot;
+	}
+	return -1;
+}
+
+void gpu_timestamp_ring_discard(GPUTimestampRing* ring)
+{
+	for (int i = 0; i < GPU_TIMESTAMP_RING_FRAMES; i++) {
+		ring->pending[i] = 0;
+		ring->last[i] = -1;
+	}
+}
+
+void gpu_timestamp_ring_cleanup(GPUTimestampRing* ring)
+{
+	if (ring->queries) {
+		glDeleteQueries(GPU_TIMESTAMP_RING_FRAMES * ring->stamp_count,
+		                ring->queries);
+		free(ring->queries);
+	}
+	*ring = (GPUTimestampRing){0};
+}
+
 // ============================================================================
 // Hybrid Timer Implementation
 // ============================================================================
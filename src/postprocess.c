@@ -4,18 +4,25 @@
 #include "effects/fx_bloom.h"
 #include "effects/fx_dof.h"
 #include "effects/fx_motion_blur.h"
+#include "frame_graph.h"
 #include "gl_common.h"
 #include "log.h"
+#include "render_target_pool.h"
 #include "render_utils.h"
 #include "shader.h"
+#include "utils.h"
+#include <cglm/cglm.h>
 #include <cglm/types.h>
+#include <math.h>
 #include <string.h>
 
 static int create_framebuffer(PostProcess* post_processing);
+static void update_render_size(PostProcess* post_processing);
 static void destroy_framebuffer(PostProcess* post_processing);
 static void destroy_screen_quad(PostProcess* post_processing);
+static void destroy_composite_target(PostProcess* post_processing);
 
-/* Texture Units */
+/* Texture Units (= layout(binding) de postprocess.frag/.comp) */
 enum {
 	POSTPROCESS_TEX_UNIT_SCENE = 0,
 	POSTPROCESS_TEX_UNIT_BLOOM = 1,
@@ -23,13 +30,25 @@ enum {
 	POSTPROCESS_TEX_UNIT_EXPOSURE = 3,
 	POSTPROCESS_TEX_UNIT_VELOCITY = 4,
 	POSTPROCESS_TEX_UNIT_NEIGHBOR_MAX = 5,
-	POSTPROCESS_TEX_UNIT_DOF_BLUR = 6
+	POSTPROCESS_TEX_UNIT_DOF_BLUR = 6,
+	POSTPROCESS_TEX_UNIT_BLOOM_UP = 7,
+	POSTPROCESS_TEX_UNIT_COLOR_LUT = COLOR_LUT_TEX_UNIT, /* sampler3D */
+	POSTPROCESS_TEX_UNIT_COUNT
 };
 
 /* Compute Shader Constants */
-enum { POSTPROCESS_COMPUTE_GROUP_SIZE = 16 };
+/* Rapport VRAM */
+#define POSTPROCESS_BYTES_PER_MB (1024.0 * 1024.0)
+enum { POSTPROCESS_VRAM_LOG_SIZE = 256 };
 
-/* Compute Shader Constants */
+enum {
+	/* local_size de postprocess.comp */
+	POSTPROCESS_COMPUTE_GROUP_SIZE = 16,
+	POSTPROCESS_COMPOSITE_IMAGE_UNIT = 0
+};
+
+/* Clé du graphe de frame : masque du composite + chemin compute */
+#define POSTPROCESS_GRAPH_COMPUTE (1U << 16U)
 
 int postprocess_init(PostProcess* post_processing, int width, int height)
 {
@@ -37,7 +56,11 @@ int postprocess_init(PostProcess* post_processing, int width, int height)
 
 	post_processing->width = width;
 	post_processing->height = height;
+	render_target_pool_init(&post_processing->target_pool);
+	frame_graph_init(&post_processing->frame_graph);
 	post_processing->time = 0.0F;
+	post_processing->render_scale = 1.0F;
+	update_render_size(post_processing);
 
 	/* Paramètres par défaut */
 	post_processing->vignette.intensity = DEFAULT_VIGNETTE_INTENSITY;
@@ -127,6 +150,16 @@ int postprocess_init(PostProcess* post_processing, int width, int height)
 	/* Charger le shader de post-processing */
 	post_processing->postprocess_shader =
 	    shader_load("shaders/postprocess.vert", "shaders/postprocess.frag");
+	postprocess_variants_init(&post_processing->variants);
+	post_processing->composite_compute_shader =
+	    shader_load_compute_program("shaders/postprocess.comp");
+	if (!post_processing->composite_compute_shader) {
+		LOG_WARN("suckless-ogl.postprocess",
+		         "Compute composite unavailable, fragment path only");
+	} else {
+		(void)fx_tile_classify_init(post_processing);
+	}
+	(void)fx_color_lut_init(post_processing);
 
 	/* Initialize UBO */
 	glGenBuffers(1, &post_processing->settings_ubo);
@@ -184,10 +217,20 @@ void postprocess_cleanup(PostProcess* post_processing)
 		shader_destroy(post_processing->postprocess_shader);
 		post_processing->postprocess_shader = NULL;
 	}
+	postprocess_variants_cleanup(&post_processing->variants);
+	if (post_processing->composite_compute_shader) {
+		shader_destroy(post_processing->composite_compute_shader);
+		post_processing->composite_compute_shader = NULL;
+	}
 	fx_bloom_cleanup(post_processing);
 	fx_dof_cleanup(post_processing);
 	fx_auto_exposure_cleanup(post_processing);
 	fx_motion_blur_cleanup(post_processing);
+	fx_tile_classify_cleanup(post_processing);
+	fx_color_lut_cleanup(post_processing);
+	/* Après les effets : tout a été rendu au pool */
+	render_target_pool_cleanup(&post_processing->target_pool);
+	frame_graph_cleanup(&post_processing->frame_graph);
 
 	LOG_INFO("suckless-ogl.postprocess", "Post-processing cleaned up");
 }
@@ -201,6 +244,7 @@ void postprocess_resize(PostProcess* post_processing, int width, int height)
 
 	post_processing->width = width;
 	post_processing->height = height;
+	update_render_size(post_processing);
 
 	/* Recréer le framebuffer avec les nouvelles dimensions */
 	destroy_framebuffer(post_processing);
@@ -209,14 +253,15 @@ void postprocess_resize(PostProcess* post_processing, int width, int height)
 		          "Failed to resize framebuffer");
 	}
 
-	fx_bloom_cleanup(post_processing);
-	if (!fx_bloom_init(post_processing)) {
-		LOG_ERROR("suckless-ogl.postprocess",
-		          "Failed to resize bloom resources");
-	}
-
+	/* Cibles rendues au pool puis détruites : reprises à la nouvelle
+	 * taille au prochain rendu de chaque effet */
+	fx_bloom_resize(post_processing);
 	fx_dof_resize(post_processing);
 	fx_motion_blur_resize(post_processing);
+	render_target_pool_trim(&post_processing->target_pool);
+	(void)fx_tile_classify_resize(post_processing);
+	/* Cibles des passes (DoF, composite) à la nouvelle taille */
+	frame_graph_reset(&post_processing->frame_graph);
 
 	/* Final Bridge: Ensure ALL used units are in a valid state.
 	 * NVIDIA driver validates units used by the last shader before resize.
@@ -225,7 +270,7 @@ void postprocess_resize(PostProcess* post_processing, int width, int height)
 	 * NVIDIA driver validates units used by the last shader before resize.
 	 */
 	render_utils_reset_texture_units(GL_TEXTURE0,
-	                                 POSTPROCESS_TEX_UNIT_DOF_BLUR + 1,
+	                                 POSTPROCESS_TEX_UNIT_COUNT,
 	                                 post_processing->dummy_black_tex);
 
 	/* Reset to Unit 0 for subsequent generic bindings */
@@ -325,11 +370,80 @@ void postprocess_set_dof(PostProcess* post_processing, float focal_distance,
 	post_processing->dof.bokeh_scale = bokeh_scale;
 }
 
+void postprocess_set_readback(PostProcess* post_processing,
+                              GpuReadback* readback)
+{
+	post_processing->readback = readback;
+}
+
 float postprocess_get_exposure(PostProcess* post_processing)
 {
 	return fx_auto_exposure_get_current_exposure(post_processing);
 }
 
+/* Cibles de la scène (couleur, vélocité, profondeur), hors pool */
+static size_t scene_target_bytes(const PostProcess* post_processing)
+{
+	if (!post_processing->scene_fbo) {
+		return 0;
+	}
+	const size_t texels =
+	    (size_t)post_processing->width * (size_t)post_processing->height;
+	return texels * (render_target_format_bytes(GL_RGBA16F) +
+	                 render_target_format_bytes(GL_RG16F) +
+	                 render_target_format_bytes(GL_DEPTH_COMPONENT32F));
+}
+
+static size_t composite_target_bytes(const PostProcess* post_processing)
+{
+	if (!post_processing->composite_tex) {
+		return 0;
+	}
+	return (size_t)post_processing->width *
+	       (size_t)post_processing->height *
+	       render_target_format_bytes(GL_RGBA8);
+}
+
+size_t postprocess_vram_bytes(const PostProcess* post_processing)
+{
+	const RenderTargetPool* pool = &post_processing->target_pool;
+	size_t bytes = scene_target_bytes(post_processing) +
+	               composite_target_bytes(post_processing);
+	for (int i = 0; i < pool->count; i++) {
+		bytes += pool->targets[i].bytes;
+	}
+	return bytes;
+}
+
+void postprocess_log_vram(const PostProcess* post_processing)
+{
+	RenderTargetUsage usage[RENDER_TARGET_POOL_MAX_OWNERS];
+	const int count =
+	    render_target_pool_usage(&post_processing->target_pool, usage,
+	                             RENDER_TARGET_POOL_MAX_OWNERS);
+
+	char text[POSTPROCESS_VRAM_LOG_SIZE];
+	(void)safe_snprintf(text, sizeof(text),
+	                    "Scene %.1f MB, Composite %.1f MB",
+	                    (double)scene_target_bytes(post_processing) /
+	                        POSTPROCESS_BYTES_PER_MB,
+	                    (double)composite_target_bytes(post_processing) /
+	                        POSTPROCESS_BYTES_PER_MB);
+	for (int i = 0; i < count; i++) {
+		const size_t length = strlen(text);
+		(void)safe_snprintf(
+		    text + length, sizeof(text) - length, ", %s %.1f MB (%d)",
+		    usage[i].owner ? usage[i].owner : "pool free",
+		    (double)usage[i].bytes / POSTPROCESS_BYTES_PER_MB,
+		    usage[i].targets);
+	}
+
+	LOG_INFO("suckless-ogl.postprocess", "VRAM %.1f MB: %s",
+	         (double)postprocess_vram_bytes(post_processing) /
+	             POSTPROCESS_BYTES_PER_MB,
+	         text);
+}
+
 void postprocess_set_auto_exposure(PostProcess* post_processing,
                                    float min_luminance, float max_luminance,
                                    float speed_up, float speed_down,
@@ -375,101 +489,120 @@ void postprocess_apply_preset(PostProcess* post_processing,
 	post_processing->dof = preset->dof;
 }
 
-void postprocess_begin(PostProcess* post_processing)
+void postprocess_set_render_scale(PostProcess* post_processing, float scale)
 {
-	/* Rendre dans notre framebuffer */
-	glBindFramebuffer(GL_FRAMEBUFFER, post_processing->scene_fbo);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	post_processing->render_scale = glm_clamp(scale, 0.0F, 1.0F);
+	update_render_size(post_processing);
 }
 
-void postprocess_end(PostProcess* post_processing)
+int postprocess_set_bloom_levels(PostProcess* post_processing, int levels)
 {
-	/* Générer le bloom (si activé) avant de binder le framebuffer par
-	 * défaut */
-	fx_bloom_render(post_processing);
-
-	/* DoF Blur Pass (if DoF enabled) */
-	/* We reuse bloom_downsample to get a filtered 1/2 res version of the
-	 * scene */
-	if (postprocess_is_enabled(post_processing, POSTFX_DOF) ||
-	    postprocess_is_enabled(post_processing, POSTFX_DOF_DEBUG)) {
-		fx_dof_render(post_processing);
-	}
-
-	/* Auto Exposure Pass */
-	if (postprocess_is_enabled(post_processing, POSTFX_AUTO_EXPOSURE)) {
-		fx_auto_exposure_render(post_processing);
-	}
+	return fx_bloom_set_levels(post_processing, levels);
+}
 
-	/* Motion Blur Pre-Pass (Compute) */
-	if (postprocess_is_enabled(post_processing, POSTFX_MOTION_BLUR)) {
-		fx_motion_blur_render(post_processing);
-	}
+int postprocess_set_compute_composite(PostProcess* post_processing,
+                                      int enabled)
+{
+	post_processing->compute_composite =
+	    enabled && post_processing->composite_compute_shader != NULL;
+	return post_processing->compute_composite;
+}
 
-	/* Retour au framebuffer par défaut */
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	glViewport(0, 0, post_processing->width, post_processing->height);
-	glClear(GL_COLOR_BUFFER_BIT);
+int postprocess_set_color_lut(PostProcess* post_processing, int size)
+{
+	return fx_color_lut_set_size(post_processing, size);
+}
 
-	/* Désactiver le depth test pour le quad */
-	glDisable(GL_DEPTH_TEST);
+int postprocess_set_tile_classification(PostProcess* post_processing,
+                                        int enabled)
+{
+	TileClassifyFX* tiles = &post_processing->tile_classify_fx;
+	tiles->enabled = enabled && tiles->classify_shader != NULL;
+	return tiles->enabled;
+}
 
-	/* Utiliser le shader de post-processing */
-	shader_use(post_processing->postprocess_shader);
+void postprocess_begin(PostProcess* post_processing)
+{
+	/* Rendre dans notre framebuffer */
+	glBindFramebuffer(GL_FRAMEBUFFER, post_processing->scene_fbo);
+	/* Le clear ignore le viewport : rien de périmé hors de la région */
+	glViewport(0, 0, post_processing->render_width,
+	           post_processing->render_height);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
 
+/* Entrées du composite : les unités sont fixées par les layout(binding)
+ * des shaders (les variantes peuvent en éliminer certains samplers) */
+static void bind_composite_textures(PostProcess* post_processing)
+{
 	/* Bind la texture de la scène */
 	glActiveTexture(GL_TEXTURE0 + POSTPROCESS_TEX_UNIT_SCENE);
 	glBindTexture(GL_TEXTURE_2D, post_processing->scene_color_tex);
-	shader_set_int(post_processing->postprocess_shader, "screenTexture",
-	               POSTPROCESS_TEX_UNIT_SCENE);
 
-	/* Bind la texture de Bloom */
+	/* Bind les textures de Bloom : niveau 0 et niveau 1 remonté (le
+	 * composite fait la dernière remontée) */
+	const BloomFX* bloom = &post_processing->bloom_fx;
+	const int bloom_on =
+	    postprocess_is_enabled(post_processing, POSTFX_BLOOM);
 	render_utils_bind_texture_safe(
 	    GL_TEXTURE0 + POSTPROCESS_TEX_UNIT_BLOOM,
-	    postprocess_is_enabled(post_processing, POSTFX_BLOOM)
-	        ? post_processing->bloom_fx.mips[0].texture
-	        : 0,
+	    bloom_on ? bloom->mips[0].texture : 0,
+	    post_processing->dummy_black_tex);
+	render_utils_bind_texture_safe(
+	    GL_TEXTURE0 + POSTPROCESS_TEX_UNIT_BLOOM_UP,
+	    bloom_on && bloom->levels > 1 ? bloom->mips[1].texture : 0,
 	    post_processing->dummy_black_tex);
-
-	shader_set_int(post_processing->postprocess_shader, "bloomTexture",
-	               POSTPROCESS_TEX_UNIT_BLOOM);
 
 	/* Bind la texture de Profondeur (pour le DoF) */
 	glActiveTexture(GL_TEXTURE0 + POSTPROCESS_TEX_UNIT_DEPTH);
 	glBindTexture(GL_TEXTURE_2D, post_processing->scene_depth_tex);
-	shader_set_int(post_processing->postprocess_shader, "depthTexture",
-	               POSTPROCESS_TEX_UNIT_DEPTH);
 
 	/* Bind Exposure Texture (Unit 3) */
 	glActiveTexture(GL_TEXTURE0 + POSTPROCESS_TEX_UNIT_EXPOSURE);
 	glBindTexture(GL_TEXTURE_2D,
 	              post_processing->auto_exposure_fx.exposure_tex);
-	shader_set_int(post_processing->postprocess_shader,
-	               "autoExposureTexture", POSTPROCESS_TEX_UNIT_EXPOSURE);
 
 	/* Bind Velocity Texture (Unit 4) */
 	glActiveTexture(GL_TEXTURE0 + POSTPROCESS_TEX_UNIT_VELOCITY);
 	glBindTexture(GL_TEXTURE_2D, post_processing->velocity_tex);
-	shader_set_int(post_processing->postprocess_shader, "velocityTexture",
-	               POSTPROCESS_TEX_UNIT_VELOCITY);
 
-	/* Bind Neighbor Max Texture (Unit 5) */
-	glActiveTexture(GL_TEXTURE0 + POSTPROCESS_TEX_UNIT_NEIGHBOR_MAX);
-	glBindTexture(GL_TEXTURE_2D,
-	              post_processing->motion_blur_fx.neighbor_max_tex);
-	shader_set_int(post_processing->postprocess_shader,
-	               "neighborMaxTexture", POSTPROCESS_TEX_UNIT_NEIGHBOR_MAX);
+	/* Bind Neighbor Max Texture (Unit 5), 0 hors pré-passe */
+	render_utils_bind_texture_safe(
+	    GL_TEXTURE0 + POSTPROCESS_TEX_UNIT_NEIGHBOR_MAX,
+	    post_processing->motion_blur_fx.neighbor_max_tex,
+	    post_processing->dummy_black_tex);
+
+	/* Bind DoF Blurred Texture (Unit 6), 0 si DoF éteint */
+	render_utils_bind_texture_safe(GL_TEXTURE0 +
+	                                   POSTPROCESS_TEX_UNIT_DOF_BLUR,
+	                               post_processing->dof_fx.blur_tex,
+	                               post_processing->dummy_black_tex);
+
+	/* Bind Color LUT (Unit 8, 3D) */
+	glActiveTexture(GL_TEXTURE0 + POSTPROCESS_TEX_UNIT_COLOR_LUT);
+	glBindTexture(GL_TEXTURE_3D, post_processing->color_lut_fx.texture);
+}
 
-	/* Bind DoF Blurred Texture (Unit 6) */
-	glActiveTexture(GL_TEXTURE0 + POSTPROCESS_TEX_UNIT_DOF_BLUR);
-	glBindTexture(GL_TEXTURE_2D, post_processing->dof_fx.blur_tex);
-	shader_set_int(post_processing->postprocess_shader, "dofBlurTexture",
-	               POSTPROCESS_TEX_UNIT_DOF_BLUR);
+/* Masque vu par le composite : effets actifs + chaîne couleur en LUT */
+static unsigned int composite_effects(const PostProcess* post_processing)
+{
+	unsigned int effects = post_processing->active_effects;
+	if (post_processing->color_lut_fx.size) {
+		effects |= POSTFX_COLOR_LUT;
+	}
+	return effects;
+}
 
+static void upload_settings(PostProcess* post_processing)
+{
 	/* Upload settings via UBO */
 	PostProcessUBO ubo = {0};
-	ubo.active_effects = post_processing->active_effects;
+	ubo.active_effects = composite_effects(post_processing);
 	ubo.time = post_processing->time;
+	ubo.render_scale[0] = (float)post_processing->render_width /
+	                      (float)post_processing->width;
+	ubo.render_scale[1] = (float)post_processing->render_height /
+	                      (float)post_processing->height;
 
 	ubo.vignette_intensity = post_processing->vignette.intensity;
 	ubo.vignette_smoothness = post_processing->vignette.smoothness;
@@ -519,16 +652,312 @@ void postprocess_end(PostProcess* post_processing)
 	glBindBuffer(GL_UNIFORM_BUFFER, post_processing->settings_ubo);
 	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(PostProcessUBO), &ubo);
 	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+/* Crée la cible RGBA8 du composite compute au premier usage */
+static int ensure_composite_target(PostProcess* post_processing)
+{
+	if (post_processing->composite_fbo) {
+		return 1;
+	}
+
+	glGenTextures(1, &post_processing->composite_tex);
+	glBindTexture(GL_TEXTURE_2D, post_processing->composite_tex);
+	glObjectLabel(GL_TEXTURE, post_processing->composite_tex, -1,
+	              "Composite (Compute)");
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, post_processing->width,
+	               post_processing->height);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glGenFramebuffers(1, &post_processing->composite_fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, post_processing->composite_fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+	                       GL_TEXTURE_2D, post_processing->composite_tex,
+	                       0);
+	const int complete =
+	    render_utils_check_framebuffer("PostProcess Composite FBO");
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	if (!complete) {
+		destroy_composite_target(post_processing);
+	}
+	return complete;
+}
+
+static void destroy_composite_target(PostProcess* post_processing)
+{
+	if (post_processing->composite_fbo) {
+		glDeleteFramebuffers(1, &post_processing->composite_fbo);
+		post_processing->composite_fbo = 0;
+	}
+	if (post_processing->composite_tex) {
+		glDeleteTextures(1, &post_processing->composite_tex);
+		post_processing->composite_tex = 0;
+	}
+}
+
+/* Composite en compute puis copie vers le framebuffer par défaut (lié) */
+static void composite_compute(PostProcess* post_processing)
+{
+	if (!ensure_composite_target(post_processing)) {
+		return;
+	}
+
+	const int groups_x =
+	    (post_processing->width + (POSTPROCESS_COMPUTE_GROUP_SIZE - 1)) /
+	    POSTPROCESS_COMPUTE_GROUP_SIZE;
+	const int groups_y =
+	    (post_processing->height + (POSTPROCESS_COMPUTE_GROUP_SIZE - 1)) /
+	    POSTPROCESS_COMPUTE_GROUP_SIZE;
+	const int tiled = post_processing->tile_classify_fx.enabled;
+
+	/* Classification comprise dans la mesure */
+	postprocess_variants_select_compute(&post_processing->variants, tiled);
+	postprocess_variants_begin_timing(&post_processing->variants);
+
+	glBindImageTexture(POSTPROCESS_COMPOSITE_IMAGE_UNIT,
+	                   post_processing->composite_tex, 0, GL_FALSE, 0,
+	                   GL_WRITE_ONLY, GL_RGBA8);
+	if (tiled) {
+		fx_tile_classify_render(post_processing);
+	} else {
+		shader_use(post_processing->composite_compute_shader);
+		glDispatchCompute((GLuint)groups_x, (GLuint)groups_y, 1);
+	}
+	glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT);
+
+	/* Le blit fait partie du coût du chemin (le fragment écrit
+	 * directement dans le framebuffer par défaut) */
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, post_processing->composite_fbo);
+	glBlitFramebuffer(0, 0, post_processing->width, post_processing->height,
+	                  0, 0, post_processing->width, post_processing->height,
+	                  GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	postprocess_variants_end_timing(&post_processing->variants);
+}
+
+/* Composite vers le framebuffer par défaut, lié par le graphe */
+static void composite(PostProcess* post_processing)
+{
+	bind_composite_textures(post_processing);
+
+	if (post_processing->compute_composite &&
+	    post_processing->composite_compute_shader) {
+		composite_compute(post_processing);
+		return;
+	}
+
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	/* Désactiver le depth test pour le quad */
+	glDisable(GL_DEPTH_TEST);
+
+	/* Variante spécialisée pour ce masque (uber-shader en attendant) */
+	shader_use(postprocess_variants_select(
+	    &post_processing->variants, composite_effects(post_processing),
+	    post_processing->postprocess_shader));
 
 	/* Dessiner le quad */
+	postprocess_variants_begin_timing(&post_processing->variants);
 	glBindVertexArray(post_processing->screen_quad_vao);
 	glDrawArrays(GL_TRIANGLES, 0, SCREEN_QUAD_VERTEX_COUNT);
 	glBindVertexArray(0);
+	postprocess_variants_end_timing(&post_processing->variants);
 
 	/* Réactiver le depth test */
 	glEnable(GL_DEPTH_TEST);
 }
 
+/* Passes du graphe : le contexte est le PostProcess */
+static void pass_settings(void* user)
+{
+	upload_settings(user);
+}
+
+static void pass_bloom(void* user)
+{
+	fx_bloom_render(user);
+}
+
+static void pass_bloom_culled(void* user)
+{
+	fx_bloom_release(user);
+}
+
+static void pass_dof(void* user)
+{
+	fx_dof_render(user);
+}
+
+static void pass_dof_culled(void* user)
+{
+	fx_dof_release(user);
+}
+
+static void pass_auto_exposure(void* user)
+{
+	fx_auto_exposure_render(user);
+}
+
+static void pass_motion_blur(void* user)
+{
+	fx_motion_blur_render(user);
+}
+
+static void pass_motion_blur_culled(void* user)
+{
+	fx_motion_blur_release(user);
+}
+
+static void pass_color_lut(void* user)
+{
+	fx_color_lut_render(user);
+}
+
+static void pass_composite(void* user)
+{
+	composite(user);
+}
+
+/**
+ * Déclare la chaîne pour une configuration. Les passes d'effet sont
+ * toujours déclarées : le composite ne lit que les sorties des effets
+ * actifs, les autres sont éliminées par la compilation (cibles rendues au
+ * pool). La scène, rastérisée avant postprocess_end(), est importée.
+ */
+static void build_frame_graph(PostProcess* post_processing, unsigned int key)
+{
+	FrameGraph* graph = &post_processing->frame_graph;
+	const unsigned int effects = key & ~POSTPROCESS_GRAPH_COMPUTE;
+	const int use_compute = (key & POSTPROCESS_GRAPH_COMPUTE) != 0;
+
+	frame_graph_reset(graph);
+	post_processing->frame_graph_key = key;
+
+	const int scene = frame_graph_add_resource(graph, "Scene Color",
+	                                           FRAME_GRAPH_TEXTURE, 0);
+	const int depth = frame_graph_add_resource(graph, "Scene Depth",
+	                                           FRAME_GRAPH_TEXTURE, 0);
+	const int velocity = frame_graph_add_resource(graph, "Velocity",
+	                                              FRAME_GRAPH_TEXTURE, 0);
+	const int settings = frame_graph_add_resource(graph, "Settings UBO",
+	                                              FRAME_GRAPH_BUFFER, 0);
+	const int bloom = frame_graph_add_resource(graph, "Bloom Chain",
+	                                           FRAME_GRAPH_TEXTURE, 0);
+	const int dof = frame_graph_add_resource(graph, "DoF Blur",
+	                                         FRAME_GRAPH_TEXTURE, 0);
+	/* Relue par la frame suivante et le CPU */
+	const int exposure = frame_graph_add_resource(graph, "Exposure",
+	                                              FRAME_GRAPH_TEXTURE, 1);
+	const int neighbor_max = frame_graph_add_resource(
+	    graph, "Neighbor Max", FRAME_GRAPH_TEXTURE, 0);
+	const int lut = frame_graph_add_resource(graph, "Color LUT",
+	                                         FRAME_GRAPH_TEXTURE, 0);
+	const int backbuffer = frame_graph_add_resource(graph, "Backbuffer",
+	                                                FRAME_GRAPH_TEXTURE, 1);
+
+	int pass = frame_graph_add_pass(graph, "Settings", pass_settings, NULL,
+	                                post_processing);
+	(void)frame_graph_write(graph, pass, settings, FRAME_GRAPH_TRANSFER);
+
+	pass = frame_graph_add_pass(graph, "Bloom", pass_bloom,
+	                            pass_bloom_culled, post_processing);
+	(void)frame_graph_read(graph, pass, scene, FRAME_GRAPH_SAMPLED);
+	(void)frame_graph_write(graph, pass, bloom, FRAME_GRAPH_IMAGE);
+
+	int dof_width = 0;
+	int dof_height = 0;
+	fx_dof_target_size(post_processing, &dof_width, &dof_height);
+	pass = frame_graph_add_pass(graph, "DoF", pass_dof, pass_dof_culled,
+	                            post_processing);
+	frame_graph_set_target(graph, pass,
+	                       (GLint)post_processing->dof_fx.fbo, dof_width,
+	                       dof_height);
+	(void)frame_graph_read(graph, pass, scene, FRAME_GRAPH_SAMPLED);
+	(void)frame_graph_write(graph, pass, dof, FRAME_GRAPH_ATTACHMENT);
+
+	/* Exposition adaptée d'une frame à l'autre (lecture-écriture) */
+	pass = frame_graph_add_pass(graph, "Auto Exposure", pass_auto_exposure,
+	                            NULL, post_processing);
+	if (pass >= 0) {
+		graph->passes[pass].enabled =
+		    (effects & POSTFX_AUTO_EXPOSURE) != 0;
+	}
+	(void)frame_graph_read(graph, pass, scene, FRAME_GRAPH_SAMPLED);
+	(void)frame_graph_read(graph, pass, exposure, FRAME_GRAPH_IMAGE);
+	(void)frame_graph_write(graph, pass, exposure, FRAME_GRAPH_IMAGE);
+
+	pass = frame_graph_add_pass(graph, "Motion Blur Tiles",
+	                            pass_motion_blur, pass_motion_blur_culled,
+	                            post_processing);
+	(void)frame_graph_read(graph, pass, velocity, FRAME_GRAPH_SAMPLED);
+	(void)frame_graph_write(graph, pass, neighbor_max, FRAME_GRAPH_IMAGE);
+
+	pass = frame_graph_add_pass(graph, "Color LUT", pass_color_lut, NULL,
+	                            post_processing);
+	(void)frame_graph_read(graph, pass, settings, FRAME_GRAPH_UNIFORM);
+	(void)frame_graph_write(graph, pass, lut, FRAME_GRAPH_IMAGE);
+
+	/* Le composite compute réduit lui-même le voisinage de vélocité :
+	 * la pré-passe motion blur n'y est pas lue */
+	pass = frame_graph_add_pass(graph,
+	                            use_compute ? "Composite (Compute)"
+	                                        : "Composite",
+	                            pass_composite, NULL, post_processing);
+	frame_graph_set_target(graph, pass, 0, post_processing->width,
+	                       post_processing->height);
+	(void)frame_graph_read(graph, pass, settings, FRAME_GRAPH_UNIFORM);
+	(void)frame_graph_read(graph, pass, scene, FRAME_GRAPH_SAMPLED);
+	(void)frame_graph_read(graph, pass, depth, FRAME_GRAPH_SAMPLED);
+	(void)frame_graph_read(graph, pass, velocity, FRAME_GRAPH_SAMPLED);
+	if (effects & POSTFX_BLOOM) {
+		(void)frame_graph_read(graph, pass, bloom,
+		                       FRAME_GRAPH_SAMPLED);
+	}
+	if (effects & (POSTFX_DOF | POSTFX_DOF_DEBUG)) {
+		(void)frame_graph_read(graph, pass, dof, FRAME_GRAPH_SAMPLED);
+	}
+	if (effects & POSTFX_AUTO_EXPOSURE) {
+		(void)frame_graph_read(graph, pass, exposure,
+		                       FRAME_GRAPH_SAMPLED);
+	}
+	if ((effects & POSTFX_MOTION_BLUR) && !use_compute) {
+		(void)frame_graph_read(graph, pass, neighbor_max,
+		                       FRAME_GRAPH_SAMPLED);
+	}
+	if (effects & POSTFX_COLOR_LUT) {
+		(void)frame_graph_read(graph, pass, lut, FRAME_GRAPH_SAMPLED);
+	}
+	(void)frame_graph_write(graph, pass, backbuffer,
+	                        FRAME_GRAPH_ATTACHMENT);
+}
+
+void postprocess_end(PostProcess* post_processing)
+{
+	const int use_compute = post_processing->compute_composite &&
+	                        post_processing->composite_compute_shader;
+	const unsigned int key = composite_effects(post_processing) |
+	                         (use_compute ? POSTPROCESS_GRAPH_COMPUTE : 0U);
+	FrameGraph* graph = &post_processing->frame_graph;
+	RenderTargetPool* pool = &post_processing->target_pool;
+
+	render_target_pool_begin_frame(pool);
+
+	/* Recompilé seulement quand la configuration change : les effets
+	 * éliminés rendent leurs cibles au pool à ce moment */
+	if (graph->pass_count == 0 ||
+	    key != post_processing->frame_graph_key) {
+		build_frame_graph(post_processing, key);
+	}
+	frame_graph_execute(graph);
+
+	if (pool->changed) {
+		postprocess_log_vram(post_processing);
+		pool->changed = 0;
+	}
+}
+
 void postprocess_update_time(PostProcess* post_processing, float delta_time)
 {
 	post_processing->time += delta_time;
@@ -543,12 +972,28 @@ void postprocess_update_matrices(PostProcess* post_processing, mat4 view_proj)
 
 /* Fonctions privées */
 
+static void update_render_size(PostProcess* post_processing)
+{
+	const float scale = post_processing->render_scale;
+	post_processing->render_width =
+	    (int)lroundf((float)post_processing->width * scale);
+	post_processing->render_height =
+	    (int)lroundf((float)post_processing->height * scale);
+	if (post_processing->render_width < 1) {
+		post_processing->render_width = 1;
+	}
+	if (post_processing->render_height < 1) {
+		post_processing->render_height = 1;
+	}
+}
+
 static int create_framebuffer(PostProcess* post_processing)
 {
 	/* Ensure Unit 0 is active for initial texture setup */
 	glActiveTexture(GL_TEXTURE0);
 
-	/* Créer le framebuffer */
+	/* Créer le framebuffer. Cibles persistantes (toujours écrites par la
+	 * scène et le G-buffer) : hors pool, mais immuables elles aussi */
 	glGenFramebuffers(1, &post_processing->scene_fbo);
 	glBindFramebuffer(GL_FRAMEBUFFER, post_processing->scene_fbo);
 
@@ -557,8 +1002,8 @@ static int create_framebuffer(PostProcess* post_processing)
 	glBindTexture(GL_TEXTURE_2D, post_processing->scene_color_tex);
 	glObjectLabel(GL_TEXTURE, post_processing->scene_color_tex, -1,
 	              "Scene Color (HDR)");
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, post_processing->width,
-	             post_processing->height, 0, GL_RGBA, GL_FLOAT, NULL);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA16F, post_processing->width,
+	               post_processing->height);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -572,8 +1017,8 @@ static int create_framebuffer(PostProcess* post_processing)
 	glBindTexture(GL_TEXTURE_2D, post_processing->velocity_tex);
 	glObjectLabel(GL_TEXTURE, post_processing->velocity_tex, -1,
 	              "Velocity Buffer");
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, post_processing->width,
-	             post_processing->height, 0, GL_RG, GL_FLOAT, NULL);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_RG16F, post_processing->width,
+	               post_processing->height);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -593,9 +1038,8 @@ static int create_framebuffer(PostProcess* post_processing)
 	glBindTexture(GL_TEXTURE_2D, post_processing->scene_depth_tex);
 	glObjectLabel(GL_TEXTURE, post_processing->scene_depth_tex, -1,
 	              "Scene Depth (D32F)");
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F,
-	             post_processing->width, post_processing->height, 0,
-	             GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT32F,
+	               post_processing->width, post_processing->height);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -629,6 +1073,8 @@ static void destroy_framebuffer(PostProcess* post_processing)
 		glDeleteTextures(1, &post_processing->velocity_tex);
 		post_processing->velocity_tex = 0;
 	}
+	/* Recréée à la bonne taille au prochain composite compute */
+	destroy_composite_target(post_processing);
 
 	/* Bridge Unit 0 with dummy to avoid invalid state warnings during
 	 * resize
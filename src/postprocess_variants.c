@@ -0,0 +1,266 @@
+#include "postprocess_variants.h"
+
+#include "gl_common.h"
+#include "log.h"
+#include "perf_timer.h"
+#include "shader.h"
+#include "utils.h"
+#include <stddef.h>
+#include <string.h>
+
+/* Timestamps autour du composite */
+enum { VARIANT_STAMP_BEGIN = 0, VARIANT_STAMP_END, VARIANT_STAMP_COUNT };
+
+/* Une frame au moins entre le lancement et la lecture du statut : le driver
+ * compile pendant ce temps */
+enum { VARIANT_MIN_WAIT_FRAMES = 1 };
+
+/* Un nom par bit de POSTPROCESS_VARIANT_KEY_MASK (cf. PostProcessEffect) */
+static const char* const VARIANT_EFFECT_NAMES[POSTPROCESS_VARIANT_KEY_BITS] = {
+    "vignette", "grain",    "exposure",  "chrom_abbr",
+    "bloom",    "grading",  "dof",       "dof_debug",
+    "auto_exp", "exp_debug", "motion_blur", "mb_debug",
+    "lut"};
+
+unsigned int postprocess_variant_key(unsigned int active_effects)
+{
+	return active_effects & POSTPROCESS_VARIANT_KEY_MASK;
+}
+
+void postprocess_variant_defines(unsigned int key, char* out, size_t size)
+{
+	(void)safe_snprintf(out, size, "#define POSTFX_VARIANT_MASK 0x%03xu\n",
+	                    key);
+}
+
+void postprocess_variant_name(unsigned int key, char* out, size_t size)
+{
+	if (size == 0) {
+		return;
+	}
+	out[0] = '\0';
+	if (key == 0) {
+		(void)safe_snprintf(out, size, "none");
+		return;
+	}
+
+	size_t used = 0;
+	for (int bit = 0; bit < POSTPROCESS_VARIANT_KEY_BITS; bit++) {
+		if ((key & (1U << (unsigned int)bit)) == 0) {
+			continue;
+		}
+		if (!safe_snprintf(out + used, size - used, "%s%s",
+		                   used > 0 ? "+" : "",
+		                   VARIANT_EFFECT_NAMES[bit])) {
+			return; /* Tronqué */
+		}
+		used += strlen(out + used);
+	}
+}
+
+void postprocess_variants_init(PostProcessVariants* variants)
+{
+	*variants = (PostProcessVariants){0};
+	variants->enabled = 1;
+	variants->uber.state = POSTPROCESS_VARIANT_READY;
+	variants->compute.state = POSTPROCESS_VARIANT_READY;
+	variants->tiled.state = POSTPROCESS_VARIANT_READY;
+}
+
+static PostProcessVariant* variants_find(PostProcessVariants* variants,
+                                         unsigned int key)
+{
+	for (int i = 0; i < variants->count; i++) {
+		if (variants->entries[i].key == key) {
+			return &variants->entries[i];
+		}
+	}
+	return NULL;
+}
+
+static PostProcessVariant* variants_start(PostProcessVariants* variants,
+                                          unsigned int key)
+{
+	if (variants->count == POSTPROCESS_MAX_VARIANTS) {
+		return NULL;
+	}
+
+	char defines[POSTPROCESS_VARIANT_DEFINES_SIZE];
+	char name[POSTPROCESS_VARIANT_NAME_SIZE];
+	postprocess_variant_defines(key, defines, sizeof(defines));
+	postprocess_variant_name(key, name, sizeof(name));
+
+	PostProcessVariant* entry = &variants->entries[variants->count++];
+	*entry = (PostProcessVariant){0};
+	entry->key = key;
+	entry->pending_program = shader_program_begin(
+	    "shaders/postprocess.vert", "shaders/postprocess.frag", defines);
+	entry->state = entry->pending_program ? POSTPROCESS_VARIANT_COMPILING
+	                                      : POSTPROCESS_VARIANT_FAILED;
+
+	LOG_INFO("suckless-ogl.postprocess",
+	         "Compiling postprocess variant 0x%03x [%s]", key, name);
+	if (variants->count == POSTPROCESS_MAX_VARIANTS) {
+		LOG_WARN("suckless-ogl.postprocess",
+		         "Variant cache full (%d): new effect masks will use "
+		         "the uber-shader",
+		         POSTPROCESS_MAX_VARIANTS);
+	}
+	return entry;
+}
+
+/* Finalise les variantes dont la compilation est terminée */
+static void variants_poll(PostProcessVariants* variants)
+{
+	for (int i = 0; i < variants->count; i++) {
+		PostProcessVariant* entry = &variants->entries[i];
+		if (entry->state != POSTPROCESS_VARIANT_COMPILING ||
+		    entry->frames_waited++ < VARIANT_MIN_WAIT_FRAMES ||
+		    !shader_program_is_ready(entry->pending_program)) {
+			continue;
+		}
+
+		char name[POSTPROCESS_VARIANT_NAME_SIZE];
+		char label[POSTPROCESS_VARIANT_NAME_SIZE + 32];
+		postprocess_variant_name(entry->key, name, sizeof(name));
+		(void)safe_snprintf(label, sizeof(label),
+		                    "shaders/postprocess.frag [%s]", name);
+
+		entry->shader =
+		    shader_program_finish(entry->pending_program, label);
+		entry->pending_program = 0;
+		if (entry->shader) {
+			entry->state = POSTPROCESS_VARIANT_READY;
+			LOG_INFO("suckless-ogl.postprocess",
+			         "Postprocess variant 0x%03x ready after %d "
+			         "frames",
+			         entry->key, entry->frames_waited);
+		} else {
+			entry->state = POSTPROCESS_VARIANT_FAILED;
+			LOG_ERROR("suckless-ogl.postprocess",
+			          "Postprocess variant 0x%03x failed, keeping "
+			          "the uber-shader",
+			          entry->key);
+		}
+	}
+}
+
+Shader* postprocess_variants_select(PostProcessVariants* variants,
+                                    unsigned int active_effects,
+                                    Shader* uber)
+{
+	variants->selected = &variants->uber;
+	variants_poll(variants);
+	if (!variants->enabled || !uber) {
+		return uber;
+	}
+
+	const unsigned int key = postprocess_variant_key(active_effects);
+	PostProcessVariant* entry = variants_find(variants, key);
+	if (!entry) {
+		entry = variants_start(variants, key);
+	}
+	if (!entry || entry->state != POSTPROCESS_VARIANT_READY) {
+		return uber; /* Repli pendant la compilation */
+	}
+
+	variants->selected = entry;
+	return entry->shader;
+}
+
+void postprocess_variants_select_compute(PostProcessVariants* variants,
+                                         int tiled)
+{
+	variants->selected = tiled ? &variants->tiled : &variants->compute;
+}
+
+/* Crédite les mesures revenues, sans attendre les autres */
+static void variants_collect(PostProcessVariants* variants)
+{
+	GLuint64 stamps[VARIANT_STAMP_COUNT];
+	int slot = 0;
+	while ((slot = gpu_timestamp_ring_try_read(&variants->timestamps,
+	                                           stamps, NULL)) >= 0) {
+		PostProcessVariant* owner = variants->query_owner[slot];
+		variants->query_owner[slot] = NULL;
+		if (!owner) {
+			continue;
+		}
+		owner->gpu_ms_sum +=
+		    (double)(stamps[VARIANT_STAMP_END] -
+		             stamps[VARIANT_STAMP_BEGIN]) /
+		    NS_PER_MS;
+		owner->gpu_samples++;
+	}
+}
+
+void postprocess_variants_begin_timing(PostProcessVariants* variants)
+{
+	variants->timing = 0;
+	if (!gpu_timestamp_ring_init(&variants->timestamps,
+	                             VARIANT_STAMP_COUNT)) {
+		return;
+	}
+	variants_collect(variants);
+	if (!variants->selected) {
+		return;
+	}
+
+	/* Un slot encore en vol (GPU en retard) est abandonné */
+	gpu_timestamp_ring_begin(&variants->timestamps);
+	variants->query_owner[variants->timestamps.slot] = variants->selected;
+	gpu_timestamp_ring_stamp(&variants->timestamps, VARIANT_STAMP_BEGIN);
+	variants->timing = 1;
+}
+
+void postprocess_variants_end_timing(PostProcessVariants* variants)
+{
+	if (!variants->timing) {
+		return;
+	}
+	gpu_timestamp_ring_stamp(&variants->timestamps, VARIANT_STAMP_END);
+	gpu_timestamp_ring_end(&variants->timestamps, 1);
+	variants->timing = 0;
+}
+
+static void variants_report_one(PostProcessVariant* entry, const char* name)
+{
+	if (entry->gpu_samples == 0) {
+		return;
+	}
+	LOG_INFO("suckless-ogl.postprocess",
+	         "Composite %s: %.3f ms GPU (%d frames)", name,
+	         entry->gpu_ms_sum / (double)entry->gpu_samples,
+	         entry->gpu_samples);
+	entry->gpu_ms_sum = 0.0;
+	entry->gpu_samples = 0;
+}
+
+void postprocess_variants_report(PostProcessVariants* variants)
+{
+	variants_report_one(&variants->uber, "uber-shader");
+	variants_report_one(&variants->compute, "compute (shared tile)");
+	variants_report_one(&variants->tiled, "compute (tile classes)");
+	for (int i = 0; i < variants->count; i++) {
+		PostProcessVariant* entry = &variants->entries[i];
+		char name[POSTPROCESS_VARIANT_NAME_SIZE];
+		char label[POSTPROCESS_VARIANT_NAME_SIZE + 32];
+		postprocess_variant_name(entry->key, name, sizeof(name));
+		(void)safe_snprintf(label, sizeof(label), "variant 0x%03x [%s]",
+		                    entry->key, name);
+		variants_report_one(entry, label);
+	}
+}
+
+void postprocess_variants_cleanup(PostProcessVariants* variants)
+{
+	gpu_timestamp_ring_cleanup(&variants->timestamps);
+	for (int i = 0; i < variants->count; i++) {
+		PostProcessVariant* entry = &variants->entries[i];
+		if (entry->pending_program) {
+			glDeleteProgram(entry->pending_program);
+		}
+		shader_destroy(entry->shader);
+	}
+	*variants = (PostProcessVariants){0};
+}
@@ -0,0 +1,222 @@
+#include "render_target_pool.h"
+
+#include "gl_common.h"
+#include "log.h"
+#include <stddef.h>
+#include <string.h>
+
+void render_target_pool_init(RenderTargetPool* pool)
+{
+	*pool = (RenderTargetPool){0};
+}
+
+size_t render_target_format_bytes(GLenum format)
+{
+	switch (format) {
+	case GL_RGBA32F:
+		return 16;
+	case GL_RGBA16F:
+		return 8;
+	case GL_RG16F:
+	case GL_R11F_G11F_B10F:
+	case GL_RGBA8:
+	case GL_R32F:
+	case GL_DEPTH_COMPONENT32F:
+		return 4;
+	case GL_R16F:
+	case GL_RG8:
+		return 2;
+	case GL_R8:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+static int owner_equal(const char* lhs, const char* rhs)
+{
+	if (!lhs || !rhs) {
+		return lhs == rhs;
+	}
+	return lhs == rhs || strcmp(lhs, rhs) == 0;
+}
+
+static RenderTarget* pool_find_free(RenderTargetPool* pool, int width,
+                                    int height, GLenum format)
+{
+	for (int i = 0; i < pool->count; i++) {
+		RenderTarget* target = &pool->targets[i];
+		if (!target->owner && target->width == width &&
+		    target->height == height && target->format == format) {
+			return target;
+		}
+	}
+	return NULL;
+}
+
+static void pool_destroy(RenderTargetPool* pool, int index)
+{
+	glDeleteTextures(1, &pool->targets[index].texture);
+	pool->targets[index] = pool->targets[pool->count - 1];
+	pool->targets[pool->count - 1] = (RenderTarget){0};
+	pool->count--;
+	pool->changed = 1;
+}
+
+GLuint render_target_pool_acquire(RenderTargetPool* pool, int width,
+                                  int height, GLenum format, GLenum filter,
+                                  const char* owner)
+{
+	if (width < 1) {
+		width = 1;
+	}
+	if (height < 1) {
+		height = 1;
+	}
+
+	RenderTarget* target = pool_find_free(pool, width, height, format);
+	if (target) {
+		pool->reused++;
+	} else {
+		if (pool->count == RENDER_TARGET_POOL_MAX) {
+			LOG_ERROR("suckless-ogl.targets",
+			          "Render target pool full (%d targets)",
+			          RENDER_TARGET_POOL_MAX);
+			return 0;
+		}
+		target = &pool->targets[pool->count++];
+		*target = (RenderTarget){0};
+		target->width = width;
+		target->height = height;
+		target->format = format;
+		target->bytes = (size_t)width * (size_t)height *
+		                render_target_format_bytes(format);
+
+		glGenTextures(1, &target->texture);
+		glBindTexture(GL_TEXTURE_2D, target->texture);
+		glTexStorage2D(GL_TEXTURE_2D, 1, format, width, height);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
+		                GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,
+		                GL_CLAMP_TO_EDGE);
+		pool->created++;
+		pool->changed = 1;
+	}
+
+	/* Le filtre et le nom suivent l'emprunteur, pas la cible */
+	glBindTexture(GL_TEXTURE_2D, target->texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (GLint)filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (GLint)filter);
+	glObjectLabel(GL_TEXTURE, target->texture, -1, owner);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	target->owner = owner;
+	return target->texture;
+}
+
+void render_target_pool_release(RenderTargetPool* pool, GLuint texture)
+{
+	if (texture == 0) {
+		return;
+	}
+	for (int i = 0; i < pool->count; i++) {
+		RenderTarget* target = &pool->targets[i];
+		if (target->texture == texture) {
+			target->owner = NULL;
+			target->last_used = pool->frame;
+			return;
+		}
+	}
+	LOG_WARN("suckless-ogl.targets",
+	         "Released texture %u does not belong to the pool", texture);
+}
+
+void render_target_pool_begin_frame(RenderTargetPool* pool)
+{
+	pool->frame++;
+	for (int i = pool->count - 1; i >= 0; i--) {
+		const RenderTarget* target = &pool->targets[i];
+		if (!target->owner && pool->frame - target->last_used >
+		                          RENDER_TARGET_POOL_IDLE_FRAMES) {
+			pool_destroy(pool, i);
+		}
+	}
+}
+
+void render_target_pool_trim(RenderTargetPool* pool)
+{
+	for (int i = pool->count - 1; i >= 0; i--) {
+		if (!pool->targets[i].owner) {
+			pool_destroy(pool, i);
+		}
+	}
+}
+
+size_t render_target_pool_bytes(const RenderTargetPool* pool,
+                                const char* owner)
+{
+	size_t bytes = 0;
+	for (int i = 0; i < pool->count; i++) {
+		if (owner_equal(pool->targets[i].owner, owner)) {
+			bytes += pool->targets[i].bytes;
+		}
+	}
+	return bytes;
+}
+
+static int usage_slot(RenderTargetUsage* usage, int count, int max_usage,
+                      const char* owner)
+{
+	for (int i = 0; i < count; i++) {
+		if (owner_equal(usage[i].owner, owner)) {
+			return i;
+		}
+	}
+	if (count == max_usage) {
+		return -1;
+	}
+	usage[count] = (RenderTargetUsage){.owner = owner};
+	return count;
+}
+
+int render_target_pool_usage(const RenderTargetPool* pool,
+                             RenderTargetUsage* usage, int max_usage)
+{
+	int count = 0;
+	size_t free_bytes = 0;
+	int free_targets = 0;
+
+	for (int i = 0; i < pool->count; i++) {
+		const RenderTarget* target = &pool->targets[i];
+		if (!target->owner) {
+			free_bytes += target->bytes;
+			free_targets++;
+			continue;
+		}
+		const int slot =
+		    usage_slot(usage, count, max_usage, target->owner);
+		if (slot < 0) {
+			continue;
+		}
+		if (slot == count) {
+			count++;
+		}
+		usage[slot].bytes += target->bytes;
+		usage[slot].targets++;
+	}
+
+	if (free_targets > 0 && count < max_usage) {
+		usage[count++] = (RenderTargetUsage){.owner = NULL,
+		                                     .bytes = free_bytes,
+		                                     .targets = free_targets};
+	}
+	return count;
+}
+
+void render_target_pool_cleanup(RenderTargetPool* pool)
+{
+	for (int i = 0; i < pool->count; i++) {
+		glDeleteTextures(1, &pool->targets[i].texture);
+	}
+	*pool = (RenderTargetPool){0};
+}
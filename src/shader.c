@@ -33,6 +33,8 @@ enum { MAX_SHADER_NAME_LEN = 256 };
 
 enum { SHADER_LABEL_BUFFER_SIZE = 512 };
 
+enum { UNIFORM_NAME_BUFFER_SIZE = 128 };
+
 /* -------------------------------------------------------------------------
  * Internal Include Processing (Chunk-List / Single-Pass Allocation)
  * ------------------------------------------------------------------------- */
@@ -63,6 +65,11 @@ enum { PATH_BUFFER_SIZE = 256 };
 enum { RESOLVED_PATH_BUFFER_SIZE = 512 };
 enum { HEADER_TAG_LEN = 7 };
 
+/* KHR_parallel_shader_compile (absent des en-têtes glad 4.4 core) */
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 /* Forward declaration */
 static bool process_source(IncludeContext* ctx, const char* current_file_src,
                            const char* current_file_path);
@@ -364,9 +371,56 @@ char* shader_read_file(const char* path)
 	return TRANSFER_OWNERSHIP(final_src);
 }
 
-GLuint shader_compile(const char* path, GLenum type)
+char* shader_read_file_with_defines(const char* path, const char* defines)
 {
-	char* src = shader_read_file(path);
+	CLEANUP_FREE char* src = shader_read_file(path);
+	if (!src || !defines || *defines == '\0') {
+		return TRANSFER_OWNERSHIP(src);
+	}
+
+	/* GLSL impose #version en tête : les #define viennent juste après */
+	size_t head = 0;
+	const char* version = strstr(src, "#version");
+	if (version) {
+		const char* eol = strchr(version, '\n');
+		head = eol ? (size_t)(eol + 1 - src) : strlen(src);
+	}
+
+	const size_t src_len = strlen(src);
+	const size_t defines_len = strlen(defines);
+	const int needs_newline = defines[defines_len - 1] != '\n';
+	const int version_newline = head > 0 && src[head - 1] != '\n';
+	const size_t total = src_len + defines_len + (size_t)needs_newline +
+	                     (size_t)version_newline;
+
+	CLEANUP_FREE char* out = safe_calloc(total + 1, 1);
+	if (!out) {
+		return NULL;
+	}
+	char* wptr = out;
+	safe_memcpy(wptr, total + 1, src, head);
+	wptr += head;
+	if (version_newline) {
+		*wptr++ = '\n';
+	}
+	safe_memcpy(wptr, total + 1 - (size_t)(wptr - out), defines,
+	            defines_len);
+	wptr += defines_len;
+	if (needs_newline) {
+		*wptr++ = '\n';
+	}
+	safe_memcpy(wptr, total + 1 - (size_t)(wptr - out), src + head,
+	            src_len - head);
+	wptr += src_len - head;
+	*wptr = '\0';
+
+	return TRANSFER_OWNERSHIP(out);
+}
+
+static GLuint shader_compile_with_defines(const char* path, GLenum type,
+                                          const char* defines)
+{
+	char* src = shader_read_file_with_defines(path, defines);
 	if (!src) {
 		LOG_ERROR("suckless-ogl.shader",
 		          "Failed to read shader file: %s", path);
@@ -392,6 +446,11 @@ GLuint shader_compile(const char* path, GLenum type)
 	return shader;
 }
 
+GLuint shader_compile(const char* path, GLenum type)
+{
+	return shader_compile_with_defines(path, type, NULL);
+}
+
 GLuint shader_load_program(const char* vertex_path, const char* fragment_path)
 {
 	GLuint vertex_shader = shader_compile(vertex_path, GL_VERTEX_SHADER);
@@ -435,9 +494,11 @@ GLuint shader_load_program(const char* vertex_path, const char* fragment_path)
 	return program;
 }
 
-GLuint shader_load_compute(const char* compute_path)
+static GLuint shader_link_compute(const char* compute_path,
+                                  const char* defines)
 {
-	GLuint compute_shader = shader_compile(compute_path, GL_COMPUTE_SHADER);
+	GLuint compute_shader = shader_compile_with_defines(
+	    compute_path, GL_COMPUTE_SHADER, defines);
 	if (compute_shader == 0) {
 		return 0;
 	}
@@ -466,6 +527,11 @@ GLuint shader_load_compute(const char* compute_path)
 	return program;
 }
 
+GLuint shader_load_compute(const char* compute_path)
+{
+	return shader_link_compute(compute_path, NULL);
+}
+
 /* -------------------------------------------------------------------------
  * New Generic Shader API Implementation
  * ------------------------------------------------------------------------- */
@@ -553,6 +619,115 @@ Shader* shader_load_compute_program(const char* compute_path)
 	return shader_create_from_program(program, compute_path);
 }
 
+Shader* shader_load_compute_program_with_defines(const char* compute_path,
+                                                 const char* defines,
+                                                 const char* name)
+{
+	GLuint program = shader_link_compute(compute_path, defines);
+	return shader_create_from_program(program, name);
+}
+
+static int shader_has_parallel_compile(void)
+{
+	static int supported = -1;
+	if (supported >= 0) {
+		return supported;
+	}
+
+	supported = 0;
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (GLint i = 0; i < count; i++) {
+		const char* ext =
+		    (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+		if (!ext) {
+			continue;
+		}
+		if (strcmp(ext, "GL_KHR_parallel_shader_compile") == 0 ||
+		    strcmp(ext, "GL_ARB_parallel_shader_compile") == 0) {
+			supported = 1;
+			break;
+		}
+	}
+	LOG_INFO("suckless-ogl.shader", "Parallel shader compile: %s",
+	         supported ? "available" : "unavailable");
+	return supported;
+}
+
+GLuint shader_program_begin(const char* vertex_path,
+                            const char* fragment_path, const char* defines)
+{
+	const char* paths[2] = {vertex_path, fragment_path};
+	const GLenum types[2] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+	char* sources[2] = {NULL, NULL};
+
+	for (int i = 0; i < 2; i++) {
+		sources[i] = shader_read_file_with_defines(paths[i], defines);
+		if (!sources[i]) {
+			LOG_ERROR("suckless-ogl.shader",
+			          "Failed to read shader file: %s", paths[i]);
+			free(sources[0]);
+			return 0;
+		}
+	}
+
+	/* Aucune requête de statut ici : elle forcerait la fin de la
+	 * compilation */
+	GLuint program = glCreateProgram();
+	for (int i = 0; i < 2; i++) {
+		GLuint shader = glCreateShader(types[i]);
+		glShaderSource(shader, 1, (const char**)&sources[i], NULL);
+		glCompileShader(shader);
+		glAttachShader(program, shader);
+		/* Libéré avec le programme, son log reste lisible d'ici là */
+		glDeleteShader(shader);
+		free(sources[i]);
+	}
+	glLinkProgram(program);
+	return program;
+}
+
+int shader_program_is_ready(GLuint program)
+{
+	if (!shader_has_parallel_compile()) {
+		/* Sans l'extension, la lecture du statut peut bloquer : au
+		 * pire une fois, au moment du finish */
+		return 1;
+	}
+	GLint done = 0;
+	glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &done);
+	return done != 0;
+}
+
+Shader* shader_program_finish(GLuint program, const char* name)
+{
+	int success = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (success != 0) {
+		return shader_create_from_program(program, name);
+	}
+
+	char log[INFO_LOG_SIZE];
+	GLuint shaders[2] = {0, 0};
+	GLsizei shader_count = 0;
+	glGetAttachedShaders(program, 2, &shader_count, shaders);
+	for (GLsizei i = 0; i < shader_count; i++) {
+		glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &success);
+		if (success == 0) {
+			glGetShaderInfoLog(shaders[i], INFO_LOG_SIZE, NULL,
+			                   log);
+			LOG_ERROR("suckless-ogl.shader",
+			          "Shader compilation error (%s):\n%s", name,
+			          log);
+		}
+	}
+	glGetProgramInfoLog(program, INFO_LOG_SIZE, NULL, log);
+	LOG_ERROR("suckless-ogl.shader", "Shader linking error (%s):\n%s",
+	          name, log);
+	glDeleteProgram(program);
+	return NULL;
+}
+
 void shader_destroy(Shader* shader)
 {
 	if (!shader) {
@@ -654,3 +829,16 @@ void shader_set_mat4(Shader* shader, const char* name, const float* val)
 		glUniformMatrix4fv(loc, 1, GL_FALSE, val);
 	}
 }
+
+void shader_set_vec4_array(Shader* shader, const char* name,
+                           const float* val, int count)
+{
+	char element[UNIFORM_NAME_BUFFER_SIZE];
+	if (!safe_snprintf(element, sizeof(element), "%s[0]", name)) {
+		return;
+	}
+	GLint loc = shader_get_uniform_location(shader, element);
+	if (loc != -1) {
+		glUniform4fv(loc, count, val);
+	}
+}
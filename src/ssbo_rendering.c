@@ -4,17 +4,20 @@
 #include "log.h"
 #include <stddef.h>
 
-void ssbo_group_init(SSBOGroup* group, const SphereInstanceSSBO* data,
-                     int count)
+static void ssbo_group_create(SSBOGroup* group, InstanceFormat format,
+                              const void* data, size_t stride, int count)
 {
 	group->instance_count = count;
+	group->format = format;
 	group->vao = 0;
+	group->stream = NULL;
+	group->index_type = GL_UNSIGNED_INT;
 
 	/* Création du SSBO */
 	glGenBuffers(1, &group->ssbo);
 	glBindBuffer(GL_SHADER_STORAGE_BUFFER, group->ssbo);
 	glBufferData(GL_SHADER_STORAGE_BUFFER,
-	             (GLsizeiptr)(count * sizeof(SphereInstanceSSBO)), data,
+	             (GLsizeiptr)((size_t)count * stride), data,
 	             GL_STATIC_DRAW);
 
 	/* IMPORTANT : Binding au point 0 */
@@ -29,10 +32,39 @@ void ssbo_group_init(SSBOGroup* group, const SphereInstanceSSBO* data,
 
 	LOG_INFO("suckless-ogl.ssbo",
 	         "SSBO initialized: %d instances (%zu bytes), buffer ID: %u",
-	         count, count * sizeof(SphereInstanceSSBO), group->ssbo);
+	         count, (size_t)count * stride, group->ssbo);
 }
 
-void ssbo_group_bind_mesh(SSBOGroup* group, GLuint vbo, GLuint nbo, GLuint ebo)
+void ssbo_group_init(SSBOGroup* group, const SphereInstanceSSBO* data,
+                     int count)
+{
+	ssbo_group_create(group, INSTANCE_FORMAT_FULL, data,
+	                  sizeof(SphereInstanceSSBO), count);
+}
+
+void ssbo_group_init_compact(SSBOGroup* group,
+                             const SphereInstanceCompact* data, int count)
+{
+	ssbo_group_create(group, INSTANCE_FORMAT_COMPACT, data,
+	                  sizeof(SphereInstanceCompact), count);
+}
+
+void ssbo_group_init_stream(SSBOGroup* group, InstanceStream* stream,
+                            int count)
+{
+	group->instance_count = count;
+	group->format = INSTANCE_FORMAT_FULL;
+	group->vao = 0;
+	group->stream = stream;
+	group->index_type = GL_UNSIGNED_INT;
+	group->ssbo = stream->buffer;
+
+	LOG_INFO("suckless-ogl.ssbo",
+	         "SSBO streaming: %d instances, %d regions, buffer ID: %u",
+	         count, INSTANCE_STREAM_FRAMES, group->ssbo);
+}
+
+void ssbo_group_bind_mesh(SSBOGroup* group, const IcosphereMesh* mesh)
 {
 	/* Si on régénère l'icosphère, l'ancien VAO n'est plus valide */
 	if (group->vao != 0) {
@@ -43,18 +75,9 @@ void ssbo_group_bind_mesh(SSBOGroup* group, GLuint vbo, GLuint nbo, GLuint ebo)
 	glGenVertexArrays(1, &group->vao);
 	glBindVertexArray(group->vao);
 
-	/* Géométrie de base (positions) */
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-	glEnableVertexAttribArray(0);
-
-	/* Normales */
-	glBindBuffer(GL_ARRAY_BUFFER, nbo);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-	glEnableVertexAttribArray(1);
-
-	/* Indices */
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+	/* Positions et indices (la normale est recalculée par le shader) */
+	icosphere_mesh_setup_vao(mesh);
+	group->index_type = mesh->index_type;
 
 	glBindVertexArray(0);
 }
@@ -62,20 +85,28 @@ void ssbo_group_bind_mesh(SSBOGroup* group, GLuint vbo, GLuint nbo, GLuint ebo)
 void ssbo_group_draw(SSBOGroup* group, size_t index_count)
 {
 	/* IMPORTANT : Re-bind le SSBO avant le draw (au cas où) */
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, group->ssbo);
+	if (group->stream) {
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, group->ssbo,
+		                  instance_stream_offset(group->stream),
+		                  (GLsizeiptr)group->stream->region_size);
+	} else {
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, group->ssbo);
+	}
 
 	glBindVertexArray(group->vao);
 	glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)index_count,
-	                        GL_UNSIGNED_INT, 0, group->instance_count);
+	                        group->index_type, 0, group->instance_count);
 	glBindVertexArray(0);
 }
 
 void ssbo_group_cleanup(SSBOGroup* group)
 {
-	if (group->ssbo) {
+	/* Le buffer d'un stream appartient au stream */
+	if (group->ssbo && !group->stream) {
 		glDeleteBuffers(1, &group->ssbo);
-		group->ssbo = 0;
 	}
+	group->ssbo = 0;
+	group->stream = NULL;
 	if (group->vao) {
 		glDeleteVertexArrays(1, &group->vao);
 		group->vao = 0;
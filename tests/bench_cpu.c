@@ -0,0 +1,194 @@
+// tests/bench_cpu.c
+/*
+ * Benchmarks CPU (hors ctest : mesures dépendantes de la machine).
+ *
+ *   bench_cpu [threads_max]
+ *
+ * threads_max : plafond du balayage de threads, par défaut le nombre de
+ * coeurs en ligne (sysconf ignore les quotas cgroup d'un conteneur).
+ */
+#include "icosphere.h"
+#include "job_system.h"
+#include "perf_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+enum {
+	BENCH_RUNS = 5, /* Meilleur temps sur BENCH_RUNS exécutions */
+	TREE_DEPTH = 14,
+	TREE_LEAF_WORK = 2000,
+	ICOSPHERE_MAX_LEVEL = 7
+};
+
+typedef struct {
+	JobSystem* system;
+	int depth;
+	long* leaves;
+} TreeNode;
+
+static void tree_job(void* user_data)
+{
+	TreeNode* node = user_data;
+
+	if (node->depth == 0) {
+		volatile unsigned acc = 0;
+		for (unsigned i = 0; i < TREE_LEAF_WORK; i++) {
+			acc += i * i;
+		}
+		__atomic_fetch_add(node->leaves, 1L, __ATOMIC_RELAXED);
+		return;
+	}
+
+	JobCounter counter = {0};
+	TreeNode children[2] = {
+	    {node->system, node->depth - 1, node->leaves},
+	    {node->system, node->depth - 1, node->leaves},
+	};
+	job_system_submit(node->system, tree_job, &children[0],
+	                  JOB_PRIORITY_NORMAL, &counter);
+	job_system_submit(node->system, tree_job, &children[1],
+	                  JOB_PRIORITY_NORMAL, &counter);
+	job_system_wait(node->system, &counter);
+}
+
+static long run_tree(JobSystem* system, int depth)
+{
+	long leaves = 0;
+	TreeNode root = {system, depth, &leaves};
+	JobCounter counter = {0};
+	job_system_submit(system, tree_job, &root, JOB_PRIORITY_NORMAL,
+	                  &counter);
+	job_system_wait(system, &counter);
+	return leaves;
+}
+
+/* Scalabilité : même arbre avec 1, 2, 4... threads (contention des deques) */
+static void bench_task_tree(int threads_max)
+{
+	double single_ms = 0.0;
+
+	printf("task tree (%ld leaves, best of %d)\n", 1L << TREE_DEPTH,
+	       BENCH_RUNS);
+	for (int threads = 1; threads <= threads_max; threads *= 2) {
+		JobSystem* system = job_system_create(threads - 1);
+		if (!system) {
+			return;
+		}
+
+		double best_ms = 0.0;
+		for (int run = 0; run < BENCH_RUNS; run++) {
+			PERF_MEASURE_MS(tree_ms)
+			{
+				(void)run_tree(system, TREE_DEPTH);
+			}
+			if (run == 0 || tree_ms < best_ms) {
+				best_ms = tree_ms;
+			}
+		}
+		if (threads == 1) {
+			single_ms = best_ms;
+		}
+
+		JobSystemStats stats;
+		job_system_stats(system, &stats);
+		printf("  %2d threads %8.3f ms  x%.2f  %ld steals/run\n",
+		       threads, best_ms,
+		       best_ms > 0.0 ? single_ms / best_ms : 0.0,
+		       stats.stolen / BENCH_RUNS);
+
+		job_system_destroy(system);
+	}
+}
+
+/* Génération d'icosphère par niveau : forme fermée séquentielle puis
+ * découpée en jobs */
+static void bench_icosphere(int threads_max)
+{
+	JobSystem* jobs = job_system_create(threads_max - 1);
+	if (!jobs) {
+		return;
+	}
+
+	IcosphereGeometry geom;
+	icosphere_init(&geom);
+
+	printf("icosphere (best of %d)\n", BENCH_RUNS);
+	for (int level = 0; level <= ICOSPHERE_MAX_LEVEL; level++) {
+		double serial_best = 0.0;
+		double parallel_best = 0.0;
+		for (int run = 0; run < BENCH_RUNS; run++) {
+			PERF_MEASURE_MS(serial_ms)
+			{
+				icosphere_generate(&geom, level);
+			}
+			PERF_MEASURE_MS(parallel_ms)
+			{
+				icosphere_generate_parallel(&geom, level, jobs);
+			}
+			if (run == 0 || serial_ms < serial_best) {
+				serial_best = serial_ms;
+			}
+			if (run == 0 || parallel_ms < parallel_best) {
+				parallel_best = parallel_ms;
+			}
+		}
+
+		printf("  level %d (%7zu vertices) serial %8.3f ms  "
+		       "parallel (%d threads) %8.3f ms\n",
+		       level, geom.vertices.size, serial_best,
+		       job_system_thread_count(jobs), parallel_best);
+	}
+
+	icosphere_free(&geom);
+	job_system_destroy(jobs);
+}
+
+/* Cache de sommets : ACMR/ATVR avant et après icosphere_optimize */
+static void bench_mesh_optimize(void)
+{
+	IcosphereGeometry geom;
+	icosphere_init(&geom);
+
+	printf("icosphere_optimize\n");
+	for (int level = 0; level <= ICOSPHERE_MAX_LEVEL; level++) {
+		icosphere_generate(&geom, level);
+
+		MeshCacheStats before;
+		MeshCacheStats after;
+		int optimized = 0;
+		PERF_MEASURE_MS(optimize_ms)
+		{
+			optimized = icosphere_optimize(&geom, &before, &after);
+		}
+		if (!optimized) {
+			printf("  level %d: optimization failed\n", level);
+			continue;
+		}
+
+		printf("  level %d (%7zu triangles) ACMR %.3f -> %.3f  "
+		       "ATVR %.3f -> %.3f  (%.2f ms)\n",
+		       level, geom.indices.size / 3, before.acmr, after.acmr,
+		       before.atvr, after.atvr, optimize_ms);
+	}
+
+	icosphere_free(&geom);
+}
+
+int main(int argc, char** argv)
+{
+	int threads_max = job_system_cpu_count();
+	if (argc > 1) {
+		threads_max = atoi(argv[1]);
+		if (threads_max < 1) {
+			threads_max = 1;
+		}
+		if (threads_max > JOB_SYSTEM_MAX_WORKERS + 1) {
+			threads_max = JOB_SYSTEM_MAX_WORKERS + 1;
+		}
+	}
+
+	bench_task_tree(threads_max);
+	bench_icosphere(threads_max);
+	bench_mesh_optimize();
+	return 0;
+}
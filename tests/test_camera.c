@@ -191,6 +191,15 @@ void test_camera_rotation_smoothing(void)
 	                 fabs(cam.pitch_target - old_pitch));
 }
 
+void test_camera_projection_planes(void)
+{
+	mat4 proj;
+	glm_perspective(glm_rad(60.0F), 16.0F / 9.0F, 0.1F, 500.0F, proj);
+
+	TEST_ASSERT_FLOAT_WITHIN(1e-4F, 0.1F, camera_projection_near(proj));
+	TEST_ASSERT_FLOAT_WITHIN(0.5F, 500.0F, camera_projection_far(proj));
+}
+
 int main(void)
 {
 	UNITY_BEGIN();
@@ -206,5 +215,6 @@ int main(void)
 	RUN_TEST(test_camera_process_scroll_changes_position);
 	RUN_TEST(test_camera_head_bobbing_enabled_by_default);
 	RUN_TEST(test_camera_rotation_smoothing);
+	RUN_TEST(test_camera_projection_planes);
 	return UNITY_END();
 }
@@ -0,0 +1,109 @@
+// tests/test_deferred.c
+#include "deferred.h"
+#include "gl_common.h"
+#include "postprocess.h"
+#include "unity.h"
+
+static GLFWwindow* test_window = NULL;
+
+void setUp(void)
+{
+	if (!glfwInit()) {
+		return;
+	}
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	test_window = glfwCreateWindow(1, 1, "Test", NULL, NULL);
+	if (!test_window) {
+		glfwTerminate();
+		return;
+	}
+
+	glfwMakeContextCurrent(test_window);
+	gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+}
+
+void tearDown(void)
+{
+	if (test_window) {
+		glfwDestroyWindow(test_window);
+		test_window = NULL;
+	}
+	glfwTerminate();
+}
+
+static GLint attachment_name(GLuint fbo, GLenum attachment)
+{
+	GLint name = 0;
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glGetFramebufferAttachmentParameteriv(
+	    GL_FRAMEBUFFER, attachment, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME,
+	    &name);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	return name;
+}
+
+void test_deferred_gbuffer_footprint(void)
+{
+	/* RGBA8 albedo/AO + RG16 normal + RG8 metallic/roughness */
+	TEST_ASSERT_EQUAL_size_t(10, deferred_gbuffer_bytes_per_pixel());
+}
+
+void test_deferred_shares_scene_targets(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	PostProcess post = {0};
+	TEST_ASSERT_TRUE(postprocess_init(&post, 64, 48));
+
+	DeferredRenderer deferred = {0};
+	TEST_ASSERT_TRUE(deferred_init(&deferred, &post));
+
+	/* Velocity and depth are written in place, lighting lands in the
+	 * scene color target */
+	TEST_ASSERT_EQUAL_INT(
+	    (GLint)post.velocity_tex,
+	    attachment_name(deferred.gbuffer_fbo, GL_COLOR_ATTACHMENT1));
+	TEST_ASSERT_EQUAL_INT(
+	    (GLint)post.scene_depth_tex,
+	    attachment_name(deferred.gbuffer_fbo, GL_DEPTH_ATTACHMENT));
+	TEST_ASSERT_EQUAL_INT(
+	    (GLint)post.scene_color_tex,
+	    attachment_name(deferred.resolve_fbo, GL_COLOR_ATTACHMENT0));
+	/* The resolve samples depth: it must not be attached there */
+	TEST_ASSERT_EQUAL_INT(
+	    0, attachment_name(deferred.resolve_fbo, GL_DEPTH_ATTACHMENT));
+
+	GLint format = 0;
+	glBindTexture(GL_TEXTURE_2D, deferred.normal_tex);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT,
+	                         &format);
+	TEST_ASSERT_EQUAL_INT(GL_RG16, format);
+
+	/* Resizing the scene reallocates the borrowed targets */
+	postprocess_resize(&post, 128, 96);
+	TEST_ASSERT_TRUE(deferred_resize(&deferred, &post));
+	TEST_ASSERT_EQUAL_INT(128, deferred.width);
+	TEST_ASSERT_EQUAL_INT(96, deferred.height);
+	TEST_ASSERT_EQUAL_INT(
+	    (GLint)post.scene_depth_tex,
+	    attachment_name(deferred.gbuffer_fbo, GL_DEPTH_ATTACHMENT));
+
+	deferred_cleanup(&deferred);
+	TEST_ASSERT_EQUAL_UINT(0, deferred.gbuffer_fbo);
+	postprocess_cleanup(&post);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_deferred_gbuffer_footprint);
+	RUN_TEST(test_deferred_shares_scene_targets);
+	return UNITY_END();
+}
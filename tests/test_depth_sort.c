@@ -0,0 +1,101 @@
+// tests/test_depth_sort.c
+#include "depth_sort.h"
+#include "gl_common.h"
+#include "hybrid_rendering.h"
+#include "instanced_rendering.h"
+#include "unity.h"
+#include <cglm/cglm.h>
+
+static GLFWwindow* test_window = NULL;
+
+void setUp(void)
+{
+	if (!glfwInit()) {
+		return;
+	}
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	test_window = glfwCreateWindow(1, 1, "Test", NULL, NULL);
+	if (!test_window) {
+		glfwTerminate();
+		return;
+	}
+
+	glfwMakeContextCurrent(test_window);
+	gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+}
+
+void tearDown(void)
+{
+	if (test_window) {
+		glfwDestroyWindow(test_window);
+		test_window = NULL;
+	}
+	glfwTerminate();
+}
+
+void test_depth_sort_front_to_back(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	/* Far, behind camera, near, middle (camera at z = 5 looking at -z) */
+	static const vec3 POSITIONS[4] = {{0.0F, 0.0F, -400.0F},
+	                                  {0.0F, 0.0F, 50.0F},
+	                                  {0.0F, 0.0F, 0.0F},
+	                                  {1.0F, 0.0F, -40.0F}};
+	static const float EXPECTED_Z[3] = {0.0F, -40.0F, -400.0F};
+
+	SphereInstance instances[4] = {0};
+	for (int i = 0; i < 4; i++) {
+		glm_mat4_identity(instances[i].model);
+		glm_translate(instances[i].model, (float*)POSITIONS[i]);
+	}
+
+	InstancedGroup source;
+	instanced_group_init(&source, instances, 4);
+
+	DepthSortGroup group = {0};
+	TEST_ASSERT_TRUE(depth_sort_group_init(&group, source.instance_vbo, 4));
+
+	mat4 view;
+	mat4 proj;
+	glm_lookat((vec3){0.0F, 0.0F, 5.0F}, (vec3){0.0F, 0.0F, 0.0F},
+	           (vec3){0.0F, 1.0F, 0.0F}, view);
+	glm_perspective(glm_rad(60.0F), 1.0F, 0.1F, 1000.0F, proj);
+
+	depth_sort_group_sort(&group, view, proj, 60);
+	TEST_ASSERT_EQUAL_INT(3, depth_sort_group_read_count(&group));
+
+	SphereInstance sorted[3];
+	glBindBuffer(GL_ARRAY_BUFFER, group.sorted.instance_vbo);
+	glGetBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(sorted), sorted);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	for (int i = 0; i < 3; i++) {
+		TEST_ASSERT_EQUAL_FLOAT(EXPECTED_Z[i], sorted[i].model[3][2]);
+	}
+
+	/* The index count is forwarded untouched to the indirect command */
+	DrawElementsIndirectCommand command = {0};
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, group.command_buffer);
+	glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(command),
+	                   &command);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	TEST_ASSERT_EQUAL_UINT(60, command.count);
+
+	depth_sort_group_cleanup(&group);
+	instanced_group_cleanup(&source);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_depth_sort_front_to_back);
+	return UNITY_END();
+}
@@ -0,0 +1,111 @@
+#include "dynamic_resolution.h"
+#include "unity.h"
+
+enum { DRS_TEST_FRAMES = 300 };
+
+#define DRS_TEST_MIN 0.5F
+#define DRS_TEST_MAX 1.0F
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/* GPU simulé : coût proportionnel au nombre de pixels */
+static double simulated_gpu_ms(float full_res_ms, float scale)
+{
+	return (double)(full_res_ms * scale * scale);
+}
+
+static float run_frames(DynamicResolution* drs, float full_res_ms, int frames)
+{
+	for (int i = 0; i < frames; i++) {
+		dynamic_resolution_step(
+		    drs, simulated_gpu_ms(full_res_ms, drs->scale));
+	}
+	return drs->scale;
+}
+
+void test_drs_starts_at_max_scale(void)
+{
+	DynamicResolution drs;
+	dynamic_resolution_init(&drs, 10.0F, DRS_TEST_MIN, DRS_TEST_MAX);
+	TEST_ASSERT_EQUAL_FLOAT(DRS_TEST_MAX, drs.scale);
+	TEST_ASSERT_EQUAL_INT(0, drs.has_sample);
+}
+
+void test_drs_under_budget_stays_at_max(void)
+{
+	DynamicResolution drs;
+	dynamic_resolution_init(&drs, 10.0F, DRS_TEST_MIN, DRS_TEST_MAX);
+	TEST_ASSERT_EQUAL_FLOAT(DRS_TEST_MAX,
+	                        run_frames(&drs, 4.0F, DRS_TEST_FRAMES));
+}
+
+void test_drs_converges_to_budget(void)
+{
+	DynamicResolution drs;
+	dynamic_resolution_init(&drs, 10.0F, DRS_TEST_MIN, DRS_TEST_MAX);
+
+	/* 20 ms en natif, 10 ms visés : ~0.71 par axe */
+	const float scale = run_frames(&drs, 20.0F, DRS_TEST_FRAMES);
+	TEST_ASSERT_TRUE(scale < DRS_TEST_MAX);
+	const double gpu_ms = simulated_gpu_ms(20.0F, scale);
+	TEST_ASSERT_DOUBLE_WITHIN(1.0, 10.0, gpu_ms);
+
+	/* Charge retombée : retour à la résolution native */
+	TEST_ASSERT_EQUAL_FLOAT(DRS_TEST_MAX,
+	                        run_frames(&drs, 5.0F, DRS_TEST_FRAMES));
+}
+
+void test_drs_clamps_to_min_scale(void)
+{
+	DynamicResolution drs;
+	dynamic_resolution_init(&drs, 10.0F, DRS_TEST_MIN, DRS_TEST_MAX);
+	/* Même à l'échelle minimale le budget est dépassé */
+	TEST_ASSERT_EQUAL_FLOAT(DRS_TEST_MIN,
+	                        run_frames(&drs, 100.0F, DRS_TEST_FRAMES));
+}
+
+void test_drs_deadband_and_hysteresis_hold_scale(void)
+{
+	DynamicResolution drs;
+	dynamic_resolution_init(&drs, 10.0F, DRS_TEST_MIN, DRS_TEST_MAX);
+	drs.scale = 0.8F;
+	drs.integral = 0.64F;
+
+	/* Dans la zone morte : rien ne bouge */
+	for (int i = 0; i < DRS_TEST_FRAMES; i++) {
+		TEST_ASSERT_EQUAL_FLOAT(0.8F,
+		                        dynamic_resolution_step(&drs, 10.3));
+	}
+
+	/* Juste hors zone morte : l'écart reste sous DRS_SCALE_STEP au
+	 * premier pas, l'échelle appliquée ne change pas */
+	TEST_ASSERT_EQUAL_FLOAT(0.8F, dynamic_resolution_step(&drs, 10.6));
+}
+
+void test_drs_reset_restores_max(void)
+{
+	DynamicResolution drs;
+	dynamic_resolution_init(&drs, 10.0F, DRS_TEST_MIN, DRS_TEST_MAX);
+	run_frames(&drs, 100.0F, DRS_TEST_FRAMES);
+	dynamic_resolution_reset(&drs);
+	TEST_ASSERT_EQUAL_FLOAT(DRS_TEST_MAX, drs.scale);
+	TEST_ASSERT_EQUAL_FLOAT(DRS_TEST_MAX * DRS_TEST_MAX, drs.integral);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_drs_starts_at_max_scale);
+	RUN_TEST(test_drs_under_budget_stays_at_max);
+	RUN_TEST(test_drs_converges_to_budget);
+	RUN_TEST(test_drs_clamps_to_min_scale);
+	RUN_TEST(test_drs_deadband_and_hysteresis_hold_scale);
+	RUN_TEST(test_drs_reset_restores_max);
+	return UNITY_END();
+}
@@ -0,0 +1,297 @@
+#include "frame_graph.h"
+#include "unity.h"
+
+/* Compilation seule : aucun appel GL, pas de contexte nécessaire */
+
+static int culled_calls;
+
+void setUp(void)
+{
+	culled_calls = 0;
+}
+
+void tearDown(void)
+{
+}
+
+static void noop_pass(void* user)
+{
+	(void)user;
+}
+
+static void count_culled(void* user)
+{
+	(void)user;
+	culled_calls++;
+}
+
+static const FrameGraphPass* step_pass(const FrameGraph* graph, int step)
+{
+	return &graph->passes[graph->steps[step].pass];
+}
+
+void test_frame_graph_barrier_bits(void)
+{
+	TEST_ASSERT_EQUAL_UINT(
+	    GL_TEXTURE_FETCH_BARRIER_BIT,
+	    frame_graph_barrier_bits(FRAME_GRAPH_SAMPLED, FRAME_GRAPH_TEXTURE));
+	TEST_ASSERT_EQUAL_UINT(
+	    GL_COMMAND_BARRIER_BIT,
+	    frame_graph_barrier_bits(FRAME_GRAPH_INDIRECT, FRAME_GRAPH_BUFFER));
+	TEST_ASSERT_EQUAL_UINT(GL_BUFFER_UPDATE_BARRIER_BIT,
+	                       frame_graph_barrier_bits(FRAME_GRAPH_TRANSFER,
+	                                                FRAME_GRAPH_BUFFER));
+	TEST_ASSERT_EQUAL_UINT(GL_TEXTURE_UPDATE_BARRIER_BIT,
+	                       frame_graph_barrier_bits(FRAME_GRAPH_TRANSFER,
+	                                                FRAME_GRAPH_TEXTURE));
+}
+
+void test_frame_graph_culls_unread_and_disabled_passes(void)
+{
+	FrameGraph graph;
+	frame_graph_init(&graph);
+
+	const int used = frame_graph_add_resource(&graph, "Used",
+	                                          FRAME_GRAPH_TEXTURE, 0);
+	const int unused = frame_graph_add_resource(&graph, "Unused",
+	                                            FRAME_GRAPH_TEXTURE, 0);
+	const int screen = frame_graph_add_resource(&graph, "Screen",
+	                                            FRAME_GRAPH_TEXTURE, 1);
+
+	const int producer = frame_graph_add_pass(&graph, "Producer", noop_pass,
+	                                          count_culled, NULL);
+	frame_graph_write(&graph, producer, used, FRAME_GRAPH_IMAGE);
+	const int orphan = frame_graph_add_pass(&graph, "Orphan", noop_pass,
+	                                        count_culled, NULL);
+	frame_graph_write(&graph, orphan, unused, FRAME_GRAPH_IMAGE);
+	const int consumer = frame_graph_add_pass(&graph, "Consumer",
+	                                          noop_pass, NULL, NULL);
+	frame_graph_read(&graph, consumer, used, FRAME_GRAPH_SAMPLED);
+	frame_graph_write(&graph, consumer, screen, FRAME_GRAPH_ATTACHMENT);
+
+	TEST_ASSERT_EQUAL_INT(2, frame_graph_compile(&graph));
+	TEST_ASSERT_FALSE(graph.passes[orphan].live);
+	TEST_ASSERT_EQUAL_INT(1, culled_calls);
+	TEST_ASSERT_EQUAL_STRING("Producer", step_pass(&graph, 0)->name);
+	TEST_ASSERT_EQUAL_STRING("Consumer", step_pass(&graph, 1)->name);
+
+	/* Consommateur désactivé : son producteur n'a plus de lecteur */
+	graph.passes[consumer].enabled = 0;
+	culled_calls = 0;
+	TEST_ASSERT_EQUAL_INT(0, frame_graph_compile(&graph));
+	TEST_ASSERT_EQUAL_INT(2, culled_calls);
+}
+
+void test_frame_graph_minimal_barriers(void)
+{
+	FrameGraph graph;
+	frame_graph_init(&graph);
+
+	const int bloom = frame_graph_add_resource(&graph, "Bloom",
+	                                           FRAME_GRAPH_TEXTURE, 0);
+	const int lut = frame_graph_add_resource(&graph, "LUT",
+	                                         FRAME_GRAPH_TEXTURE, 0);
+	const int blur = frame_graph_add_resource(&graph, "Blur",
+	                                          FRAME_GRAPH_TEXTURE, 0);
+	const int screen = frame_graph_add_resource(&graph, "Screen",
+	                                            FRAME_GRAPH_TEXTURE, 1);
+
+	int pass = frame_graph_add_pass(&graph, "Bloom", noop_pass, NULL, NULL);
+	frame_graph_write(&graph, pass, bloom, FRAME_GRAPH_IMAGE);
+	pass = frame_graph_add_pass(&graph, "LUT", noop_pass, NULL, NULL);
+	frame_graph_write(&graph, pass, lut, FRAME_GRAPH_IMAGE);
+	/* Rastérisé : cohérent, aucune barrière */
+	pass = frame_graph_add_pass(&graph, "Blur", noop_pass, NULL, NULL);
+	frame_graph_set_target(&graph, pass, 1, 8, 8);
+	frame_graph_write(&graph, pass, blur, FRAME_GRAPH_ATTACHMENT);
+	pass = frame_graph_add_pass(&graph, "Composite", noop_pass, NULL,
+	                            NULL);
+	frame_graph_set_target(&graph, pass, 0, 32, 32);
+	frame_graph_read(&graph, pass, bloom, FRAME_GRAPH_SAMPLED);
+	frame_graph_read(&graph, pass, lut, FRAME_GRAPH_SAMPLED);
+	frame_graph_read(&graph, pass, blur, FRAME_GRAPH_SAMPLED);
+	frame_graph_write(&graph, pass, screen, FRAME_GRAPH_ATTACHMENT);
+
+	TEST_ASSERT_EQUAL_INT(4, frame_graph_compile(&graph));
+	/* Deux écritures image, une seule barrière fetch avant le composite
+	 * (et l'écriture image de la frame suivante sur le bloom) */
+	TEST_ASSERT_EQUAL_STRING("Composite", step_pass(&graph, 3)->name);
+	TEST_ASSERT_EQUAL_UINT(GL_TEXTURE_FETCH_BARRIER_BIT,
+	                       graph.steps[3].barriers);
+	TEST_ASSERT_EQUAL_UINT(0, graph.steps[2].barriers);
+	TEST_ASSERT_EQUAL_UINT(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+	                       graph.steps[0].barriers);
+	TEST_ASSERT_EQUAL_UINT(0, graph.steps[1].barriers);
+	TEST_ASSERT_EQUAL_INT(2, graph.barrier_count);
+}
+
+void test_frame_graph_cross_frame_read_modify_write(void)
+{
+	FrameGraph graph;
+	frame_graph_init(&graph);
+
+	const int exposure = frame_graph_add_resource(&graph, "Exposure",
+	                                              FRAME_GRAPH_TEXTURE, 1);
+	const int pass = frame_graph_add_pass(&graph, "Adapt", noop_pass,
+	                                      NULL, NULL);
+	frame_graph_read(&graph, pass, exposure, FRAME_GRAPH_IMAGE);
+	frame_graph_write(&graph, pass, exposure, FRAME_GRAPH_IMAGE);
+
+	/* Première frame sans barrière, régime permanent : celle de la
+	 * frame précédente */
+	TEST_ASSERT_EQUAL_INT(1, frame_graph_compile(&graph));
+	TEST_ASSERT_EQUAL_UINT(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+	                       graph.steps[0].barriers);
+}
+
+void test_frame_graph_attachment_write_keeps_pending_image_write(void)
+{
+	FrameGraph graph;
+	frame_graph_init(&graph);
+
+	const int splat = frame_graph_add_resource(&graph, "Splat",
+	                                           FRAME_GRAPH_TEXTURE, 0);
+	const int screen = frame_graph_add_resource(&graph, "Screen",
+	                                            FRAME_GRAPH_TEXTURE, 1);
+
+	/* imageStore, puis rastérisation dans la même texture, puis lecture
+	 * par sampler */
+	int pass = frame_graph_add_pass(&graph, "Splat", noop_pass, NULL, NULL);
+	frame_graph_write(&graph, pass, splat, FRAME_GRAPH_IMAGE);
+	pass = frame_graph_add_pass(&graph, "Overlay", noop_pass, NULL, NULL);
+	frame_graph_set_target(&graph, pass, 1, 16, 16);
+	frame_graph_write(&graph, pass, splat, FRAME_GRAPH_ATTACHMENT);
+	pass = frame_graph_add_pass(&graph, "Composite", noop_pass, NULL,
+	                            NULL);
+	frame_graph_set_target(&graph, pass, 0, 16, 16);
+	frame_graph_read(&graph, pass, splat, FRAME_GRAPH_SAMPLED);
+	frame_graph_write(&graph, pass, screen, FRAME_GRAPH_ATTACHMENT);
+
+	TEST_ASSERT_EQUAL_INT(3, frame_graph_compile(&graph));
+	TEST_ASSERT_EQUAL_STRING("Overlay", step_pass(&graph, 1)->name);
+	/* L'attachement attend l'imageStore... */
+	TEST_ASSERT_EQUAL_UINT(GL_FRAMEBUFFER_BARRIER_BIT,
+	                       graph.steps[1].barriers);
+	/* ...sans le rendre visible au sampler qui suit */
+	TEST_ASSERT_EQUAL_UINT(GL_TEXTURE_FETCH_BARRIER_BIT,
+	                       graph.steps[2].barriers);
+	TEST_ASSERT_EQUAL_UINT(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+	                       graph.steps[0].barriers);
+}
+
+void test_frame_graph_attachment_write_keeps_pending_storage_write(void)
+{
+	FrameGraph graph;
+	frame_graph_init(&graph);
+
+	const int target = frame_graph_add_resource(&graph, "Target",
+	                                            FRAME_GRAPH_TEXTURE, 1);
+	const int counts = frame_graph_add_resource(&graph, "Counts",
+	                                            FRAME_GRAPH_BUFFER, 0);
+	const int screen = frame_graph_add_resource(&graph, "Screen",
+	                                            FRAME_GRAPH_TEXTURE, 1);
+
+	/* SSBO écrit, attachement qui lit déjà un SSBO (bits cumulés), puis
+	 * lecture indirecte du même SSBO */
+	int pass = frame_graph_add_pass(&graph, "Count", noop_pass, NULL, NULL);
+	frame_graph_write(&graph, pass, counts, FRAME_GRAPH_STORAGE);
+	frame_graph_write(&graph, pass, target, FRAME_GRAPH_IMAGE);
+	pass = frame_graph_add_pass(&graph, "Draw", noop_pass, NULL, NULL);
+	frame_graph_set_target(&graph, pass, 1, 16, 16);
+	frame_graph_read(&graph, pass, counts, FRAME_GRAPH_STORAGE);
+	frame_graph_write(&graph, pass, target, FRAME_GRAPH_ATTACHMENT);
+	pass = frame_graph_add_pass(&graph, "Dispatch", noop_pass, NULL,
+	                            NULL);
+	frame_graph_set_target(&graph, pass, 0, 16, 16);
+	frame_graph_read(&graph, pass, counts, FRAME_GRAPH_INDIRECT);
+	frame_graph_read(&graph, pass, target, FRAME_GRAPH_SAMPLED);
+	frame_graph_write(&graph, pass, screen, FRAME_GRAPH_ATTACHMENT);
+
+	TEST_ASSERT_EQUAL_INT(3, frame_graph_compile(&graph));
+	TEST_ASSERT_EQUAL_UINT(GL_SHADER_STORAGE_BARRIER_BIT |
+	                           GL_FRAMEBUFFER_BARRIER_BIT,
+	                       graph.steps[1].barriers);
+	TEST_ASSERT_EQUAL_UINT(GL_COMMAND_BARRIER_BIT |
+	                           GL_TEXTURE_FETCH_BARRIER_BIT,
+	                       graph.steps[2].barriers);
+}
+
+void test_frame_graph_groups_passes_by_target(void)
+{
+	FrameGraph graph;
+	frame_graph_init(&graph);
+
+	const int out_a = frame_graph_add_resource(&graph, "A",
+	                                           FRAME_GRAPH_TEXTURE, 1);
+	const int out_b = frame_graph_add_resource(&graph, "B",
+	                                           FRAME_GRAPH_TEXTURE, 1);
+	const int out_c = frame_graph_add_resource(&graph, "C",
+	                                           FRAME_GRAPH_TEXTURE, 1);
+	const int out_d = frame_graph_add_resource(&graph, "D",
+	                                           FRAME_GRAPH_TEXTURE, 1);
+
+	int pass = frame_graph_add_pass(&graph, "A", noop_pass, NULL, NULL);
+	frame_graph_set_target(&graph, pass, 1, 16, 16);
+	frame_graph_write(&graph, pass, out_a, FRAME_GRAPH_ATTACHMENT);
+	pass = frame_graph_add_pass(&graph, "B", noop_pass, NULL, NULL);
+	frame_graph_set_target(&graph, pass, 2, 16, 16);
+	frame_graph_write(&graph, pass, out_b, FRAME_GRAPH_ATTACHMENT);
+	pass = frame_graph_add_pass(&graph, "C", noop_pass, NULL, NULL);
+	frame_graph_write(&graph, pass, out_c, FRAME_GRAPH_IMAGE);
+	pass = frame_graph_add_pass(&graph, "D", noop_pass, NULL, NULL);
+	frame_graph_set_target(&graph, pass, 1, 16, 16);
+	frame_graph_write(&graph, pass, out_d, FRAME_GRAPH_ATTACHMENT);
+
+	/* Déclaré A B C D : trois changements ; groupé C A D B : deux (la
+	 * passe compute ne lie rien) */
+	TEST_ASSERT_EQUAL_INT(4, frame_graph_compile(&graph));
+	TEST_ASSERT_EQUAL_STRING("C", step_pass(&graph, 0)->name);
+	TEST_ASSERT_EQUAL_STRING("A", step_pass(&graph, 1)->name);
+	TEST_ASSERT_EQUAL_STRING("D", step_pass(&graph, 2)->name);
+	TEST_ASSERT_EQUAL_STRING("B", step_pass(&graph, 3)->name);
+	TEST_ASSERT_EQUAL_INT(2, graph.target_switches);
+	TEST_ASSERT_FALSE(graph.steps[2].bind_target);
+}
+
+void test_frame_graph_keeps_declared_dependencies(void)
+{
+	FrameGraph graph;
+	frame_graph_init(&graph);
+
+	const int shared = frame_graph_add_resource(&graph, "Shared",
+	                                            FRAME_GRAPH_TEXTURE, 1);
+
+	/* Même cible que la première passe, mais écrit après la lecture de
+	 * la seconde : l'ordre déclaré l'emporte sur le regroupement */
+	int pass = frame_graph_add_pass(&graph, "Write", noop_pass, NULL, NULL);
+	frame_graph_set_target(&graph, pass, 1, 16, 16);
+	frame_graph_write(&graph, pass, shared, FRAME_GRAPH_ATTACHMENT);
+	pass = frame_graph_add_pass(&graph, "Read", noop_pass, NULL, NULL);
+	frame_graph_set_target(&graph, pass, 2, 16, 16);
+	frame_graph_read(&graph, pass, shared, FRAME_GRAPH_SAMPLED);
+	frame_graph_write(&graph, pass, shared, FRAME_GRAPH_ATTACHMENT);
+	pass = frame_graph_add_pass(&graph, "Overwrite", noop_pass, NULL,
+	                            NULL);
+	frame_graph_set_target(&graph, pass, 1, 16, 16);
+	frame_graph_write(&graph, pass, shared, FRAME_GRAPH_ATTACHMENT);
+
+	TEST_ASSERT_EQUAL_INT(3, frame_graph_compile(&graph));
+	TEST_ASSERT_EQUAL_STRING("Read", step_pass(&graph, 1)->name);
+	TEST_ASSERT_EQUAL_STRING("Overwrite", step_pass(&graph, 2)->name);
+	TEST_ASSERT_EQUAL_INT(3, graph.target_switches);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_frame_graph_barrier_bits);
+	RUN_TEST(test_frame_graph_culls_unread_and_disabled_passes);
+	RUN_TEST(test_frame_graph_minimal_barriers);
+	RUN_TEST(test_frame_graph_cross_frame_read_modify_write);
+	RUN_TEST(test_frame_graph_attachment_write_keeps_pending_image_write);
+	RUN_TEST(
+	    test_frame_graph_attachment_write_keeps_pending_storage_write);
+	RUN_TEST(test_frame_graph_groups_passes_by_target);
+	RUN_TEST(test_frame_graph_keeps_declared_dependencies);
+	return UNITY_END();
+}
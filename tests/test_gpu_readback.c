@@ -0,0 +1,181 @@
+// tests/test_gpu_readback.c
+#include "gl_common.h"
+#include "gpu_readback.h"
+#include "unity.h"
+#include <string.h>
+
+static GLFWwindow* test_window = NULL;
+
+void setUp(void)
+{
+	if (!glfwInit()) {
+		return;
+	}
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	test_window = glfwCreateWindow(1, 1, "Test", NULL, NULL);
+	if (!test_window) {
+		glfwTerminate();
+		return;
+	}
+
+	glfwMakeContextCurrent(test_window);
+	gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+}
+
+void tearDown(void)
+{
+	if (test_window) {
+		glfwDestroyWindow(test_window);
+		test_window = NULL;
+	}
+	glfwTerminate();
+}
+
+typedef struct {
+	int calls;
+	unsigned int values[4];
+} CallbackResult;
+
+static void store_values(void* user, const void* data, size_t size)
+{
+	CallbackResult* result = user;
+	result->calls++;
+	memcpy(result->values, data, size);
+}
+
+static GLuint make_buffer(const unsigned int* values, size_t size)
+{
+	GLuint buffer = 0;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)size, values,
+	             GL_STATIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	return buffer;
+}
+
+void test_gpu_readback_invalid_args(void)
+{
+	GpuReadback readback;
+	TEST_ASSERT_EQUAL_INT(0, gpu_readback_init(&readback, 0));
+	TEST_ASSERT_EQUAL_UINT64(
+	    0, gpu_readback_buffer(&readback, 1, 0, 4, NULL, NULL));
+	TEST_ASSERT_FALSE(gpu_readback_done(&readback, 0));
+}
+
+void test_gpu_readback_buffer_callback_and_polling(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	GpuReadback readback;
+	TEST_ASSERT_TRUE(gpu_readback_init(&readback, 256));
+
+	const unsigned int values[4] = {7, 11, 13, 17};
+	GLuint buffer = make_buffer(values, sizeof(values));
+
+	CallbackResult result = {0};
+	unsigned int polled = 0;
+	const unsigned long long first = gpu_readback_buffer(
+	    &readback, buffer, 0, sizeof(values), store_values, &result);
+	const unsigned long long second = gpu_readback_buffer(
+	    &readback, buffer, 2 * sizeof(unsigned int), sizeof(polled), NULL,
+	    &polled);
+	TEST_ASSERT_NOT_EQUAL(0, first);
+	TEST_ASSERT_TRUE(second > first);
+	TEST_ASSERT_FALSE(gpu_readback_done(&readback, first));
+
+	/* Frame suivante, GPU terminé : tout est livré, dans l'ordre */
+	glFinish();
+	gpu_readback_poll(&readback);
+	TEST_ASSERT_EQUAL_INT(0, readback.count);
+	TEST_ASSERT_EQUAL_INT(1, readback.last_latency);
+	TEST_ASSERT_TRUE(gpu_readback_done(&readback, second));
+	TEST_ASSERT_EQUAL_INT(1, result.calls);
+	TEST_ASSERT_EQUAL_UINT32_ARRAY(values, result.values, 4);
+	TEST_ASSERT_EQUAL_UINT(13, polled);
+
+	glDeleteBuffers(1, &buffer);
+	gpu_readback_cleanup(&readback);
+	TEST_ASSERT_EQUAL(0, readback.buffer);
+}
+
+void test_gpu_readback_texture(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	GpuReadback readback;
+	TEST_ASSERT_TRUE(gpu_readback_init(&readback, 256));
+
+	const float texel[4] = {1.5F, -2.0F, 0.25F, 1.0F};
+	GLuint texture = 0;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, 1, 1, 0, GL_RGBA, GL_FLOAT,
+	             texel);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	float out[4] = {0};
+	const unsigned long long ticket =
+	    gpu_readback_texture(&readback, texture, 0, GL_RGBA, GL_FLOAT,
+	                         sizeof(out), NULL, out);
+	TEST_ASSERT_NOT_EQUAL(0, ticket);
+
+	gpu_readback_flush(&readback);
+	TEST_ASSERT_TRUE(gpu_readback_done(&readback, ticket));
+	TEST_ASSERT_EQUAL_FLOAT_ARRAY(texel, out, 4);
+
+	glDeleteTextures(1, &texture);
+	gpu_readback_cleanup(&readback);
+}
+
+void test_gpu_readback_ring_full_drops(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	/* Deux copies de 32 octets remplissent l'anneau */
+	GpuReadback readback;
+	TEST_ASSERT_TRUE(gpu_readback_init(&readback, 64));
+
+	const unsigned int values[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+	GLuint buffer = make_buffer(values, sizeof(values));
+	unsigned int out[8];
+
+	const size_t size = sizeof(values);
+	TEST_ASSERT_NOT_EQUAL(
+	    0, gpu_readback_buffer(&readback, buffer, 0, size, NULL, out));
+	TEST_ASSERT_NOT_EQUAL(
+	    0, gpu_readback_buffer(&readback, buffer, 0, size, NULL, out));
+	TEST_ASSERT_EQUAL_UINT64(
+	    0, gpu_readback_buffer(&readback, buffer, 0, size, NULL, out));
+	TEST_ASSERT_EQUAL_INT(1, readback.dropped);
+
+	/* Place libérée à la livraison */
+	gpu_readback_flush(&readback);
+	TEST_ASSERT_EQUAL_UINT32_ARRAY(values, out, 8);
+	TEST_ASSERT_NOT_EQUAL(
+	    0, gpu_readback_buffer(&readback, buffer, 0, size, NULL, out));
+
+	glDeleteBuffers(1, &buffer);
+	gpu_readback_cleanup(&readback);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_gpu_readback_invalid_args);
+	RUN_TEST(test_gpu_readback_buffer_callback_and_polling);
+	RUN_TEST(test_gpu_readback_texture);
+	RUN_TEST(test_gpu_readback_ring_full_drops);
+	return UNITY_END();
+}
@@ -0,0 +1,97 @@
+// tests/test_hybrid_rendering.c
+#include "gl_common.h"
+#include "hybrid_rendering.h"
+#include "instanced_rendering.h"
+#include "unity.h"
+#include <cglm/cglm.h>
+
+static GLFWwindow* test_window = NULL;
+
+void setUp(void)
+{
+	if (!glfwInit()) {
+		return;
+	}
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	test_window = glfwCreateWindow(1, 1, "Test", NULL, NULL);
+	if (!test_window) {
+		glfwTerminate();
+		return;
+	}
+
+	glfwMakeContextCurrent(test_window);
+	gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+}
+
+void tearDown(void)
+{
+	if (test_window) {
+		glfwDestroyWindow(test_window);
+		test_window = NULL;
+	}
+	glfwTerminate();
+}
+
+void test_hybrid_indirect_command_layout(void)
+{
+	/* Must match the std430 DrawCommands block of hybrid_classify.comp */
+	TEST_ASSERT_EQUAL(20, sizeof(DrawElementsIndirectCommand));
+	TEST_ASSERT_EQUAL(16, sizeof(DrawArraysIndirectCommand));
+	TEST_ASSERT_EQUAL(36, sizeof(HybridDrawCommands));
+	TEST_ASSERT_EQUAL(20, offsetof(HybridDrawCommands, impostor));
+}
+
+void test_hybrid_classify_near_far_culled(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	/* Near (big on screen), far (a couple of pixels), behind camera */
+	static const vec3 POSITIONS[3] = {
+	    {0.0F, 0.0F, 0.0F}, {0.0F, 0.0F, -400.0F}, {0.0F, 0.0F, 50.0F}};
+
+	SphereInstance instances[3] = {0};
+	for (int i = 0; i < 3; i++) {
+		glm_mat4_identity(instances[i].model);
+		glm_translate(instances[i].model, (float*)POSITIONS[i]);
+	}
+
+	InstancedGroup source;
+	instanced_group_init(&source, instances, 3);
+
+	HybridGroup group = {0};
+	TEST_ASSERT_TRUE(
+	    hybrid_group_init(&group, source.instance_vbo, 3));
+
+	mat4 view;
+	mat4 proj;
+	glm_lookat((vec3){0.0F, 0.0F, 5.0F}, (vec3){0.0F, 0.0F, 0.0F},
+	           (vec3){0.0F, 1.0F, 0.0F}, view);
+	glm_perspective(glm_rad(60.0F), 1.0F, 0.1F, 1000.0F, proj);
+
+	hybrid_group_classify(&group, view, proj, 768, 60);
+
+	int mesh_count = -1;
+	int impostor_count = -1;
+	hybrid_group_read_counts(&group, &mesh_count, &impostor_count);
+
+	TEST_ASSERT_EQUAL_INT(1, mesh_count);
+	TEST_ASSERT_EQUAL_INT(1, impostor_count);
+
+	hybrid_group_cleanup(&group);
+	instanced_group_cleanup(&source);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_hybrid_indirect_command_layout);
+	RUN_TEST(test_hybrid_classify_near_far_culled);
+	return UNITY_END();
+}
@@ -1,5 +1,105 @@
 #include "icosphere.h"
+#include "job_system.h"
 #include "unity.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum { REFERENCE_MAX_LEVEL = 6 };
+
+/*
+ * Référence : l'ancien générateur (table de hachage des arêtes, sommets
+ * poussés dans l'ordre de première rencontre). Le générateur actuel doit
+ * produire exactement les mêmes octets.
+ */
+typedef struct {
+	unsigned int a, b;
+	unsigned int midpoint;
+} RefEdge;
+
+static unsigned int ref_midpoint(unsigned int p1, unsigned int p2,
+                                 Vec3Array* vertices, RefEdge* table,
+                                 size_t capacity)
+{
+	unsigned int idx_a = p1 < p2 ? p1 : p2;
+	unsigned int idx_b = p1 < p2 ? p2 : p1;
+	uint64_t key = ((uint64_t)idx_a << 32U) | idx_b;
+	size_t index = (size_t)(key % capacity);
+
+	while (table[index].midpoint != 0) {
+		if (table[index].a == idx_a && table[index].b == idx_b) {
+			return table[index].midpoint;
+		}
+		index = (index + 1) % capacity;
+	}
+
+	vec3 midpoint;
+	glm_vec3_add(vertices->data[p1], vertices->data[p2], midpoint);
+	glm_vec3_scale(midpoint, 0.5F, midpoint);
+	glm_vec3_normalize(midpoint);
+	vec3array_push(vertices, midpoint);
+
+	table[index].a = idx_a;
+	table[index].b = idx_b;
+	table[index].midpoint = (unsigned int)(vertices->size - 1);
+	return table[index].midpoint;
+}
+
+static void reference_generate(IcosphereGeometry* geom, int subdivisions)
+{
+	/* Niveau 0 : l'icosaèdre tel que généré par la bibliothèque */
+	icosphere_generate(geom, 0);
+
+	for (int depth = 0; depth < subdivisions; depth++) {
+		UintArray next;
+		uintarray_init(&next);
+		const size_t capacity = geom->indices.size * 4;
+		RefEdge* table = calloc(capacity, sizeof(RefEdge));
+		TEST_ASSERT_NOT_NULL(table);
+
+		for (size_t i = 0; i < geom->indices.size; i += 3) {
+			unsigned int v0 = geom->indices.data[i + 0];
+			unsigned int v1 = geom->indices.data[i + 1];
+			unsigned int v2 = geom->indices.data[i + 2];
+			unsigned int m0 = ref_midpoint(v0, v1, &geom->vertices,
+			                               table, capacity);
+			unsigned int m1 = ref_midpoint(v1, v2, &geom->vertices,
+			                               table, capacity);
+			unsigned int m2 = ref_midpoint(v2, v0, &geom->vertices,
+			                               table, capacity);
+			const unsigned int tris[12] = {v0, m0, m2, v1, m1, m0,
+			                               v2, m2, m1, m0, m1, m2};
+			for (int k = 0; k < 12; k++) {
+				uintarray_push(&next, tris[k]);
+			}
+		}
+
+		free(table);
+		uintarray_free(&geom->indices);
+		geom->indices = next;
+	}
+
+	geom->normals.size = 0;
+	for (size_t i = 0; i < geom->vertices.size; i++) {
+		vec3 normal;
+		glm_vec3_normalize_to(geom->vertices.data[i], normal);
+		vec3array_push(&geom->normals, normal);
+	}
+}
+
+static void assert_same_geometry(const IcosphereGeometry* expected,
+                                 const IcosphereGeometry* actual)
+{
+	TEST_ASSERT_EQUAL_UINT(expected->vertices.size, actual->vertices.size);
+	TEST_ASSERT_EQUAL_UINT(expected->normals.size, actual->normals.size);
+	TEST_ASSERT_EQUAL_UINT(expected->indices.size, actual->indices.size);
+	TEST_ASSERT_EQUAL_MEMORY(expected->vertices.data, actual->vertices.data,
+	                         expected->vertices.size * sizeof(vec3));
+	TEST_ASSERT_EQUAL_MEMORY(expected->normals.data, actual->normals.data,
+	                         expected->normals.size * sizeof(vec3));
+	TEST_ASSERT_EQUAL_MEMORY(expected->indices.data, actual->indices.data,
+	                         expected->indices.size * sizeof(unsigned int));
+}
 
 void setUp(void)
 {
@@ -67,6 +167,102 @@ void test_icosphere_counts_subdivision_1(void)
 	icosphere_free(&geom);
 }
 
+void test_icosphere_closed_form_counts(void)
+{
+	TEST_ASSERT_EQUAL_UINT(12, icosphere_vertex_count(0));
+	TEST_ASSERT_EQUAL_UINT(60, icosphere_index_count(0));
+	TEST_ASSERT_EQUAL_UINT(655362, icosphere_vertex_count(8));
+	TEST_ASSERT_EQUAL_UINT(3932160, icosphere_index_count(8));
+
+	IcosphereGeometry geom;
+	icosphere_init(&geom);
+	for (int level = 0; level <= 4; level++) {
+		icosphere_generate(&geom, level);
+		TEST_ASSERT_EQUAL_UINT(icosphere_vertex_count(level),
+		                       geom.vertices.size);
+		TEST_ASSERT_EQUAL_UINT(icosphere_index_count(level),
+		                       geom.indices.size);
+	}
+	/* Preallocated: no doubling past the exact size */
+	TEST_ASSERT_EQUAL_UINT(geom.vertices.size, geom.vertices.capacity);
+	TEST_ASSERT_EQUAL_UINT(geom.indices.size, geom.indices.capacity);
+	icosphere_free(&geom);
+}
+
+void test_icosphere_matches_reference_generator(void)
+{
+	JobSystem* jobs = job_system_create(3);
+	TEST_ASSERT_NOT_NULL(jobs);
+
+	IcosphereGeometry serial;
+	IcosphereGeometry parallel;
+	icosphere_init(&serial);
+	icosphere_init(&parallel);
+
+	for (int level = 0; level <= REFERENCE_MAX_LEVEL; level++) {
+		IcosphereGeometry reference;
+		icosphere_init(&reference);
+		reference_generate(&reference, level);
+
+		icosphere_generate(&serial, level);
+		icosphere_generate_parallel(&parallel, level, jobs);
+		assert_same_geometry(&reference, &serial);
+		assert_same_geometry(&reference, &parallel);
+
+		icosphere_free(&reference);
+	}
+
+	icosphere_free(&serial);
+	icosphere_free(&parallel);
+	job_system_destroy(jobs);
+}
+
+void test_icosphere_pack_snorm16_positions(void)
+{
+	IcosphereGeometry geom;
+	icosphere_init(&geom);
+	icosphere_generate(&geom, 3);
+
+	TEST_ASSERT_EQUAL_UINT(8, icosphere_position_stride(
+	                              ICOSPHERE_POSITION_SNORM16));
+	int16_t* packed = malloc(geom.vertices.size * 8);
+	TEST_ASSERT_NOT_NULL(packed);
+	icosphere_pack_positions(&geom, ICOSPHERE_POSITION_SNORM16, packed);
+
+	/* Décodage GL : c / 32767, erreur d'arrondi <= un pas */
+	for (size_t i = 0; i < geom.vertices.size; i++) {
+		for (int c = 0; c < 3; c++) {
+			TEST_ASSERT_FLOAT_WITHIN(
+			    1.0F / 32767.0F, geom.vertices.data[i][c],
+			    (float)packed[(i * 4) + c] / 32767.0F);
+		}
+		TEST_ASSERT_EQUAL_INT16(0, packed[(i * 4) + 3]);
+	}
+
+	free(packed);
+	icosphere_free(&geom);
+}
+
+void test_icosphere_short_indices(void)
+{
+	TEST_ASSERT_TRUE(
+	    icosphere_fits_short_indices(icosphere_vertex_count(6)));
+	TEST_ASSERT_FALSE(
+	    icosphere_fits_short_indices(icosphere_vertex_count(7)));
+
+	IcosphereGeometry geom;
+	icosphere_init(&geom);
+	icosphere_generate(&geom, 2);
+	uint16_t* packed = malloc(geom.indices.size * sizeof(uint16_t));
+	TEST_ASSERT_NOT_NULL(packed);
+	icosphere_pack_short_indices(&geom, packed);
+	for (size_t i = 0; i < geom.indices.size; i++) {
+		TEST_ASSERT_EQUAL_UINT(geom.indices.data[i], packed[i]);
+	}
+	free(packed);
+	icosphere_free(&geom);
+}
+
 int main(void)
 {
 	UNITY_BEGIN();
@@ -74,5 +270,9 @@ int main(void)
 	RUN_TEST(test_vec3array_push_should_add_elements);
 	RUN_TEST(test_icosphere_counts_subdivision_0);
 	RUN_TEST(test_icosphere_counts_subdivision_1);
+	RUN_TEST(test_icosphere_closed_form_counts);
+	RUN_TEST(test_icosphere_matches_reference_generator);
+	RUN_TEST(test_icosphere_pack_snorm16_positions);
+	RUN_TEST(test_icosphere_short_indices);
 	return UNITY_END();
 }
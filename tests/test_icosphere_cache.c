@@ -0,0 +1,192 @@
+// tests/test_icosphere_cache.c
+#include "gl_common.h"
+#include "icosphere.h"
+#include "icosphere_cache.h"
+#include "job_system.h"
+#include "unity.h"
+#include <time.h>
+
+static GLFWwindow* test_window = NULL;
+
+void setUp(void)
+{
+	if (!glfwInit()) {
+		return;
+	}
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	test_window = glfwCreateWindow(1, 1, "Test", NULL, NULL);
+	if (!test_window) {
+		glfwTerminate();
+		return;
+	}
+
+	glfwMakeContextCurrent(test_window);
+	gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+}
+
+void tearDown(void)
+{
+	if (test_window) {
+		glfwDestroyWindow(test_window);
+		test_window = NULL;
+	}
+	glfwTerminate();
+}
+
+static GLint buffer_size(GLuint buffer)
+{
+	GLint size = 0;
+	glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+	glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_SIZE, &size);
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	return size;
+}
+
+void test_icosphere_cache_synchronous_without_jobs(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	IcosphereCache cache;
+	icosphere_cache_init(&cache, NULL);
+	TEST_ASSERT_NULL(icosphere_cache_current(&cache));
+
+	TEST_ASSERT_EQUAL_INT(1, icosphere_cache_request(&cache, 2));
+	const IcosphereMesh* mesh = icosphere_cache_current(&cache);
+	TEST_ASSERT_NOT_NULL(mesh);
+	TEST_ASSERT_EQUAL_UINT(icosphere_index_count(2), mesh->index_count);
+	TEST_ASSERT_EQUAL_INT(
+	    (GLint)(icosphere_vertex_count(2) * sizeof(vec3)),
+	    buffer_size(mesh->vbo));
+
+	/* Same level again: nothing to swap */
+	TEST_ASSERT_EQUAL_INT(0, icosphere_cache_request(&cache, 2));
+
+	icosphere_cache_cleanup(&cache);
+	TEST_ASSERT_NULL(icosphere_cache_current(&cache));
+}
+
+void test_icosphere_cache_async_keeps_old_mesh(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	JobSystem* jobs = job_system_create(1);
+	TEST_ASSERT_NOT_NULL(jobs);
+
+	IcosphereCache cache;
+	icosphere_cache_init(&cache, jobs);
+	icosphere_cache_load(&cache, 1);
+	const GLuint level1_vbo = icosphere_cache_current(&cache)->vbo;
+
+	/* Until the worker is done, level 1 stays current */
+	int swapped = icosphere_cache_request(&cache, 5);
+	int frames = 0;
+	while (!swapped && frames++ < 10000) {
+		TEST_ASSERT_EQUAL_UINT(level1_vbo,
+		                       icosphere_cache_current(&cache)->vbo);
+		struct timespec req = {0, 1000000};
+		nanosleep(&req, NULL);
+		swapped = icosphere_cache_request(&cache, 5);
+	}
+	TEST_ASSERT_EQUAL_INT(1, swapped);
+	TEST_ASSERT_EQUAL_UINT(icosphere_index_count(5),
+	                       icosphere_cache_current(&cache)->index_count);
+
+	/* Cached level: switching back is immediate, buffers untouched */
+	TEST_ASSERT_EQUAL_INT(1, icosphere_cache_request(&cache, 1));
+	TEST_ASSERT_EQUAL_UINT(level1_vbo,
+	                       icosphere_cache_current(&cache)->vbo);
+	TEST_ASSERT_FALSE(icosphere_cache_busy(&cache));
+
+	icosphere_cache_cleanup(&cache);
+	job_system_destroy(jobs);
+}
+
+void test_icosphere_cache_synchronous_without_workers(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	/* Aucun worker : un job soumis ne tournerait jamais sans wait */
+	JobSystem* jobs = job_system_create(0);
+	TEST_ASSERT_NOT_NULL(jobs);
+	TEST_ASSERT_EQUAL_INT(1, job_system_thread_count(jobs));
+
+	IcosphereCache cache;
+	icosphere_cache_init(&cache, jobs);
+	icosphere_cache_load(&cache, 1);
+
+	TEST_ASSERT_EQUAL_INT(1, icosphere_cache_request(&cache, 4));
+	TEST_ASSERT_EQUAL_UINT(icosphere_index_count(4),
+	                       icosphere_cache_current(&cache)->index_count);
+	TEST_ASSERT_FALSE(icosphere_cache_busy(&cache));
+
+	icosphere_cache_cleanup(&cache);
+	job_system_destroy(jobs);
+}
+
+void test_icosphere_cache_clamps_levels(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	IcosphereCache cache;
+	icosphere_cache_init(&cache, NULL);
+	TEST_ASSERT_EQUAL_INT(1, icosphere_cache_request(&cache, -3));
+	TEST_ASSERT_EQUAL_INT(0, cache.current);
+	icosphere_cache_cleanup(&cache);
+}
+
+void test_icosphere_cache_compact_streams(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	IcosphereCache cache;
+	icosphere_cache_init(&cache, NULL);
+	icosphere_cache_load(&cache, 6);
+
+	/* 40962 vertices: 16-bit indices, positions only */
+	const IcosphereMesh* mesh = icosphere_cache_current(&cache);
+	TEST_ASSERT_EQUAL_UINT(GL_UNSIGNED_SHORT, mesh->index_type);
+	TEST_ASSERT_EQUAL_INT((GLint)(icosphere_index_count(6) * 2),
+	                      buffer_size(mesh->ebo));
+
+	/* Format change: the current level is rebuilt right away */
+	TEST_ASSERT_EQUAL_INT(
+	    1, icosphere_cache_set_format(&cache, ICOSPHERE_POSITION_SNORM16));
+	mesh = icosphere_cache_current(&cache);
+	TEST_ASSERT_EQUAL_INT((GLint)(icosphere_vertex_count(6) * 8),
+	                      buffer_size(mesh->vbo));
+	TEST_ASSERT_EQUAL_INT(
+	    0, icosphere_cache_set_format(&cache, ICOSPHERE_POSITION_SNORM16));
+
+	/* Level 7 no longer fits in 16 bits */
+	TEST_ASSERT_EQUAL_INT(1, icosphere_cache_request(&cache, 7));
+	TEST_ASSERT_EQUAL_UINT(GL_UNSIGNED_INT,
+	                       icosphere_cache_current(&cache)->index_type);
+
+	icosphere_cache_cleanup(&cache);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_icosphere_cache_synchronous_without_jobs);
+	RUN_TEST(test_icosphere_cache_async_keeps_old_mesh);
+	RUN_TEST(test_icosphere_cache_synchronous_without_workers);
+	RUN_TEST(test_icosphere_cache_clamps_levels);
+	RUN_TEST(test_icosphere_cache_compact_streams);
+	return UNITY_END();
+}
@@ -0,0 +1,186 @@
+// tests/test_instance_generator.c
+#include "app_settings.h"
+#include "gl_common.h"
+#include "instance_generator.h"
+#include "instanced_rendering.h"
+#include "material.h"
+#include "unity.h"
+#include <cglm/cglm.h>
+#include <stdlib.h>
+
+static GLFWwindow* test_window = NULL;
+
+void setUp(void)
+{
+	if (!glfwInit()) {
+		return;
+	}
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	test_window = glfwCreateWindow(1, 1, "Test", NULL, NULL);
+	if (!test_window) {
+		glfwTerminate();
+		return;
+	}
+
+	glfwMakeContextCurrent(test_window);
+	gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+}
+
+void tearDown(void)
+{
+	if (test_window) {
+		glfwDestroyWindow(test_window);
+		test_window = NULL;
+	}
+	glfwTerminate();
+}
+
+void test_instance_generator_columns(void)
+{
+	/* The default material grid keeps its historical shape */
+	TEST_ASSERT_EQUAL_INT(DEFAULT_COLS, instance_generator_columns(1));
+	TEST_ASSERT_EQUAL_INT(DEFAULT_COLS,
+	                      instance_generator_columns(DEFAULT_COLS *
+	                                                 DEFAULT_COLS));
+	TEST_ASSERT_EQUAL_INT(1000, instance_generator_columns(1000000));
+	TEST_ASSERT_EQUAL_INT(101, instance_generator_columns(10001));
+}
+
+/* Génère `count` instances et les relit (format de params->format) */
+static void* generate(const InstanceGenParams* params)
+{
+	static PBRMaterial materials[2] = {
+	    {.albedo = {1.0F, 0.0F, 0.0F}, .metallic = 1.0F, .roughness = 0.2F},
+	    {.albedo = {0.0F, 0.0F, 1.0F}, .metallic = 0.0F, .roughness = 0.8F},
+	};
+	MaterialLib lib = {.materials = materials, .count = 2};
+
+	MaterialTable table = {0};
+	TEST_ASSERT_TRUE(material_table_init(&table, &lib));
+
+	InstanceGenerator gen = {0};
+	TEST_ASSERT_TRUE(instance_generator_init(&gen));
+
+	const size_t size =
+	    instance_format_stride(params->format) * (size_t)params->count;
+
+	InstancedGroup group;
+	if (params->format == INSTANCE_FORMAT_COMPACT) {
+		instanced_group_init_compact(&group, NULL, params->count);
+	} else {
+		instanced_group_init(&group, NULL, params->count);
+	}
+	instance_generator_run(&gen, params, &table, group.instance_vbo);
+
+	void* out = NULL;
+	TEST_ASSERT_EQUAL_INT(0,
+	                      posix_memalign(&out, SIMD_ALIGNMENT, size));
+	glBindBuffer(GL_ARRAY_BUFFER, group.instance_vbo);
+	glGetBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)size, out);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	instanced_group_cleanup(&group);
+	instance_generator_cleanup(&gen);
+	material_table_cleanup(&table);
+	return out;
+}
+
+void test_instance_generator_grid_matches_cpu_layout(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	InstanceGenParams params = {.layout = INSTANCE_LAYOUT_GRID,
+	                            .count = 12,
+	                            .spacing = 2.0F,
+	                            .radius = 0.5F,
+	                            .material_index = -1,
+	                            .seed = 1};
+	SphereInstance* out = generate(&params);
+
+	/* 10 columns x 2 rows, centered, first row on +Y */
+	TEST_ASSERT_FLOAT_WITHIN(1e-5F, -9.0F, out[0].model[3][0]);
+	TEST_ASSERT_FLOAT_WITHIN(1e-5F, 1.0F, out[0].model[3][1]);
+	TEST_ASSERT_FLOAT_WITHIN(1e-5F, 9.0F, out[9].model[3][0]);
+	TEST_ASSERT_FLOAT_WITHIN(1e-5F, -1.0F, out[11].model[3][1]);
+	TEST_ASSERT_FLOAT_WITHIN(1e-5F, 0.5F, out[0].model[0][0]);
+
+	/* Materials cycle through the library */
+	TEST_ASSERT_FLOAT_WITHIN(1e-5F, 1.0F, out[0].albedo[0]);
+	TEST_ASSERT_FLOAT_WITHIN(1e-5F, 1.0F, out[1].albedo[2]);
+	TEST_ASSERT_FLOAT_WITHIN(1e-5F, 0.8F, out[1].roughness);
+	TEST_ASSERT_FLOAT_WITHIN(1e-5F, 1.0F, out[1].ao);
+
+	free(out);
+}
+
+void test_instance_generator_poisson_min_distance(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	enum { COUNT = 400 };
+	InstanceGenParams params = {.layout = INSTANCE_LAYOUT_POISSON,
+	                            .count = COUNT,
+	                            .spacing = 2.5F,
+	                            .radius = 0.5F,
+	                            .material_index = 0,
+	                            .seed = 7};
+	SphereInstance* out = generate(&params);
+
+	float min_dist = 1e9F;
+	for (int i = 0; i < COUNT; i++) {
+		for (int j = i + 1; j < COUNT; j++) {
+			float d = glm_vec3_distance(out[i].model[3],
+			                            out[j].model[3]);
+			min_dist = glm_min(min_dist, d);
+		}
+	}
+	TEST_ASSERT_TRUE(min_dist >= 2.0F * params.radius - 1e-4F);
+
+	free(out);
+}
+
+void test_instance_generator_compact_output(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	InstanceGenParams params = {.layout = INSTANCE_LAYOUT_GRID,
+	                            .count = 12,
+	                            .spacing = 2.0F,
+	                            .radius = 0.5F,
+	                            .material_index = -1,
+	                            .seed = 1,
+	                            .format = INSTANCE_FORMAT_COMPACT};
+	SphereInstanceCompact* out = generate(&params);
+
+	/* Same positions as the full format, material index instead of data */
+	SphereInstanceCompact expected;
+	sphere_instance_compact_pack(&expected, (vec3){9.0F, 1.0F, 0.0F},
+	                             0.5F, 1);
+	TEST_ASSERT_FLOAT_WITHIN(1e-5F, 9.0F, out[9].position[0]);
+	TEST_ASSERT_FLOAT_WITHIN(1e-5F, 1.0F, out[9].position[1]);
+	TEST_ASSERT_EQUAL_HEX32(expected.scale_material,
+	                        out[9].scale_material);
+
+	free(out);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_instance_generator_columns);
+	RUN_TEST(test_instance_generator_grid_matches_cpu_layout);
+	RUN_TEST(test_instance_generator_poisson_min_distance);
+	RUN_TEST(test_instance_generator_compact_output);
+	return UNITY_END();
+}
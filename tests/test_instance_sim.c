@@ -0,0 +1,214 @@
+// tests/test_instance_sim.c
+#include "instance_sim.h"
+#include "instanced_rendering.h"
+#include "job_system.h"
+#include "material.h"
+#include "unity.h"
+#include <stdlib.h>
+#include <string.h>
+
+enum { TEST_MATERIALS = 3, TEST_INSTANCES = 1003 };
+
+static PBRMaterial materials[TEST_MATERIALS];
+static MaterialLib lib = {materials, TEST_MATERIALS};
+
+void setUp(void)
+{
+	memset(materials, 0, sizeof(materials));
+	for (int i = 0; i < TEST_MATERIALS; i++) {
+		materials[i].albedo[0] = 0.1F * (float)(i + 1);
+		materials[i].albedo[1] = 0.2F;
+		materials[i].albedo[2] = 0.3F;
+		materials[i].metallic = 0.5F;
+		materials[i].roughness = 0.25F * (float)(i + 1);
+	}
+}
+void tearDown(void)
+{
+}
+
+static void assert_inside_bounds(const InstanceSim* sim)
+{
+	const float* pos[3] = {sim->pos_x, sim->pos_y, sim->pos_z};
+	for (int i = 0; i < sim->count; i++) {
+		for (int axis = 0; axis < 3; axis++) {
+			TEST_ASSERT_TRUE(pos[axis][i] >=
+			                 sim->bounds_min[axis] + sim->scale[i]);
+			TEST_ASSERT_TRUE(pos[axis][i] <=
+			                 sim->bounds_max[axis] - sim->scale[i]);
+		}
+	}
+}
+
+void test_instance_sim_init(void)
+{
+	InstanceSim sim;
+	TEST_ASSERT_EQUAL_INT(1,
+	                      instance_sim_init(&sim, &lib, TEST_INSTANCES,
+	                                        3.0F, 1.0F, 42U));
+	TEST_ASSERT_EQUAL_INT(TEST_INSTANCES, sim.count);
+	TEST_ASSERT_EQUAL_INT(TEST_MATERIALS, sim.material_count);
+	TEST_ASSERT_EQUAL_INT(0, (int)((size_t)sim.pos_x % SIMD_ALIGNMENT));
+	TEST_ASSERT_EQUAL_INT(0, (int)((size_t)sim.scale % SIMD_ALIGNMENT));
+	TEST_ASSERT_EQUAL_UINT32(1U, sim.material[1]);
+	assert_inside_bounds(&sim);
+	instance_sim_cleanup(&sim);
+	TEST_ASSERT_NULL(sim.pos_x);
+}
+
+void test_instance_sim_rejects_empty(void)
+{
+	InstanceSim sim;
+	TEST_ASSERT_EQUAL_INT(0, instance_sim_init(&sim, &lib, 0, 3.0F, 1.0F,
+	                                           42U));
+	MaterialLib empty = {NULL, 0};
+	TEST_ASSERT_EQUAL_INT(0, instance_sim_init(&sim, &empty, 10, 3.0F,
+	                                           1.0F, 42U));
+}
+
+void test_instance_sim_bounces_stay_in_box(void)
+{
+	InstanceSim sim;
+	TEST_ASSERT_EQUAL_INT(1,
+	                      instance_sim_init(&sim, &lib, TEST_INSTANCES,
+	                                        3.0F, 1.0F, 7U));
+
+	/* Large steps: every sphere hits a wall several times */
+	for (int step = 0; step < 100; step++) {
+		instance_sim_step(&sim, 0, sim.count, 0.5F);
+		assert_inside_bounds(&sim);
+	}
+	instance_sim_cleanup(&sim);
+}
+
+void test_instance_sim_bounce_reflects_and_cycles_material(void)
+{
+	InstanceSim sim;
+	TEST_ASSERT_EQUAL_INT(1, instance_sim_init(&sim, &lib, 16, 3.0F, 1.0F,
+	                                           1U));
+	/* Instance 5 heads straight into the +X wall */
+	sim.pos_x[5] = sim.bounds_max[0] - 1.5F;
+	sim.pos_y[5] = 0.0F;
+	sim.pos_z[5] = 0.0F;
+	sim.vel_x[5] = 2.0F;
+	sim.vel_y[5] = 0.0F;
+	sim.vel_z[5] = 0.0F;
+	const uint32_t material = sim.material[5];
+
+	instance_sim_step(&sim, 0, sim.count, 1.0F);
+
+	TEST_ASSERT_EQUAL_FLOAT(sim.bounds_max[0] - 1.0F, sim.pos_x[5]);
+	TEST_ASSERT_EQUAL_FLOAT(-2.0F, sim.vel_x[5]);
+	TEST_ASSERT_EQUAL_UINT32((material + 1U) % TEST_MATERIALS,
+	                         sim.material[5]);
+	instance_sim_cleanup(&sim);
+}
+
+void test_instance_sim_unaligned_ranges_match(void)
+{
+	InstanceSim a;
+	InstanceSim b;
+	TEST_ASSERT_EQUAL_INT(1, instance_sim_init(&a, &lib, TEST_INSTANCES,
+	                                           3.0F, 1.0F, 9U));
+	TEST_ASSERT_EQUAL_INT(1, instance_sim_init(&b, &lib, TEST_INSTANCES,
+	                                           3.0F, 1.0F, 9U));
+
+	/* Scalar heads/tails and SIMD body must agree bit for bit */
+	for (int step = 0; step < 20; step++) {
+		instance_sim_step(&a, 0, a.count, 0.1F);
+		instance_sim_step(&b, 0, 3, 0.1F);
+		instance_sim_step(&b, 3, 517, 0.1F);
+		instance_sim_step(&b, 517, b.count, 0.1F);
+	}
+	TEST_ASSERT_EQUAL_MEMORY(a.pos_x, b.pos_x,
+	                         sizeof(float) * TEST_INSTANCES);
+	TEST_ASSERT_EQUAL_MEMORY(a.vel_z, b.vel_z,
+	                         sizeof(float) * TEST_INSTANCES);
+	TEST_ASSERT_EQUAL_MEMORY(a.material, b.material,
+	                         sizeof(uint32_t) * TEST_INSTANCES);
+	instance_sim_cleanup(&a);
+	instance_sim_cleanup(&b);
+}
+
+void test_instance_sim_write_layout(void)
+{
+	InstanceSim sim;
+	TEST_ASSERT_EQUAL_INT(1, instance_sim_init(&sim, &lib, 8, 3.0F, 0.75F,
+	                                           3U));
+	SphereInstance* out = NULL;
+	TEST_ASSERT_EQUAL_INT(0, posix_memalign((void**)&out, SIMD_ALIGNMENT,
+	                                        8 * sizeof(SphereInstance)));
+
+	instance_sim_write(&sim, out, sizeof(SphereInstance), 0, sim.count);
+
+	const SphereInstance* inst = &out[2];
+	const PBRMaterial* mat = &materials[sim.material[2]];
+	TEST_ASSERT_EQUAL_FLOAT(0.75F, inst->model[0][0]);
+	TEST_ASSERT_EQUAL_FLOAT(0.75F, inst->model[1][1]);
+	TEST_ASSERT_EQUAL_FLOAT(0.75F, inst->model[2][2]);
+	TEST_ASSERT_EQUAL_FLOAT(0.0F, inst->model[0][1]);
+	TEST_ASSERT_EQUAL_FLOAT(sim.pos_x[2], inst->model[3][0]);
+	TEST_ASSERT_EQUAL_FLOAT(sim.pos_y[2], inst->model[3][1]);
+	TEST_ASSERT_EQUAL_FLOAT(sim.pos_z[2], inst->model[3][2]);
+	TEST_ASSERT_EQUAL_FLOAT(1.0F, inst->model[3][3]);
+	TEST_ASSERT_EQUAL_FLOAT(mat->albedo[0], inst->albedo[0]);
+	TEST_ASSERT_EQUAL_FLOAT(mat->metallic, inst->metallic);
+	TEST_ASSERT_EQUAL_FLOAT(mat->roughness, inst->roughness);
+	TEST_ASSERT_EQUAL_FLOAT(1.0F, inst->ao);
+
+	free(out);
+	instance_sim_cleanup(&sim);
+}
+
+void test_instance_sim_threaded_update_matches_serial(void)
+{
+	InstanceSim serial;
+	InstanceSim threaded;
+	TEST_ASSERT_EQUAL_INT(1,
+	                      instance_sim_init(&serial, &lib, 20000, 3.0F,
+	                                        1.0F, 5U));
+	TEST_ASSERT_EQUAL_INT(1,
+	                      instance_sim_init(&threaded, &lib, 20000, 3.0F,
+	                                        1.0F, 5U));
+	SphereInstance* out_serial = NULL;
+	SphereInstance* out_threaded = NULL;
+	TEST_ASSERT_EQUAL_INT(
+	    0, posix_memalign((void**)&out_serial, SIMD_ALIGNMENT,
+	                      20000 * sizeof(SphereInstance)));
+	TEST_ASSERT_EQUAL_INT(
+	    0, posix_memalign((void**)&out_threaded, SIMD_ALIGNMENT,
+	                      20000 * sizeof(SphereInstance)));
+
+	JobSystem* jobs = job_system_create(3);
+	TEST_ASSERT_NOT_NULL(jobs);
+	for (int step = 0; step < 10; step++) {
+		instance_sim_update(&serial, NULL, 0.1F, out_serial,
+		                    sizeof(SphereInstance));
+		instance_sim_update(&threaded, jobs, 0.1F, out_threaded,
+		                    sizeof(SphereInstance));
+	}
+	job_system_destroy(jobs);
+
+	for (int i = 0; i < 20000; i++) {
+		TEST_ASSERT_EQUAL_MEMORY(&out_serial[i], &out_threaded[i],
+		                         offsetof(SphereInstance, padding));
+	}
+
+	free(out_serial);
+	free(out_threaded);
+	instance_sim_cleanup(&serial);
+	instance_sim_cleanup(&threaded);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_instance_sim_init);
+	RUN_TEST(test_instance_sim_rejects_empty);
+	RUN_TEST(test_instance_sim_bounces_stay_in_box);
+	RUN_TEST(test_instance_sim_bounce_reflects_and_cycles_material);
+	RUN_TEST(test_instance_sim_unaligned_ranges_match);
+	RUN_TEST(test_instance_sim_write_layout);
+	RUN_TEST(test_instance_sim_threaded_update_matches_serial);
+	return UNITY_END();
+}
@@ -0,0 +1,135 @@
+// tests/test_instance_stream.c
+#include "gl_common.h"
+#include "instance_stream.h"
+#include "instanced_rendering.h"
+#include "ssbo_rendering.h"
+#include "unity.h"
+#include <string.h>
+
+static GLFWwindow* test_window = NULL;
+
+void setUp(void)
+{
+	if (!glfwInit()) {
+		return;
+	}
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	test_window = glfwCreateWindow(1, 1, "Test", NULL, NULL);
+	if (!test_window) {
+		glfwTerminate();
+		return;
+	}
+
+	glfwMakeContextCurrent(test_window);
+	gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+}
+
+void tearDown(void)
+{
+	if (test_window) {
+		glfwDestroyWindow(test_window);
+		test_window = NULL;
+	}
+	glfwTerminate();
+}
+
+void test_instance_stream_invalid_args(void)
+{
+	InstanceStream stream;
+	TEST_ASSERT_EQUAL_INT(0, instance_stream_init(&stream, 0, 10));
+	TEST_ASSERT_EQUAL_INT(0, instance_stream_init(&stream, 16, 0));
+	TEST_ASSERT_NULL(instance_stream_next(&stream));
+}
+
+void test_instance_stream_regions_are_ssbo_aligned(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	GLint alignment = 1;
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+	/* 80-byte SSBO records are not a divisor of the usual 256 */
+	InstanceStream stream;
+	TEST_ASSERT_TRUE(
+	    instance_stream_init(&stream, sizeof(SphereInstanceSSBO), 7));
+	TEST_ASSERT_TRUE(stream.capacity >= 7);
+	TEST_ASSERT_EQUAL(0, stream.region_size % (size_t)alignment);
+	TEST_ASSERT_EQUAL(stream.region_size,
+	                  (size_t)stream.capacity * sizeof(SphereInstanceSSBO));
+
+	instance_stream_cleanup(&stream);
+}
+
+void test_instance_stream_ring_rotation(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	InstanceStream stream;
+	TEST_ASSERT_TRUE(
+	    instance_stream_init(&stream, sizeof(SphereInstance), 4));
+
+	unsigned char* regions[INSTANCE_STREAM_FRAMES + 1];
+	for (int i = 0; i <= INSTANCE_STREAM_FRAMES; i++) {
+		regions[i] = instance_stream_next(&stream);
+		TEST_ASSERT_NOT_NULL(regions[i]);
+		TEST_ASSERT_EQUAL_INT(i % INSTANCE_STREAM_FRAMES,
+		                      stream.region);
+		TEST_ASSERT_EQUAL_UINT(
+		    (unsigned)((i % INSTANCE_STREAM_FRAMES) * stream.capacity),
+		    instance_stream_base_instance(&stream));
+		(void)memset(regions[i], i, stream.region_size);
+	}
+
+	/* Third frame later, the CPU is back on region 0 */
+	TEST_ASSERT_EQUAL_PTR(regions[0], regions[INSTANCE_STREAM_FRAMES]);
+	TEST_ASSERT_EQUAL_PTR(regions[0] + stream.region_size, regions[1]);
+
+	/* Coherent mapping: the GPU sees the CPU writes without a flush */
+	glFinish();
+	unsigned char value = 0;
+	glBindBuffer(GL_ARRAY_BUFFER, stream.buffer);
+	glGetBufferSubData(GL_ARRAY_BUFFER, (GLintptr)stream.region_size * 2,
+	                   1, &value);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	TEST_ASSERT_EQUAL_UINT8(2, value);
+
+	instance_stream_cleanup(&stream);
+}
+
+void test_instance_stream_group_does_not_own_buffer(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	InstanceStream stream;
+	TEST_ASSERT_TRUE(
+	    instance_stream_init(&stream, sizeof(SphereInstance), 4));
+
+	InstancedGroup group;
+	instanced_group_init_stream(&group, &stream, INSTANCE_FORMAT_FULL, 4);
+	TEST_ASSERT_EQUAL_UINT(stream.buffer, group.instance_vbo);
+	instanced_group_cleanup(&group);
+
+	TEST_ASSERT_TRUE(glIsBuffer(stream.buffer));
+	instance_stream_cleanup(&stream);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_instance_stream_invalid_args);
+	RUN_TEST(test_instance_stream_regions_are_ssbo_aligned);
+	RUN_TEST(test_instance_stream_ring_rotation);
+	RUN_TEST(test_instance_stream_group_does_not_own_buffer);
+	return UNITY_END();
+}
@@ -55,10 +55,57 @@ void test_instanced_rendering_init_cleanup(void)
 	TEST_PASS();
 }
 
+void test_instanced_rendering_compact_layout(void)
+{
+	/* Must match uvec4 / (vec3, uint) attributes of the compact shaders */
+	TEST_ASSERT_EQUAL(16, sizeof(SphereInstanceCompact));
+	TEST_ASSERT_EQUAL(12, offsetof(SphereInstanceCompact, scale_material));
+	TEST_ASSERT_EQUAL(16, instance_format_stride(INSTANCE_FORMAT_COMPACT));
+	TEST_ASSERT_EQUAL(sizeof(SphereInstance),
+	                  instance_format_stride(INSTANCE_FORMAT_FULL));
+}
+
+void test_instanced_rendering_compact_pack(void)
+{
+	SphereInstanceCompact instance;
+	sphere_instance_compact_pack(&instance, (vec3){1.0F, -2.0F, 3.0F},
+	                             1.5F, 42);
+
+	TEST_ASSERT_EQUAL_FLOAT(-2.0F, instance.position[1]);
+	/* half(1.5) = 0x3E00 */
+	TEST_ASSERT_EQUAL_HEX32(0x3E00002AU, instance.scale_material);
+
+	sphere_instance_compact_pack(&instance, (vec3){0.0F, 0.0F, 0.0F},
+	                             0.25F, 0x1FFFF);
+	/* half(0.25) = 0x3400, index wraps to 16 bits */
+	TEST_ASSERT_EQUAL_HEX32(0x3400FFFFU, instance.scale_material);
+}
+
+void test_instanced_rendering_compact_init_cleanup(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	InstancedGroup group;
+	instanced_group_init_compact(&group, NULL, 4);
+	TEST_ASSERT_EQUAL(INSTANCE_FORMAT_COMPACT, group.format);
+
+	GLint size = 0;
+	glBindBuffer(GL_ARRAY_BUFFER, group.instance_vbo);
+	glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+	TEST_ASSERT_EQUAL_INT(64, size);
+
+	instanced_group_cleanup(&group);
+}
+
 int main(void)
 {
 	UNITY_BEGIN();
 	RUN_TEST(test_instanced_rendering_module_exists);
 	RUN_TEST(test_instanced_rendering_init_cleanup);
+	RUN_TEST(test_instanced_rendering_compact_layout);
+	RUN_TEST(test_instanced_rendering_compact_pack);
+	RUN_TEST(test_instanced_rendering_compact_init_cleanup);
 	return UNITY_END();
 }
\ No newline at end of file
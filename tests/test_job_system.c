@@ -0,0 +1,333 @@
+// tests/test_job_system.c
+#include "job_system.h"
+#include "unity.h"
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+enum { TEST_COUNT = 100003, TREE_DEPTH = 14, TREE_LEAF_WORK = 2000 };
+
+static int hits[TEST_COUNT];
+
+void setUp(void)
+{
+	memset(hits, 0, sizeof(hits));
+}
+void tearDown(void)
+{
+}
+
+static void mark_range(void* user_data, int begin, int end)
+{
+	(void)user_data;
+	for (int i = begin; i < end; i++) {
+		__atomic_fetch_add(&hits[i], 1, __ATOMIC_RELAXED);
+	}
+}
+
+static void assert_each_index_once(void)
+{
+	for (int i = 0; i < TEST_COUNT; i++) {
+		TEST_ASSERT_EQUAL_INT_MESSAGE(1, hits[i], "index not run once");
+	}
+}
+
+static void increment_job(void* user_data)
+{
+	__atomic_fetch_add((int*)user_data, 1, __ATOMIC_RELAXED);
+}
+
+/* Arbre binaire : chaque noeud fork ses 2 fils puis join (task tree) */
+typedef struct {
+	JobSystem* system;
+	int depth;
+	long* leaves;
+} TreeNode;
+
+static void tree_job(void* user_data)
+{
+	TreeNode* node = user_data;
+
+	if (node->depth == 0) {
+		volatile unsigned acc = 0;
+		for (unsigned i = 0; i < TREE_LEAF_WORK; i++) {
+			acc += i * i;
+		}
+		__atomic_fetch_add(node->leaves, 1L, __ATOMIC_RELAXED);
+		return;
+	}
+
+	JobCounter counter = {0};
+	TreeNode children[2] = {
+	    {node->system, node->depth - 1, node->leaves},
+	    {node->system, node->depth - 1, node->leaves},
+	};
+	job_system_submit(node->system, tree_job, &children[0],
+	                  JOB_PRIORITY_NORMAL, &counter);
+	job_system_submit(node->system, tree_job, &children[1],
+	                  JOB_PRIORITY_NORMAL, &counter);
+	job_system_wait(node->system, &counter);
+}
+
+static long run_tree(JobSystem* system, int depth)
+{
+	long leaves = 0;
+	TreeNode root = {system, depth, &leaves};
+	JobCounter counter = {0};
+	job_system_submit(system, tree_job, &root, JOB_PRIORITY_NORMAL,
+	                  &counter);
+	job_system_wait(system, &counter);
+	return leaves;
+}
+
+void test_job_system_create_destroy(void)
+{
+	JobSystem* system = job_system_create(2);
+	TEST_ASSERT_NOT_NULL(system);
+	TEST_ASSERT_EQUAL_INT(3, job_system_thread_count(system));
+	job_system_destroy(system);
+
+	TEST_ASSERT_EQUAL_INT(1, job_system_thread_count(NULL));
+	TEST_ASSERT_GREATER_OR_EQUAL(1, job_system_cpu_count());
+}
+
+void test_job_system_counter_join(void)
+{
+	JobSystem* system = job_system_create(3);
+	TEST_ASSERT_NOT_NULL(system);
+
+	int value = 0;
+	JobCounter counter = {0};
+	for (int i = 0; i < 5000; i++) {
+		job_system_submit(system, increment_job, &value,
+		                  (JobPriority)(i % JOB_PRIORITY_COUNT), &counter);
+	}
+	job_system_wait(system, &counter);
+	TEST_ASSERT_EQUAL_INT(0, counter.pending);
+	TEST_ASSERT_EQUAL_INT(5000, value);
+
+	job_system_destroy(system);
+}
+
+void test_job_system_parallel_for_covers_every_index(void)
+{
+	JobSystem* system = job_system_create(3);
+	TEST_ASSERT_NOT_NULL(system);
+
+	job_system_parallel_for(system, TEST_COUNT, 97, mark_range, NULL,
+	                        JOB_PRIORITY_HIGH);
+	assert_each_index_once();
+
+	/* Repeated calls reuse sleeping workers */
+	for (int run = 0; run < 20; run++) {
+		memset(hits, 0, sizeof(hits));
+		job_system_parallel_for(system, TEST_COUNT, 1000, mark_range,
+		                        NULL, JOB_PRIORITY_NORMAL);
+	}
+	assert_each_index_once();
+
+	job_system_destroy(system);
+}
+
+void test_job_system_without_workers(void)
+{
+	/* Caller only: everything runs inside wait/parallel_for */
+	JobSystem* system = job_system_create(0);
+	TEST_ASSERT_NOT_NULL(system);
+
+	job_system_parallel_for(system, TEST_COUNT, 64, mark_range, NULL,
+	                        JOB_PRIORITY_LOW);
+	assert_each_index_once();
+	TEST_ASSERT_EQUAL(1L << 10, run_tree(system, 10));
+
+	job_system_destroy(system);
+}
+
+typedef struct {
+	int order[JOB_PRIORITY_COUNT];
+	int next;
+} PriorityLog;
+
+typedef struct {
+	PriorityLog* log;
+	int tag;
+} PriorityTag;
+
+static void record_job(void* user_data)
+{
+	PriorityTag* tag = user_data;
+	tag->log->order[tag->log->next++] = tag->tag;
+}
+
+void test_job_system_priority_order(void)
+{
+	/* No workers: the caller drains HIGH before NORMAL before LOW */
+	JobSystem* system = job_system_create(0);
+	TEST_ASSERT_NOT_NULL(system);
+
+	PriorityLog log = {{0}, 0};
+	PriorityTag tags[JOB_PRIORITY_COUNT];
+	JobCounter counter = {0};
+	for (int p = JOB_PRIORITY_COUNT - 1; p >= 0; p--) {
+		tags[p].log = &log;
+		tags[p].tag = p;
+		job_system_submit(system, record_job, &tags[p], (JobPriority)p,
+		                  &counter);
+	}
+	job_system_wait(system, &counter);
+
+	TEST_ASSERT_EQUAL_INT(JOB_PRIORITY_COUNT, log.next);
+	TEST_ASSERT_EQUAL_INT(JOB_PRIORITY_HIGH, log.order[0]);
+	TEST_ASSERT_EQUAL_INT(JOB_PRIORITY_NORMAL, log.order[1]);
+	TEST_ASSERT_EQUAL_INT(JOB_PRIORITY_LOW, log.order[2]);
+
+	job_system_destroy(system);
+}
+
+static void* external_submitter(void* arg)
+{
+	JobSystem* system = arg;
+	int value = 0;
+	JobCounter counter = {0};
+	for (int i = 0; i < 1000; i++) {
+		job_system_submit(system, increment_job, &value,
+		                  JOB_PRIORITY_NORMAL, &counter);
+	}
+	job_system_wait(system, &counter);
+	return value == 1000 ? system : NULL;
+}
+
+void test_job_system_external_thread_submit(void)
+{
+	/* Threads outside the system go through the injection queue */
+	JobSystem* system = job_system_create(2);
+	TEST_ASSERT_NOT_NULL(system);
+
+	pthread_t thread;
+	void* result = NULL;
+	TEST_ASSERT_EQUAL_INT(
+	    0, pthread_create(&thread, NULL, external_submitter, system));
+	pthread_join(thread, &result);
+	TEST_ASSERT_EQUAL_PTR(system, result);
+
+	job_system_destroy(system);
+}
+
+void test_job_system_task_tree(void)
+{
+	JobSystem* system = job_system_create(-1);
+	TEST_ASSERT_NOT_NULL(system);
+	TEST_ASSERT_EQUAL(1L << TREE_DEPTH, run_tree(system, TREE_DEPTH));
+	job_system_destroy(system);
+}
+
+/* Même arbre quel que soit le nombre de threads ; chaque noeud est un job */
+void test_job_system_task_tree_thread_counts(void)
+{
+	for (int threads = 1; threads <= 4; threads *= 2) {
+		JobSystem* system = job_system_create(threads - 1);
+		TEST_ASSERT_NOT_NULL(system);
+
+		TEST_ASSERT_EQUAL(1L << TREE_DEPTH,
+		                  run_tree(system, TREE_DEPTH));
+
+		JobSystemStats stats;
+		job_system_stats(system, &stats);
+		TEST_ASSERT_EQUAL((2L << TREE_DEPTH) - 1, stats.executed);
+
+		job_system_destroy(system);
+	}
+}
+
+typedef struct {
+	int started;
+	int release;
+} BlockerJob;
+
+static void blocker_job(void* user_data)
+{
+	BlockerJob* blocker = user_data;
+	__atomic_store_n(&blocker->started, 1, __ATOMIC_RELEASE);
+	while (!__atomic_load_n(&blocker->release, __ATOMIC_ACQUIRE)) {
+		sched_yield();
+	}
+}
+
+typedef struct {
+	int ran;
+	pthread_t thread;
+} ThreadRecord;
+
+static void record_thread_job(void* user_data)
+{
+	ThreadRecord* record = user_data;
+	record->thread = pthread_self();
+	__atomic_store_n(&record->ran, 1, __ATOMIC_RELEASE);
+}
+
+/* Un job background (génération d'icosphère...) n'est jamais exécuté par
+ * un wait du thread créateur, même quand le seul worker est occupé */
+void test_job_system_background_skips_caller_wait(void)
+{
+	JobSystem* system = job_system_create(1);
+	TEST_ASSERT_NOT_NULL(system);
+
+	BlockerJob blocker = {0, 0};
+	JobCounter background = {0};
+	job_system_submit_background(system, blocker_job, &blocker,
+	                             JOB_PRIORITY_NORMAL, &background);
+	while (!__atomic_load_n(&blocker.started, __ATOMIC_ACQUIRE)) {
+		sched_yield();
+	}
+
+	ThreadRecord record = {0};
+	job_system_submit_background(system, record_thread_job, &record,
+	                             JOB_PRIORITY_NORMAL, &background);
+
+	/* Le thread appelant aide à ces waits sans toucher au job background */
+	job_system_parallel_for(system, TEST_COUNT, 64, mark_range, NULL,
+	                        JOB_PRIORITY_NORMAL);
+	assert_each_index_once();
+	TEST_ASSERT_EQUAL(1L << 10, run_tree(system, 10));
+	TEST_ASSERT_EQUAL_INT(0, __atomic_load_n(&record.ran,
+	                                         __ATOMIC_ACQUIRE));
+
+	__atomic_store_n(&blocker.release, 1, __ATOMIC_RELEASE);
+	job_system_wait(system, &background);
+	TEST_ASSERT_EQUAL_INT(1, record.ran);
+	TEST_ASSERT_FALSE(pthread_equal(record.thread, pthread_self()));
+
+	job_system_destroy(system);
+}
+
+void test_job_system_background_without_workers(void)
+{
+	/* Personne pour la file background : exécuté à la soumission */
+	JobSystem* system = job_system_create(0);
+	TEST_ASSERT_NOT_NULL(system);
+
+	ThreadRecord record = {0};
+	JobCounter counter = {0};
+	job_system_submit_background(system, record_thread_job, &record,
+	                             JOB_PRIORITY_NORMAL, &counter);
+	TEST_ASSERT_EQUAL_INT(1, record.ran);
+	TEST_ASSERT_EQUAL_INT(0, counter.pending);
+
+	job_system_destroy(system);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_job_system_create_destroy);
+	RUN_TEST(test_job_system_counter_join);
+	RUN_TEST(test_job_system_parallel_for_covers_every_index);
+	RUN_TEST(test_job_system_without_workers);
+	RUN_TEST(test_job_system_priority_order);
+	RUN_TEST(test_job_system_external_thread_submit);
+	RUN_TEST(test_job_system_task_tree);
+	RUN_TEST(test_job_system_task_tree_thread_counts);
+	RUN_TEST(test_job_system_background_skips_caller_wait);
+	RUN_TEST(test_job_system_background_without_workers);
+	return UNITY_END();
+}
@@ -0,0 +1,176 @@
+// tests/test_light_clusters.c
+#include "light_clusters.h"
+#include "gl_common.h"
+#include "unity.h"
+#include <cglm/cglm.h>
+#include <math.h>
+#include <string.h>
+
+static GLFWwindow* test_window = NULL;
+
+void setUp(void)
+{
+	if (!glfwInit()) {
+		return;
+	}
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	test_window = glfwCreateWindow(1, 1, "Test", NULL, NULL);
+	if (!test_window) {
+		glfwTerminate();
+		return;
+	}
+
+	glfwMakeContextCurrent(test_window);
+	gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+}
+
+void tearDown(void)
+{
+	if (test_window) {
+		glfwDestroyWindow(test_window);
+		test_window = NULL;
+	}
+	glfwTerminate();
+}
+
+void test_light_clusters_generate_deterministic(void)
+{
+	static const vec3 BOUNDS_MIN = {-10.0F, -5.0F, -2.0F};
+	static const vec3 BOUNDS_MAX = {10.0F, 5.0F, 4.0F};
+	AnalyticLight first[64];
+	AnalyticLight second[64];
+
+	light_clusters_generate(first, 64, BOUNDS_MIN, BOUNDS_MAX, 7U);
+	light_clusters_generate(second, 64, BOUNDS_MIN, BOUNDS_MAX, 7U);
+	TEST_ASSERT_EQUAL_MEMORY(first, second, sizeof(first));
+
+	int spots = 0;
+	for (int i = 0; i < 64; i++) {
+		const AnalyticLight* light = &first[i];
+		for (int axis = 0; axis < 3; axis++) {
+			TEST_ASSERT_TRUE(light->position_range[axis] >=
+			                 BOUNDS_MIN[axis]);
+			TEST_ASSERT_TRUE(light->position_range[axis] <=
+			                 BOUNDS_MAX[axis]);
+		}
+		TEST_ASSERT_TRUE(light->position_range[3] > 0.0F);
+		if (light->direction_cos_outer[3] > LIGHT_POINT_COS_OUTER) {
+			/* Smooth cone edge: inner cone inside the outer */
+			TEST_ASSERT_TRUE(light->color_cos_inner[3] >
+			                 light->direction_cos_outer[3]);
+			TEST_ASSERT_FLOAT_WITHIN(
+			    1e-5F, 1.0F,
+			    glm_vec3_norm(light->direction_cos_outer));
+			spots++;
+		}
+	}
+	TEST_ASSERT_EQUAL_INT(16, spots);
+
+	/* Denser sets get shorter ranges */
+	AnalyticLight dense[640];
+	light_clusters_generate(dense, 640, BOUNDS_MIN, BOUNDS_MAX, 7U);
+	TEST_ASSERT_TRUE(dense[0].position_range[3] <
+	                 first[0].position_range[3]);
+}
+
+void test_light_clusters_slice_mapping(void)
+{
+	const float near_plane = 0.1F;
+	const float far_plane = 100.0F;
+
+	TEST_ASSERT_EQUAL_INT(0, light_clusters_slice(0.05F, near_plane,
+	                                              far_plane));
+	TEST_ASSERT_EQUAL_INT(0, light_clusters_slice(near_plane, near_plane,
+	                                              far_plane));
+	TEST_ASSERT_EQUAL_INT(
+	    LIGHT_CLUSTER_Z - 1,
+	    light_clusters_slice(far_plane, near_plane, far_plane));
+
+	/* Logarithmic: the geometric mean splits the slices in half */
+	const float middle = sqrtf(near_plane * far_plane) * 1.01F;
+	TEST_ASSERT_EQUAL_INT(
+	    LIGHT_CLUSTER_Z / 2,
+	    light_clusters_slice(middle, near_plane, far_plane));
+
+	int previous = 0;
+	for (float depth = near_plane; depth < far_plane; depth *= 1.1F) {
+		const int slice =
+		    light_clusters_slice(depth, near_plane, far_plane);
+		TEST_ASSERT_TRUE(slice >= previous);
+		previous = slice;
+	}
+}
+
+void test_light_clusters_cull(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	LightClusters clusters;
+	TEST_ASSERT_TRUE(light_clusters_init(&clusters));
+
+	/* Camera at the origin looking at -z: one light straight ahead, one
+	 * behind the camera */
+	AnalyticLight lights[2];
+	(void)memset(lights, 0, sizeof(lights));
+	glm_vec4_copy((vec4){0.0F, 0.0F, -10.0F, 1.0F},
+	              lights[0].position_range);
+	glm_vec4_copy((vec4){0.0F, 0.0F, 10.0F, 1.0F},
+	              lights[1].position_range);
+	for (int i = 0; i < 2; i++) {
+		glm_vec4_copy((vec4){1.0F, 1.0F, 1.0F, 1.0F},
+		              lights[i].color_cos_inner);
+		lights[i].direction_cos_outer[3] = LIGHT_POINT_COS_OUTER;
+	}
+	light_clusters_upload(&clusters, lights, 2);
+
+	mat4 view;
+	mat4 proj;
+	glm_mat4_identity(view);
+	glm_perspective(glm_rad(60.0F), 16.0F / 9.0F, 0.1F, 100.0F, proj);
+	light_clusters_cull(&clusters, view, proj, 1600, 900);
+
+	const int index_count = light_clusters_read_index_count(&clusters);
+	TEST_ASSERT_TRUE(index_count > 0);
+	TEST_ASSERT_TRUE(index_count < LIGHT_CLUSTER_COUNT);
+
+	/* Screen center, slice of the light center */
+	const int slice = light_clusters_slice(10.0F, 0.1F, 100.0F);
+	const int cluster =
+	    (((slice * LIGHT_CLUSTER_Y) + (LIGHT_CLUSTER_Y / 2)) *
+	     LIGHT_CLUSTER_X) +
+	    (LIGHT_CLUSTER_X / 2);
+
+	GLuint range[2] = {0, 0};
+	GLuint index = ~0U;
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusters.cluster_buffer);
+	glGetBufferSubData(GL_SHADER_STORAGE_BUFFER,
+	                   (GLintptr)((2 + (2 * cluster)) * sizeof(GLuint)),
+	                   sizeof(range), range);
+	TEST_ASSERT_EQUAL_UINT(1, range[1]);
+	glGetBufferSubData(
+	    GL_SHADER_STORAGE_BUFFER,
+	    (GLintptr)((2 + (2 * LIGHT_CLUSTER_COUNT) + range[0]) *
+	               sizeof(GLuint)),
+	    sizeof(index), &index);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	TEST_ASSERT_EQUAL_UINT(0, index);
+
+	light_clusters_cleanup(&clusters);
+	TEST_ASSERT_EQUAL_UINT(0, clusters.cluster_buffer);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_light_clusters_generate_deterministic);
+	RUN_TEST(test_light_clusters_slice_mapping);
+	RUN_TEST(test_light_clusters_cull);
+	return UNITY_END();
+}
@@ -1,14 +1,40 @@
 // tests/test_material.c
+#include "gl_common.h"
 #include "material.h"
 #include "unity.h"
 #include <stdlib.h>
 #include <string.h>
 
+static GLFWwindow* test_window = NULL;
+
 void setUp(void)
 {
+	if (!glfwInit()) {
+		return;
+	}
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	test_window = glfwCreateWindow(1, 1, "Test", NULL, NULL);
+	if (!test_window) {
+		glfwTerminate();
+		return;
+	}
+
+	glfwMakeContextCurrent(test_window);
+	gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
 }
+
 void tearDown(void)
 {
+	if (test_window) {
+		glfwDestroyWindow(test_window);
+		test_window = NULL;
+	}
+	glfwTerminate();
 }
 
 void test_material_module_exists(void)
@@ -46,6 +72,97 @@ void test_material_lib_cleanup_valid(void)
 	TEST_PASS();
 }
 
+enum { TABLE_TEST_MATERIALS = 3 };
+
+static void fill_test_lib(MaterialLib* lib, PBRMaterial* materials)
+{
+	for (int i = 0; i < TABLE_TEST_MATERIALS; i++) {
+		(void)memset(&materials[i], 0, sizeof(PBRMaterial));
+		materials[i].albedo[0] = 0.1F * (float)(i + 1);
+		materials[i].albedo[1] = 0.2F;
+		materials[i].albedo[2] = 0.3F;
+		materials[i].metallic = 0.0F;
+		materials[i].roughness = 0.5F;
+	}
+	lib->materials = materials;
+	lib->count = TABLE_TEST_MATERIALS;
+}
+
+void test_material_gpu_pack_layout(void)
+{
+	PBRMaterial mat = {0};
+	mat.albedo[0] = 0.25F;
+	mat.albedo[1] = 0.5F;
+	mat.albedo[2] = 0.75F;
+	mat.metallic = 1.0F;
+	mat.roughness = 0.3F;
+
+	MaterialGPU gpu;
+	material_gpu_pack(&mat, &gpu);
+
+	/* std430 : 2 vec4 contigus, (albedo, metallic) puis (roughness, ao) */
+	TEST_ASSERT_EQUAL_INT(8 * sizeof(float), sizeof(MaterialGPU));
+	TEST_ASSERT_EQUAL_FLOAT(0.75F, gpu.albedo_metallic[2]);
+	TEST_ASSERT_EQUAL_FLOAT(1.0F, gpu.albedo_metallic[3]);
+	TEST_ASSERT_EQUAL_FLOAT(0.3F, gpu.roughness_ao[0]);
+	TEST_ASSERT_EQUAL_FLOAT(1.0F, gpu.roughness_ao[1]);
+}
+
+void test_material_table_update_uploads_edited_entry(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	PBRMaterial materials[TABLE_TEST_MATERIALS];
+	MaterialLib lib = {0};
+	fill_test_lib(&lib, materials);
+
+	MaterialTable table;
+	TEST_ASSERT_EQUAL_INT(1, material_table_init(&table, &lib));
+
+	/* Édition de l'entrée du milieu uniquement */
+	materials[1].roughness = 0.9F;
+	materials[1].metallic = 1.0F;
+	TEST_ASSERT_EQUAL_INT(1, material_table_update(&table, &lib, 1));
+
+	MaterialGPU uploaded[TABLE_TEST_MATERIALS];
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, table.ssbo);
+	glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(uploaded),
+	                   uploaded);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	for (int i = 0; i < TABLE_TEST_MATERIALS; i++) {
+		MaterialGPU expected;
+		material_gpu_pack(&materials[i], &expected);
+		TEST_ASSERT_EQUAL_MEMORY(&expected, &uploaded[i],
+		                         sizeof(MaterialGPU));
+	}
+	TEST_ASSERT_EQUAL_FLOAT(0.9F, uploaded[1].roughness_ao[0]);
+	TEST_ASSERT_EQUAL_FLOAT(0.5F, uploaded[0].roughness_ao[0]);
+	TEST_ASSERT_EQUAL_FLOAT(0.5F, uploaded[2].roughness_ao[0]);
+
+	material_table_cleanup(&table);
+}
+
+void test_material_table_update_rejects_bad_index(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	PBRMaterial materials[TABLE_TEST_MATERIALS];
+	MaterialLib lib = {0};
+	fill_test_lib(&lib, materials);
+
+	MaterialTable table;
+	TEST_ASSERT_EQUAL_INT(1, material_table_init(&table, &lib));
+	TEST_ASSERT_EQUAL_INT(0, material_table_update(&table, &lib, -1));
+	TEST_ASSERT_EQUAL_INT(
+	    0, material_table_update(&table, &lib, TABLE_TEST_MATERIALS));
+	material_table_cleanup(&table);
+}
+
 int main(void)
 {
 	UNITY_BEGIN();
@@ -53,5 +170,8 @@ int main(void)
 	RUN_TEST(test_material_load_presets_null_path);
 	RUN_TEST(test_material_lib_cleanup_null);
 	RUN_TEST(test_material_lib_cleanup_valid);
+	RUN_TEST(test_material_gpu_pack_layout);
+	RUN_TEST(test_material_table_update_uploads_edited_entry);
+	RUN_TEST(test_material_table_update_rejects_bad_index);
 	return UNITY_END();
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "icosphere.h"
+#include "mesh_optimize.h"
+#include "unity.h"
+#include <stdlib.h>
+#include <string.h>
+
+enum { STATS_MAX_LEVEL = 7 };
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/* Triangle canonique : rotation qui place le plus petit index en tête
+ * (l'orientation est conservée) */
+static void canonical_triangle(const unsigned int* tri, unsigned int* out)
+{
+	int first = 0;
+	if (tri[1] < tri[first]) {
+		first = 1;
+	}
+	if (tri[2] < tri[first]) {
+		first = 2;
+	}
+	for (int k = 0; k < 3; k++) {
+		out[k] = tri[(first + k) % 3];
+	}
+}
+
+static int compare_triangles(const void* lhs, const void* rhs)
+{
+	return memcmp(lhs, rhs, 3 * sizeof(unsigned int));
+}
+
+static unsigned int* sorted_triangles(const unsigned int* indices,
+                                      size_t index_count)
+{
+	unsigned int* tris = malloc(index_count * sizeof(unsigned int));
+	TEST_ASSERT_NOT_NULL(tris);
+	for (size_t i = 0; i < index_count; i += 3) {
+		canonical_triangle(&indices[i], &tris[i]);
+	}
+	qsort(tris, index_count / 3, 3 * sizeof(unsigned int),
+	      compare_triangles);
+	return tris;
+}
+
+void test_mesh_analyze_worst_and_best_case(void)
+{
+	/* Triangles disjoints : chaque sommet transformé une fois */
+	const unsigned int disjoint[6] = {0, 1, 2, 3, 4, 5};
+	MeshCacheStats stats = mesh_analyze_vertex_cache(disjoint, 6, 6, 16);
+	TEST_ASSERT_EQUAL_UINT(6, stats.transformed);
+	TEST_ASSERT_EQUAL_DOUBLE(3.0, stats.acmr);
+	TEST_ASSERT_EQUAL_DOUBLE(1.0, stats.atvr);
+
+	/* Ruban : deux triangles partagent une arête */
+	const unsigned int strip[6] = {0, 1, 2, 2, 1, 3};
+	stats = mesh_analyze_vertex_cache(strip, 6, 4, 16);
+	TEST_ASSERT_EQUAL_UINT(4, stats.transformed);
+	TEST_ASSERT_EQUAL_DOUBLE(2.0, stats.acmr);
+}
+
+void test_mesh_optimize_keeps_triangles(void)
+{
+	IcosphereGeometry geom;
+	icosphere_init(&geom);
+	icosphere_generate(&geom, 3);
+
+	unsigned int* expected =
+	    sorted_triangles(geom.indices.data, geom.indices.size);
+	TEST_ASSERT_EQUAL_INT(1, mesh_optimize_vertex_cache(
+	                             geom.indices.data, geom.indices.size,
+	                             geom.vertices.size));
+	unsigned int* actual =
+	    sorted_triangles(geom.indices.data, geom.indices.size);
+	TEST_ASSERT_EQUAL_MEMORY(expected, actual,
+	                         geom.indices.size * sizeof(unsigned int));
+
+	free(expected);
+	free(actual);
+	icosphere_free(&geom);
+}
+
+void test_mesh_vertex_fetch_remap_is_first_use_order(void)
+{
+	unsigned int indices[6] = {4, 2, 0, 0, 2, 1};
+	unsigned int remap[5];
+	mesh_optimize_vertex_fetch_remap(indices, 6, 5, remap);
+
+	const unsigned int expected[6] = {0, 1, 2, 2, 1, 3};
+	TEST_ASSERT_EQUAL_UINT_ARRAY(expected, indices, 6);
+	/* Sommet 3 inutilisé : placé à la fin */
+	TEST_ASSERT_EQUAL_UINT(4, remap[3]);
+
+	vec3 data[5] = {{0, 0, 0}, {1, 1, 1}, {2, 2, 2}, {3, 3, 3}, {4, 4, 4}};
+	TEST_ASSERT_EQUAL_INT(1, mesh_remap_vec3(data, 5, remap));
+	TEST_ASSERT_EQUAL_FLOAT(4.0F, data[0][0]);
+	TEST_ASSERT_EQUAL_FLOAT(2.0F, data[1][0]);
+	TEST_ASSERT_EQUAL_FLOAT(0.0F, data[2][0]);
+	TEST_ASSERT_EQUAL_FLOAT(1.0F, data[3][0]);
+	TEST_ASSERT_EQUAL_FLOAT(3.0F, data[4][0]);
+}
+
+/* icosphere_optimize ne dégrade l'ACMR à aucun niveau (chiffres : bench_cpu) */
+void test_icosphere_optimize_stats_per_level(void)
+{
+	IcosphereGeometry geom;
+	icosphere_init(&geom);
+
+	for (int level = 0; level <= STATS_MAX_LEVEL; level++) {
+		icosphere_generate(&geom, level);
+
+		MeshCacheStats before;
+		MeshCacheStats after;
+		int optimized = icosphere_optimize(&geom, &before, &after);
+		TEST_ASSERT_EQUAL_INT(1, optimized);
+		TEST_ASSERT_TRUE(after.acmr <= before.acmr);
+
+		/* Sommets et normales suivent le remap */
+		for (size_t i = 0; i < geom.vertices.size; i++) {
+			vec3 normal;
+			glm_vec3_normalize_to(geom.vertices.data[i], normal);
+			TEST_ASSERT_EQUAL_MEMORY(normal, geom.normals.data[i],
+			                         sizeof(vec3));
+		}
+	}
+
+	icosphere_free(&geom);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_mesh_analyze_worst_and_best_case);
+	RUN_TEST(test_mesh_optimize_keeps_triangles);
+	RUN_TEST(test_mesh_vertex_fetch_remap_is_first_use_order);
+	RUN_TEST(test_icosphere_optimize_stats_per_level);
+	return UNITY_END();
+}
@@ -46,10 +46,57 @@ void test_pbr_functions_linkage(void)
 	TEST_PASS();
 }
 
+static PbrLuminanceThreshold read_threshold(GLuint ssbo)
+{
+	PbrLuminanceThreshold data = {0};
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+	glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(data), &data);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	return data;
+}
+
+void test_pbr_threshold_buffer_create(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	GLuint ssbo = pbr_threshold_buffer_create(7.5F);
+	TEST_ASSERT_NOT_EQUAL(0, ssbo);
+
+	PbrLuminanceThreshold data = read_threshold(ssbo);
+	TEST_ASSERT_EQUAL_FLOAT(0.0F, data.mean_luminance);
+	TEST_ASSERT_EQUAL_FLOAT(7.5F, data.clamp_threshold);
+	glDeleteBuffers(1, &ssbo);
+}
+
+void test_pbr_luminance_without_shaders_keeps_default(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	/* Le bake doit toujours trouver un seuil valide dans ssbos[1] */
+	GLuint ssbos[2] = {0, 0};
+	TEST_ASSERT_EQUAL_INT(
+	    0, dispatch_mean_luminance_gpu(0, 0, 0, 16, 16, 3.0F, 5.0F, ssbos));
+	TEST_ASSERT_NOT_EQUAL(0, ssbos[1]);
+	TEST_ASSERT_EQUAL_FLOAT(5.0F, read_threshold(ssbos[1]).clamp_threshold);
+
+	/* Buffers réutilisés, seuil réécrit */
+	const GLuint first = ssbos[1];
+	dispatch_mean_luminance_gpu(0, 0, 0, 16, 16, 3.0F, 2.0F, ssbos);
+	TEST_ASSERT_EQUAL(first, ssbos[1]);
+	TEST_ASSERT_EQUAL_FLOAT(2.0F, read_threshold(ssbos[1]).clamp_threshold);
+	glDeleteBuffers(2, ssbos);
+}
+
 int main(void)
 {
 	UNITY_BEGIN();
 	RUN_TEST(test_pbr_module_exists);
 	RUN_TEST(test_pbr_functions_linkage);
+	RUN_TEST(test_pbr_threshold_buffer_create);
+	RUN_TEST(test_pbr_luminance_without_shaders_keeps_default);
 	return UNITY_END();
 }
\ No newline at end of file
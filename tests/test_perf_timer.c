@@ -1,13 +1,39 @@
 // tests/test_perf_timer.c
+#include "gl_common.h"
 #include "perf_timer.h"
 #include "unity.h"
 #include <string.h>
 
+static GLFWwindow* test_window = NULL;
+
 void setUp(void)
 {
+	if (!glfwInit()) {
+		return;
+	}
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	test_window = glfwCreateWindow(1, 1, "Test", NULL, NULL);
+	if (!test_window) {
+		glfwTerminate();
+		return;
+	}
+
+	glfwMakeContextCurrent(test_window);
+	gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
 }
+
 void tearDown(void)
 {
+	if (test_window) {
+		glfwDestroyWindow(test_window);
+		test_window = NULL;
+	}
+	glfwTerminate();
 }
 
 void test_perf_timer_module_exists(void)
@@ -60,6 +86,68 @@ void test_perf_timer_elapsed_s(void)
 	TEST_ASSERT_GREATER_OR_EQUAL(0.0, elapsed);
 }
 
+void test_gpu_timestamp_ring_reads_oldest_first(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	GPUTimestampRing ring = {0};
+	TEST_ASSERT_EQUAL_INT(1, gpu_timestamp_ring_init(&ring, 2));
+
+	/* Deux frames complètes (tags 1 et 2), une ouverte non fermée */
+	for (int tag = 1; tag <= 2; tag++) {
+		gpu_timestamp_ring_begin(&ring);
+		gpu_timestamp_ring_stamp(&ring, 0);
+		gpu_timestamp_ring_stamp(&ring, 1);
+		gpu_timestamp_ring_end(&ring, tag);
+	}
+	gpu_timestamp_ring_begin(&ring);
+	gpu_timestamp_ring_stamp(&ring, 0);
+	glFinish();
+
+	GLuint64 stamps[2] = {0, 0};
+	int tag = 0;
+	TEST_ASSERT_GREATER_OR_EQUAL(
+	    0, gpu_timestamp_ring_try_read(&ring, stamps, &tag));
+	TEST_ASSERT_EQUAL_INT(1, tag);
+	TEST_ASSERT_TRUE(stamps[1] >= stamps[0]);
+	TEST_ASSERT_GREATER_OR_EQUAL(
+	    0, gpu_timestamp_ring_try_read(&ring, stamps, &tag));
+	TEST_ASSERT_EQUAL_INT(2, tag);
+	TEST_ASSERT_EQUAL_INT(-1,
+	                      gpu_timestamp_ring_try_read(&ring, stamps, &tag));
+
+	gpu_timestamp_ring_cleanup(&ring);
+	TEST_ASSERT_NULL(ring.queries);
+}
+
+void test_gpu_timestamp_ring_drops_unread_slot(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	GPUTimestampRing ring = {0};
+	TEST_ASSERT_EQUAL_INT(1, gpu_timestamp_ring_init(&ring, 1));
+
+	/* Une frame de plus que l'anneau : la plus ancienne est perdue */
+	for (int tag = 1; tag <= GPU_TIMESTAMP_RING_FRAMES + 1; tag++) {
+		gpu_timestamp_ring_begin(&ring);
+		gpu_timestamp_ring_stamp(&ring, 0);
+		gpu_timestamp_ring_end(&ring, tag);
+	}
+	glFinish();
+
+	GLuint64 stamp = 0;
+	int tag = 0;
+	TEST_ASSERT_GREATER_OR_EQUAL(
+	    0, gpu_timestamp_ring_try_read(&ring, &stamp, &tag));
+	TEST_ASSERT_EQUAL_INT(2, tag);
+
+	gpu_timestamp_ring_cleanup(&ring);
+}
+
 int main(void)
 {
 	UNITY_BEGIN();
@@ -68,5 +156,7 @@ int main(void)
 	RUN_TEST(test_perf_timer_elapsed_ms);
 	RUN_TEST(test_perf_timer_elapsed_us);
 	RUN_TEST(test_perf_timer_elapsed_s);
+	RUN_TEST(test_gpu_timestamp_ring_reads_oldest_first);
+	RUN_TEST(test_gpu_timestamp_ring_drops_unread_slot);
 	return UNITY_END();
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "postprocess_presets.h"
 #include "unity.h"
 #include <GLFW/glfw3.h>
+#include <math.h>
+#include <string.h>
 
 static GLFWwindow* window = NULL;
 
@@ -54,12 +56,13 @@ void test_postprocess_init_creates_resources(void)
 	TEST_ASSERT_NOT_EQUAL(0, pp.screen_quad_vao);
 	TEST_ASSERT_NOT_EQUAL(0, pp.screen_quad_vbo);
 	TEST_ASSERT_NOT_EQUAL(0, pp.postprocess_shader);
-	/* Bloom resources */
-	TEST_ASSERT_NOT_EQUAL(0, pp.bloom_fx.fbo);
-	TEST_ASSERT_NOT_EQUAL(0, pp.bloom_fx.mips[0].texture);
+	/* Bloom resources (chaîne prise au premier rendu actif) */
+	TEST_ASSERT_NOT_EQUAL(0, pp.bloom_fx.spd_counter_ssbo);
+	TEST_ASSERT_EQUAL(0, pp.bloom_fx.mips[0].texture);
 	/* DoF resources */
 	TEST_ASSERT_NOT_EQUAL(0, pp.dof_fx.fbo);
-	TEST_ASSERT_NOT_EQUAL(0, pp.dof_fx.blur_tex);
+	TEST_ASSERT_EQUAL(0, pp.dof_fx.blur_tex);
+	TEST_ASSERT_EQUAL_INT(0, pp.target_pool.count);
 
 	TEST_ASSERT_EQUAL(640, pp.width);
 	TEST_ASSERT_EQUAL(480, pp.height);
@@ -185,6 +188,354 @@ void test_postprocess_cleanup(void)
 	TEST_ASSERT_NULL(pp.postprocess_shader);
 }
 
+void test_postprocess_compute_composite(void)
+{
+	PostProcess pp = {0};
+	postprocess_init(&pp, 64, 64);
+	TEST_ASSERT_EQUAL(0, pp.composite_tex);
+
+	/* Sans postprocess.comp (contexte trop ancien) : reste en fragment */
+	const int compute = postprocess_set_compute_composite(&pp, 1);
+	TEST_ASSERT_EQUAL_INT(pp.composite_compute_shader != NULL, compute);
+	if (compute) {
+		/* Cible RGBA8 créée au premier composite */
+		postprocess_begin(&pp);
+		postprocess_end(&pp);
+		TEST_ASSERT_NOT_EQUAL(0, pp.composite_tex);
+		TEST_ASSERT_TRUE(glIsFramebuffer(pp.composite_fbo));
+	}
+	TEST_ASSERT_EQUAL_INT(0, postprocess_set_compute_composite(&pp, 0));
+
+	postprocess_cleanup(&pp);
+	TEST_ASSERT_EQUAL(0, pp.composite_tex);
+	TEST_ASSERT_EQUAL(0, pp.composite_fbo);
+}
+
+void test_postprocess_tile_classification(void)
+{
+	/* 70x40 : grille de 5x3 tuiles 16x16 */
+	PostProcess pp = {0};
+	postprocess_init(&pp, 70, 40);
+	const TileClassifyFX* tiles = &pp.tile_classify_fx;
+	const int available = postprocess_set_compute_composite(&pp, 1) &&
+	                      tiles->classify_shader != NULL;
+	TEST_ASSERT_EQUAL_INT(available,
+	                      postprocess_set_tile_classification(&pp, 1));
+	if (!available) {
+		postprocess_cleanup(&pp);
+		TEST_IGNORE_MESSAGE("Tile classification not available");
+	}
+	TEST_ASSERT_EQUAL_UINT(5, tiles->header.grid[0]);
+	TEST_ASSERT_EQUAL_UINT(3, tiles->header.grid[1]);
+	TEST_ASSERT_NOT_EQUAL(0, tiles->lists_ssbo);
+
+	GpuReadback readback;
+	TEST_ASSERT_TRUE(
+	    gpu_readback_init(&readback, GPU_READBACK_DEFAULT_CAPACITY));
+	postprocess_set_readback(&pp, &readback);
+
+	/* Scène vide : ni vélocité ni profondeur, tout est SKIP */
+	postprocess_enable(&pp, POSTFX_DOF);
+	postprocess_enable(&pp, POSTFX_MOTION_BLUR);
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	gpu_readback_flush(&readback);
+	TEST_ASSERT_EQUAL_UINT(15, tiles->counts[TILE_CLASS_SKIP]);
+	TEST_ASSERT_EQUAL_UINT(0, tiles->counts[TILE_CLASS_CHEAP]);
+	TEST_ASSERT_EQUAL_UINT(0, tiles->counts[TILE_CLASS_FULL]);
+
+	/* Debug motion blur : tout l'écran en FULL */
+	postprocess_enable(&pp, POSTFX_MOTION_BLUR_DEBUG);
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	gpu_readback_flush(&readback);
+	TEST_ASSERT_EQUAL_UINT(15, tiles->counts[TILE_CLASS_FULL]);
+	TEST_ASSERT_EQUAL(GL_NO_ERROR, glGetError());
+
+	/* Grille recalculée au redimensionnement */
+	postprocess_resize(&pp, 32, 33);
+	TEST_ASSERT_EQUAL_UINT(2, tiles->header.grid[0]);
+	TEST_ASSERT_EQUAL_UINT(3, tiles->header.grid[1]);
+
+	postprocess_cleanup(&pp);
+	gpu_readback_cleanup(&readback);
+	TEST_ASSERT_EQUAL(0, tiles->lists_ssbo);
+}
+
+void test_postprocess_tile_class_defines(void)
+{
+	char buf[POSTPROCESS_VARIANT_DEFINES_SIZE + 32];
+	fx_tile_classify_defines(TILE_CLASS_SKIP, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL_STRING("#define POSTFX_TILE_CLASS 0\n"
+	                         "#define POSTFX_TILE_EFFECT_MASK 0x133fu\n",
+	                         buf);
+	fx_tile_classify_defines(TILE_CLASS_CHEAP, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL_STRING("#define POSTFX_TILE_CLASS 1\n"
+	                         "#define POSTFX_TILE_EFFECT_MASK 0x13ffu\n",
+	                         buf);
+	fx_tile_classify_defines(TILE_CLASS_FULL, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL_STRING("#define POSTFX_TILE_CLASS 2\n"
+	                         "#define POSTFX_TILE_EFFECT_MASK 0x1fffu\n",
+	                         buf);
+}
+
+void test_postprocess_color_lut(void)
+{
+	PostProcess pp = {0};
+	postprocess_init(&pp, 64, 64);
+	const ColorLutFX* lut = &pp.color_lut_fx;
+	if (!lut->bake_shader) {
+		TEST_ASSERT_EQUAL_INT(0, postprocess_set_color_lut(&pp, 32));
+		postprocess_cleanup(&pp);
+		TEST_IGNORE_MESSAGE("Color LUT not available");
+	}
+	TEST_ASSERT_EQUAL_INT(COLOR_LUT_SIZE_LARGE, lut->size);
+	TEST_ASSERT_NOT_EQUAL(0, lut->texture);
+
+	/* Cuite au premier composite, puis seulement si une entrée change */
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	TEST_ASSERT_EQUAL_INT(1, lut->bake_count);
+
+	/* Réglages neutres : sous le niveau 8 bits par rapport au chemin
+	 * analytique */
+	ColorLutError error;
+	TEST_ASSERT_TRUE(fx_color_lut_measure_error(&pp, &error));
+	TEST_ASSERT_EQUAL_UINT(COLOR_LUT_ERROR_SAMPLES *
+	                           COLOR_LUT_ERROR_SAMPLES *
+	                           COLOR_LUT_ERROR_SAMPLES,
+	                       error.samples);
+	TEST_ASSERT_TRUE(error.max_error < 1.0F);
+
+	postprocess_toggle(&pp, POSTFX_VIGNETTE);
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	TEST_ASSERT_EQUAL_INT(1, lut->bake_count);
+	postprocess_set_tonemapper(&pp, 0.9F, 0.5F, 0.2F, 0.0F, 0.04F);
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	TEST_ASSERT_EQUAL_INT(2, lut->bake_count);
+
+	/* Retour au chemin analytique */
+	TEST_ASSERT_EQUAL_INT(0, postprocess_set_color_lut(&pp, 0));
+	TEST_ASSERT_EQUAL(0, lut->texture);
+	TEST_ASSERT_FALSE(fx_color_lut_measure_error(&pp, &error));
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	TEST_ASSERT_EQUAL(GL_NO_ERROR, glGetError());
+
+	postprocess_cleanup(&pp);
+	TEST_ASSERT_NULL(lut->bake_shader);
+}
+
+void test_postprocess_bloom_levels(void)
+{
+	PostProcess pp = {0};
+	postprocess_init(&pp, 640, 480);
+	TEST_ASSERT_EQUAL_INT(BLOOM_MIP_LEVELS, pp.bloom_fx.levels);
+
+	TEST_ASSERT_EQUAL_INT(BLOOM_MAX_MIP_LEVELS,
+	                      postprocess_set_bloom_levels(&pp, 99));
+	const BloomMip* last = &pp.bloom_fx.mips[BLOOM_MAX_MIP_LEVELS - 1];
+	TEST_ASSERT_EQUAL(0, last->texture); /* Bloom éteint */
+	TEST_ASSERT_EQUAL_INT(640 >> BLOOM_MAX_MIP_LEVELS, last->width);
+
+	postprocess_toggle(&pp, POSTFX_BLOOM);
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	TEST_ASSERT_NOT_EQUAL(0, last->texture);
+
+	TEST_ASSERT_EQUAL_INT(3, postprocess_set_bloom_levels(&pp, 3));
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	TEST_ASSERT_NOT_EQUAL(0, pp.bloom_fx.mips[2].texture);
+	TEST_ASSERT_EQUAL(0, pp.bloom_fx.mips[3].texture);
+	TEST_ASSERT_EQUAL_INT(1, postprocess_set_bloom_levels(&pp, 0));
+
+	/* Conservé au redimensionnement */
+	postprocess_set_bloom_levels(&pp, 6);
+	postprocess_resize(&pp, 320, 240);
+	TEST_ASSERT_EQUAL_INT(6, pp.bloom_fx.levels);
+	TEST_ASSERT_EQUAL_INT(320 >> 6, pp.bloom_fx.mips[5].width);
+
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	TEST_ASSERT_EQUAL(GL_NO_ERROR, glGetError());
+	TEST_ASSERT_NOT_EQUAL(0, pp.bloom_fx.mips[5].texture);
+
+	postprocess_cleanup(&pp);
+	TEST_ASSERT_EQUAL(0, pp.bloom_fx.mips[0].texture);
+}
+
+void test_postprocess_lazy_effect_targets(void)
+{
+	PostProcess pp = {0};
+	postprocess_init(&pp, 128, 64);
+	const RenderTargetPool* pool = &pp.target_pool;
+	const size_t idle_vram = postprocess_vram_bytes(&pp);
+
+	postprocess_enable(&pp, POSTFX_BLOOM);
+	postprocess_enable(&pp, POSTFX_DOF);
+	postprocess_enable(&pp, POSTFX_MOTION_BLUR);
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	TEST_ASSERT_EQUAL(GL_NO_ERROR, glGetError());
+	TEST_ASSERT_NOT_EQUAL(0, pp.bloom_fx.mips[0].texture);
+	TEST_ASSERT_NOT_EQUAL(0, pp.dof_fx.blur_tex);
+	TEST_ASSERT_NOT_EQUAL(0, pp.motion_blur_fx.neighbor_max_tex);
+	TEST_ASSERT_TRUE(postprocess_vram_bytes(&pp) > idle_vram);
+
+	/* Ping-pong du DoF et tile max : empruntés puis rendus dans la
+	 * frame */
+	TEST_ASSERT_EQUAL_size_t(
+	    32 * 16 * 4, render_target_pool_bytes(pool, DOF_TARGET_OWNER));
+	TEST_ASSERT_EQUAL_size_t(
+	    8 * 4 * 4,
+	    render_target_pool_bytes(pool, MOTION_BLUR_TARGET_OWNER));
+	TEST_ASSERT_EQUAL_size_t(32 * 16 * 4 + 8 * 4 * 4,
+	                         render_target_pool_bytes(pool, NULL));
+
+	/* Frame suivante : les transitoires sont repris, rien n'est créé */
+	const int created = pool->created;
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	TEST_ASSERT_EQUAL_INT(created, pool->created);
+
+	/* Effets éteints : tout est rendu au pool */
+	postprocess_disable(&pp, POSTFX_BLOOM);
+	postprocess_disable(&pp, POSTFX_DOF);
+	postprocess_disable(&pp, POSTFX_MOTION_BLUR);
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	TEST_ASSERT_EQUAL(0, pp.bloom_fx.mips[0].texture);
+	TEST_ASSERT_EQUAL(0, pp.dof_fx.blur_tex);
+	TEST_ASSERT_EQUAL(0, pp.motion_blur_fx.neighbor_max_tex);
+	TEST_ASSERT_EQUAL_size_t(
+	    0, render_target_pool_bytes(pool, BLOOM_TARGET_OWNER));
+
+	/* Redimensionnement : les cibles libres sont détruites */
+	postprocess_resize(&pp, 64, 32);
+	TEST_ASSERT_EQUAL_INT(0, pool->count);
+
+	postprocess_cleanup(&pp);
+}
+
+static const FrameGraphPass* graph_pass(const FrameGraph* graph,
+                                        const char* name)
+{
+	for (int i = 0; i < graph->pass_count; i++) {
+		if (strcmp(graph->passes[i].name, name) == 0) {
+			return &graph->passes[i];
+		}
+	}
+	return NULL;
+}
+
+void test_postprocess_frame_graph(void)
+{
+	PostProcess pp = {0};
+	postprocess_init(&pp, 64, 64);
+	const FrameGraph* graph = &pp.frame_graph;
+
+	postprocess_enable(&pp, POSTFX_BLOOM);
+	postprocess_enable(&pp, POSTFX_MOTION_BLUR);
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	TEST_ASSERT_EQUAL(GL_NO_ERROR, glGetError());
+	TEST_ASSERT_TRUE(graph->compiled);
+	TEST_ASSERT_TRUE(graph_pass(graph, "Bloom")->live);
+	TEST_ASSERT_TRUE(graph_pass(graph, "Motion Blur Tiles")->live);
+	TEST_ASSERT_FALSE(graph_pass(graph, "DoF")->live);
+	TEST_ASSERT_FALSE(graph_pass(graph, "Auto Exposure")->live);
+
+	/* Composite en dernier, une seule barrière fetch pour toutes les
+	 * sorties compute */
+	const FrameGraphStep* last = &graph->steps[graph->step_count - 1];
+	TEST_ASSERT_EQUAL_STRING("Composite", graph->passes[last->pass].name);
+	TEST_ASSERT_EQUAL_UINT(GL_TEXTURE_FETCH_BARRIER_BIT, last->barriers);
+
+	/* Même configuration : pas de recompilation */
+	const int generation = graph->generation;
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+	TEST_ASSERT_EQUAL_INT(generation, graph->generation);
+
+	/* Le composite compute ne lit pas la pré-passe : éliminée */
+	if (postprocess_set_compute_composite(&pp, 1)) {
+		postprocess_begin(&pp);
+		postprocess_end(&pp);
+		TEST_ASSERT_EQUAL(GL_NO_ERROR, glGetError());
+		TEST_ASSERT_FALSE(
+		    graph_pass(graph, "Motion Blur Tiles")->live);
+		TEST_ASSERT_EQUAL(0, pp.motion_blur_fx.neighbor_max_tex);
+	}
+
+	postprocess_cleanup(&pp);
+}
+
+void test_postprocess_auto_exposure_histogram(void)
+{
+	PostProcess pp = {0};
+	postprocess_init(&pp, 64, 48);
+	TEST_ASSERT_NOT_EQUAL(0, pp.auto_exposure_fx.histogram_ssbo);
+
+	GpuReadback readback;
+	TEST_ASSERT_TRUE(
+	    gpu_readback_init(&readback, GPU_READBACK_DEFAULT_CAPACITY));
+	postprocess_set_readback(&pp, &readback);
+
+	postprocess_toggle(&pp, POSTFX_AUTO_EXPOSURE);
+	postprocess_toggle(&pp, POSTFX_EXPOSURE_DEBUG);
+	postprocess_begin(&pp);
+	postprocess_end(&pp);
+
+	/* Rien n'est lu de façon synchrone */
+	unsigned int bins[LUM_HISTOGRAM_BINS];
+	TEST_ASSERT_EQUAL_INT(0, fx_auto_exposure_read_histogram(&pp, bins));
+	TEST_ASSERT_EQUAL_INT(2, readback.count);
+
+	/* Chaque pixel de la région rendue tombe dans un bin */
+	gpu_readback_flush(&readback);
+	TEST_ASSERT_EQUAL_INT(1, fx_auto_exposure_read_histogram(&pp, bins));
+	unsigned int total = 0;
+	for (int i = 0; i < LUM_HISTOGRAM_BINS; i++) {
+		total += bins[i];
+	}
+	TEST_ASSERT_EQUAL_UINT(
+	    (unsigned int)(pp.render_width * pp.render_height), total);
+
+	/* Bins 1 et 255 aux bords de [log2(min), log2(max)] */
+	const AutoExposureParams* params = &pp.auto_exposure;
+	TEST_ASSERT_TRUE(fx_auto_exposure_bin_log_lum(params, 1) >
+	                 log2f(params->min_luminance));
+	TEST_ASSERT_TRUE(fx_auto_exposure_bin_log_lum(
+	                     params, LUM_HISTOGRAM_BINS - 1) <
+	                 log2f(params->max_luminance));
+
+	TEST_ASSERT_TRUE(postprocess_get_exposure(&pp) > 0.0F);
+
+	postprocess_cleanup(&pp);
+	gpu_readback_cleanup(&readback);
+	TEST_ASSERT_EQUAL(0, pp.auto_exposure_fx.histogram_ssbo);
+}
+
+void test_postprocess_variant_key_and_name(void)
+{
+	/* Bits hors du composite ignorés */
+	const unsigned int mask = POSTFX_BLOOM | POSTFX_VIGNETTE | (1U << 20U);
+	const unsigned int key = postprocess_variant_key(mask);
+	TEST_ASSERT_EQUAL_HEX(POSTFX_BLOOM | POSTFX_VIGNETTE, key);
+
+	char buf[POSTPROCESS_VARIANT_NAME_SIZE];
+	postprocess_variant_name(key, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL_STRING("vignette+bloom", buf);
+	postprocess_variant_name(0, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL_STRING("none", buf);
+
+	postprocess_variant_defines(key, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL_STRING("#define POSTFX_VARIANT_MASK 0x011u\n", buf);
+}
+
 int main(void)
 {
 	UNITY_BEGIN();
@@ -194,5 +545,14 @@ int main(void)
 	RUN_TEST(test_postprocess_apply_preset);
 	RUN_TEST(test_postprocess_resize);
 	RUN_TEST(test_postprocess_cleanup);
+	RUN_TEST(test_postprocess_compute_composite);
+	RUN_TEST(test_postprocess_tile_classification);
+	RUN_TEST(test_postprocess_tile_class_defines);
+	RUN_TEST(test_postprocess_color_lut);
+	RUN_TEST(test_postprocess_bloom_levels);
+	RUN_TEST(test_postprocess_lazy_effect_targets);
+	RUN_TEST(test_postprocess_frame_graph);
+	RUN_TEST(test_postprocess_auto_exposure_histogram);
+	RUN_TEST(test_postprocess_variant_key_and_name);
 	return UNITY_END();
 }
@@ -0,0 +1,176 @@
+// tests/test_render_target_pool.c
+#include "gl_common.h"
+#include "render_target_pool.h"
+#include "unity.h"
+
+static GLFWwindow* test_window = NULL;
+
+void setUp(void)
+{
+	if (!glfwInit()) {
+		return;
+	}
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	test_window = glfwCreateWindow(1, 1, "Test", NULL, NULL);
+	if (!test_window) {
+		glfwTerminate();
+		return;
+	}
+
+	glfwMakeContextCurrent(test_window);
+	gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+}
+
+void tearDown(void)
+{
+	if (test_window) {
+		glfwDestroyWindow(test_window);
+		test_window = NULL;
+	}
+	glfwTerminate();
+}
+
+void test_render_target_format_bytes(void)
+{
+	TEST_ASSERT_EQUAL_size_t(8, render_target_format_bytes(GL_RGBA16F));
+	TEST_ASSERT_EQUAL_size_t(4, render_target_format_bytes(GL_RG16F));
+	TEST_ASSERT_EQUAL_size_t(
+	    4, render_target_format_bytes(GL_R11F_G11F_B10F));
+	TEST_ASSERT_EQUAL_size_t(0, render_target_format_bytes(GL_RGB));
+}
+
+void test_render_target_pool_immutable_and_reused(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	RenderTargetPool pool;
+	render_target_pool_init(&pool);
+
+	const GLuint first = render_target_pool_acquire(
+	    &pool, 64, 32, GL_R11F_G11F_B10F, GL_LINEAR, "A");
+	TEST_ASSERT_NOT_EQUAL(0, first);
+
+	GLint immutable = GL_FALSE;
+	glBindTexture(GL_TEXTURE_2D, first);
+	glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_IMMUTABLE_FORMAT,
+	                    &immutable);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	TEST_ASSERT_EQUAL_INT(GL_TRUE, immutable);
+
+	/* Prêtée : une deuxième demande de même clé crée une autre cible */
+	const GLuint second = render_target_pool_acquire(
+	    &pool, 64, 32, GL_R11F_G11F_B10F, GL_LINEAR, "A");
+	TEST_ASSERT_NOT_EQUAL(first, second);
+
+	/* Rendue en cours de frame : reprise par le prochain emprunteur de
+	 * même clé (aliasing), pas par une autre clé */
+	render_target_pool_release(&pool, first);
+	const GLuint other = render_target_pool_acquire(
+	    &pool, 64, 32, GL_RG16F, GL_NEAREST, "B");
+	TEST_ASSERT_NOT_EQUAL(first, other);
+	TEST_ASSERT_EQUAL_UINT(first,
+	                       render_target_pool_acquire(
+	                           &pool, 64, 32, GL_R11F_G11F_B10F,
+	                           GL_NEAREST, "B"));
+	TEST_ASSERT_EQUAL_INT(3, pool.created);
+	TEST_ASSERT_EQUAL_INT(1, pool.reused);
+
+	GLint filter = 0;
+	glBindTexture(GL_TEXTURE_2D, first);
+	glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &filter);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	TEST_ASSERT_EQUAL_INT(GL_NEAREST, filter);
+
+	render_target_pool_cleanup(&pool);
+	TEST_ASSERT_FALSE(glIsTexture(first));
+	TEST_ASSERT_EQUAL_INT(0, pool.count);
+}
+
+void test_render_target_pool_usage_report(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	RenderTargetPool pool;
+	render_target_pool_init(&pool);
+
+	(void)render_target_pool_acquire(&pool, 16, 16, GL_RGBA16F, GL_LINEAR,
+	                                 "A");
+	(void)render_target_pool_acquire(&pool, 16, 16, GL_RGBA16F, GL_LINEAR,
+	                                 "A");
+	const GLuint released = render_target_pool_acquire(
+	    &pool, 8, 8, GL_RG16F, GL_NEAREST, "B");
+	render_target_pool_release(&pool, released);
+
+	TEST_ASSERT_EQUAL_size_t(2 * 16 * 16 * 8,
+	                         render_target_pool_bytes(&pool, "A"));
+	TEST_ASSERT_EQUAL_size_t(0, render_target_pool_bytes(&pool, "B"));
+	TEST_ASSERT_EQUAL_size_t(8 * 8 * 4,
+	                         render_target_pool_bytes(&pool, NULL));
+
+	RenderTargetUsage usage[RENDER_TARGET_POOL_MAX_OWNERS];
+	const int count = render_target_pool_usage(
+	    &pool, usage, RENDER_TARGET_POOL_MAX_OWNERS);
+	TEST_ASSERT_EQUAL_INT(2, count);
+	TEST_ASSERT_EQUAL_STRING("A", usage[0].owner);
+	TEST_ASSERT_EQUAL_INT(2, usage[0].targets);
+	TEST_ASSERT_NULL(usage[1].owner); /* Libres en dernier */
+	TEST_ASSERT_EQUAL_INT(1, usage[1].targets);
+
+	render_target_pool_cleanup(&pool);
+}
+
+void test_render_target_pool_idle_targets_destroyed(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	RenderTargetPool pool;
+	render_target_pool_init(&pool);
+
+	const GLuint kept = render_target_pool_acquire(&pool, 4, 4, GL_RG16F,
+	                                               GL_NEAREST, "A");
+	const GLuint idle = render_target_pool_acquire(&pool, 4, 4, GL_RG16F,
+	                                               GL_NEAREST, "A");
+	render_target_pool_release(&pool, idle);
+	pool.changed = 0;
+
+	for (int i = 0; i < RENDER_TARGET_POOL_IDLE_FRAMES; i++) {
+		render_target_pool_begin_frame(&pool);
+	}
+	TEST_ASSERT_EQUAL_INT(2, pool.count);
+	TEST_ASSERT_FALSE(pool.changed);
+
+	/* Les cibles prêtées ne vieillissent pas */
+	render_target_pool_begin_frame(&pool);
+	TEST_ASSERT_EQUAL_INT(1, pool.count);
+	TEST_ASSERT_TRUE(pool.changed);
+	TEST_ASSERT_FALSE(glIsTexture(idle));
+	TEST_ASSERT_TRUE(glIsTexture(kept));
+
+	/* Redimensionnement : plus aucune cible libre */
+	render_target_pool_release(&pool, kept);
+	render_target_pool_trim(&pool);
+	TEST_ASSERT_EQUAL_INT(0, pool.count);
+
+	render_target_pool_cleanup(&pool);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_render_target_format_bytes);
+	RUN_TEST(test_render_target_pool_immutable_and_reused);
+	RUN_TEST(test_render_target_pool_usage_report);
+	RUN_TEST(test_render_target_pool_idle_targets_destroyed);
+	return UNITY_END();
+}
@@ -308,6 +308,61 @@ void test_shader_load_compute_link_fail(void)
 	remove("test_comp_link.comp");
 }
 
+void test_shader_read_file_with_defines(void)
+{
+	write_file("test_defines.frag",
+	           "#version 330 core\n"
+	           "void main() { }\n");
+	char* content = shader_read_file_with_defines(
+	    "test_defines.frag", "#define VARIANT 1\n");
+	TEST_ASSERT_NOT_NULL(content);
+	// Defines must follow #version, which stays first
+	TEST_ASSERT_EQUAL_STRING("#version 330 core\n"
+	                         "#define VARIANT 1\n"
+	                         "void main() { }\n",
+	                         content);
+	free(content);
+	remove("test_defines.frag");
+}
+
+void test_shader_program_async_success(void)
+{
+	write_file("test_valid.vert",
+	           "#version 330 core\n"
+	           "void main() { gl_Position = vec4(0.0, 0.0, 0.0, 1.0); }");
+	write_file("test_valid.frag",
+	           "#version 330 core\n"
+	           "out vec4 FragColor;\n"
+	           "void main() { FragColor = vec4(COLOR); }");
+
+	GLuint prog = shader_program_begin(
+	    "test_valid.vert", "test_valid.frag", "#define COLOR 0.5\n");
+	TEST_ASSERT_NOT_EQUAL(0, prog);
+	while (!shader_program_is_ready(prog)) {
+	}
+
+	Shader* shader = shader_program_finish(prog, "test_async");
+	TEST_ASSERT_NOT_NULL(shader);
+	shader_destroy(shader);
+}
+
+void test_shader_program_async_fail(void)
+{
+	write_file("test_valid.vert",
+	           "#version 330 core\n"
+	           "void main() { gl_Position = vec4(0.0, 0.0, 0.0, 1.0); }");
+	write_file("test_valid.frag",
+	           "#version 330 core\n"
+	           "out vec4 FragColor;\n"
+	           "void main() { FragColor = vec4(COLOR); }");
+
+	// COLOR is not defined: the fragment stage fails to compile
+	GLuint prog =
+	    shader_program_begin("test_valid.vert", "test_valid.frag", "");
+	TEST_ASSERT_NOT_EQUAL(0, prog);
+	TEST_ASSERT_NULL(shader_program_finish(prog, "test_async_fail"));
+}
+
 int main(void)
 {
 	UNITY_BEGIN();
@@ -326,5 +381,8 @@ int main(void)
 	RUN_TEST(test_shader_load_compute_success);
 	RUN_TEST(test_shader_load_compute_compile_fail);
 	RUN_TEST(test_shader_load_compute_link_fail);
+	RUN_TEST(test_shader_read_file_with_defines);
+	RUN_TEST(test_shader_program_async_success);
+	RUN_TEST(test_shader_program_async_fail);
 	return UNITY_END();
 }
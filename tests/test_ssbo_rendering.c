@@ -55,10 +55,32 @@ void test_ssbo_rendering_init_cleanup(void)
 	TEST_PASS();
 }
 
+void test_ssbo_rendering_compact_init(void)
+{
+	if (!test_window) {
+		TEST_IGNORE_MESSAGE("OpenGL context not available");
+	}
+
+	SSBOGroup group;
+	SphereInstanceCompact instances[3] = {0};
+
+	ssbo_group_init_compact(&group, instances, 3);
+	TEST_ASSERT_EQUAL_INT(INSTANCE_FORMAT_COMPACT, group.format);
+
+	GLint size = 0;
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, group.ssbo);
+	glGetBufferParameteriv(GL_SHADER_STORAGE_BUFFER, GL_BUFFER_SIZE, &size);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	TEST_ASSERT_EQUAL_INT(3 * 16, size);
+
+	ssbo_group_cleanup(&group);
+}
+
 int main(void)
 {
 	UNITY_BEGIN();
 	RUN_TEST(test_ssbo_rendering_module_exists);
 	RUN_TEST(test_ssbo_rendering_init_cleanup);
+	RUN_TEST(test_ssbo_rendering_compact_init);
 	return UNITY_END();
 }
\ No newline at end of file
@@ -226,7 +226,7 @@ def test_parse_trace_dump_labels():
         '5678 glObjectLabel(identifier = GL_PROGRAM, name = 99, length = -1, label = "shaders/pbr.frag")',
     ]
 
-    prog_labels, _, _ = trace_analyze.parse_trace_dump(iter(dump_lines))
+    prog_labels, _, _, _ = trace_analyze.parse_trace_dump(iter(dump_lines))
 
     assert len(prog_labels) == 2
     assert prog_labels[42] == "shaders/test.glsl"
@@ -242,7 +242,7 @@ def test_parse_trace_dump_debug_groups():
         "400 glPopDebugGroup()",
     ]
 
-    _, call_markers_raw, _ = trace_analyze.parse_trace_dump(iter(dump_lines))
+    _, call_markers_raw, _, _ = trace_analyze.parse_trace_dump(iter(dump_lines))
 
     assert len(call_markers_raw) == 2
     assert call_markers_raw[0] == (100, 200, "IBL Generation")
@@ -256,13 +256,81 @@ def test_parse_trace_dump_timestamp_fetches():
         "16039 glGetQueryObjectui64v(id = 4, pname = GL_QUERY_RESULT, params = &3550650788280)",
     ]
 
-    _, _, timestamp_fetches = trace_analyze.parse_trace_dump(iter(dump_lines))
+    _, _, timestamp_fetches, _ = trace_analyze.parse_trace_dump(iter(dump_lines))
 
     assert len(timestamp_fetches) == 2
     assert timestamp_fetches[0] == (16038, 3550341052030)
     assert timestamp_fetches[1] == (16039, 3550650788280)
 
 
+def test_parse_trace_dump_render_scales():
+    """Test parsing of the per-frame render_scale debug markers."""
+    dump_lines = [
+        '500 glDebugMessageInsert(source = GL_DEBUG_SOURCE_APPLICATION, type = GL_DEBUG_TYPE_MARKER, id = 0, severity = GL_DEBUG_SEVERITY_NOTIFICATION, length = -1, buf = "render_scale=1.000 1920x1080")',
+        '900 glDebugMessageInsert(source = GL_DEBUG_SOURCE_APPLICATION, type = GL_DEBUG_TYPE_MARKER, id = 0, severity = GL_DEBUG_SEVERITY_NOTIFICATION, length = -1, buf = "render_scale=0.750 1440x810")',
+        '950 glDebugMessageInsert(source = GL_DEBUG_SOURCE_APPLICATION, type = GL_DEBUG_TYPE_MARKER, id = 0, severity = GL_DEBUG_SEVERITY_NOTIFICATION, length = -1, buf = "other marker")',
+    ]
+
+    _, _, _, render_scales = trace_analyze.parse_trace_dump(iter(dump_lines))
+
+    assert render_scales == [(500, 1.0, 1920, 1080), (900, 0.75, 1440, 810)]
+
+
+def test_assign_render_scales():
+    """Test debug groups get the scale of the last marker before them."""
+    marker_instances = [
+        {"id": 0, "start": 100, "end": 200},
+        {"id": 1, "start": 600, "end": 700},
+        {"id": 2, "start": 1000, "end": 1100},
+    ]
+    render_scales = [(500, 1.0, 1920, 1080), (900, 0.75, 1440, 810)]
+
+    trace_analyze.assign_render_scales(marker_instances, render_scales)
+
+    assert marker_instances[0]["render_scale"] is None
+    assert marker_instances[1]["render_scale"] == 1.0
+    assert marker_instances[2]["render_scale"] == 0.75
+
+
+def test_summarize_render_scales():
+    """Test the per-frame render scale summary."""
+    render_scales = [
+        (100, 1.0, 1920, 1080),
+        (200, 0.75, 1440, 810),
+        (300, 0.75, 1440, 810),
+        (400, 1.0, 1920, 1080),
+    ]
+
+    summary = trace_analyze.summarize_render_scales(render_scales)
+
+    assert summary["frames"] == 4
+    assert summary["min"] == 0.75
+    assert summary["max"] == 1.0
+    assert summary["mean"] == 0.875
+    assert summary["changes"] == 2
+    assert summary["histogram"] == {1.0: 2, 0.75: 2}
+    assert trace_analyze.summarize_render_scales([]) is None
+
+
+def test_print_render_scale_summary():
+    """Test render scale summary output."""
+    summary = trace_analyze.summarize_render_scales(
+        [(100, 1.0, 1920, 1080), (200, 0.5, 960, 540)]
+    )
+
+    output = StringIO()
+    with patch("sys.stdout", output):
+        trace_analyze.print_render_scale_summary(summary)
+        trace_analyze.print_render_scale_summary(None)
+
+    result = output.getvalue()
+
+    assert "Render Scale" in result
+    assert "Frames: 2" in result
+    assert "0.500: 1 frames" in result
+    assert "No render_scale marker" in result
+
+
 def test_print_shader_table_formatting():
     """Test shader table output formatting."""
     stats = {
@@ -301,6 +369,7 @@ def test_print_instance_table_with_sum_indicator():
             "calls": 50,
             "gpu": 10000000,
             "range": 100,
+            "render_scale": 0.75,
         }
     ]
 
@@ -314,6 +383,7 @@ def test_print_instance_table_with_sum_indicator():
     assert "Test Group" in result
     assert "100-200" in result
     assert "500.0*" in result  # Asterisk for sum
+    assert "0.750" in result  # Render scale of the frame
 
 
 def test_process_replay_output():
@@ -393,6 +463,7 @@ def test_main_minimal():
         mock_dump = MagicMock()
         mock_dump.stdout = StringIO(
             '10 glObjectLabel(identifier = GL_PROGRAM, name = 1, length = -1, label = "shaders/test.glsl")\n'
+            '15 glDebugMessageInsert(source = GL_DEBUG_SOURCE_APPLICATION, type = GL_DEBUG_TYPE_MARKER, id = 0, severity = GL_DEBUG_SEVERITY_NOTIFICATION, length = -1, buf = "render_scale=1.000 1920x1080")\n'
             '20 glPushDebugGroup(source = GL_DEBUG_SOURCE_APPLICATION, id = 0, length = -1, message = "Group")\n'
             "30 glPopDebugGroup()\n"
             "31 glGetQueryObjectui64v(id = 1, pname = GL_QUERY_RESULT, params = &1000)\n"
@@ -437,10 +508,14 @@ if __name__ == "__main__":
         test_parse_trace_dump_labels()
         test_parse_trace_dump_debug_groups()
         test_parse_trace_dump_timestamp_fetches()
+        test_parse_trace_dump_render_scales()
+        test_assign_render_scales()
+        test_summarize_render_scales()
+        test_print_render_scale_summary()
         test_print_shader_table_formatting()
         test_print_instance_table_with_sum_indicator()
         test_process_replay_output()
         test_get_frame_count_success()
         test_get_frame_count_failure()
         test_main_minimal()
-        print("✓ All 19 tests passed!")
+        print("✓ All 23 tests passed!")